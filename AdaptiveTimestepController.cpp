@@ -0,0 +1,79 @@
+#include "AdaptiveTimestepController.h"
+
+#include <math.h>
+
+const float AdaptiveTimestepController::_MAX_GROWTH_PER_STEP = 1.25f;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Ensures that the object starts object with initialized values.  The first step is the 
+    longest allowed one, and the first call to NextStepSec(...) shortens it if necessary.
+Parameters:
+    minStepSec              The shortest delta time.  Very fast particles may still tunnel.
+    maxStepSec              The longest delta time, which is used when nothing is moving.
+    maxDisplacementInRadii  How far the fastest particle is allowed to move in one step, as a 
+                            fraction of the radius of influence.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+AdaptiveTimestepController::AdaptiveTimestepController(const float minStepSec, 
+    const float maxStepSec, const float maxDisplacementInRadii) :
+    _minStepSec(minStepSec),
+    _maxStepSec((maxStepSec < minStepSec) ? minStepSec : maxStepSec),
+    _maxDisplacementInRadii(maxDisplacementInRadii),
+    _lastStepSec((maxStepSec < minStepSec) ? minStepSec : maxStepSec)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Solves 0.5 * a * dt^2 + v * dt = d for dt, where d is the allowed displacement, and clamps 
+    it.
+Parameters:
+    maxSpeed            The fastest particle speed.
+    maxAcceleration     The largest net force / mass on any particle.
+    radiusOfInfluence   The smallest particle radius.  Small particles tunnel first.
+Returns:
+    The delta time for the next step.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+float AdaptiveTimestepController::NextStepSec(const float maxSpeed, 
+    const float maxAcceleration, const float radiusOfInfluence)
+{
+    // positive root of the quadratic
+    // Note: Written as 2d / (v + sqrt(v^2 + 2ad)) instead of (sqrt(v^2 + 2ad) - v) / a so that 
+    // it doesn't lose precision when the acceleration is small and doesn't divide by 0 when it 
+    // is 0.
+    float maxDisplacement = _maxDisplacementInRadii * radiusOfInfluence;
+    float denominator = maxSpeed + 
+        sqrtf((maxSpeed * maxSpeed) + (2.0f * maxAcceleration * maxDisplacement));
+    float stepSec = _maxStepSec;
+    if (denominator > 0.0f)
+    {
+        stepSec = (2.0f * maxDisplacement) / denominator;
+    }
+
+    float maxGrownStepSec = _lastStepSec * _MAX_GROWTH_PER_STEP;
+    stepSec = (stepSec > maxGrownStepSec) ? maxGrownStepSec : stepSec;
+    stepSec = (stepSec > _maxStepSec) ? _maxStepSec : stepSec;
+    stepSec = (stepSec < _minStepSec) ? _minStepSec : stepSec;
+
+    _lastStepSec = stepSec;
+    return stepSec;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    The delta time that the last call to NextStepSec(...) picked.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+float AdaptiveTimestepController::LastStepSec() const
+{
+    return _lastStepSec;
+}
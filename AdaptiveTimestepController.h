@@ -0,0 +1,37 @@
+#pragma once
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Picks the delta time for the next simulation step from how fast things are moving, in the 
+    spirit of the Courant-Friedrichs-Lewy condition: no particle should move more than a 
+    fraction of a particle radius in one step.  Otherwise two fast particles can pass through 
+    each other between steps without ever being close enough to collide.
+
+    With speed v and acceleration a, a particle moves v * dt + 0.5 * a * dt^2 in one step, so 
+    the next delta time is the one that makes that equal to the allowed displacement.  Slow 
+    scenes get long steps, fast ones short steps.  The result is clamped to the configured 
+    bounds, and it is allowed to grow only gradually from one step to the next so that it 
+    doesn't jump back and forth.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class AdaptiveTimestepController
+{
+public:
+    AdaptiveTimestepController(const float minStepSec, const float maxStepSec, 
+        const float maxDisplacementInRadii = 0.5f);
+
+    float NextStepSec(const float maxSpeed, const float maxAcceleration, 
+        const float radiusOfInfluence);
+    float LastStepSec() const;
+
+private:
+    float _minStepSec;
+    float _maxStepSec;
+    float _maxDisplacementInRadii;
+    float _lastStepSec;
+
+    // the most that delta time can grow by from one step to the next
+    // Note: Shrinking is not limited.  A particle that suddenly speeds up needs the short step 
+    // right away.
+    static const float _MAX_GROWTH_PER_STEP;
+};
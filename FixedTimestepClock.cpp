@@ -0,0 +1,171 @@
+#include "FixedTimestepClock.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Ensures that the object starts object with initialized values.
+Parameters:
+    fixedStepSec        The simulation's delta time until SetStepSec(...) says otherwise.
+    maxStepsPerFrame    The cap on steps per displayed frame.  At least 1.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+FixedTimestepClock::FixedTimestepClock(const float fixedStepSec, const int maxStepsPerFrame) :
+    _stepSec(fixedStepSec),
+    _maxStepsPerFrame((maxStepsPerFrame < 1) ? 1 : maxStepsPerFrame),
+    _numStepsThisFrame(0),
+    _accumulatorSec(0.0),
+    _throughputWindowSec(0.0),
+    _throughputWindowSteps(0),
+    _stepsPerSecond(0.0),
+    _numDroppedSteps(0)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Starts measuring real time from now.  Nothing before this counts.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void FixedTimestepClock::Start()
+{
+    _lastFrameTime = clock_type::now();
+    _accumulatorSec = 0.0;
+    _throughputWindowSec = 0.0;
+    _throughputWindowSteps = 0;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Adds the real time since the last call to the accumulator.  Call it once per displayed 
+    frame, before the NextStep() loop.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void FixedTimestepClock::AdvanceFrame()
+{
+    clock_type::time_point now = clock_type::now();
+    double elapsedSec = std::chrono::duration<double>(now - _lastFrameTime).count();
+    _lastFrameTime = now;
+
+    _accumulatorSec += elapsedSec;
+    _numStepsThisFrame = 0;
+
+    // Note: The steps are counted as NextStep() hands them out, so the rate lags by a frame, 
+    // which doesn't matter over a whole second.
+    _throughputWindowSec += elapsedSec;
+    if (_throughputWindowSec > 1.0)
+    {
+        _stepsPerSecond = (double)_throughputWindowSteps / _throughputWindowSec;
+        _throughputWindowSec = 0.0;
+        _throughputWindowSteps = 0;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Takes one step's worth of time out of the accumulator if there is that much and this 
+    frame hasn't hit the cap.  If it has hit the cap, the rest of the backlog is dropped, but 
+    the fraction of a step is kept so that the interpolation stays smooth.
+Parameters: None
+Returns:
+    True if the caller should run another step of StepSec() before displaying this frame.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+bool FixedTimestepClock::NextStep()
+{
+    if (_accumulatorSec < _stepSec)
+    {
+        return false;
+    }
+
+    if (_numStepsThisFrame >= _maxStepsPerFrame)
+    {
+        unsigned int numBehind = (unsigned int)(_accumulatorSec / _stepSec);
+        _numDroppedSteps += numBehind;
+        _accumulatorSec -= (double)numBehind * _stepSec;
+        return false;
+    }
+
+    _accumulatorSec -= _stepSec;
+    _numStepsThisFrame++;
+    _throughputWindowSteps++;
+    return true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.  The new step size is used starting with the next NextStep().
+Parameters:
+    stepSec     Self-explanatory.  Must be greater than 0.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void FixedTimestepClock::SetStepSec(const float stepSec)
+{
+    _stepSec = stepSec;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    The delta time to give to each simulation step.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+float FixedTimestepClock::StepSec() const
+{
+    return _stepSec;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    How far the displayed frame is between the last simulated state and the next one.
+Parameters: None
+Returns:
+    A value on the range [0,1).  0 means "show the state before the last step".
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+float FixedTimestepClock::InterpolationAlpha() const
+{
+    return (float)(_accumulatorSec / _stepSec);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the simulation throughput, which is reported separately from the 
+    render frame rate.
+Parameters: None
+Returns:
+    Simulation steps per real second, as of the last full second.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+double FixedTimestepClock::StepsPerSecond() const
+{
+    return _stepsPerSecond;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.  If this keeps growing, then the simulation can't keep up with real time.
+Parameters: None
+Returns:
+    The number of steps that have been skipped by the steps-per-frame cap since construction.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int FixedTimestepClock::NumDroppedSteps() const
+{
+    return _numDroppedSteps;
+}
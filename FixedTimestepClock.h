@@ -0,0 +1,60 @@
+#pragma once
+
+#include <chrono>
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Decides how many fixed-size simulation steps to run each displayed frame so that 
+    simulated time keeps pace with real time no matter how fast the machine renders.
+
+    Call Start() once, then AdvanceFrame() once per displayed frame, which adds the real time 
+    since the last call to an accumulator, and then run a step each time NextStep() returns 
+    true, which takes one step's worth of time out of the accumulator.  What is left over is 
+    less than one step, and InterpolationAlpha() says how far into the next step the displayed 
+    frame is, so the renderer can blend the last two states.
+
+    The step size is fixed unless it is changed with SetStepSec(...).  An adaptive delta time 
+    (see AdaptiveTimestepController) can change it between any two steps.
+
+    If the simulation can't keep up, the number of steps per frame would keep growing, each 
+    frame would take longer, and it would never catch up (the "spiral of death").  So the steps 
+    per frame are capped and any time beyond the cap is dropped.  The simulation then runs 
+    slower than real time instead of locking up.
+
+    Uses std::chrono::steady_clock, which never jumps backwards, instead of Stopwatch, which 
+    shares its state between all instances.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class FixedTimestepClock
+{
+public:
+    FixedTimestepClock(const float fixedStepSec = 0.01f, const int maxStepsPerFrame = 5);
+    void Start();
+    void AdvanceFrame();
+    bool NextStep();
+
+    void SetStepSec(const float stepSec);
+    float StepSec() const;
+    float InterpolationAlpha() const;
+    double StepsPerSecond() const;
+    unsigned int NumDroppedSteps() const;
+
+private:
+    typedef std::chrono::steady_clock clock_type;
+
+    float _stepSec;
+    int _maxStepsPerFrame;
+    int _numStepsThisFrame;
+    clock_type::time_point _lastFrameTime;
+
+    // real time that hasn't been simulated yet
+    double _accumulatorSec;
+
+    // simulation throughput, measured over about a second at a time
+    double _throughputWindowSec;
+    int _throughputWindowSteps;
+    double _stepsPerSecond;
+
+    // steps that were skipped by the cap
+    unsigned int _numDroppedSteps;
+};
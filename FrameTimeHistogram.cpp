@@ -0,0 +1,232 @@
+#include "FrameTimeHistogram.h"
+
+#include <stdio.h>
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Ensures that the object starts object with initialized values.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+FrameTimeHistogram::FrameTimeHistogram() :
+    _counts(_NUM_BUCKETS, 0),
+    _numSamples(0),
+    _maxNanoseconds(0),
+    _totalSec(0.0)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Counts one time.
+Parameters:
+    sec     Self-explanatory.  Negative times count as 0.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameTimeHistogram::Record(double sec)
+{
+    unsigned long long nanoseconds = (sec > 0.0) ? (unsigned long long)(sec * 1.0e9) : 0;
+    _counts[BucketIndex(nanoseconds)]++;
+    _numSamples++;
+    _maxNanoseconds = (nanoseconds > _maxNanoseconds) ? nanoseconds : _maxNanoseconds;
+    _totalSec += (sec > 0.0) ? sec : 0.0;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Forgets everything that was recorded.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameTimeHistogram::Reset()
+{
+    _counts.assign(_NUM_BUCKETS, 0);
+    _numSamples = 0;
+    _maxNanoseconds = 0;
+    _totalSec = 0.0;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many times have been recorded since the start or the last Reset().
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned long long FrameTimeHistogram::NumSamples() const
+{
+    return _numSamples;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Finds the time that the given percent of the recorded times are at or below.
+Parameters:
+    percentile  0-100.  100 is the maximum.
+Returns:
+    The top of the bucket that the percentile falls in, or the maximum if it falls in the last
+    one.  0 if nothing has been recorded.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+double FrameTimeHistogram::PercentileSec(double percentile) const
+{
+    if (_numSamples == 0)
+    {
+        return 0.0;
+    }
+
+    // the sample that the percentile lands on, counting from 1
+    double fraction = percentile / 100.0;
+    fraction = (fraction < 0.0) ? 0.0 : ((fraction > 1.0) ? 1.0 : fraction);
+    unsigned long long targetCount = (unsigned long long)(fraction * (double)_numSamples + 0.5);
+    targetCount = (targetCount < 1) ? 1 : targetCount;
+
+    unsigned long long countSoFar = 0;
+    for (int bucketIndex = 0; bucketIndex < _NUM_BUCKETS; bucketIndex++)
+    {
+        countSoFar += _counts[bucketIndex];
+        if (countSoFar == _numSamples)
+        {
+            // the last bucket's top can be past the maximum, or short of it if the maximum is
+            // off the end
+            return MaxSec();
+        }
+        else if (countSoFar >= targetCount)
+        {
+            return (double)BucketHighestNanoseconds(bucketIndex) * 1.0e-9;
+        }
+    }
+
+    return MaxSec();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    The average of the recorded times.  0 if nothing has been recorded.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+double FrameTimeHistogram::MeanSec() const
+{
+    return (_numSamples > 0) ? (_totalSec / (double)_numSamples) : 0.0;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    The longest recorded time, to the nanosecond.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+double FrameTimeHistogram::MaxSec() const
+{
+    return (double)_maxNanoseconds * 1.0e-9;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Prints the percentiles to the console, and optionally every bucket that has anything in
+    it along with the percent of the samples that are at or below it.
+Parameters:
+    name            What was timed.
+    withBuckets     Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameTimeHistogram::Print(const char *name, bool withBuckets) const
+{
+    printf("%-12s samples %8llu  mean %8.3fms  p50 %8.3fms  p90 %8.3fms  p99 %8.3fms  "
+        "p99.9 %8.3fms  max %8.3fms\n", name, _numSamples, 1000.0 * MeanSec(),
+        1000.0 * PercentileSec(50.0), 1000.0 * PercentileSec(90.0),
+        1000.0 * PercentileSec(99.0), 1000.0 * PercentileSec(99.9), 1000.0 * MaxSec());
+    if (!withBuckets || _numSamples == 0)
+    {
+        return;
+    }
+
+    unsigned long long countSoFar = 0;
+    for (int bucketIndex = 0; bucketIndex < _NUM_BUCKETS; bucketIndex++)
+    {
+        if (_counts[bucketIndex] == 0)
+        {
+            continue;
+        }
+
+        countSoFar += _counts[bucketIndex];
+        printf("    <= %10.4fms %8u  %7.3f%%\n",
+            1.0e-6 * (double)BucketHighestNanoseconds(bucketIndex), _counts[bucketIndex],
+            100.0 * (double)countSoFar / (double)_numSamples);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Cleans up Record(...).  Times below the first doubling have a bucket each.  After that,
+    the highest bit says which doubling a time is in and the next few bits below it say
+    which bucket of that doubling.
+Parameters:
+    nanoseconds     Self-explanatory.
+Returns:
+    An index into the counts.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int FrameTimeHistogram::BucketIndex(unsigned long long nanoseconds)
+{
+    const unsigned long long largestValue = (1ULL << _MAX_VALUE_BITS) - 1;
+    nanoseconds = (nanoseconds < largestValue) ? nanoseconds : largestValue;
+    if (nanoseconds < _NUM_LINEAR_BUCKETS)
+    {
+        return (int)nanoseconds;
+    }
+
+    int highestBit = 0;
+    while ((nanoseconds >> (highestBit + 1)) != 0)
+    {
+        highestBit++;
+    }
+
+    // keep the highest bit and the next (_SUB_BUCKET_BITS - 1) below it
+    int shift = highestBit - (_SUB_BUCKET_BITS - 1);
+    int subBucket = (int)(nanoseconds >> shift) - _NUM_BUCKETS_PER_DOUBLING;
+    return _NUM_LINEAR_BUCKETS + ((shift - 1) * _NUM_BUCKETS_PER_DOUBLING) + subBucket;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Undoes BucketIndex(...) as far as it can be undone.
+Parameters:
+    bucketIndex     Self-explanatory.
+Returns:
+    The largest time that goes in the bucket.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned long long FrameTimeHistogram::BucketHighestNanoseconds(int bucketIndex)
+{
+    if (bucketIndex < _NUM_LINEAR_BUCKETS)
+    {
+        return (unsigned long long)bucketIndex;
+    }
+
+    int indexPastLinear = bucketIndex - _NUM_LINEAR_BUCKETS;
+    int shift = (indexPastLinear / _NUM_BUCKETS_PER_DOUBLING) + 1;
+    unsigned long long subBucket = (unsigned long long)(_NUM_BUCKETS_PER_DOUBLING +
+        (indexPastLinear % _NUM_BUCKETS_PER_DOUBLING));
+    return ((subBucket + 1) << shift) - 1;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Counts how long something took, every time that it happened, so that the slow times can
+    be told apart from the usual ones.  An average over a second hides a 50ms stall among 60
+    frames; the 99th percentile and the maximum don't.
+
+    The buckets are laid out the way that HDR histograms lay them out: times are kept in
+    nanoseconds, everything below 64ns has a bucket of its own, and every doubling after
+    that is split into 32 buckets of the same width.  That is about 3% precision at any
+    size, from nanoseconds up to a minute, in a fixed ~4KB array, so recording is a few
+    shifts and an increment and never allocates.  Percentiles are read back as the top of
+    the bucket that they fall in.  The maximum is kept exactly.
+
+    Note: Not thread safe.  Each histogram should only be recorded into from one thread.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class FrameTimeHistogram
+{
+public:
+    FrameTimeHistogram();
+
+    void Record(double sec);
+    void Reset();
+
+    unsigned long long NumSamples() const;
+    double PercentileSec(double percentile) const;
+    double MeanSec() const;
+    double MaxSec() const;
+
+    // one summary line, and with the buckets, one line per bucket that has anything in it
+    void Print(const char *name, bool withBuckets) const;
+
+private:
+    static int BucketIndex(unsigned long long nanoseconds);
+    static unsigned long long BucketHighestNanoseconds(int bucketIndex);
+
+    // 2^this buckets below the first doubling, and half that many per doubling after it
+    static const int _SUB_BUCKET_BITS = 6;
+    static const int _NUM_LINEAR_BUCKETS = 1 << _SUB_BUCKET_BITS;
+    static const int _NUM_BUCKETS_PER_DOUBLING = _NUM_LINEAR_BUCKETS / 2;
+
+    // 2^36ns is a little more than a minute; anything longer goes in the last bucket
+    static const int _MAX_VALUE_BITS = 36;
+    static const int _NUM_BUCKETS = _NUM_LINEAR_BUCKETS +
+        ((_MAX_VALUE_BITS - _SUB_BUCKET_BITS) * _NUM_BUCKETS_PER_DOUBLING);
+
+    std::vector<unsigned int> _counts;
+    unsigned long long _numSamples;
+    unsigned long long _maxNanoseconds;
+    double _totalSec;
+};
@@ -15,5 +15,9 @@ public:
     virtual ~IParticleEmitter() {}
     virtual void ResetParticle(Particle *resetThis) const = 0;
     virtual void SetTransform(const glm::mat4 &m) = 0;
+
+    // particles that this emitter sends out are of this species (see ParticlePropertyStorage)
+    virtual void SetSpecies(unsigned char speciesId) = 0;
+    virtual unsigned char GetSpecies() const = 0;
 };
 
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "glm/vec2.hpp"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The force field grid must be able to add up any number of external force fields without 
+    knowing what they are, so use an interface that defines the basic functionality of each 
+    field.  The fields are only evaluated when the grid is baked, not per particle, so they 
+    can be as expensive as they like.
+
+    Every field has a version number that goes up whenever one of its parameters changes.  The 
+    grid remembers the version of each field that it baked and bakes again when one differs.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class IParticleForceField
+{
+public:
+    virtual ~IParticleForceField() {}
+    virtual glm::vec2 ForceAt(const glm::vec2 &position) const = 0;
+    virtual unsigned int Version() const = 0;
+};
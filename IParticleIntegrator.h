@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+#include "Particle.h"
+#include "ParticleProperties.h"
+
+class ParticleTaskScheduler;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Integrators that need more than one force evaluation per step (velocity Verlet, RK4) must 
+    be able to ask for forces at intermediate states without knowing how they are calculated, 
+    so use an interface for it.  ParticleSimulation implements it with the spatial tree and the 
+    collision engine.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class IParticleForceEvaluator
+{
+public:
+    virtual ~IParticleForceEvaluator() {}
+
+    // sets the net force on every active particle for the particles' current positions and 
+    // velocities
+    virtual void EvaluateForces(std::vector<Particle> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties, float deltaTimeSec) = 0;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The simulation must be able to swap integration schemes without much trouble, so use an 
+    interface that defines the one thing an integrator does: advance every awake, active 
+    particle by delta time.
+
+    Every integrator keeps the same promise: on the way in and on the way out, each particle's 
+    net force is the force for its current position and velocity.  That way the last force 
+    evaluation of one step is the first one of the next, and an integrator never has to 
+    evaluate forces before it moves anything.
+
+    Sleeping particles are not moved.  Inactive particles are ignored.
+
+    A scheme that ends with a force evaluation can also stop just short of it, so that the 
+    caller can run that evaluation itself, in pieces (see 
+    ParticleSimulation::IntegrateStep(...)).  A scheme that ends with anything else says so 
+    and does nothing.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class IParticleIntegrator
+{
+public:
+    virtual ~IParticleIntegrator() {}
+    virtual void Integrate(IParticleForceEvaluator &forceEvaluator, 
+        std::vector<Particle> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties, float deltaTimeSec) = 0;
+
+    // returns false, and moves nothing, if the scheme doesn't end with a force evaluation; 
+    // otherwise the caller must evaluate the forces with the given delta time afterwards
+    virtual bool IntegrateExceptLastEvaluation(IParticleForceEvaluator & /*forceEvaluator*/, 
+        std::vector<Particle> & /*particleCollection*/, 
+        const ParticlePropertyStorage & /*particleProperties*/, float /*deltaTimeSec*/, 
+        float * /*putLastEvaluationSecHere*/)
+    {
+        return false;
+    }
+
+    // schemes that split their loops over the particles into chunks run them on this pool; 
+    // 0 runs them on the calling thread
+    virtual void SetScheduler(ParticleTaskScheduler * /*pScheduler*/) {}
+};
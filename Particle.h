@@ -1,6 +1,30 @@
 #pragma once
 
 #include "glm/vec2.hpp"
+#include "glm/vec3.hpp"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Compile-time description of the space that the particles live in.  The particle structure,
+    the spatial tree, and the collision code are all templated on the number of dimensions and
+    pull their vector type from here.  Only 2D and 3D are specialized, so anything else is a
+    compile error.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+struct ParticleDimension;
+
+template<>
+struct ParticleDimension<2>
+{
+    typedef glm::vec2 vec_type;
+};
+
+template<>
+struct ParticleDimension<3>
+{
+    typedef glm::vec3 vec_type;
+};
 
 /*-----------------------------------------------------------------------------------------------
 Description:
@@ -8,38 +32,53 @@ Description:
     has gone out of bounds ("is active" flag).  That flag also serves to prevent all particles
     from going out all at once upon creation by letting the "particle updater" regulate how many
     are emitted every frame.
+
+    The structure is templated on the number of dimensions.  The 2D version is uploaded
+    straight to the GPU (see ParticleStorage), so don't reorder the members without also
+    changing the vertex attributes.
 Creator:    John Cox (7-2-2016)
 -----------------------------------------------------------------------------------------------*/
-struct Particle
+template<int DIM>
+struct GenericParticle
 {
-    Particle() :
+    typedef typename ParticleDimension<DIM>::vec_type vec_type;
+
+    GenericParticle() :
         // glm structures already have "set to 0" constructors
         _collisionCountThisFrame(0),
-        _mass(0.1f),
-        _radiusOfInfluence(0.01f),
         _currentQuadTreeIndex(0),
-        _isActive(0)
+        _isActive(0),
+        _framesAtRest(0),
+        _isAsleep(0)
     {
     }
 
-    glm::vec2 _position;
-    glm::vec2 _velocity;
-    glm::vec2 _netForce;
+    vec_type _position;
+    vec_type _velocity;
+    vec_type _netForce;
 
     int _collisionCountThisFrame;
 
-    // all particles are identical for now
-    float _mass;
-
-    // used for collision detection because a particle's position is float values, so two 
-    // particles' positions are almost never going to be exactly equal
-    float _radiusOfInfluence;
+    // Note: Mass and radius of influence are in ParticleProperties.  They are read far less 
+    // often than these members, and when every particle is identical they aren't read at all.
 
     // TODO: get rid of this
     int _currentQuadTreeIndex;
 
-    // Note: Booleans cannot be uploaded to the shader 
-    // (https://www.opengl.org/sdk/docs/man/html/glVertexAttribPointer.xhtml), so send the 
-    // "is active" flag as an integer.  It is understood 
+    // Note: Booleans cannot be uploaded to the shader
+    // (https://www.opengl.org/sdk/docs/man/html/glVertexAttribPointer.xhtml), so send the
+    // "is active" flag as an integer.  It is understood
     int _isActive;
-};
\ No newline at end of file
+
+    // Sleeping: A particle that has been nearly still for long enough, and whose neighbors have 
+    // been too, is put to sleep.  Sleeping particles are not integrated and pairs of them are 
+    // not collided.  Any collision that pushes on a sleeping particle wakes it on the next 
+    // update (see ParticleUpdater and ParticleCollisionKernel).
+    // Note: Integers for the same reason as "is active".
+    int _framesAtRest;
+    int _isAsleep;
+};
+
+// the rest of the program (emitters, storage, updater, rendering) is 2D
+typedef GenericParticle<2> Particle;
+typedef GenericParticle<3> Particle3D;
@@ -0,0 +1,568 @@
+#include "ParticleBroadphase.h"
+
+#include "ParticleCollisionKernel.h"
+#include "ParticleTaskScheduler.h"
+#include "ParticleStats.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Ensures that the object starts object with initialized values.  The scratch space is
+    allocated by the first pass.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+ParticleBroadphase<DIM>::ParticleBroadphase() :
+    _type(BROADPHASE_TREE),
+    _searchDistanceSqr(0.0f),
+    _pScheduler(0),
+    _pJoinCounter(0),
+    _pStats(0),
+    _numGridCells(0)
+{
+    for (int axis = 0; axis < DIM; axis++)
+    {
+        _numCellsPerAxis[axis] = 0;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple setter.  The collision engine uses the tree for BROADPHASE_TREE and this object
+    for anything else.
+Parameters:
+    type    Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+void ParticleBroadphase<DIM>::SetType(BroadphaseType type)
+{
+    _type = type;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    Which broadphase the collision engine is using.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+BroadphaseType ParticleBroadphase<DIM>::Type() const
+{
+    return _type;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs the particle-particle collisions with whichever broadphase is in use.  Does nothing
+    for the tree, which the collision engine runs itself.
+
+    Both broadphases work from the particles' current positions, so unlike the tree, they
+    don't need any search padding.
+Parameters:
+    kernel              Collides a single pair.
+    particleCollection  Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+template<typename KERNEL>
+void ParticleBroadphase<DIM>::DoTheParticleParticleCollisions(const KERNEL &kernel,
+    std::vector<particle_type> &particleCollection)
+{
+    if (_type == BROADPHASE_BRUTE_FORCE)
+    {
+        BruteForceCollisions(kernel, particleCollection);
+    }
+    else if (_type == BROADPHASE_UNIFORM_GRID)
+    {
+        UniformGridCollisions(kernel, particleCollection);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.
+Parameters:
+    pScheduler  The pool to find brute force's pairs on.  0 to find them on the calling 
+                thread.  Must outlive its use.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+void ParticleBroadphase<DIM>::SetScheduler(ParticleTaskScheduler *pScheduler)
+{
+    _pScheduler = pScheduler;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.
+Parameters:
+    pStats  The brute force and grid passes add what they counted to this.  0 doesn't count.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+void ParticleBroadphase<DIM>::SetStats(ParticleStats *pStats)
+{
+    _pStats = pStats;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many cells the uniform grid had the last time that it ran.  0 if it hasn't.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+int ParticleBroadphase<DIM>::NumGridCellsLastPass() const
+{
+    return _numGridCells;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Makes a list of the active particles and copies their positions into one array per axis.
+Parameters:
+    particleCollection  Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+void ParticleBroadphase<DIM>::GatherActiveParticles(
+    const std::vector<particle_type> &particleCollection)
+{
+    _activeIndices.clear();
+    for (int axis = 0; axis < DIM; axis++)
+    {
+        _coordinates[axis].clear();
+    }
+
+    for (size_t particleIndex = 0; particleIndex < particleCollection.size(); particleIndex++)
+    {
+        const particle_type &p = particleCollection[particleIndex];
+        if (p._isActive == 0)
+        {
+            continue;
+        }
+
+        _activeIndices.push_back((int)particleIndex);
+        for (int axis = 0; axis < DIM; axis++)
+        {
+            _coordinates[axis].push_back(p._position[axis]);
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Checks every pair of active particles.  The pairs that are within the search distance are 
+    found one row of tiles at a time (see FindPairsInTileRow(...)), on the pool if there is 
+    one, and then handed to the kernel row by row.  Either way, the kernel sees the pairs in 
+    the same order.
+Parameters:
+    kernel              Collides a single pair.
+    particleCollection  Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+template<typename KERNEL>
+void ParticleBroadphase<DIM>::BruteForceCollisions(const KERNEL &kernel,
+    std::vector<particle_type> &particleCollection)
+{
+    GatherActiveParticles(particleCollection);
+    float searchDistance = kernel.NeighborSearchDistance();
+    _searchDistanceSqr = searchDistance * searchDistance;
+
+    int numActive = (int)_activeIndices.size();
+    int numTileRows = (numActive + _TILE_SIZE - 1) / _TILE_SIZE;
+    if (numTileRows > (int)_tileRowPairs.size())
+    {
+        _tileRowPairs.resize(numTileRows);
+    }
+
+    bool isForked = (_pScheduler != 0) && (_pScheduler->NumWorkerThreads() > 0);
+    if (isForked)
+    {
+        std::atomic<int> joinCounter(0);
+        _pJoinCounter = &joinCounter;
+        _pScheduler->Spawn(joinCounter, &FindPairsJob, this, 0, numTileRows);
+        _pScheduler->Wait(joinCounter);
+        _pJoinCounter = 0;
+    }
+
+    ParticleCollisionCounters counters;
+    for (int tileRowIndex = 0; tileRowIndex < numTileRows; tileRowIndex++)
+    {
+        if (!isForked)
+        {
+            FindPairsInTileRow(tileRowIndex);
+        }
+
+        const std::vector<int> &pairs = _tileRowPairs[tileRowIndex];
+        counters._numPairTests += pairs.size() / 2;
+        for (size_t pairCount = 0; pairCount < pairs.size(); pairCount += 2)
+        {
+            if (kernel.CollideP1WithP2(_activeIndices[pairs[pairCount]], 
+                _activeIndices[pairs[pairCount + 1]], particleCollection))
+            {
+                counters._numPairsCollided++;
+            }
+        }
+    }
+
+    if (_pStats != 0)
+    {
+        _pStats->AddCounters(counters);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Finds the pairs within the search distance between one row of tiles and every tile from 
+    it on, one pair of tiles at a time.  For each particle in the row's tile, the squared 
+    distances to the particles in the other tile are worked out first, with nothing but 
+    arithmetic in the loop, and then the ones within the search distance are listed.  A tile 
+    paired with itself only checks the pairs after the particle, the same as the tree does 
+    within a node.
+
+    Only reads the gathered positions and only writes the row's own list, so any number of 
+    rows can be searched at the same time.
+Parameters:
+    tileRowIndex    The first tile of the row is (tileRowIndex * _TILE_SIZE).
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+void ParticleBroadphase<DIM>::FindPairsInTileRow(int tileRowIndex)
+{
+    std::vector<int> &pairs = _tileRowPairs[tileRowIndex];
+    pairs.clear();
+
+    // Note: On the stack so that rows on different threads don't share it.
+    float distancesSqr[_TILE_SIZE];
+
+    int numActive = (int)_activeIndices.size();
+    int tile1Start = tileRowIndex * _TILE_SIZE;
+    int tile1End = (tile1Start + _TILE_SIZE < numActive) ? tile1Start + _TILE_SIZE : numActive;
+    for (int tile2Start = tile1Start; tile2Start < numActive; tile2Start += _TILE_SIZE)
+    {
+        int tile2End = (tile2Start + _TILE_SIZE < numActive) ?
+            tile2Start + _TILE_SIZE : numActive;
+        for (int active1 = tile1Start; active1 < tile1End; active1++)
+        {
+            int rowStart = (active1 + 1 > tile2Start) ? active1 + 1 : tile2Start;
+            int rowLength = tile2End - rowStart;
+            if (rowLength <= 0)
+            {
+                continue;
+            }
+
+            // the distances to the whole row first
+            // Note: Axis by axis so that the inner loop runs straight through each 
+            // coordinate array.
+            for (int rowCount = 0; rowCount < rowLength; rowCount++)
+            {
+                distancesSqr[rowCount] = 0.0f;
+            }
+            for (int axis = 0; axis < DIM; axis++)
+            {
+                const float *rowCoordinates = &_coordinates[axis][rowStart];
+                float p1Coordinate = _coordinates[axis][active1];
+                for (int rowCount = 0; rowCount < rowLength; rowCount++)
+                {
+                    float diff = rowCoordinates[rowCount] - p1Coordinate;
+                    distancesSqr[rowCount] += diff * diff;
+                }
+            }
+
+            // then the pairs that are close enough
+            for (int rowCount = 0; rowCount < rowLength; rowCount++)
+            {
+                if (distancesSqr[rowCount] < _searchDistanceSqr)
+                {
+                    pairs.push_back(active1);
+                    pairs.push_back(rowStart + rowCount);
+                }
+            }
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    One forked job of brute force's pair search.  Splits its range of tile rows in half, 
+    spawning the back half, until it is down to a single row, then searches that.
+Parameters:
+    context     The broadphase.
+    begin, end  The range of tile rows.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+void ParticleBroadphase<DIM>::FindPairsJob(void *context, int begin, int end)
+{
+    ParticleBroadphase<DIM> *pBroadphase = (ParticleBroadphase<DIM> *)context;
+    while (end - begin > 1)
+    {
+        int middle = begin + (end - begin) / 2;
+        pBroadphase->_pScheduler->Spawn(*pBroadphase->_pJoinCounter, &FindPairsJob, context, 
+            middle, end);
+        end = middle;
+    }
+
+    if (begin < end)
+    {
+        pBroadphase->FindPairsInTileRow(begin);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Counting-sorts the active particles into cells that are at least the search distance wide
+    across the active particles' bounding box, then checks every cell against itself and
+    against the neighbors that come after it in the stencil (see SpatialTreeStencil).  A pair
+    in range of each other is either in the same cell or in neighboring cells, and each pair
+    of neighboring cells is only checked from one side.
+Parameters:
+    kernel              Collides a single pair.
+    particleCollection  Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+template<typename KERNEL>
+void ParticleBroadphase<DIM>::UniformGridCollisions(const KERNEL &kernel,
+    std::vector<particle_type> &particleCollection)
+{
+    typedef SpatialTreeStencil<DIM> stencil_type;
+
+    GatherActiveParticles(particleCollection);
+    int numActive = (int)_activeIndices.size();
+    _numGridCells = 0;
+    if (numActive < 2)
+    {
+        return;
+    }
+
+    float searchDistance = kernel.NeighborSearchDistance();
+    float searchDistanceSqr = searchDistance * searchDistance;
+
+    float boundsMin[DIM];
+    float boundsMax[DIM];
+    for (int axis = 0; axis < DIM; axis++)
+    {
+        boundsMin[axis] = _coordinates[axis][0];
+        boundsMax[axis] = _coordinates[axis][0];
+        for (int activeCount = 1; activeCount < numActive; activeCount++)
+        {
+            float coordinate = _coordinates[axis][activeCount];
+            boundsMin[axis] = (coordinate < boundsMin[axis]) ? coordinate : boundsMin[axis];
+            boundsMax[axis] = (coordinate > boundsMax[axis]) ? coordinate : boundsMax[axis];
+        }
+    }
+
+    // cells as small as the search distance allows, unless that is too many
+    // Note: The cell count is worked out in double so that a tiny search distance over a big
+    // region doesn't overflow before it is caught.
+    double maxCells = (double)numActive * _MAX_CELLS_PER_PARTICLE;
+    float cellSize = (searchDistance > 0.0f) ? searchDistance : 1.0f;
+    while (true)
+    {
+        double numCells = 1.0;
+        for (int axis = 0; axis < DIM; axis++)
+        {
+            numCells *= (double)((int)((boundsMax[axis] - boundsMin[axis]) / cellSize) + 1);
+        }
+        if (numCells <= maxCells)
+        {
+            break;
+        }
+        cellSize *= 2.0f;
+    }
+
+    float inverseCellSize = 1.0f / cellSize;
+    _numGridCells = 1;
+    for (int axis = 0; axis < DIM; axis++)
+    {
+        _numCellsPerAxis[axis] = (int)((boundsMax[axis] - boundsMin[axis]) * inverseCellSize) + 1;
+        _numGridCells *= _numCellsPerAxis[axis];
+    }
+
+    // counting sort
+    // Note: Same linear cell index as the tree's starting grid, with the X axis changing
+    // fastest.
+    _cellOfParticle.resize(numActive);
+    _cellStarts.assign(_numGridCells + 1, 0);
+    for (int activeCount = 0; activeCount < numActive; activeCount++)
+    {
+        int cellIndex = 0;
+        int axisStride = 1;
+        for (int axis = 0; axis < DIM; axis++)
+        {
+            int cell = (int)((_coordinates[axis][activeCount] - boundsMin[axis]) * inverseCellSize);
+            cell = (cell >= _numCellsPerAxis[axis]) ? _numCellsPerAxis[axis] - 1 : cell;
+            cellIndex += cell * axisStride;
+            axisStride *= _numCellsPerAxis[axis];
+        }
+        _cellOfParticle[activeCount] = cellIndex;
+        _cellStarts[cellIndex + 1]++;
+    }
+    for (int cellIndex = 0; cellIndex < _numGridCells; cellIndex++)
+    {
+        _cellStarts[cellIndex + 1] += _cellStarts[cellIndex];
+    }
+
+    // Note: The cell starts are used as insertion points and then put back by shifting them.
+    _sortedIndices.resize(numActive);
+    for (int axis = 0; axis < DIM; axis++)
+    {
+        _sortedCoordinates[axis].resize(numActive);
+    }
+    for (int activeCount = 0; activeCount < numActive; activeCount++)
+    {
+        int sortedIndex = _cellStarts[_cellOfParticle[activeCount]]++;
+        _sortedIndices[sortedIndex] = _activeIndices[activeCount];
+        for (int axis = 0; axis < DIM; axis++)
+        {
+            _sortedCoordinates[axis][sortedIndex] = _coordinates[axis][activeCount];
+        }
+    }
+    for (int cellIndex = _numGridCells; cellIndex > 0; cellIndex--)
+    {
+        _cellStarts[cellIndex] = _cellStarts[cellIndex - 1];
+    }
+    _cellStarts[0] = 0;
+
+    // every cell with itself and with the neighbors after it
+    // Note: Stencil cells past the center are the "after" half, since the stencil's index
+    // has the same axis order as the cells'.
+    ParticleCollisionCounters counters;
+    for (int cellIndex = 0; cellIndex < _numGridCells; cellIndex++)
+    {
+        if (_cellStarts[cellIndex] == _cellStarts[cellIndex + 1])
+        {
+            continue;
+        }
+
+        CollideCellWithCell(cellIndex, cellIndex, searchDistanceSqr, kernel, particleCollection, 
+            counters);
+
+        int cell[DIM];
+        int remainder = cellIndex;
+        for (int axis = 0; axis < DIM; axis++)
+        {
+            cell[axis] = remainder % _numCellsPerAxis[axis];
+            remainder /= _numCellsPerAxis[axis];
+        }
+
+        for (int neighborIndex = stencil_type::CENTER_STENCIL_CELL;
+            neighborIndex < stencil_type::NUM_NEIGHBORS; neighborIndex++)
+        {
+            int neighborCellIndex = 0;
+            int axisStride = 1;
+            bool isInGrid = true;
+            for (int axis = 0; axis < DIM; axis++)
+            {
+                int neighborCell = cell[axis] + stencil_type::NeighborOffset(neighborIndex, axis);
+                isInGrid = isInGrid && (neighborCell >= 0) &&
+                    (neighborCell < _numCellsPerAxis[axis]);
+                neighborCellIndex += neighborCell * axisStride;
+                axisStride *= _numCellsPerAxis[axis];
+            }
+
+            if (isInGrid)
+            {
+                counters._numNeighborNodeVisits++;
+                CollideCellWithCell(cellIndex, neighborCellIndex, searchDistanceSqr, kernel,
+                    particleCollection, counters);
+            }
+        }
+    }
+
+    if (_pStats != 0)
+    {
+        _pStats->AddCounters(counters);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Checks the particles of one cell against another's.  A cell checked against itself only
+    checks the pairs after each particle.
+Parameters:
+    cell1Index, cell2Index  Self-explanatory.  May be the same.
+    searchDistanceSqr       Pairs further apart than this aren't handed to the kernel.
+    kernel                  Collides a single pair.
+    particleCollection      Self-explanatory.
+    counters                The pass's statistics.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+template<typename KERNEL>
+void ParticleBroadphase<DIM>::CollideCellWithCell(int cell1Index, int cell2Index,
+    float searchDistanceSqr, const KERNEL &kernel,
+    std::vector<particle_type> &particleCollection, ParticleCollisionCounters &counters)
+{
+    int cell2End = _cellStarts[cell2Index + 1];
+    for (int sorted1 = _cellStarts[cell1Index]; sorted1 < _cellStarts[cell1Index + 1]; sorted1++)
+    {
+        int cell2Start = (cell1Index == cell2Index) ? sorted1 + 1 : _cellStarts[cell2Index];
+        for (int sorted2 = cell2Start; sorted2 < cell2End; sorted2++)
+        {
+            float distanceSqr = 0.0f;
+            for (int axis = 0; axis < DIM; axis++)
+            {
+                float diff = _sortedCoordinates[axis][sorted2] - _sortedCoordinates[axis][sorted1];
+                distanceSqr += diff * diff;
+            }
+
+            if (distanceSqr < searchDistanceSqr)
+            {
+                counters._numPairTests++;
+                if (kernel.CollideP1WithP2(_sortedIndices[sorted1], _sortedIndices[sorted2],
+                    particleCollection))
+                {
+                    counters._numPairsCollided++;
+                }
+            }
+        }
+    }
+}
+
+// the only two spaces that this program deals with
+template class ParticleBroadphase<2>;
+template class ParticleBroadphase<3>;
+
+// one collision pass per pre-instantiated collision engine and property access
+#define INSTANTIATE_BROADPHASE_COLLISIONS(DIM, RESPONSE) \
+    template void ParticleBroadphase<DIM>::DoTheParticleParticleCollisions( \
+        const ParticleCollisionKernel<DIM, RESPONSE, UniformParticlePropertyAccess> &kernel, \
+        std::vector<GenericParticle<DIM> > &particleCollection); \
+    template void ParticleBroadphase<DIM>::DoTheParticleParticleCollisions( \
+        const ParticleCollisionKernel<DIM, RESPONSE, SpeciesParticlePropertyAccess> &kernel, \
+        std::vector<GenericParticle<DIM> > &particleCollection);
+FOR_EACH_COLLISION_RESPONSE(INSTANTIATE_BROADPHASE_COLLISIONS, 2)
+FOR_EACH_COLLISION_RESPONSE(INSTANTIATE_BROADPHASE_COLLISIONS, 3)
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include "Particle.h"
+#include "ParticleQuadTreeNode.h"
+
+class ParticleTaskScheduler;
+class ParticleStats;
+struct ParticleCollisionCounters;
+
+// the ways that the collision engine can find the pairs that are close enough to check
+enum BroadphaseType
+{
+    BROADPHASE_BRUTE_FORCE = 0,
+    BROADPHASE_UNIFORM_GRID,
+    BROADPHASE_TREE,
+    NUM_BROADPHASE_TYPES
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The collision passes that don't use the spatial tree.  Which one is best depends mostly
+    on how many particles there are (see ParticleBroadphaseSelector), so the collision engine
+    asks this which one is in use and, unless it is the tree, hands it the kernel instead.
+
+    Brute force checks every pair of active particles.  The active particles' positions are
+    gathered into one array per axis, and the pairs are walked in square tiles so that one
+    tile's positions stay in the cache while every particle of the other tile is checked
+    against them.  The distances to a whole row of a tile are worked out in a loop with no
+    branches in it, which the compiler vectorizes, and only the pairs within the search
+    distance go to the kernel.  For a few hundred particles, that beats building anything.
+
+    Optionally, brute force finds its pairs on a work-stealing pool, one row of tiles per job, 
+    and then hands them to the kernel on the calling thread in the same order that it would 
+    have on its own, so the results are the same to the last bit.  Finding the pairs is 
+    nearly all of the work, so that is what makes brute force usable for tens of thousands of 
+    particles (see ParticleCollisionValidator).
+
+    The uniform grid sorts the active particles into cells that are the search distance wide,
+    so that a particle only has to check its own cell and the cells right next to it.  Each
+    cell checks itself and only the half of its neighbors that come after it, so every pair
+    of cells is only checked once.  It is built from the particles' current positions on
+    every pass, so it is never stale.  It does well when particles are spread out evenly, but
+    where they bunch up, a cell holds lots of them and every one of them checks all the
+    rest.  If the active particles are spread over a region that would need too many cells,
+    the cells are made bigger.
+
+    Note: Both are built on every pass from scratch space that is allocated by the first one
+    and reused after that, so they are not thread safe.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+class ParticleBroadphase
+{
+public:
+    typedef GenericParticle<DIM> particle_type;
+    typedef typename ParticleDimension<DIM>::vec_type vec_type;
+
+    ParticleBroadphase();
+
+    // the tree until changed
+    void SetType(BroadphaseType type);
+    BroadphaseType Type() const;
+
+    // KERNEL is a ParticleCollisionKernel<DIM, ...>; only for the brute force and grid types
+    template<typename KERNEL>
+    void DoTheParticleParticleCollisions(const KERNEL &kernel,
+        std::vector<particle_type> &particleCollection);
+
+    // 0 finds the brute force's pairs on the calling thread
+    void SetScheduler(ParticleTaskScheduler *pScheduler);
+
+    // 0 doesn't count (see ParticleStats)
+    void SetStats(ParticleStats *pStats);
+
+    int NumGridCellsLastPass() const;
+
+private:
+    void GatherActiveParticles(const std::vector<particle_type> &particleCollection);
+    void FindPairsInTileRow(int tileRowIndex);
+    static void FindPairsJob(void *context, int begin, int end);
+
+    template<typename KERNEL>
+    void BruteForceCollisions(const KERNEL &kernel,
+        std::vector<particle_type> &particleCollection);
+    template<typename KERNEL>
+    void UniformGridCollisions(const KERNEL &kernel,
+        std::vector<particle_type> &particleCollection);
+    template<typename KERNEL>
+    void CollideCellWithCell(int cell1Index, int cell2Index, float searchDistanceSqr,
+        const KERNEL &kernel, std::vector<particle_type> &particleCollection,
+        ParticleCollisionCounters &counters);
+
+    BroadphaseType _type;
+
+    // the active particles in the order that they are checked in, with their positions one
+    // array per axis
+    std::vector<int> _activeIndices;
+    std::vector<float> _coordinates[DIM];
+
+    // the brute force's pairs are walked in tiles of this many particles on a side
+    // Note: Each row of tiles gets its own list of pairs (indices into the active particles, 
+    // two per pair) so that the rows can be searched at the same time.
+    static const int _TILE_SIZE = 64;
+    std::vector<std::vector<int> > _tileRowPairs;
+    float _searchDistanceSqr;
+
+    // 0 unless the pairs are found on a pool; the counter is only set during the search
+    ParticleTaskScheduler *_pScheduler;
+    std::atomic<int> *_pJoinCounter;
+
+    // 0 unless the passes are counted
+    ParticleStats *_pStats;
+
+    // the grid's cells; _cellStarts[cell] is where the cell's particles start in the sorted
+    // arrays and _cellStarts[cell + 1] is where they end
+    std::vector<int> _cellOfParticle;
+    std::vector<int> _cellStarts;
+    std::vector<int> _sortedIndices;
+    std::vector<float> _sortedCoordinates[DIM];
+    int _numCellsPerAxis[DIM];
+    int _numGridCells;
+
+    // the grid never has more cells than this many per active particle
+    static const int _MAX_CELLS_PER_PARTICLE = 4;
+};
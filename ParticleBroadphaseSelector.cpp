@@ -0,0 +1,237 @@
+#include "ParticleBroadphaseSelector.h"
+
+#include <math.h>
+
+const float ParticleBroadphaseSelector::_COST_SMOOTHING = 0.2f;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Ensures that the object starts object with initialized values.  Nothing has been measured
+    yet, so the tree is the cheapest until something else is.
+Parameters:
+    stepsBetweenSamples     How often a broadphase that isn't in use is measured.
+    maxSampleCostRatio      One that is predicted to cost more than this many times the
+                            cheapest isn't sampled.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleBroadphaseSelector::ParticleBroadphaseSelector(int stepsBetweenSamples,
+    float maxSampleCostRatio) :
+    _stepsBetweenSamples((stepsBetweenSamples < 1) ? 1 : stepsBetweenSamples),
+    _maxSampleCostRatio(maxSampleCostRatio),
+    _stepCount(0),
+    _stepsUntilNextSample(0),
+    _lastType(BROADPHASE_TREE),
+    _numSwitches(0)
+{
+    _stepsUntilNextSample = _stepsBetweenSamples;
+    for (int typeIndex = 0; typeIndex < NUM_BROADPHASE_TYPES; typeIndex++)
+    {
+        _secPerWork[typeIndex] = 0.0;
+        _numSamples[typeIndex] = 0;
+        _stepOfLastSample[typeIndex] = 0;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Picks the broadphase for the next step.  Usually that is the one that is predicted to be
+    cheapest, but it may be one that is due to be sampled instead.
+Parameters:
+    numActiveParticles  Self-explanatory.  The last step's count is close enough.
+Returns:
+    The broadphase to use.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+BroadphaseType ParticleBroadphaseSelector::ChooseForStep(unsigned int numActiveParticles)
+{
+    _stepCount++;
+    BroadphaseType cheapestType = CheapestType(numActiveParticles);
+    if (cheapestType != _lastType)
+    {
+        _numSwitches++;
+        _lastType = cheapestType;
+    }
+
+    if (numActiveParticles < _MIN_MEASURED_PARTICLES)
+    {
+        return cheapestType;
+    }
+
+    // anything that hasn't been measured yet goes first
+    for (int typeIndex = 0; typeIndex < NUM_BROADPHASE_TYPES; typeIndex++)
+    {
+        BroadphaseType type = (BroadphaseType)typeIndex;
+        bool mayTry = (type != BROADPHASE_BRUTE_FORCE) ||
+            (numActiveParticles <= _MAX_UNMEASURED_BRUTE_FORCE_PARTICLES);
+        if (_numSamples[typeIndex] == 0 && mayTry)
+        {
+            return type;
+        }
+    }
+
+    _stepsUntilNextSample--;
+    if (_stepsUntilNextSample > 0)
+    {
+        return cheapestType;
+    }
+    _stepsUntilNextSample = _stepsBetweenSamples;
+
+    // the one that was measured longest ago, as long as it might be close
+    double maxSampleSec = _maxSampleCostRatio * PredictedSec(cheapestType, numActiveParticles);
+    int oldestIndex = -1;
+    for (int typeIndex = 0; typeIndex < NUM_BROADPHASE_TYPES; typeIndex++)
+    {
+        BroadphaseType type = (BroadphaseType)typeIndex;
+        if (type == cheapestType || _numSamples[typeIndex] == 0 ||
+            PredictedSec(type, numActiveParticles) > maxSampleSec)
+        {
+            continue;
+        }
+        if (oldestIndex < 0 || _stepOfLastSample[typeIndex] < _stepOfLastSample[oldestIndex])
+        {
+            oldestIndex = typeIndex;
+        }
+    }
+
+    return (oldestIndex < 0) ? cheapestType : (BroadphaseType)oldestIndex;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Adds a step's cost to the model of the broadphase that ran it.
+Parameters:
+    type                The broadphase that the step used.
+    collisionSec        How long the step's tree building and collisions took.
+    numActiveParticles  Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleBroadphaseSelector::RecordStep(BroadphaseType type, double collisionSec,
+    unsigned int numActiveParticles)
+{
+    if (numActiveParticles < _MIN_MEASURED_PARTICLES)
+    {
+        return;
+    }
+
+    double secPerWork = collisionSec / Work(type, numActiveParticles);
+    if (_numSamples[type] == 0)
+    {
+        _secPerWork[type] = secPerWork;
+    }
+    else
+    {
+        _secPerWork[type] += _COST_SMOOTHING * (secPerWork - _secPerWork[type]);
+    }
+    _numSamples[type]++;
+    _stepOfLastSample[type] = _stepCount;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Uses a broadphase's cost model to predict what a step would cost it.
+Parameters:
+    type                Self-explanatory.
+    numActiveParticles  Self-explanatory.
+Returns:
+    The predicted seconds, or 0 if it hasn't been measured yet.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+double ParticleBroadphaseSelector::PredictedSec(BroadphaseType type,
+    unsigned int numActiveParticles) const
+{
+    return _secPerWork[type] * Work(type, numActiveParticles);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Finds the broadphase that is predicted to be cheapest.
+Parameters:
+    numActiveParticles  Self-explanatory.
+Returns:
+    Of the ones that have been measured, the cheapest.  The tree if none have.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+BroadphaseType ParticleBroadphaseSelector::CheapestType(unsigned int numActiveParticles) const
+{
+    int cheapestIndex = -1;
+    double cheapestSec = 0.0;
+    for (int typeIndex = 0; typeIndex < NUM_BROADPHASE_TYPES; typeIndex++)
+    {
+        if (_numSamples[typeIndex] == 0)
+        {
+            continue;
+        }
+
+        double sec = PredictedSec((BroadphaseType)typeIndex, numActiveParticles);
+        if (cheapestIndex < 0 || sec < cheapestSec)
+        {
+            cheapestIndex = typeIndex;
+            cheapestSec = sec;
+        }
+    }
+
+    return (cheapestIndex < 0) ? BROADPHASE_TREE : (BroadphaseType)cheapestIndex;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters:
+    type    Self-explanatory.
+Returns:
+    How many steps have been measured with that broadphase.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleBroadphaseSelector::NumSamples(BroadphaseType type) const
+{
+    return _numSamples[type];
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many times the cheapest broadphase has changed.  Samples don't count.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleBroadphaseSelector::NumSwitches() const
+{
+    return _numSwitches;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    How a broadphase's work grows with the number of particles.  Only the shape matters, since
+    the cost model measures the constant in front of it.
+Parameters:
+    type                Self-explanatory.
+    numActiveParticles  Fewer than 2 are treated as 2, so the work is never 0.
+Returns:
+    Pairs for brute force, particles for the grid, and particles * log2(particles) for the
+    tree.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+double ParticleBroadphaseSelector::Work(BroadphaseType type, unsigned int numActiveParticles)
+{
+    double n = (numActiveParticles < 2) ? 2.0 : (double)numActiveParticles;
+    if (type == BROADPHASE_BRUTE_FORCE)
+    {
+        return 0.5 * n * (n - 1.0);
+    }
+    else if (type == BROADPHASE_UNIFORM_GRID)
+    {
+        return n;
+    }
+    return n * log(n) / log(2.0);
+}
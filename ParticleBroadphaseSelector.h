@@ -0,0 +1,67 @@
+#pragma once
+
+#include "ParticleBroadphase.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Picks the broadphase for each step from what each one has been measured to cost.  Brute
+    force wins for a few hundred particles, the uniform grid wins for a medium number of
+    evenly spread particles, and the tree wins for lots of particles, especially bunched up
+    ones.  The particle count goes from 0 to the maximum over a run, so no one choice is right
+    for all of it.
+
+    Each broadphase has a running cost model: its measured step cost divided by how its work
+    grows with the number of active particles (n^2 pairs for brute force, n for the grid, and
+    n log n for the tree), averaged over its recent steps.  That predicts what each would cost
+    at the current count, and each step uses the cheapest.
+
+    The ones that aren't in use only get measured when they are sampled.  One that has never
+    been measured is sampled as soon as there are enough particles to measure it with (brute
+    force only while there are few enough particles that one step of it can't take long).
+    After that, every so often, the one that was measured longest ago is sampled for a step,
+    unless it is predicted to cost so much more than the cheapest that it can't be close.
+
+    The measurement is whatever the simulation's collision time for the step was, so it
+    includes the tree's build when the tree is in use.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticleBroadphaseSelector
+{
+public:
+    ParticleBroadphaseSelector(int stepsBetweenSamples = 30, float maxSampleCostRatio = 4.0f);
+
+    // called before every step, and then after it with what it cost
+    BroadphaseType ChooseForStep(unsigned int numActiveParticles);
+    void RecordStep(BroadphaseType type, double collisionSec, unsigned int numActiveParticles);
+
+    // 0 if it hasn't been measured yet
+    double PredictedSec(BroadphaseType type, unsigned int numActiveParticles) const;
+
+    BroadphaseType CheapestType(unsigned int numActiveParticles) const;
+    int NumSamples(BroadphaseType type) const;
+    int NumSwitches() const;
+
+private:
+    static double Work(BroadphaseType type, unsigned int numActiveParticles);
+
+    int _stepsBetweenSamples;
+    float _maxSampleCostRatio;
+
+    // seconds per unit of work, averaged over recent steps
+    // Note: Each new step gets this much of the weight.
+    static const float _COST_SMOOTHING;
+    double _secPerWork[NUM_BROADPHASE_TYPES];
+    int _numSamples[NUM_BROADPHASE_TYPES];
+    int _stepOfLastSample[NUM_BROADPHASE_TYPES];
+
+    // brute force isn't tried before it has a model if there are more particles than this
+    static const unsigned int _MAX_UNMEASURED_BRUTE_FORCE_PARTICLES = 2048;
+
+    // fewer particles than this don't tell anything apart from the timer's noise
+    static const unsigned int _MIN_MEASURED_PARTICLES = 16;
+
+    int _stepCount;
+    int _stepsUntilNextSample;
+    BroadphaseType _lastType;
+    int _numSwitches;
+};
@@ -0,0 +1,171 @@
+#include "ParticleCollisionEngine.h"
+
+#include "ParticleCollisionKernel.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.
+Parameters: 
+    response    The interaction law and its parameters.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM, typename RESPONSE>
+ParticleCollisionEngine<DIM, RESPONSE>::ParticleCollisionEngine(const RESPONSE &response) :
+    _response(response),
+    _pScheduler(0),
+    _serialCutoff(0),
+    _pBroadphase(0)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs the particle-particle collisions on an already-built tree with this engine's 
+    interaction law.
+Parameters: 
+    tree                Must have had AddParticlestoTree(...) called on this particle 
+                        collection, unless the broadphase isn't the tree.
+    particleProperties  The species of every particle in the collection.
+    deltaTimeSec        Self-explanatory.
+    searchPadding       How far particles have moved since the tree was built.  0 if the tree 
+                        is fresh.
+    particleCollection  Self-explanatory.
+    pEvents             Optional.  Gets every pair that a force was applied to, from 
+                        whichever thread collided it.  The caller begins and ends the pass.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM, typename RESPONSE>
+void ParticleCollisionEngine<DIM, RESPONSE>::DoTheParticleParticleCollisions(
+    const ParticleSpatialTree<DIM> &tree, const ParticlePropertyStorage &particleProperties, 
+    float deltaTimeSec, float searchPadding, 
+    std::vector<GenericParticle<DIM> > &particleCollection, 
+    ParticleCollisionEventStream<DIM> *pEvents) const
+{
+    float range = _response.InteractionRangeInContactDistances();
+    if (particleProperties.IsUniform())
+    {
+        UniformParticlePropertyAccess properties(particleProperties, range);
+        ParticleCollisionKernel<DIM, RESPONSE, UniformParticlePropertyAccess> kernel(
+            _response, properties, deltaTimeSec, pEvents);
+        if (_pBroadphase != 0 && _pBroadphase->Type() != BROADPHASE_TREE)
+        {
+            _pBroadphase->DoTheParticleParticleCollisions(kernel, particleCollection);
+        }
+        else if (_pScheduler != 0)
+        {
+            tree.DoTheParticleParticleCollisionsForkJoin(kernel, particleCollection, 
+                *_pScheduler, _serialCutoff, searchPadding);
+        }
+        else
+        {
+            tree.DoTheParticleParticleCollisions(kernel, particleCollection, searchPadding);
+        }
+    }
+    else
+    {
+        SpeciesParticlePropertyAccess properties(particleProperties, range);
+        ParticleCollisionKernel<DIM, RESPONSE, SpeciesParticlePropertyAccess> kernel(
+            _response, properties, deltaTimeSec, pEvents);
+        if (_pBroadphase != 0 && _pBroadphase->Type() != BROADPHASE_TREE)
+        {
+            _pBroadphase->DoTheParticleParticleCollisions(kernel, particleCollection);
+        }
+        else if (_pScheduler != 0)
+        {
+            tree.DoTheParticleParticleCollisionsForkJoin(kernel, particleCollection, 
+                *_pScheduler, _serialCutoff, searchPadding);
+        }
+        else
+        {
+            tree.DoTheParticleParticleCollisions(kernel, particleCollection, searchPadding);
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.  Passes along the response's range.
+Parameters: None
+Returns:    
+    How far apart, in contact distances, a pair can be and still interact.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM, typename RESPONSE>
+float ParticleCollisionEngine<DIM, RESPONSE>::InteractionRangeInContactDistances() const
+{
+    return _response.InteractionRangeInContactDistances();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Forks the tree traversal out on a pool from the next pass on.
+Parameters: 
+    pScheduler      0 to go back to running on the calling thread.  Must outlive its use.
+    serialCutoff    Subtrees with this many particles or fewer are run by a single job.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM, typename RESPONSE>
+void ParticleCollisionEngine<DIM, RESPONSE>::SetForkJoinScheduler(
+    ParticleTaskScheduler *pScheduler, int serialCutoff)
+{
+    _pScheduler = pScheduler;
+    _serialCutoff = serialCutoff;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Lets the broadphase object decide, from the next pass on, whether the pairs are found with 
+    the tree or with one of the broadphases that don't need it.
+Parameters: 
+    pBroadphase     0 to always use the tree.  Must outlive its use.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM, typename RESPONSE>
+void ParticleCollisionEngine<DIM, RESPONSE>::SetBroadphase(ParticleBroadphase<DIM> *pBroadphase)
+{
+    _pBroadphase = pBroadphase;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Picks one of the pre-instantiated engines.
+Parameters: 
+    responseType    Self-explanatory.
+Returns:    
+    A new engine.  The caller must delete it.  The elastic engine if the type is unknown.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+IParticleCollisionEngine<DIM> *NewParticleCollisionEngine(CollisionResponseType responseType)
+{
+    switch (responseType)
+    {
+    case COLLISION_RESPONSE_SPRING_DASHPOT:
+        return new ParticleCollisionEngine<DIM, SpringDashpotCollisionResponse>();
+    case COLLISION_RESPONSE_LENNARD_JONES:
+        return new ParticleCollisionEngine<DIM, LennardJonesCollisionResponse>();
+    case COLLISION_RESPONSE_REPULSION:
+        return new ParticleCollisionEngine<DIM, RepulsionCollisionResponse>();
+    case COLLISION_RESPONSE_ELASTIC:
+    default:
+        return new ParticleCollisionEngine<DIM, ElasticCollisionResponse>();
+    }
+}
+
+#define INSTANTIATE_COLLISION_ENGINE(DIM, RESPONSE) \
+    template class ParticleCollisionEngine<DIM, RESPONSE>;
+FOR_EACH_COLLISION_RESPONSE(INSTANTIATE_COLLISION_ENGINE, 2)
+FOR_EACH_COLLISION_RESPONSE(INSTANTIATE_COLLISION_ENGINE, 3)
+
+template IParticleCollisionEngine<2> *NewParticleCollisionEngine<2>(CollisionResponseType responseType);
+template IParticleCollisionEngine<3> *NewParticleCollisionEngine<3>(CollisionResponseType responseType);
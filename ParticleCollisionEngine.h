@@ -0,0 +1,96 @@
+#pragma once
+
+#include <vector>
+#include "Particle.h"
+#include "ParticleQuadTree.h"
+#include "ParticleCollisionResponse.h"
+#include "ParticleProperties.h"
+#include "ParticleCollisionEvents.h"
+#include "ParticleTaskScheduler.h"
+#include "ParticleBroadphase.h"
+
+// the interaction laws that have a pre-instantiated engine
+enum CollisionResponseType
+{
+    COLLISION_RESPONSE_ELASTIC = 0,
+    COLLISION_RESPONSE_SPRING_DASHPOT,
+    COLLISION_RESPONSE_LENNARD_JONES,
+    COLLISION_RESPONSE_REPULSION
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The scenario must be able to pick an interaction law at startup without knowing about the
+    templates behind it, so use an interface that defines the one thing a collision engine
+    does.  There is one virtual call per collision pass.  Everything below it is templated on
+    the response and on how particle properties are read, and is inlined.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+class IParticleCollisionEngine
+{
+public:
+    virtual ~IParticleCollisionEngine() {}
+    virtual void DoTheParticleParticleCollisions(const ParticleSpatialTree<DIM> &tree, 
+        const ParticlePropertyStorage &particleProperties, float deltaTimeSec, 
+        float searchPadding, std::vector<GenericParticle<DIM> > &particleCollection, 
+        ParticleCollisionEventStream<DIM> *pEvents = 0) const = 0;
+
+    // how far apart, in contact distances, a pair can be and still interact
+    virtual float InteractionRangeInContactDistances() const = 0;
+
+    // 0 runs the tree traversal on the calling thread
+    virtual void SetForkJoinScheduler(ParticleTaskScheduler *pScheduler, int serialCutoff) = 0;
+
+    // 0 always uses the tree
+    virtual void SetBroadphase(ParticleBroadphase<DIM> *pBroadphase) = 0;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A collision engine for one interaction law.  It owns the response parameters and hands the 
+    tree a collision kernel that is templated on them.  Every pass checks whether only one 
+    species is in use and, if so, uses the kernel that treats mass and radius as constants.  A 
+    scenario that starts mixing species switches to the kernel that looks up the species pair 
+    table on the next pass.
+
+    Optionally, the tree traversal is forked out on a work-stealing pool (see 
+    ParticleSpatialTree::DoTheParticleParticleCollisionsForkJoin(...)).  A pass that reports 
+    collision events is forked out too; each thread stages its own events (see 
+    ParticleCollisionEventStream).
+
+    Optionally, the pairs are found by brute force or a uniform grid instead of the tree (see 
+    ParticleBroadphase).  The broadphase object says which one to use on each pass.
+
+    Only the dimensions and responses listed in FOR_EACH_COLLISION_RESPONSE are instantiated 
+    (see ParticleCollisionEngine.cpp).
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM, typename RESPONSE>
+class ParticleCollisionEngine : public IParticleCollisionEngine<DIM>
+{
+public:
+    ParticleCollisionEngine(const RESPONSE &response = RESPONSE());
+    virtual void DoTheParticleParticleCollisions(const ParticleSpatialTree<DIM> &tree, 
+        const ParticlePropertyStorage &particleProperties, float deltaTimeSec, 
+        float searchPadding, std::vector<GenericParticle<DIM> > &particleCollection, 
+        ParticleCollisionEventStream<DIM> *pEvents = 0) const;
+    virtual float InteractionRangeInContactDistances() const;
+    virtual void SetForkJoinScheduler(ParticleTaskScheduler *pScheduler, int serialCutoff);
+    virtual void SetBroadphase(ParticleBroadphase<DIM> *pBroadphase);
+
+private:
+    RESPONSE _response;
+
+    // 0 unless the traversal is forked out
+    ParticleTaskScheduler *_pScheduler;
+    int _serialCutoff;
+
+    // 0 unless the broadphase can be something other than the tree
+    ParticleBroadphase<DIM> *_pBroadphase;
+};
+
+// the response's parameters are left at their defaults
+// Note: The caller is responsible for deleting the engine.
+template<int DIM>
+IParticleCollisionEngine<DIM> *NewParticleCollisionEngine(CollisionResponseType responseType);
@@ -0,0 +1,294 @@
+#include "ParticleCollisionEvents.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Allocates the simulation thread's staging buffer and the queue.  Every collision is kept
+    until the filters say otherwise.
+Parameters:
+    maxEventsPerPass    How many events one thread can keep during one collision pass.
+    queueCapacity       How many events can wait for the consumer.  Rounded up to a power
+                        of 2.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+ParticleCollisionEventStream<DIM>::ParticleCollisionEventStream(int maxEventsPerPass,
+    int queueCapacity) :
+    _minImpulseSqr(0.0f),
+    _sampleInterval(1),
+    _maxEventsPerPass((maxEventsPerPass < 1) ? 1 : maxEventsPerPass),
+    _frame(0),
+    _numRealParticles(0),
+    _ghostSourceIndices(0),
+    _particleIds(0),
+    _numEventsLastPass(0),
+    _numDroppedEvents(0),
+    _queueHead(0),
+    _queueTail(0)
+{
+    unsigned int capacity = 1;
+    while (capacity < (unsigned int)queueCapacity)
+    {
+        capacity *= 2;
+    }
+    _queue.resize(capacity);
+    _queueMask = capacity - 1;
+
+    SetNumWorkerThreads(0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Collisions with less impulse than this are not reported.  Soft, resting contacts produce
+    a steady stream of tiny impulses that most consumers don't care about.
+Parameters:
+    minImpulse  Self-explanatory.  0 reports everything.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+void ParticleCollisionEventStream<DIM>::SetMinImpulse(float minImpulse)
+{
+    _minImpulseSqr = minImpulse * minImpulse;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Of the collisions that pass the impulse threshold, only one in this many is reported.
+Parameters:
+    keepOneIn   Self-explanatory.  1 reports all of them.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+void ParticleCollisionEventStream<DIM>::SetSampleInterval(int keepOneIn)
+{
+    _sampleInterval = (keepOneIn < 1) ? 1 : keepOneIn;
+    for (size_t stagingIndex = 0; stagingIndex < _staging.size(); stagingIndex++)
+    {
+        _staging[stagingIndex]._sampleCounter = 0;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Makes one staging buffer per thread that can run a collision pass.  Anything staged and
+    not published is thrown away.
+Parameters:
+    numWorkerThreads    The pool's workers (see ParticleTaskScheduler::NumWorkerThreads()).
+                        0 if the collisions only run on the simulation's thread.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+void ParticleCollisionEventStream<DIM>::SetNumWorkerThreads(int numWorkerThreads)
+{
+    _staging.assign((numWorkerThreads < 0) ? 1 : numWorkerThreads + 1, StagingBuffer());
+    for (size_t stagingIndex = 0; stagingIndex < _staging.size(); stagingIndex++)
+    {
+        _staging[stagingIndex]._events.resize(_maxEventsPerPass);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Starts a collision pass.  Anything staged and not published is thrown away.
+Parameters:
+    frame               Stamped on every event from this pass.
+    numRealParticles    Indices at or past this are periodic ghosts.
+    ghostSourceIndices  One entry per ghost; the real particle it was copied from.  0 if
+                        there are no ghosts.
+    particleIds         One entry per real particle; its stable ID.  0 if the IDs are the
+                        indices.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+void ParticleCollisionEventStream<DIM>::BeginPass(unsigned int frame, int numRealParticles,
+    const int *ghostSourceIndices, const unsigned int *particleIds)
+{
+    _frame = frame;
+    _numRealParticles = numRealParticles;
+    _ghostSourceIndices = ghostSourceIndices;
+    _particleIds = particleIds;
+    for (size_t stagingIndex = 0; stagingIndex < _staging.size(); stagingIndex++)
+    {
+        _staging[stagingIndex]._numEvents = 0;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Publishes this pass's events to the queue for the consumer, the simulation thread's
+    first and then each worker's.  The events are copied in first and the new tail is stored
+    after them with release ordering, so the consumer can't see the tail move before the
+    events are there.
+
+    Note: Called on the simulation's thread after the pass has joined, so the workers are
+    done with their buffers.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+void ParticleCollisionEventStream<DIM>::EndPass()
+{
+    unsigned int tail = _queueTail.load(std::memory_order_relaxed);
+    unsigned int head = _queueHead.load(std::memory_order_acquire);
+    unsigned int numFree = (unsigned int)_queue.size() - (tail - head);
+    unsigned int numPublished = 0;
+    for (size_t stagingIndex = 0; stagingIndex < _staging.size(); stagingIndex++)
+    {
+        StagingBuffer &staging = _staging[stagingIndex];
+        unsigned int numToPublish = (unsigned int)staging._numEvents;
+        if (numToPublish > numFree - numPublished)
+        {
+            staging._numDropped += numToPublish - (numFree - numPublished);
+            numToPublish = numFree - numPublished;
+        }
+
+        for (unsigned int eventCount = 0; eventCount < numToPublish; eventCount++)
+        {
+            _queue[(tail + numPublished + eventCount) & _queueMask] = staging._events[eventCount];
+        }
+        numPublished += numToPublish;
+
+        _numDroppedEvents += staging._numDropped;
+        staging._numDropped = 0;
+        staging._numEvents = 0;
+    }
+    _queueTail.store(tail + numPublished, std::memory_order_release);
+
+    _numEventsLastPass = (int)numPublished;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Takes events out of the queue, oldest first.  Only one thread may drain at a time, but it
+    doesn't have to be the one that runs the simulation.
+Parameters:
+    putEventsHere   Self-explanatory.
+    maxEvents       How many fit.
+Returns:
+    How many events were taken.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+int ParticleCollisionEventStream<DIM>::Drain(event_type *putEventsHere, int maxEvents)
+{
+    unsigned int head = _queueHead.load(std::memory_order_relaxed);
+    unsigned int tail = _queueTail.load(std::memory_order_acquire);
+    unsigned int numToTake = tail - head;
+    if (maxEvents < 0)
+    {
+        maxEvents = 0;
+    }
+    if (numToTake > (unsigned int)maxEvents)
+    {
+        numToTake = (unsigned int)maxEvents;
+    }
+
+    for (unsigned int eventCount = 0; eventCount < numToTake; eventCount++)
+    {
+        putEventsHere[eventCount] = _queue[(head + eventCount) & _queueMask];
+    }
+    _queueHead.store(head + numToTake, std::memory_order_release);
+    return (int)numToTake;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many events the last EndPass() published.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+int ParticleCollisionEventStream<DIM>::NumEventsLastPass() const
+{
+    return _numEventsLastPass;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.  Events that passed the filters but didn't fit.  If this keeps growing,
+    then the consumer isn't keeping up or the filters need to be tighter.
+Parameters: None
+Returns:
+    The number of dropped events since construction.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+unsigned int ParticleCollisionEventStream<DIM>::NumDroppedEvents() const
+{
+    return _numDroppedEvents;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A snapshot of how many events are waiting for the consumer.  Already out of date if the
+    other side is running.
+Parameters: None
+Returns:
+    See description.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+int ParticleCollisionEventStream<DIM>::QueueDepth() const
+{
+    unsigned int head = _queueHead.load(std::memory_order_acquire);
+    unsigned int tail = _queueTail.load(std::memory_order_acquire);
+    return (int)(tail - head);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Turns ghost indices into the real particles' indices.  A pair across a periodic seam is
+    collided twice, once as each real particle with the other's ghost, so only the one with
+    the smaller real index first is kept.  Pairs of two ghosts are duplicates of pairs near
+    a corner and are skipped.
+Parameters:
+    p1Index, p2Index    In: broadphase indices.  Out: real particle indices.
+Returns:
+    False if the pair shouldn't be reported.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+bool ParticleCollisionEventStream<DIM>::RecordGhostPair(int *p1Index, int *p2Index)
+{
+    bool p1IsGhost = (*p1Index >= _numRealParticles);
+    bool p2IsGhost = (*p2Index >= _numRealParticles);
+    if ((p1IsGhost && p2IsGhost) || _ghostSourceIndices == 0)
+    {
+        return false;
+    }
+
+    int realIndex = p1IsGhost ? *p2Index : *p1Index;
+    int ghostIndex = p1IsGhost ? *p1Index : *p2Index;
+    int sourceIndex = _ghostSourceIndices[ghostIndex - _numRealParticles];
+    if (realIndex >= sourceIndex)
+    {
+        // the same pair the other way around is reported instead (or it is a particle
+        // touching its own ghost)
+        return false;
+    }
+
+    *p1Index = realIndex;
+    *p2Index = sourceIndex;
+    return true;
+}
+
+template class ParticleCollisionEventStream<2>;
+template class ParticleCollisionEventStream<3>;
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include "Particle.h"
+#include "ParticleTaskScheduler.h"
+#include "glm/detail/func_geometric.hpp"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    One particle-particle collision, as reported to systems outside of the simulation (audio,
+    analytics, damage).  The contact point is halfway between the two centers, which is where
+    the two touch if they have the same radius.  The impulse is the magnitude of the collision
+    force times the delta time that it was applied over.
+
+    The indices are the particles' slots when the event was recorded, which can be out of date
+    by the time it is drained if the particle collection is reordered (see 
+    ParticleSpatialReorder).  The IDs stay with the particles.  Without a reorder, they are the 
+    same as the indices.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+struct GenericParticleCollisionEvent
+{
+    typedef typename ParticleDimension<DIM>::vec_type vec_type;
+
+    unsigned int _frame;
+    int _p1Index;
+    int _p2Index;
+    unsigned int _p1Id;
+    unsigned int _p2Id;
+    vec_type _contactPoint;
+    float _impulse;
+};
+
+typedef GenericParticleCollisionEvent<2> ParticleCollisionEvent;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    An optional stage on the collision pass that reports collisions as events.  The collision
+    kernel calls Record(...) for every pair that it applies a force to, and the stage decides
+    whether to keep it:
+    - Pairs with less impulse than a threshold are skipped.  The check is on the squared
+    force, so there is no square root for pairs that don't make it.
+    - Of the pairs that pass, only one in every N is kept (sampling).
+
+    Events that are kept go into a staging buffer that belongs to the thread that recorded
+    them, so the hot loop never touches anything shared, even when the collision pass is
+    forked out on a pool.  There is one buffer for the simulation's thread and one for each
+    of the pool's workers, looked up by ParticleTaskScheduler::CurrentWorkerIndex() (see
+    SetNumWorkerThreads(...)).  EndPass() then publishes the buffers one after another to a
+    single-consumer queue with one atomic store.  The queue is a lock-free ring: the producer
+    only writes the tail and the consumer only writes the head, so Drain(...) can be called
+    from another thread (an audio thread, for example) while the next collision pass is
+    running.
+
+    Note: Each thread samples its own pairs, and which thread collides which pair depends on
+    the scheduling, so with a pool, which pairs are sampled and the order that they are
+    published in can change from run to run.  Without sampling, a pass reports the same set
+    of pairs either way.
+
+    Nothing is allocated after SetNumWorkerThreads(...).  If a staging buffer or the queue is
+    full, the event is dropped and counted.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+class ParticleCollisionEventStream
+{
+public:
+    typedef GenericParticleCollisionEvent<DIM> event_type;
+    typedef typename ParticleDimension<DIM>::vec_type vec_type;
+
+    ParticleCollisionEventStream(int maxEventsPerPass = 4096, int queueCapacity = 65536);
+
+    void SetMinImpulse(float minImpulse);
+    void SetSampleInterval(int keepOneIn);
+
+    // one staging buffer for the simulation's thread and one for each of the pool's workers
+    // Note: Not during a pass.
+    void SetNumWorkerThreads(int numWorkerThreads);
+
+    // producer side; called by the simulation around the collision pass
+    // Note: Particle indices at or past the number of real particles are periodic ghosts and
+    // are reported as the real particle that they were copied from (see ParticlePeriodicGhosts).
+    // Also Note: The particle IDs are indexed by real particle index.  0 if there are none.
+    void BeginPass(unsigned int frame, int numRealParticles, const int *ghostSourceIndices = 0, 
+        const unsigned int *particleIds = 0);
+    void Record(int p1Index, int p2Index, const vec_type &p1Position, const vec_type &p1ToP2,
+        const vec_type &forceOnP2, float deltaTimeSec);
+    void EndPass();
+
+    // consumer side; one consumer at a time, on any thread
+    int Drain(event_type *putEventsHere, int maxEvents);
+
+    int NumEventsLastPass() const;
+    unsigned int NumDroppedEvents() const;
+    int QueueDepth() const;
+
+private:
+    bool RecordGhostPair(int *p1Index, int *p2Index);
+
+    // one thread's share of the current pass
+    // Note: Padded to a cache line so that two threads' counters never share one.
+    struct StagingBuffer
+    {
+        StagingBuffer() :
+            _numEvents(0),
+            _sampleCounter(0),
+            _numDropped(0)
+        {
+        }
+
+        std::vector<event_type> _events;
+        int _numEvents;
+        int _sampleCounter;
+        unsigned int _numDropped;
+        char _padding[64 - ((sizeof(std::vector<event_type>) + (3 * sizeof(int))) % 64)];
+    };
+
+    float _minImpulseSqr;
+    int _sampleInterval;
+    int _maxEventsPerPass;
+
+    unsigned int _frame;
+    int _numRealParticles;
+    const int *_ghostSourceIndices;
+    const unsigned int *_particleIds;
+
+    // the current pass's events, by ParticleTaskScheduler::CurrentWorkerIndex()
+    std::vector<StagingBuffer> _staging;
+    int _numEventsLastPass;
+    unsigned int _numDroppedEvents;
+
+    // Note: The capacity is a power of 2 and the head and tail only ever count up, so the
+    // number of queued events is (tail - head) even after they wrap.
+    std::vector<event_type> _queue;
+    unsigned int _queueMask;
+    std::atomic<unsigned int> _queueHead;
+    std::atomic<unsigned int> _queueTail;
+};
+
+typedef ParticleCollisionEventStream<2> ParticleCollisionEvents;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Called by the collision kernel for every pair that it applied a force to.  Filters the
+    pair and, if it is kept, adds it to the calling thread's staging buffer.  Any of the
+    pool's threads can call this at the same time.
+Parameters:
+    p1Index, p2Index    Self-explanatory.
+    p1Position          Self-explanatory.
+    p1ToP2              From P1's center to P2's.
+    forceOnP2           The collision force.  P1 got the opposite.
+    deltaTimeSec        What the force will be applied over.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+inline void ParticleCollisionEventStream<DIM>::Record(int p1Index, int p2Index,
+    const vec_type &p1Position, const vec_type &p1ToP2, const vec_type &forceOnP2,
+    float deltaTimeSec)
+{
+    float impulseSqr = glm::dot(forceOnP2, forceOnP2) * deltaTimeSec * deltaTimeSec;
+    if (impulseSqr < _minImpulseSqr)
+    {
+        return;
+    }
+
+    if ((p1Index >= _numRealParticles || p2Index >= _numRealParticles) &&
+        !RecordGhostPair(&p1Index, &p2Index))
+    {
+        return;
+    }
+
+    // Note: A thread from a bigger pool than the one that this was set up for would share a
+    // buffer, so it gets 0's instead, which belongs to the simulation's thread.  That can only
+    // happen if SetNumWorkerThreads(...) was given the wrong pool.
+    int stagingIndex = ParticleTaskScheduler::CurrentWorkerIndex();
+    if (stagingIndex >= (int)_staging.size())
+    {
+        stagingIndex = 0;
+    }
+    StagingBuffer &staging = _staging[stagingIndex];
+
+    staging._sampleCounter++;
+    if (staging._sampleCounter < _sampleInterval)
+    {
+        return;
+    }
+    staging._sampleCounter = 0;
+
+    if (staging._numEvents == _maxEventsPerPass)
+    {
+        staging._numDropped++;
+        return;
+    }
+
+    event_type &e = staging._events[staging._numEvents++];
+    e._frame = _frame;
+    e._p1Index = p1Index;
+    e._p2Index = p2Index;
+    e._p1Id = (_particleIds != 0) ? _particleIds[p1Index] : (unsigned int)p1Index;
+    e._p2Id = (_particleIds != 0) ? _particleIds[p2Index] : (unsigned int)p2Index;
+    e._contactPoint = p1Position + (0.5f * p1ToP2);
+    e._impulse = sqrtf(impulseSqr);
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <vector>
+#include "Particle.h"
+#include "ParticleCollisionResponse.h"
+#include "ParticlePropertyAccess.h"
+#include "ParticleCollisionEvents.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The innermost part of the particle-particle collisions: given two particle indices, check
+    whether they are within range and, if so, apply the response's force to both.  The tree
+    traversal is templated on this kernel, which is templated on the response and on how
+    particle properties are read (see ParticlePropertyAccess.h), so the whole pair test is
+    inlined into the traversal loops.  With uniform properties, the interaction distance and
+    the masses are constants for the whole pass.
+
+    It is built on the stack once per collision pass and is just a bundle of references.  If 
+    there is a collision event stream, every pair that gets a force is also handed to it.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM, typename RESPONSE, typename PROPERTIES>
+class ParticleCollisionKernel
+{
+public:
+    typedef GenericParticle<DIM> particle_type;
+    typedef typename ParticleDimension<DIM>::vec_type vec_type;
+
+    ParticleCollisionKernel(const RESPONSE &response, const PROPERTIES &properties, float deltaTimeSec, 
+        ParticleCollisionEventStream<DIM> *pEvents = 0);
+
+    float NeighborSearchDistance() const;
+    bool CollideP1WithP2(int p1Index, int p2Index, std::vector<particle_type> &particleCollection) const;
+
+private:
+    const RESPONSE &_response;
+    const PROPERTIES &_properties;
+    float _deltaTimeSec;
+
+    // 0 unless collision events are being reported
+    ParticleCollisionEventStream<DIM> *_pEvents;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.
+Parameters:
+    response        The interaction law.  Must outlive the kernel.
+    properties      Particle masses and radii.  Must outlive the kernel.
+    deltaTimeSec    Self-explanatory.
+    pEvents         Optional.  Must outlive the kernel.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM, typename RESPONSE, typename PROPERTIES>
+inline ParticleCollisionKernel<DIM, RESPONSE, PROPERTIES>::ParticleCollisionKernel(
+    const RESPONSE &response, const PROPERTIES &properties, float deltaTimeSec, 
+    ParticleCollisionEventStream<DIM> *pEvents) :
+    _response(response),
+    _properties(properties),
+    _deltaTimeSec(deltaTimeSec),
+    _pEvents(pEvents)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The furthest apart that two particles can be and still interact.  The tree uses this to
+    decide whether a particle needs to be checked against a neighboring node.
+Parameters: None
+Returns:
+    See description.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM, typename RESPONSE, typename PROPERTIES>
+inline float ParticleCollisionKernel<DIM, RESPONSE, PROPERTIES>::NeighborSearchDistance() const
+{
+    return _properties.MaxInteractionDistance();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Calculates and adds force for P1 on P2 and P2 on P1.  An N^2 particle collision approach
+    will result in duplicate force calculations.  Pairs of sleeping particles are skipped.
+Parameters:
+    p1Index     Self-explanatory
+    p2Index     Self-explanatory
+    particleCollection  Self-explanatory.
+Returns:
+    True if the pair got a force.
+Exception:  Safe
+Creator:    John Cox (1-3-2017)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM, typename RESPONSE, typename PROPERTIES>
+inline bool ParticleCollisionKernel<DIM, RESPONSE, PROPERTIES>::CollideP1WithP2(int p1Index, int p2Index,
+    std::vector<particle_type> &particleCollection) const
+{
+    particle_type &p1 = particleCollection[p1Index];
+    particle_type &p2 = particleCollection[p2Index];
+    if (p1._isAsleep && p2._isAsleep)
+    {
+        // both settled; nothing to do
+        return false;
+    }
+
+    vec_type p1ToP2 = p2._position - p1._position;
+
+    // partial pythagorean theorem
+    float distanceBetweenSqr = glm::dot(p1ToP2, p1ToP2);
+
+    // Note: Two particles in exactly the same spot have no line of contact, so leave them be.
+    if (distanceBetweenSqr < _properties.InteractionDistanceSqr(p1Index, p2Index) &&
+        distanceBetweenSqr > 0.0f)
+    {
+        // a particle can't fall asleep while something it touches is still moving
+        // Note: A sleeping particle that gets pushed here is woken on the next update because 
+        // its collision count is no longer 0.
+        if (p1._framesAtRest == 0)
+        {
+            p2._framesAtRest = 0;
+        }
+        if (p2._framesAtRest == 0)
+        {
+            p1._framesAtRest = 0;
+        }
+
+        vec_type forceOnP2;
+        if (_response.Respond(p1, p2, _properties.PairProperties(p1Index, p2Index), p1ToP2,
+            distanceBetweenSqr, _deltaTimeSec, &forceOnP2))
+        {
+            p1._netForce -= forceOnP2;
+            p2._netForce += forceOnP2;
+
+            p1._collisionCountThisFrame += 1;
+            p2._collisionCountThisFrame += 1;
+
+            if (_pEvents != 0)
+            {
+                _pEvents->Record(p1Index, p2Index, p1._position, p1ToP2, forceOnP2, _deltaTimeSec);
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
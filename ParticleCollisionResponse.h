@@ -0,0 +1,314 @@
+#pragma once
+
+#include <math.h>
+#include "glm/detail/func_geometric.hpp" // for normalizing glm vectors
+#include "ParticleProperties.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The interaction laws for particle-particle collisions.  Each one is a small policy struct
+    that ParticleCollisionKernel is templated on, so the law is inlined into the tree traversal
+    loops instead of being called through a virtual function for every pair.
+
+    Every policy has the same two methods:
+    - InteractionRangeInContactDistances(): Pairs that are closer than this many contact
+    distances (sum of the radii of influence) interact.  It is a ratio rather than a distance
+    so that the uniform property path can work out the interaction distance once per pass (see
+    ParticlePropertyAccess.h).  The tree also uses it to decide how far to look into
+    neighboring nodes.
+    - Respond(...): Calculates the force on p2.  Masses, radii, and the species pair's
+    interaction coefficient come from the pair properties, never from the particles.  Every
+    response scales its force by the coefficient.  All of these laws are central forces, so the
+    force on p1 is the exact opposite (Newton's third law) and the kernel applies it.  Returns
+    false if the pair is within range but the law decided not to push on them (ex: elastic
+    particles that are already separating).
+
+    Parameters are members with demo-scaled defaults (particle mass 0.1, radius 0.01, speeds
+    around 0.1-0.5, and delta time 0.01).
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+
+// the default; this is the original particle-particle collision
+struct ElasticCollisionResponse
+{
+    float InteractionRangeInContactDistances() const;
+
+    template<typename PARTICLE, typename VEC>
+    bool Respond(const PARTICLE &p1, const PARTICLE &p2, const ParticlePairProperties &pair,
+        const VEC &p1ToP2, float distanceBetweenSqr, float deltaTimeSec, VEC *forceOnP2) const;
+};
+
+// a soft contact with a linear spring to push particles apart and a dashpot to damp the
+// bounce, like the discrete element method (DEM)
+struct SpringDashpotCollisionResponse
+{
+    SpringDashpotCollisionResponse() : _stiffness(1000.0f), _damping(1.0f) {}
+
+    float InteractionRangeInContactDistances() const;
+
+    template<typename PARTICLE, typename VEC>
+    bool Respond(const PARTICLE &p1, const PARTICLE &p2, const ParticlePairProperties &pair,
+        const VEC &p1ToP2, float distanceBetweenSqr, float deltaTimeSec, VEC *forceOnP2) const;
+
+    float _stiffness;
+    float _damping;
+};
+
+// 12-6 Lennard-Jones: repulsive up close, mildly attractive further out, cut off at a
+// multiple of sigma
+// Note: Sigma is calculated per pair so that the bottom of the potential well is where the
+// two particles' regions of influence touch.
+struct LennardJonesCollisionResponse
+{
+    LennardJonesCollisionResponse() : _epsilon(0.001f), _cutoffInSigmas(2.5f), _minDistanceInSigmas(0.9f) {}
+
+    float InteractionRangeInContactDistances() const;
+
+    template<typename PARTICLE, typename VEC>
+    bool Respond(const PARTICLE &p1, const PARTICLE &p2, const ParticlePairProperties &pair,
+        const VEC &p1ToP2, float distanceBetweenSqr, float deltaTimeSec, VEC *forceOnP2) const;
+
+    float _epsilon;
+    float _cutoffInSigmas;
+
+    // the force is evaluated no closer than this so that a deep overlap doesn't launch
+    // particles across the region
+    float _minDistanceInSigmas;
+};
+
+// a soft push that ramps linearly from 0 at first contact to _strength at full overlap, with
+// no damping and no attraction
+struct RepulsionCollisionResponse
+{
+    RepulsionCollisionResponse() : _strength(20.0f) {}
+
+    float InteractionRangeInContactDistances() const;
+
+    template<typename PARTICLE, typename VEC>
+    bool Respond(const PARTICLE &p1, const PARTICLE &p2, const ParticlePairProperties &pair,
+        const VEC &p1ToP2, float distanceBetweenSqr, float deltaTimeSec, VEC *forceOnP2) const;
+
+    float _strength;
+};
+
+// every response that gets a pre-instantiated collision engine
+// Note: Used for explicit template instantiation.  Add new responses here.
+#define FOR_EACH_COLLISION_RESPONSE(MACRO, DIM) \
+    MACRO(DIM, ElasticCollisionResponse) \
+    MACRO(DIM, SpringDashpotCollisionResponse) \
+    MACRO(DIM, LennardJonesCollisionResponse) \
+    MACRO(DIM, RepulsionCollisionResponse)
+
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Particles collide when their regions of influence overlap.
+Parameters: None
+Returns:
+    See description.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+inline float ElasticCollisionResponse::InteractionRangeInContactDistances() const
+{
+    return 1.0f;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Elastic collision with conservation of momentum.  The change in momentum is converted into
+    a force by dividing by delta time so that the particle updater applies it on the next
+    update.  The pair's restitution scales the bounce (1 is fully elastic, 0 stops the
+    particles' approach without bouncing them apart).
+
+    Note: For an elastic collision between two particles of equal mass, the velocities of the
+    two will be exchanged.  I could use this simplified idea for this demo, but I want to
+    eventually have the option of different masses of particles, so I will use the general
+    case elastic collision calculations (bottom of page at link).
+    http://hyperphysics.phy-astr.gsu.edu/hbase/colsta.html
+
+    For elastic collisions between two masses (ignoring rotation because these particles are
+    points), use the calculations from this article (I followed them on paper too and it seems
+    legit).
+    http://www.gamasutra.com/view/feature/3015/pool_hall_lessons_fast_accurate_.php?page=3
+Parameters:
+    p1, p2          The pair.
+    pair            Their masses, contact distance, and interaction coefficient.
+    p1ToP2          p2's position - p1's position.
+    distanceBetweenSqr  Self-explanatory.
+    deltaTimeSec    Self-explanatory.
+    forceOnP2       Receives the force on p2.  The force on p1 is the opposite.
+Returns:
+    False if the particles are already moving apart, otherwise true.
+Exception:  Safe
+Creator:    John Cox (1-3-2017)
+-----------------------------------------------------------------------------------------------*/
+template<typename PARTICLE, typename VEC>
+inline bool ElasticCollisionResponse::Respond(const PARTICLE &p1, const PARTICLE &p2,
+    const ParticlePairProperties &pair, const VEC &p1ToP2, float distanceBetweenSqr, float deltaTimeSec, VEC *forceOnP2) const
+{
+    // Note: I tried using a fast inverse square root calculation instead, but it didn't
+    // seem to save any frames, so I'm just using GLM's normalize.
+    VEC normalizedLineOfContact = p1ToP2 / sqrtf(distanceBetweenSqr);
+
+    // the velocity components along the line of contact
+    // Note: These were once dotted with the unnormalized p1ToP2, which scaled the exchange by
+    // the distance between the particles.
+    float a1 = glm::dot(p1._velocity, normalizedLineOfContact);
+    float a2 = glm::dot(p2._velocity, normalizedLineOfContact);
+    if (a1 - a2 <= 0.0f)
+    {
+        // already separating; the exchange would pull them back together
+        return false;
+    }
+
+    // v2' = v2 + ((1 + e) * (a1 - a2) / (m1 + m2)) * m1 * n
+    // delta momentum (impulse) = m2 * (v2' - v2) = (1 + e) * (a1 - a2) * (m1 * m2 / (m1 + m2)) * n
+    // force = delta momentum / delta time
+    // Note: With the default restitution of 1, this is the original elastic exchange.
+    float impulse = (1.0f + pair._restitution) * (a1 - a2) * pair._reducedMass;
+    *forceOnP2 = normalizedLineOfContact * (pair._interactionCoefficient * impulse / deltaTimeSec);
+    return true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Particles are in contact when their regions of influence overlap.
+Parameters: None
+Returns:
+    See description.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+inline float SpringDashpotCollisionResponse::InteractionRangeInContactDistances() const
+{
+    return 1.0f;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Normal force = stiffness * overlap - damping * (closing speed along the line of contact).
+    The dashpot is not allowed to pull the particles together, so the force is clamped at 0.
+Parameters:
+    p1, p2          The pair.
+    pair            Their masses, contact distance, and interaction coefficient.
+    p1ToP2          p2's position - p1's position.
+    distanceBetweenSqr  Self-explanatory.
+    deltaTimeSec    Unused.  Only impulse-based responses need it.
+    forceOnP2       Receives the force on p2.  The force on p1 is the opposite.
+Returns:
+    False if the damping cancelled out the spring, otherwise true.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<typename PARTICLE, typename VEC>
+inline bool SpringDashpotCollisionResponse::Respond(const PARTICLE &p1, const PARTICLE &p2,
+    const ParticlePairProperties &pair, const VEC &p1ToP2, float distanceBetweenSqr, float /*deltaTimeSec*/, VEC *forceOnP2) const
+{
+    float distanceBetween = sqrtf(distanceBetweenSqr);
+    VEC normalizedLineOfContact = p1ToP2 / distanceBetween;
+    float overlap = pair._contactDistance - distanceBetween;
+
+    // positive when separating
+    float separationSpeed = glm::dot(p2._velocity - p1._velocity, normalizedLineOfContact);
+
+    float forceMagnitude = (_stiffness * overlap) - (_damping * separationSpeed);
+    if (forceMagnitude <= 0.0f)
+    {
+        return false;
+    }
+
+    *forceOnP2 = normalizedLineOfContact * (pair._interactionCoefficient * forceMagnitude);
+    return true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The cutoff is _cutoffInSigmas sigmas, and sigma is chosen so that the potential's minimum
+    (2^(1/6) * sigma) lands where the two regions of influence touch.
+Parameters: None
+Returns:
+    See description.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+inline float LennardJonesCollisionResponse::InteractionRangeInContactDistances() const
+{
+    // 1 / 2^(1/6)
+    const float sigmaPerContactDistance = 0.89089871814f;
+    return sigmaPerContactDistance * _cutoffInSigmas;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    F(r) = 24 * epsilon * (2 * (sigma / r)^12 - (sigma / r)^6) / r, positive being repulsive.
+Parameters:
+    p1, p2          The pair.
+    pair            Their masses, contact distance, and interaction coefficient.
+    p1ToP2          p2's position - p1's position.
+    distanceBetweenSqr  Self-explanatory.
+    deltaTimeSec    Unused.  Only impulse-based responses need it.
+    forceOnP2       Receives the force on p2.  The force on p1 is the opposite.
+Returns:
+    Always true.  Every pair inside the cutoff pushes or pulls.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<typename PARTICLE, typename VEC>
+inline bool LennardJonesCollisionResponse::Respond(const PARTICLE &/*p1*/, const PARTICLE &/*p2*/,
+    const ParticlePairProperties &pair, const VEC &p1ToP2, float distanceBetweenSqr, float /*deltaTimeSec*/, VEC *forceOnP2) const
+{
+    const float sigmaPerContactDistance = 0.89089871814f;
+    float sigma = pair._contactDistance * sigmaPerContactDistance;
+    float distanceBetween = sqrtf(distanceBetweenSqr);
+    VEC normalizedLineOfContact = p1ToP2 / distanceBetween;
+
+    float minDistance = sigma * _minDistanceInSigmas;
+    float r = (distanceBetween < minDistance) ? minDistance : distanceBetween;
+    float sr2 = (sigma * sigma) / (r * r);
+    float sr6 = sr2 * sr2 * sr2;
+    float forceMagnitude = 24.0f * _epsilon * ((2.0f * sr6 * sr6) - sr6) / r;
+
+    *forceOnP2 = normalizedLineOfContact * (pair._interactionCoefficient * forceMagnitude);
+    return true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Particles repel when their regions of influence overlap.
+Parameters: None
+Returns:
+    See description.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+inline float RepulsionCollisionResponse::InteractionRangeInContactDistances() const
+{
+    return 1.0f;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    F = strength * (1 - distance / contact distance), directed away from the other particle.
+Parameters:
+    p1, p2          The pair.
+    pair            Their masses, contact distance, and interaction coefficient.
+    p1ToP2          p2's position - p1's position.
+    distanceBetweenSqr  Self-explanatory.
+    deltaTimeSec    Unused.  Only impulse-based responses need it.
+    forceOnP2       Receives the force on p2.  The force on p1 is the opposite.
+Returns:
+    Always true.  Every overlapping pair pushes.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<typename PARTICLE, typename VEC>
+inline bool RepulsionCollisionResponse::Respond(const PARTICLE &/*p1*/, const PARTICLE &/*p2*/,
+    const ParticlePairProperties &pair, const VEC &p1ToP2, float distanceBetweenSqr, float /*deltaTimeSec*/, VEC *forceOnP2) const
+{
+    float distanceBetween = sqrtf(distanceBetweenSqr);
+    VEC normalizedLineOfContact = p1ToP2 / distanceBetween;
+    *forceOnP2 = normalizedLineOfContact * (pair._interactionCoefficient * _strength * 
+        (1.0f - (distanceBetween / pair._contactDistance)));
+    return true;
+}
@@ -0,0 +1,417 @@
+#include "ParticleCollisionValidator.h"
+
+#include "ParticleTaskScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Ensures that the object starts object with initialized values.  Nothing is checked until
+    Init(...).
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleCollisionValidator::ParticleCollisionValidator() :
+    _pCollisionEngine(0),
+    _pProductionBroadphase(0),
+    _pEvents(0),
+    _forceTolerance(0.0001f),
+    _lastValidationPassed(true),
+    _numValidations(0),
+    _numFailedValidations(0)
+{
+    _referenceBroadphase.SetType(BROADPHASE_BRUTE_FORCE);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Cleans up the event stream that collects the pairs.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleCollisionValidator::~ParticleCollisionValidator()
+{
+    delete _pEvents;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets up what to check and allocates everything that the validations need, so a
+    validation doesn't allocate unless the particle collection has grown.
+Parameters:
+    pCollisionEngine        The engine that the simulation uses.
+    pProductionBroadphase   The broadphase that the engine was given, or 0 if it always uses
+                            the tree.
+    maxParticles            Sizes the pair collection.  Each of the pool's threads gets room
+                            for every pair, since any one of them could collide all of them.
+    pScheduler              The reference's brute force search is spread over this pool.
+                            Should be the pool that the engine forks out on, if it does, so
+                            that every thread that reports production pairs has a staging
+                            buffer.  0 keeps the reference on the calling thread.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleCollisionValidator::Init(IParticleCollisionEngine<2> *pCollisionEngine,
+    ParticleBroadphase<2> *pProductionBroadphase, unsigned int maxParticles,
+    ParticleTaskScheduler *pScheduler)
+{
+    _pCollisionEngine = pCollisionEngine;
+    _pProductionBroadphase = pProductionBroadphase;
+    _referenceBroadphase.SetScheduler(pScheduler);
+
+    int maxPairs = _MAX_PAIRS_PER_PARTICLE * (int)maxParticles;
+    delete _pEvents;
+    _pEvents = new ParticleCollisionEvents(maxPairs, maxPairs);
+    _pEvents->SetNumWorkerThreads((pScheduler != 0) ? pScheduler->NumWorkerThreads() : 0);
+    _drainedEvents.resize(maxPairs);
+    _referencePairKeys.reserve(maxPairs);
+    _productionPairKeys.reserve(maxPairs);
+
+    _productionParticles.reserve(maxParticles);
+    _referenceParticles.reserve(maxParticles);
+    _missedPairs.reserve(2 * _MAX_KEPT_PAIRS);
+    _extraPairs.reserve(2 * _MAX_KEPT_PAIRS);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.  The forces won't match to the last bit when the pairs are handed to
+    the kernel in a different order, so they only need to match this closely.
+Parameters:
+    fractionOfMaxForce  Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleCollisionValidator::SetForceTolerance(float fractionOfMaxForce)
+{
+    _forceTolerance = fractionOfMaxForce;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs the production collisions and the exhaustive ones side by side on copies of the
+    same state and compares them.  The particle collection is not changed.
+Parameters:
+    particleCollection  Self-explanatory.
+    particleProperties  Self-explanatory.
+    tree                The tree that the simulation uses.  It is rebuilt from a copy.
+    deltaTimeSec        What the collisions would apply their forces over.
+Returns:
+    True if the pairs were the same and the forces were within the tolerance.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleCollisionValidator::Validate(const std::vector<Particle> &particleCollection,
+    const ParticlePropertyStorage &particleProperties, ParticleQuadTree &tree,
+    float deltaTimeSec)
+{
+    if (_pCollisionEngine == 0)
+    {
+        return true;
+    }
+
+    _lastReport = ParticleCollisionValidationReport();
+    CopyParticles(particleCollection, _productionParticles);
+    CopyParticles(particleCollection, _referenceParticles);
+
+    // the tree holds indices, so one that is built from one copy works for both of them
+    tree.ResetTree();
+    tree.AddParticlestoTree(_productionParticles);
+
+    // production, the way that the simulation runs it
+    unsigned int numDroppedBefore = _pEvents->NumDroppedEvents();
+    _pEvents->BeginPass(0, (int)_productionParticles.size());
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    _pCollisionEngine->DoTheParticleParticleCollisions(tree, particleProperties, deltaTimeSec,
+        0.0f, _productionParticles, _pEvents);
+    _lastReport._productionSec = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    _pEvents->EndPass();
+    bool productionComplete = CollectPairs(numDroppedBefore, _productionPairKeys);
+
+    // the reference
+    _pCollisionEngine->SetBroadphase(&_referenceBroadphase);
+    numDroppedBefore = _pEvents->NumDroppedEvents();
+    _pEvents->BeginPass(0, (int)_referenceParticles.size());
+    start = std::chrono::steady_clock::now();
+    _pCollisionEngine->DoTheParticleParticleCollisions(tree, particleProperties, deltaTimeSec,
+        0.0f, _referenceParticles, _pEvents);
+    _lastReport._referenceSec = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    _pEvents->EndPass();
+    _pCollisionEngine->SetBroadphase(_pProductionBroadphase);
+    bool referenceComplete = CollectPairs(numDroppedBefore, _referencePairKeys);
+
+    _lastReport._pairListsComplete = referenceComplete && productionComplete;
+    ComparePairs();
+    CompareForces();
+
+    float maxForceDelta = _forceTolerance * _lastReport._maxReferenceForce;
+    _lastValidationPassed = _lastReport._pairListsComplete &&
+        (_lastReport._numMissedPairs == 0) &&
+        (_lastReport._numExtraPairs == 0) &&
+        (_lastReport._numDuplicatePairs == 0) &&
+        (_lastReport._numCountMismatches == 0) &&
+        (_lastReport._maxForceDelta <= maxForceDelta);
+
+    _numValidations++;
+    if (!_lastValidationPassed)
+    {
+        _numFailedValidations++;
+    }
+    return _lastValidationPassed;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    What the last validation found.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+const ParticleCollisionValidationReport &ParticleCollisionValidator::LastReport() const
+{
+    return _lastReport;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    What the last Validate(...) returned.  True if there hasn't been one.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleCollisionValidator::LastValidationPassed() const
+{
+    return _lastValidationPassed;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many times Validate(...) has run.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleCollisionValidator::NumValidations() const
+{
+    return _numValidations;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many of the validations didn't pass.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleCollisionValidator::NumFailedValidations() const
+{
+    return _numFailedValidations;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    Up to the first 64 pairs that the reference found and production didn't, as two particle
+    indices each, lower first.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+const std::vector<int> &ParticleCollisionValidator::MissedPairs() const
+{
+    return _missedPairs;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    Up to the first 64 pairs that production found and the reference didn't, as two particle
+    indices each, lower first.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+const std::vector<int> &ParticleCollisionValidator::ExtraPairs() const
+{
+    return _extraPairs;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Copies the particle collection and clears what the collisions add to, the same way that
+    the simulation does before its collision pass.
+Parameters:
+    particleCollection  Self-explanatory.
+    copy                Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleCollisionValidator::CopyParticles(const std::vector<Particle> &particleCollection,
+    std::vector<Particle> &copy) const
+{
+    copy = particleCollection;
+    for (size_t particleIndex = 0; particleIndex < copy.size(); particleIndex++)
+    {
+        Particle &p = copy[particleIndex];
+        if (p._isActive)
+        {
+            p._netForce = glm::vec2();
+            p._collisionCountThisFrame = 0;
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Takes the last pass's events out of the stream and turns them into sorted pair keys.
+Parameters:
+    numDroppedBefore    The stream's dropped event count from before the pass.
+    pairKeys            Self-explanatory.
+Returns:
+    False if the stream ran out of room and dropped some.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleCollisionValidator::CollectPairs(unsigned int numDroppedBefore,
+    std::vector<unsigned long long> &pairKeys)
+{
+    int numEvents = _pEvents->Drain(_drainedEvents.data(), (int)_drainedEvents.size());
+    bool isComplete = (_pEvents->NumEventsLastPass() == numEvents) &&
+        (_pEvents->NumDroppedEvents() == numDroppedBefore);
+
+    pairKeys.clear();
+    for (int eventIndex = 0; eventIndex < numEvents; eventIndex++)
+    {
+        const ParticleCollisionEvent &e = _drainedEvents[eventIndex];
+        unsigned long long lower = (unsigned int)std::min(e._p1Index, e._p2Index);
+        unsigned long long higher = (unsigned int)std::max(e._p1Index, e._p2Index);
+        pairKeys.push_back((lower << 32) | higher);
+    }
+    std::sort(pairKeys.begin(), pairKeys.end());
+    return isComplete;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Walks the two sorted pair lists together.  The reference checks every pair once, so any
+    repeat is production's.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleCollisionValidator::ComparePairs()
+{
+    _missedPairs.clear();
+    _extraPairs.clear();
+
+    const std::vector<unsigned long long> &reference = _referencePairKeys;
+    const std::vector<unsigned long long> &production = _productionPairKeys;
+    _lastReport._numReferencePairs = (int)reference.size();
+    _lastReport._numProductionPairs = (int)production.size();
+
+    size_t referenceIndex = 0;
+    size_t productionIndex = 0;
+    while (referenceIndex < reference.size() || productionIndex < production.size())
+    {
+        if (productionIndex > 0 && productionIndex < production.size() &&
+            production[productionIndex] == production[productionIndex - 1])
+        {
+            _lastReport._numDuplicatePairs++;
+            productionIndex++;
+            continue;
+        }
+
+        bool referenceDone = (referenceIndex == reference.size());
+        bool productionDone = (productionIndex == production.size());
+        if (!referenceDone && !productionDone &&
+            reference[referenceIndex] == production[productionIndex])
+        {
+            referenceIndex++;
+            productionIndex++;
+        }
+        else if (productionDone ||
+            (!referenceDone && reference[referenceIndex] < production[productionIndex]))
+        {
+            unsigned long long key = reference[referenceIndex++];
+            _lastReport._numMissedPairs++;
+            if (_missedPairs.size() < 2 * _MAX_KEPT_PAIRS)
+            {
+                _missedPairs.push_back((int)(key >> 32));
+                _missedPairs.push_back((int)(key & 0xffffffff));
+            }
+        }
+        else
+        {
+            unsigned long long key = production[productionIndex++];
+            _lastReport._numExtraPairs++;
+            if (_extraPairs.size() < 2 * _MAX_KEPT_PAIRS)
+            {
+                _extraPairs.push_back((int)(key >> 32));
+                _extraPairs.push_back((int)(key & 0xffffffff));
+            }
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Compares every active particle's net force and collision count between the production
+    pass and the reference pass.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleCollisionValidator::CompareForces()
+{
+    double sumDeltaSqr = 0.0;
+    int numActive = 0;
+    for (size_t particleIndex = 0; particleIndex < _referenceParticles.size(); particleIndex++)
+    {
+        const Particle &reference = _referenceParticles[particleIndex];
+        const Particle &production = _productionParticles[particleIndex];
+        if (!reference._isActive)
+        {
+            continue;
+        }
+        numActive++;
+
+        glm::vec2 delta = production._netForce - reference._netForce;
+        float deltaLength = sqrtf(glm::dot(delta, delta));
+        float referenceLength = sqrtf(glm::dot(reference._netForce, reference._netForce));
+        sumDeltaSqr += (double)deltaLength * deltaLength;
+        _lastReport._maxForceDelta = std::max(_lastReport._maxForceDelta, deltaLength);
+        _lastReport._maxReferenceForce =
+            std::max(_lastReport._maxReferenceForce, referenceLength);
+
+        if (production._collisionCountThisFrame != reference._collisionCountThisFrame)
+        {
+            _lastReport._numCountMismatches++;
+        }
+    }
+
+    _lastReport._numActiveParticles = numActive;
+    _lastReport._rmsForceDelta = (numActive == 0) ? 0.0f : (float)sqrt(sumDeltaSqr / numActive);
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <vector>
+#include "Particle.h"
+#include "ParticleProperties.h"
+#include "ParticleQuadTree.h"
+#include "ParticleBroadphase.h"
+#include "ParticleCollisionEvents.h"
+#include "ParticleCollisionEngine.h"
+
+class ParticleTaskScheduler;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    What one validation found.  A pair is two particles that the collision kernel applied a
+    force between.  "Missed" pairs are ones that the exhaustive search found and the
+    production broadphase didn't, "extra" pairs are the other way around, and "duplicate"
+    pairs are ones that the production broadphase handed to the kernel more than once.
+
+    The force deltas are the lengths of the differences between each active particle's net
+    collision force from the two passes.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+struct ParticleCollisionValidationReport
+{
+    ParticleCollisionValidationReport() :
+        _numActiveParticles(0),
+        _numReferencePairs(0),
+        _numProductionPairs(0),
+        _numMissedPairs(0),
+        _numExtraPairs(0),
+        _numDuplicatePairs(0),
+        _numCountMismatches(0),
+        _pairListsComplete(true),
+        _maxForceDelta(0.0f),
+        _rmsForceDelta(0.0f),
+        _maxReferenceForce(0.0f),
+        _referenceSec(0.0),
+        _productionSec(0.0)
+    {
+    }
+
+    int _numActiveParticles;
+    int _numReferencePairs;
+    int _numProductionPairs;
+    int _numMissedPairs;
+    int _numExtraPairs;
+    int _numDuplicatePairs;
+
+    // active particles whose collision counts are different
+    int _numCountMismatches;
+
+    // false if either pass had more pairs than there was room to record
+    bool _pairListsComplete;
+
+    float _maxForceDelta;
+    float _rmsForceDelta;
+    float _maxReferenceForce;
+
+    double _referenceSec;
+    double _productionSec;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A debug mode that checks the optimized collision paths against an exhaustive one.  Every
+    so often, the simulation's state is copied and the particle-particle collisions are run
+    on the copies twice: once the way that production runs them (the tree, possibly forked
+    out, or whichever broadphase is selected), and once with every pair of active particles
+    checked by brute force (see ParticleBroadphase).  Both go through the same collision
+    engine and so the same kernel, so the only difference is which pairs get to the kernel.
+    The two are then compared pair by pair and particle by particle.
+
+    The pairs are collected with a collision event stream that keeps everything.  The
+    stream stages each thread's events separately, so the production pass reports its pairs
+    from the same forked-out traversal that gives its forces, and both passes' times include
+    recording the events.
+
+    The reference is slow on purpose, but the brute force search is tiled so that the
+    compiler vectorizes it and can be spread over a thread pool, so it stays usable for tens
+    of thousands of particles.
+
+    Not modeled:
+    - Periodic boundaries.  The production pass would need the ghosts.
+    - The contact solver, which doesn't use the collision engine.
+    - The tree's reuse between rebuilds.  The production tree is built fresh from the copy,
+    so a pair that a stale tree misses isn't caught here.
+
+    Note: The production pass rebuilds the tree from the copy, so the tree holds the copy's
+    indices afterwards.  They are the same as the particle collection's, and the simulation
+    rebuilds the tree on its next step anyway.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticleCollisionValidator
+{
+public:
+    ParticleCollisionValidator();
+    ~ParticleCollisionValidator();
+
+    void Init(IParticleCollisionEngine<2> *pCollisionEngine,
+        ParticleBroadphase<2> *pProductionBroadphase, unsigned int maxParticles,
+        ParticleTaskScheduler *pScheduler = 0);
+
+    // a validation passes if the pairs are the same and no particle's force is off by more
+    // than this fraction of the largest reference force
+    void SetForceTolerance(float fractionOfMaxForce);
+
+    bool Validate(const std::vector<Particle> &particleCollection,
+        const ParticlePropertyStorage &particleProperties, ParticleQuadTree &tree,
+        float deltaTimeSec);
+
+    const ParticleCollisionValidationReport &LastReport() const;
+    bool LastValidationPassed() const;
+    int NumValidations() const;
+    int NumFailedValidations() const;
+
+    // the first few of the last validation's mismatched pairs, two particle indices each
+    const std::vector<int> &MissedPairs() const;
+    const std::vector<int> &ExtraPairs() const;
+
+private:
+    ParticleCollisionValidator(const ParticleCollisionValidator &);
+    ParticleCollisionValidator &operator=(const ParticleCollisionValidator &);
+
+    void CopyParticles(const std::vector<Particle> &particleCollection,
+        std::vector<Particle> &copy) const;
+    bool CollectPairs(unsigned int numDroppedBefore,
+        std::vector<unsigned long long> &pairKeys);
+    void ComparePairs();
+    void CompareForces();
+
+    IParticleCollisionEngine<2> *_pCollisionEngine;
+    ParticleBroadphase<2> *_pProductionBroadphase;
+    ParticleBroadphase<2> _referenceBroadphase;
+    ParticleCollisionEvents *_pEvents;
+    std::vector<ParticleCollisionEvent> _drainedEvents;
+
+    std::vector<Particle> _productionParticles;
+    std::vector<Particle> _referenceParticles;
+
+    // each pair as (lower index << 32) | higher index, sorted
+    std::vector<unsigned long long> _referencePairKeys;
+    std::vector<unsigned long long> _productionPairKeys;
+
+    // room for this many pairs per particle in each pass
+    static const int _MAX_PAIRS_PER_PARTICLE = 16;
+
+    // only this many mismatched pairs are kept for looking at
+    static const int _MAX_KEPT_PAIRS = 64;
+    std::vector<int> _missedPairs;
+    std::vector<int> _extraPairs;
+
+    float _forceTolerance;
+    ParticleCollisionValidationReport _lastReport;
+    bool _lastValidationPassed;
+    int _numValidations;
+    int _numFailedValidations;
+};
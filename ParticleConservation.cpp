@@ -0,0 +1,340 @@
+#include "ParticleConservation.h"
+
+#include "glm/detail/func_geometric.hpp" // for glm::length
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Cleans up RecordStep(...).  A change relative to a scale, where a scale of 0 means that
+    any change at all is as bad as it gets.
+Parameters:
+    change  Self-explanatory.
+    scale   Self-explanatory.
+Returns:
+    A fraction.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+static float RelativeError(float change, float scale)
+{
+    if (scale > 0.0f)
+    {
+        return fabsf(change) / scale;
+    }
+
+    return (change != 0.0f) ? 1.0f : 0.0f;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Ensures that the object starts object with initialized values.
+
+    The tolerances are for float rounding over tens of thousands of particles, with room to
+    spare.  A pair whose forces didn't both make it moves the momentum by that pair's share,
+    which is far above them.
+Parameters:
+    historyCapacity     How many steps are kept, and how far back the drift is summed.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleConservationMonitor::ParticleConservationMonitor(int historyCapacity) :
+    _history((historyCapacity > 0) ? historyCapacity : 1),
+    _newestIndex(-1),
+    _numRecords(0),
+    _driftX(0.0),
+    _driftY(0.0),
+    _momentumDrift(0.0f),
+    _momentumDriftIsOver(false),
+    _massTolerance(1e-5f),
+    _momentumTolerance(1e-7f),
+    _momentumDriftTolerance(1e-6f),
+    _energyGainTolerance(0.5f),
+    _hasPreviousTotals(false),
+    _previousNumForcesDropped(0),
+    _stepNumber(0),
+    _numStepsChecked(0),
+    _numClosedSteps(0),
+    _numAlarmedSteps(0),
+    _maxMomentumError(0.0f)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.
+Parameters:
+    tolerance   The mass change during a step, as a fraction of the mass.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleConservationMonitor::SetMassTolerance(float tolerance)
+{
+    _massTolerance = tolerance;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.
+Parameters:
+    tolerance   The momentum change during a closed step, as a fraction of the momentum
+                scale (see ParticleConservationSums).
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleConservationMonitor::SetMomentumTolerance(float tolerance)
+{
+    _momentumTolerance = tolerance;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.
+Parameters:
+    tolerance   The closed steps' summed momentum changes over the history, as a fraction of
+                the momentum scale.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleConservationMonitor::SetMomentumDriftTolerance(float tolerance)
+{
+    _momentumDriftTolerance = tolerance;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.
+Parameters:
+    tolerance   The kinetic energy gained during a closed step, as a fraction of the kinetic
+                energy before it.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleConservationMonitor::SetEnergyGainTolerance(float tolerance)
+{
+    _energyGainTolerance = tolerance;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Compares what the updater found at the start of this step with what it left at the
+    start of the last one, which is what the last step did, and adds a record to the
+    history.  The first call only remembers the totals.
+Parameters:
+    totals                  From ParticleUpdater::ConservationTotals() after the step.
+    previousStepWasClosed   True if nothing but the particles pushed on the particles during
+                            the step before this one.  A step that disturbed a sleeping
+                            particle or that followed one that dropped a particle's force
+                            isn't closed either, but the totals know about those.
+Returns:
+    The step's alarms (see ParticleConservationAlarm).
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleConservationMonitor::RecordStep(const ParticleConservationTotals &totals,
+    bool previousStepWasClosed)
+{
+    const ParticleConservationSums &asFound = totals._asFound;
+    ParticleConservationRecord record;
+    record._stepNumber = _stepNumber++;
+    record._numParticles = asFound._numParticles;
+    record._mass = (float)asFound._mass.Value();
+    record._momentum = glm::vec2(asFound._momentumX.Value(), asFound._momentumY.Value());
+    record._kineticEnergy = (float)asFound._kineticEnergy.Value();
+    record._momentumScale = (float)asFound._momentumScale.Value();
+    record._isClosed = previousStepWasClosed && (totals._numDisturbedSleepers == 0) &&
+        (_previousNumForcesDropped == 0);
+
+    if (_hasPreviousTotals)
+    {
+        _numStepsChecked++;
+        const ParticleConservationSums &before = _previousAfterUpdate;
+        // Note: The differences are taken in double so that the totals' low bits count.
+        double massBefore = before._mass.Value();
+        record._massError = RelativeError((float)(asFound._mass.Value() - massBefore),
+            (float)massBefore);
+        if (record._massError > _massTolerance)
+        {
+            record._alarms |= CONSERVATION_ALARM_MASS;
+        }
+
+        // either side's scale will do, but a particle that was stopped by a wall has none
+        // afterwards, so take the larger
+        float momentumScaleBefore = (float)before._momentumScale.Value();
+        float momentumScale = (record._momentumScale > momentumScaleBefore) ?
+            record._momentumScale : momentumScaleBefore;
+        record._momentumChange = glm::vec2(
+            asFound._momentumX.Value() - before._momentumX.Value(),
+            asFound._momentumY.Value() - before._momentumY.Value());
+        record._momentumError = RelativeError(glm::length(record._momentumChange),
+            momentumScale);
+
+        double kineticEnergyBefore = before._kineticEnergy.Value();
+        record._energyGain = (kineticEnergyBefore > 0.0) ? (float)(
+            (asFound._kineticEnergy.Value() - kineticEnergyBefore) / kineticEnergyBefore) : 0.0f;
+
+        if (record._isClosed)
+        {
+            _numClosedSteps++;
+            _maxMomentumError = (record._momentumError > _maxMomentumError) ?
+                record._momentumError : _maxMomentumError;
+            if (record._momentumError > _momentumTolerance)
+            {
+                record._alarms |= CONSERVATION_ALARM_MOMENTUM;
+            }
+            if (record._energyGain > _energyGainTolerance)
+            {
+                record._alarms |= CONSERVATION_ALARM_ENERGY;
+            }
+        }
+    }
+
+    // the oldest record makes room, and its momentum change leaves the drift
+    int capacity = (int)_history.size();
+    _newestIndex = (_newestIndex + 1) % capacity;
+    if (_numRecords == capacity)
+    {
+        const ParticleConservationRecord &oldest = _history[_newestIndex];
+        if (oldest._isClosed)
+        {
+            _driftX -= oldest._momentumChange.x;
+            _driftY -= oldest._momentumChange.y;
+        }
+    }
+    else
+    {
+        _numRecords++;
+    }
+
+    if (record._isClosed)
+    {
+        _driftX += record._momentumChange.x;
+        _driftY += record._momentumChange.y;
+    }
+    _momentumDrift = RelativeError((float)sqrt((_driftX * _driftX) + (_driftY * _driftY)),
+        record._momentumScale);
+    if (record._isClosed)
+    {
+        bool momentumDriftIsOver = (_momentumDrift > _momentumDriftTolerance);
+        if (momentumDriftIsOver && !_momentumDriftIsOver)
+        {
+            record._alarms |= CONSERVATION_ALARM_MOMENTUM_DRIFT;
+        }
+        _momentumDriftIsOver = momentumDriftIsOver;
+    }
+
+    if (record._alarms != CONSERVATION_ALARM_NONE)
+    {
+        _numAlarmedSteps++;
+    }
+    _history[_newestIndex] = record;
+
+    _previousAfterUpdate = totals._afterUpdate;
+    _previousNumForcesDropped = totals._numForcesDropped;
+    _hasPreviousTotals = true;
+    return record._alarms;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many steps are in the history.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleConservationMonitor::NumRecords() const
+{
+    return _numRecords;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Looks up a step in the history.
+Parameters:
+    stepsAgo    0 for the last RecordStep(...).  Must be less than NumRecords().
+Returns:
+    A const reference to the step's record.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+const ParticleConservationRecord &ParticleConservationMonitor::Record(int stepsAgo) const
+{
+    int capacity = (int)_history.size();
+    return _history[(_newestIndex - stepsAgo + capacity) % capacity];
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    The length of the closed steps' momentum changes in the history, summed as vectors, as a
+    fraction of the latest momentum scale.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+float ParticleConservationMonitor::MomentumDrift() const
+{
+    return _momentumDrift;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many steps have been compared with the step before them.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleConservationMonitor::NumStepsChecked() const
+{
+    return _numStepsChecked;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many of the checked steps had their momentum checked.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleConservationMonitor::NumClosedSteps() const
+{
+    return _numClosedSteps;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many steps have tripped at least one alarm.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleConservationMonitor::NumAlarmedSteps() const
+{
+    return _numAlarmedSteps;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    The worst closed step's momentum error so far.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+float ParticleConservationMonitor::MaxMomentumError() const
+{
+    return _maxMomentumError;
+}
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <vector>
+#include <math.h>
+#include "glm/vec2.hpp"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A running sum that keeps the low bits that a plain float sum would lose (Kahan
+    summation).  Each add is four float operations and no branches, so a loop that fills a
+    few of these stays cheap.  Two sums from different ranges of particles are merged
+    without losing either one's correction, so ranges that were summed separately (or on
+    separate threads) combine pairwise instead of one particle at a time.
+
+    Note: Relies on the compiler not reassociating floats (MSVC's default /fp:precise).
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+struct CompensatedSum
+{
+    CompensatedSum() :
+        _sum(0.0f),
+        _compensation(0.0f)
+    {
+    }
+
+    void Add(float value)
+    {
+        float corrected = value - _compensation;
+        float newSum = _sum + corrected;
+        _compensation = (newSum - _sum) - corrected;
+        _sum = newSum;
+    }
+
+    void Merge(const CompensatedSum &other)
+    {
+        _compensation += other._compensation;
+        Add(other._sum);
+    }
+
+    // Note: Double so that the correction isn't rounded away again.
+    double Value() const
+    {
+        return (double)_sum - (double)_compensation;
+    }
+
+    float _sum;
+
+    // what the last add lost, negated
+    float _compensation;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The conserved quantities of a set of active particles.  The momentum scale is the sum of
+    every particle's momentum magnitude, which is what a momentum error is measured against,
+    since the total momentum of a swirling crowd can be close to 0.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+struct ParticleConservationSums
+{
+    ParticleConservationSums() :
+        _numParticles(0)
+    {
+    }
+
+    void AddParticle(float mass, const glm::vec2 &velocity)
+    {
+        float speedSqr = (velocity.x * velocity.x) + (velocity.y * velocity.y);
+        _mass.Add(mass);
+        _momentumX.Add(mass * velocity.x);
+        _momentumY.Add(mass * velocity.y);
+        _kineticEnergy.Add(0.5f * mass * speedSqr);
+        _momentumScale.Add(mass * sqrtf(speedSqr));
+        _numParticles++;
+    }
+
+    // a particle at rest only has mass
+    void AddRestingParticle(float mass)
+    {
+        _mass.Add(mass);
+        _numParticles++;
+    }
+
+    void Merge(const ParticleConservationSums &other)
+    {
+        _mass.Merge(other._mass);
+        _momentumX.Merge(other._momentumX);
+        _momentumY.Merge(other._momentumY);
+        _kineticEnergy.Merge(other._kineticEnergy);
+        _momentumScale.Merge(other._momentumScale);
+        _numParticles += other._numParticles;
+    }
+
+    CompensatedSum _mass;
+    CompensatedSum _momentumX;
+    CompensatedSum _momentumY;
+    CompensatedSum _kineticEnergy;
+    CompensatedSum _momentumScale;
+    int _numParticles;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    What one ParticleUpdater::Update(...) measured.  The particles are summed twice in the
+    same pass: as the update found them, which is how the last step left them, and after the
+    update emitted, removed, and put particles to sleep.  The difference between one update's
+    "as found" and the previous update's "after update" is then only what the step between
+    them did, without any of the updater's bookkeeping mixed in.
+
+    Two things make the step after an update lose momentum that the particles didn't lose
+    to each other, so the updater counts them:
+    - A sleeping particle that something collided with doesn't move (the integrator skips
+    it) but the particle that hit it does.  The updater finds those when it wakes them up.
+    - A particle that goes out of bounds, or that is put to sleep, loses its half of a pair's
+    force, and the integrator still applies the other half.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+struct ParticleConservationTotals
+{
+    ParticleConservationTotals() :
+        _numDisturbedSleepers(0),
+        _numForcesDropped(0)
+    {
+    }
+
+    void Merge(const ParticleConservationTotals &other)
+    {
+        _asFound.Merge(other._asFound);
+        _afterUpdate.Merge(other._afterUpdate);
+        _numDisturbedSleepers += other._numDisturbedSleepers;
+        _numForcesDropped += other._numForcesDropped;
+    }
+
+    ParticleConservationSums _asFound;
+    ParticleConservationSums _afterUpdate;
+    int _numDisturbedSleepers;
+    int _numForcesDropped;
+};
+
+// which checks a step failed (see ParticleConservationMonitor)
+enum ParticleConservationAlarm
+{
+    CONSERVATION_ALARM_NONE = 0,
+    CONSERVATION_ALARM_MASS = 1,
+    CONSERVATION_ALARM_MOMENTUM = 2,
+    CONSERVATION_ALARM_MOMENTUM_DRIFT = 4,
+    CONSERVATION_ALARM_ENERGY = 8
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    One step's totals and how far they moved during the step.  The errors are relative: the
+    mass change to the mass, the momentum change to the momentum scale, and the kinetic
+    energy gain to the kinetic energy before the step.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+struct ParticleConservationRecord
+{
+    ParticleConservationRecord() :
+        _stepNumber(0),
+        _numParticles(0),
+        _mass(0.0f),
+        _kineticEnergy(0.0f),
+        _momentumScale(0.0f),
+        _massError(0.0f),
+        _momentumError(0.0f),
+        _energyGain(0.0f),
+        _isClosed(false),
+        _alarms(CONSERVATION_ALARM_NONE)
+    {
+    }
+
+    unsigned int _stepNumber;
+    int _numParticles;
+    float _mass;
+    glm::vec2 _momentum;
+    float _kineticEnergy;
+    float _momentumScale;
+
+    // during the step
+    glm::vec2 _momentumChange;
+    float _massError;
+    float _momentumError;
+    float _energyGain;
+
+    // false if something outside the particles (walls, force fields, the updater) pushed on
+    // them
+    bool _isClosed;
+    int _alarms;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Checks, step by step, that the simulation conserves what it should.  It is meant to
+    catch a parallel or vectorized path that drops or double-counts a force, so it only
+    looks at the totals that the updater already gathers and costs nothing per particle.
+
+    - Mass never changes during a step.  Emitted and removed particles are the updater's
+    doing and aren't part of the step (see ParticleConservationTotals).
+    - In a closed step, one where only the particles pushed on each other, momentum doesn't
+    change.  The collision kernel applies equal and opposite forces, so anything beyond float
+    rounding means that a pair's forces didn't both make it.
+    - Momentum errors that are each too small to trip the alarm can still add up in the same
+    direction, so the closed steps' momentum changes are also summed over the history and
+    checked against a looser tolerance.  That alarm goes off when the drift goes over, not
+    on every step that it stays over.
+    - The springy collisions store and release energy, so kinetic energy isn't conserved,
+    but a closed step that adds a lot of it has blown up.
+
+    The last so many steps are kept for anyone who wants to look at them.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticleConservationMonitor
+{
+public:
+    ParticleConservationMonitor(int historyCapacity = 600);
+
+    // Note: All fractions.
+    void SetMassTolerance(float tolerance);
+    void SetMomentumTolerance(float tolerance);
+    void SetMomentumDriftTolerance(float tolerance);
+    void SetEnergyGainTolerance(float tolerance);
+
+    // called after every step with the updater's totals, which describe the step before it,
+    // and whether that step was closed
+    int RecordStep(const ParticleConservationTotals &totals, bool previousStepWasClosed);
+
+    int NumRecords() const;
+    const ParticleConservationRecord &Record(int stepsAgo) const;
+    float MomentumDrift() const;
+
+    int NumStepsChecked() const;
+    int NumClosedSteps() const;
+    int NumAlarmedSteps() const;
+    float MaxMomentumError() const;
+
+private:
+    std::vector<ParticleConservationRecord> _history;
+    int _newestIndex;
+    int _numRecords;
+
+    // the closed steps' momentum changes that are in the history
+    // Note: Double so that taking a step back out of the sum leaves nothing behind.
+    double _driftX;
+    double _driftY;
+    float _momentumDrift;
+    bool _momentumDriftIsOver;
+
+    float _massTolerance;
+    float _momentumTolerance;
+    float _momentumDriftTolerance;
+    float _energyGainTolerance;
+
+    bool _hasPreviousTotals;
+    ParticleConservationSums _previousAfterUpdate;
+    int _previousNumForcesDropped;
+    unsigned int _stepNumber;
+
+    int _numStepsChecked;
+    int _numClosedSteps;
+    int _numAlarmedSteps;
+    float _maxMomentumError;
+};
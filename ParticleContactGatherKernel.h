@@ -0,0 +1,147 @@
+#pragma once
+
+#include <vector>
+#include "Particle.h"
+#include "ParticleProperties.h"
+#include "glm/vec2.hpp"
+#include "glm/detail/func_geometric.hpp" // for glm::dot
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A pair of particles that are touching or nearly touching, as far as the contact solver is 
+    concerned.  The inverse masses are 0 for sleeping particles, so the solver never moves 
+    them.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+struct ParticleContact
+{
+    // lower particle index in the high 32 bits; used to match up contacts between frames
+    unsigned long long _key;
+    int _p1Index;
+    int _p2Index;
+    float _contactDistance;
+    float _inverseMass1;
+    float _inverseMass2;
+
+    // the total correction (distance / (w1 + w2)) that this contact has asked for this frame
+    float _accumulatedCorrection;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The tree traversal's kernel for gathering contacts instead of applying forces.  Any pair 
+    that is within the pair's contact distance, plus a small margin for particles that are 
+    about to touch, is recorded.  It follows the same sleep rules as ParticleCollisionKernel.
+
+    Like that kernel, it is defined here so that it is inlined into the tree traversal.  Only 
+    2D is instantiated (see ParticleQuadTree.cpp).
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<typename PROPERTIES>
+class ParticleContactGatherKernel
+{
+public:
+    ParticleContactGatherKernel(const PROPERTIES &properties, 
+        std::vector<ParticleContact> *putContactsHere);
+
+    float NeighborSearchDistance() const;
+    bool CollideP1WithP2(int p1Index, int p2Index, std::vector<Particle> &particleCollection) const;
+
+private:
+    const PROPERTIES &_properties;
+    std::vector<ParticleContact> *_pContacts;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.
+Parameters:
+    properties          Particle masses and radii.  Must outlive the kernel.
+    putContactsHere     Contacts are appended to this.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<typename PROPERTIES>
+inline ParticleContactGatherKernel<PROPERTIES>::ParticleContactGatherKernel(
+    const PROPERTIES &properties, std::vector<ParticleContact> *putContactsHere) :
+    _properties(properties),
+    _pContacts(putContactsHere)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The furthest apart that two particles can be and still make a contact, margin included.
+Parameters: None
+Returns:
+    See description.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<typename PROPERTIES>
+inline float ParticleContactGatherKernel<PROPERTIES>::NeighborSearchDistance() const
+{
+    return _properties.MaxInteractionDistance();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Records a contact if the two particles are close enough.  Like the collision kernel, pairs 
+    of sleeping particles are skipped, and a particle can't stay at rest while something it 
+    touches is moving.
+Parameters:
+    p1Index, p2Index    Self-explanatory.
+    particleCollection  Self-explanatory.
+Returns:
+    True if a contact was recorded.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<typename PROPERTIES>
+inline bool ParticleContactGatherKernel<PROPERTIES>::CollideP1WithP2(int p1Index, int p2Index, 
+    std::vector<Particle> &particleCollection) const
+{
+    Particle &p1 = particleCollection[p1Index];
+    Particle &p2 = particleCollection[p2Index];
+    if (p1._isAsleep && p2._isAsleep)
+    {
+        return false;
+    }
+
+    glm::vec2 p1ToP2 = p2._position - p1._position;
+    float distanceBetweenSqr = glm::dot(p1ToP2, p1ToP2);
+    if (distanceBetweenSqr >= _properties.InteractionDistanceSqr(p1Index, p2Index))
+    {
+        return false;
+    }
+
+    const ParticlePairProperties &pair = _properties.PairProperties(p1Index, p2Index);
+    if (pair._interactionCoefficient == 0.0f)
+    {
+        // these two species pass through each other
+        return false;
+    }
+
+    if (p1._framesAtRest == 0)
+    {
+        p2._framesAtRest = 0;
+    }
+    if (p2._framesAtRest == 0)
+    {
+        p1._framesAtRest = 0;
+    }
+
+    ParticleContact contact;
+    int lowIndex = (p1Index < p2Index) ? p1Index : p2Index;
+    int highIndex = (p1Index < p2Index) ? p2Index : p1Index;
+    contact._key = ((unsigned long long)lowIndex << 32) | (unsigned long long)highIndex;
+    contact._p1Index = p1Index;
+    contact._p2Index = p2Index;
+    contact._contactDistance = pair._contactDistance;
+    contact._inverseMass1 = p1._isAsleep ? 0.0f : _properties.InverseMass(p1Index);
+    contact._inverseMass2 = p2._isAsleep ? 0.0f : _properties.InverseMass(p2Index);
+    contact._accumulatedCorrection = 0.0f;
+    _pContacts->push_back(contact);
+    return true;
+}
@@ -0,0 +1,541 @@
+#include "ParticleContactSolver.h"
+
+#include <algorithm>
+#include <math.h>
+#include "glm/detail/func_geometric.hpp" // for glm::dot
+#include "ParticlePropertyAccess.h"
+#include "ParticleTaskScheduler.h"
+
+const float ParticleContactSolver::_CONTACT_MARGIN_IN_CONTACT_DISTANCES = 0.1f;
+
+// the contact list is sorted by key so that it can be matched up with last frame's
+static bool ContactKeyLessThan(const ParticleContact &left, const ParticleContact &right)
+{
+    return left._key < right._key;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Ensures that the object starts object with initialized values.
+Parameters:
+    numIterations       Jacobi iterations per solve, not counting the warm start.  At least 1.
+    relaxation          Scales each particle's averaged correction.  1 is the plain average.  
+                        Somewhat more than 1 converges faster in dense piles.
+    warmStartFraction   How much of last frame's correction a contact starts with.  0 disables 
+                        warm starting.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleContactSolver::ParticleContactSolver(const int numIterations, const float relaxation, 
+    const float warmStartFraction) :
+    _numIterations((numIterations < 1) ? 1 : numIterations),
+    _relaxation(relaxation),
+    _warmStartFraction(warmStartFraction),
+    _threadCorrections(1),
+    _pScheduler(0),
+    _pJoinCounter(0),
+    _pParticleCollection(0),
+    _isWarmStartIteration(false),
+    _numWarmStartedContacts(0),
+    _maxOverlap(0.0f)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Pushes apart every overlapping pair of active particles and adjusts their velocities to 
+    match.  Call it after the integrator has moved the particles.
+Parameters:
+    tree                Must contain the active particles.
+    searchPadding       The furthest that any particle has moved since the tree was built.
+    particleCollection  Self-explanatory.
+    particleProperties  Self-explanatory.
+    deltaTimeSec        The step that the particles were just moved by.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleContactSolver::Solve(const ParticleQuadTree &tree, float searchPadding, 
+    std::vector<Particle> &particleCollection, 
+    const ParticlePropertyStorage &particleProperties, float deltaTimeSec)
+{
+    _contacts.clear();
+    float interactionRange = InteractionRangeInContactDistances();
+    if (particleProperties.IsUniform())
+    {
+        UniformParticlePropertyAccess properties(particleProperties, interactionRange);
+        GatherContacts(properties, tree, searchPadding, particleCollection);
+    }
+    else
+    {
+        SpeciesParticlePropertyAccess properties(particleProperties, interactionRange);
+        GatherContacts(properties, tree, searchPadding, particleCollection);
+    }
+    std::sort(_contacts.begin(), _contacts.end(), ContactKeyLessThan);
+
+    // every particle in a contact starts with no correction
+    size_t numParticles = particleCollection.size();
+    for (size_t threadIndex = 0; threadIndex < _threadCorrections.size(); threadIndex++)
+    {
+        ThreadCorrections &thread = _threadCorrections[threadIndex];
+        if (thread._corrections.size() != numParticles)
+        {
+            thread._corrections.assign(numParticles, glm::vec2());
+            thread._correctionCounts.assign(numParticles, 0);
+            thread._touchCounts.assign(numParticles, 0);
+        }
+    }
+    _totalCorrections.resize(numParticles);
+
+    // use the calling thread's counts as a "seen" flag, and put them back to 0 afterwards
+    std::vector<int> &isSeen = _threadCorrections[0]._correctionCounts;
+    _contactParticleIndices.clear();
+    for (size_t contactCount = 0; contactCount < _contacts.size(); contactCount++)
+    {
+        int particleIndices[2] = { _contacts[contactCount]._p1Index, _contacts[contactCount]._p2Index };
+        for (int pairCount = 0; pairCount < 2; pairCount++)
+        {
+            int particleIndex = particleIndices[pairCount];
+            if (isSeen[particleIndex] == 0)
+            {
+                isSeen[particleIndex] = 1;
+                _totalCorrections[particleIndex] = glm::vec2();
+                _contactParticleIndices.push_back(particleIndex);
+            }
+        }
+    }
+    for (size_t particleCount = 0; particleCount < _contactParticleIndices.size(); particleCount++)
+    {
+        isSeen[_contactParticleIndices[particleCount]] = 0;
+    }
+
+    WarmStart();
+    RunIteration(true, particleCollection);
+    for (int iterationCount = 0; iterationCount < _numIterations; iterationCount++)
+    {
+        RunIteration(false, particleCollection);
+    }
+
+    // the velocity that it took to get to the corrected position
+    float inverseDeltaTime = 1.0f / deltaTimeSec;
+    for (size_t particleCount = 0; particleCount < _contactParticleIndices.size(); particleCount++)
+    {
+        int particleIndex = _contactParticleIndices[particleCount];
+        particleCollection[particleIndex]._velocity += 
+            _totalCorrections[particleIndex] * inverseDeltaTime;
+    }
+
+    SaveContactCache();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets the pool that the iterations run on.  Each thread that can run a job gets its own 
+    correction sums.
+Parameters:
+    pScheduler  Self-explanatory.  0 runs the iterations on the calling thread.  Must outlive 
+                its use.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleContactSolver::SetScheduler(ParticleTaskScheduler *pScheduler)
+{
+    _pScheduler = pScheduler;
+
+    // Solve(...) sizes the new threads' sums
+    int numThreads = (pScheduler != 0) ? (pScheduler->NumWorkerThreads() + 1) : 1;
+    _threadCorrections.resize(numThreads);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Pairs that are slightly apart are contacts too, so that a contact isn't lost and found 
+    again as the pair jiggles.
+Parameters: None
+Returns:
+    How far apart, in contact distances, a pair can be and still be a contact.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+float ParticleContactSolver::InteractionRangeInContactDistances() const
+{
+    return 1.0f + _CONTACT_MARGIN_IN_CONTACT_DISTANCES;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many contacts the last Solve(...) worked on.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleContactSolver::NumContactsLastSolve() const
+{
+    // the last solve's contacts are the cache now
+    return (int)_contactCache.size();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many of the last Solve(...)'s contacts also existed the solve before.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleContactSolver::NumWarmStartedContactsLastSolve() const
+{
+    return _numWarmStartedContacts;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.  If this stays large, then more iterations are needed.
+Parameters: None
+Returns:
+    The largest overlap that the last iteration of the last Solve(...) found.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+float ParticleContactSolver::MaxOverlapLastSolve() const
+{
+    return _maxOverlap;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The particle collection was reordered since the last Solve(...), so move the warm start 
+    cache's contacts to the particles' new slots and sort it again.  Contacts with periodic 
+    ghosts are dropped, since the ghosts are numbered differently once the particles that they 
+    are copied from have moved.
+Parameters:
+    newIndexOfOld   For each slot before the reorder, the slot that its particle is in now.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleContactSolver::RemapParticleIndices(const std::vector<int> &newIndexOfOld)
+{
+    int numParticles = (int)newIndexOfOld.size();
+    size_t numKept = 0;
+    for (size_t contactCount = 0; contactCount < _contactCache.size(); contactCount++)
+    {
+        ParticleContact contact = _contactCache[contactCount];
+        if (contact._p1Index >= numParticles || contact._p2Index >= numParticles)
+        {
+            continue;
+        }
+
+        contact._p1Index = newIndexOfOld[contact._p1Index];
+        contact._p2Index = newIndexOfOld[contact._p2Index];
+        int lowIndex = (contact._p1Index < contact._p2Index) ? contact._p1Index : contact._p2Index;
+        int highIndex = (contact._p1Index < contact._p2Index) ? contact._p2Index : contact._p1Index;
+        contact._key = ((unsigned long long)lowIndex << 32) | (unsigned long long)highIndex;
+        _contactCache[numKept++] = contact;
+    }
+    _contactCache.resize(numKept);
+    std::sort(_contactCache.begin(), _contactCache.end(), ContactKeyLessThan);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs the tree traversal with the contact-gathering kernel.
+Parameters:
+    properties          One of the accessors in ParticlePropertyAccess.h.
+    tree                Self-explanatory.
+    searchPadding       Self-explanatory.
+    particleCollection  Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<typename PROPERTIES>
+void ParticleContactSolver::GatherContacts(const PROPERTIES &properties, 
+    const ParticleQuadTree &tree, float searchPadding, std::vector<Particle> &particleCollection)
+{
+    ParticleContactGatherKernel<PROPERTIES> kernel(properties, &_contacts);
+    tree.DoTheParticleParticleCollisions(kernel, particleCollection, searchPadding);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Walks this frame's contacts and last frame's cache, which are both sorted by key, and 
+    gives each contact that was in the cache a fraction of its old correction.  RunIteration(...) 
+    caps it at the current overlap.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleContactSolver::WarmStart()
+{
+    _numWarmStartedContacts = 0;
+    if (_warmStartFraction <= 0.0f)
+    {
+        return;
+    }
+
+    size_t cacheIndex = 0;
+    for (size_t contactCount = 0; contactCount < _contacts.size(); contactCount++)
+    {
+        ParticleContact &contact = _contacts[contactCount];
+        while (cacheIndex < _contactCache.size() && _contactCache[cacheIndex]._key < contact._key)
+        {
+            cacheIndex++;
+        }
+
+        if (cacheIndex < _contactCache.size() && _contactCache[cacheIndex]._key == contact._key)
+        {
+            contact._accumulatedCorrection = 
+                _warmStartFraction * _contactCache[cacheIndex]._accumulatedCorrection;
+            _numWarmStartedContacts++;
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    One Jacobi iteration: every contact works out its correction from the current positions, 
+    the corrections are summed per particle, and then every particle moves by its average.
+    
+    The warm start is the same thing, except that each contact applies the correction that 
+    WarmStart(...) gave it (if it still overlaps) instead of working out a new one.
+
+    With a pool, the contacts are forked out and joined, and then the particles are.  Each 
+    round's jobs only write what belongs to their own range or their own thread, and the 
+    join is what keeps the second round from reading positions before the first round is 
+    done with them.
+Parameters:
+    isWarmStart         Self-explanatory.
+    particleCollection  Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleContactSolver::RunIteration(bool isWarmStart, std::vector<Particle> &particleCollection)
+{
+    _pParticleCollection = &particleCollection;
+    _isWarmStartIteration = isWarmStart;
+    for (size_t threadIndex = 0; threadIndex < _threadCorrections.size(); threadIndex++)
+    {
+        _threadCorrections[threadIndex]._maxOverlap = 0.0f;
+    }
+
+    int numContacts = (int)_contacts.size();
+    int numContactParticles = (int)_contactParticleIndices.size();
+    bool isForked = (_pScheduler != 0) && (_pScheduler->NumWorkerThreads() > 0);
+    if (isForked)
+    {
+        std::atomic<int> joinCounter(0);
+        _pJoinCounter = &joinCounter;
+        _pScheduler->Spawn(joinCounter, &SolveContactsJob, this, 0, numContacts);
+        _pScheduler->Wait(joinCounter);
+        _pScheduler->Spawn(joinCounter, &ApplyCorrectionsJob, this, 0, numContactParticles);
+        _pScheduler->Wait(joinCounter);
+        _pJoinCounter = 0;
+    }
+    else
+    {
+        SolveContacts(0, numContacts);
+        ApplyCorrections(0, numContactParticles);
+    }
+
+    float maxOverlap = 0.0f;
+    for (size_t threadIndex = 0; threadIndex < _threadCorrections.size(); threadIndex++)
+    {
+        float threadMaxOverlap = _threadCorrections[threadIndex]._maxOverlap;
+        maxOverlap = (threadMaxOverlap > maxOverlap) ? threadMaxOverlap : maxOverlap;
+    }
+    _maxOverlap = maxOverlap;
+    _pParticleCollection = 0;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The first half of an iteration for a range of contacts.  Each contact works out its 
+    correction from the positions that the iteration started with and adds it to the calling 
+    thread's sums.  Nothing moves yet.
+Parameters:
+    beginContact, endContact    The range of contacts.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleContactSolver::SolveContacts(int beginContact, int endContact)
+{
+    // Note: A thread from a bigger pool than the one that this was set up for would share a
+    // thread's sums, so it gets 0's instead, which belongs to the calling thread.  That can 
+    // only happen if SetScheduler(...) was given a different pool than the one running this.
+    int threadIndex = ParticleTaskScheduler::CurrentWorkerIndex();
+    if (threadIndex >= (int)_threadCorrections.size())
+    {
+        threadIndex = 0;
+    }
+    ThreadCorrections &thread = _threadCorrections[threadIndex];
+
+    const std::vector<Particle> &particleCollection = *_pParticleCollection;
+    float maxOverlap = thread._maxOverlap;
+    for (int contactCount = beginContact; contactCount < endContact; contactCount++)
+    {
+        ParticleContact &contact = _contacts[contactCount];
+        float inverseMassSum = contact._inverseMass1 + contact._inverseMass2;
+        const Particle &p1 = particleCollection[contact._p1Index];
+        const Particle &p2 = particleCollection[contact._p2Index];
+        glm::vec2 p1ToP2 = p2._position - p1._position;
+        float distanceSqr = glm::dot(p1ToP2, p1ToP2);
+        if (distanceSqr >= (contact._contactDistance * contact._contactDistance) || 
+            distanceSqr == 0.0f || inverseMassSum == 0.0f)
+        {
+            // not touching, no line of contact, or neither can move
+            continue;
+        }
+
+        float distance = sqrtf(distanceSqr);
+        float overlap = contact._contactDistance - distance;
+        maxOverlap = (overlap > maxOverlap) ? overlap : maxOverlap;
+
+        float correction = overlap / inverseMassSum;
+        if (_isWarmStartIteration)
+        {
+            // the warm start happens once per solve, so count the touch here
+            thread._touchCounts[contact._p1Index]++;
+            thread._touchCounts[contact._p2Index]++;
+
+            correction = (contact._accumulatedCorrection < correction) ? 
+                contact._accumulatedCorrection : correction;
+            contact._accumulatedCorrection = correction;
+            if (correction == 0.0f)
+            {
+                // new contact; don't water down the other contacts' averages
+                continue;
+            }
+        }
+        else
+        {
+            contact._accumulatedCorrection += correction;
+        }
+
+        glm::vec2 normal = p1ToP2 / distance;
+        thread._corrections[contact._p1Index] -= normal * (correction * contact._inverseMass1);
+        thread._corrections[contact._p2Index] += normal * (correction * contact._inverseMass2);
+        thread._correctionCounts[contact._p1Index]++;
+        thread._correctionCounts[contact._p2Index]++;
+    }
+    thread._maxOverlap = maxOverlap;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The second half of an iteration for a range of the particles that are in a contact.  
+    Adds up each particle's sums from every thread, in thread order, moves it by the average, 
+    and puts the sums back to 0 for the next iteration.
+Parameters:
+    beginParticle, endParticle  The range of _contactParticleIndices.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleContactSolver::ApplyCorrections(int beginParticle, int endParticle)
+{
+    std::vector<Particle> &particleCollection = *_pParticleCollection;
+    int numThreads = (int)_threadCorrections.size();
+    for (int particleCount = beginParticle; particleCount < endParticle; particleCount++)
+    {
+        int particleIndex = _contactParticleIndices[particleCount];
+        glm::vec2 correctionSum;
+        int count = 0;
+        int numTouches = 0;
+        for (int threadIndex = 0; threadIndex < numThreads; threadIndex++)
+        {
+            ThreadCorrections &thread = _threadCorrections[threadIndex];
+            correctionSum += thread._corrections[particleIndex];
+            count += thread._correctionCounts[particleIndex];
+            numTouches += thread._touchCounts[particleIndex];
+            thread._corrections[particleIndex] = glm::vec2();
+            thread._correctionCounts[particleIndex] = 0;
+            thread._touchCounts[particleIndex] = 0;
+        }
+
+        Particle &p = particleCollection[particleIndex];
+        p._collisionCountThisFrame += numTouches;
+        if (count == 0)
+        {
+            continue;
+        }
+
+        glm::vec2 averageCorrection = correctionSum * (_relaxation / count);
+        p._position += averageCorrection;
+        _totalCorrections[particleIndex] += averageCorrection;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    One forked job of an iteration's contacts.  Splits its range in half, spawning the back 
+    half, until it is down to a few hundred contacts, then solves them.
+Parameters:
+    context     The solver.
+    begin, end  The range of contacts.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleContactSolver::SolveContactsJob(void *context, int begin, int end)
+{
+    ParticleContactSolver *pSolver = (ParticleContactSolver *)context;
+    while (end - begin > _ITEMS_PER_JOB)
+    {
+        int middle = begin + (end - begin) / 2;
+        pSolver->_pScheduler->Spawn(*pSolver->_pJoinCounter, &SolveContactsJob, context, 
+            middle, end);
+        end = middle;
+    }
+
+    pSolver->SolveContacts(begin, end);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    One forked job of an iteration's corrections.  Splits its range in half, spawning the 
+    back half, until it is down to a few hundred particles, then moves them.
+Parameters:
+    context     The solver.
+    begin, end  The range of _contactParticleIndices.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleContactSolver::ApplyCorrectionsJob(void *context, int begin, int end)
+{
+    ParticleContactSolver *pSolver = (ParticleContactSolver *)context;
+    while (end - begin > _ITEMS_PER_JOB)
+    {
+        int middle = begin + (end - begin) / 2;
+        pSolver->_pScheduler->Spawn(*pSolver->_pJoinCounter, &ApplyCorrectionsJob, context, 
+            middle, end);
+        end = middle;
+    }
+
+    pSolver->ApplyCorrections(begin, end);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Keeps this frame's contacts and their total corrections for the next warm start.  The 
+    contacts are already sorted.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleContactSolver::SaveContactCache()
+{
+    // swap instead of copy; the old cache's memory is reused for next frame's contacts
+    _contactCache.swap(_contacts);
+    _contacts.clear();
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include "Particle.h"
+#include "ParticleProperties.h"
+#include "ParticleQuadTree.h"
+#include "ParticleContactGatherKernel.h"
+#include "glm/vec2.hpp"
+
+class ParticleTaskScheduler;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A position-based dynamics alternative to the force-based collision responses.  The 
+    impulse-based response turns a velocity change into a force / dt, and a dense pile of 
+    overlapping particles jitters unless the step is tiny.  This instead works on positions 
+    after the integrator has moved everything:
+    - Build a contact list from the tree.
+    - Warm start: contacts that also existed last frame get (a fraction of) last frame's 
+    correction up front, capped at their current overlap.  A pile pushes the same way from 
+    one frame to the next, so that gets most of the way there before the first iteration.
+    - Jacobi iterations: every contact works out how far apart its two particles need to be 
+    moved, weighted by inverse mass, from the positions at the start of the iteration.  The 
+    corrections are added up per particle and then each particle moves by the average of its 
+    corrections.  Every contact reads the same positions, so the result doesn't depend on the 
+    order of the contacts, and each iteration's contacts can be split up among threads as long 
+    as each one gets its own correction sums.
+    - Velocity += total correction / delta time, so the velocity is what it took to get to the 
+    corrected position.  Contacts end up perfectly inelastic.
+
+    Contacts are only pushed apart, never pulled together.
+
+    Optionally, each iteration runs on a work-stealing pool in two rounds of jobs: the 
+    contacts are split into ranges and each thread adds its contacts' corrections to sums of 
+    its own, and then the particles in a contact are split into ranges and each one adds up 
+    the threads' sums and moves.  Only the order that a particle's corrections are added up 
+    in depends on the threads, so the result can change in the last bits from run to run.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticleContactSolver
+{
+public:
+    ParticleContactSolver(const int numIterations = 4, const float relaxation = 1.0f, 
+        const float warmStartFraction = 0.8f);
+
+    void Solve(const ParticleQuadTree &tree, float searchPadding, 
+        std::vector<Particle> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties, float deltaTimeSec);
+    void RemapParticleIndices(const std::vector<int> &newIndexOfOld);
+
+    // 0 runs the iterations on the calling thread
+    void SetScheduler(ParticleTaskScheduler *pScheduler);
+
+    float InteractionRangeInContactDistances() const;
+    int NumContactsLastSolve() const;
+    int NumWarmStartedContactsLastSolve() const;
+    float MaxOverlapLastSolve() const;
+
+private:
+    template<typename PROPERTIES>
+    void GatherContacts(const PROPERTIES &properties, const ParticleQuadTree &tree, 
+        float searchPadding, std::vector<Particle> &particleCollection);
+    void WarmStart();
+    void RunIteration(bool isWarmStart, std::vector<Particle> &particleCollection);
+    void SolveContacts(int beginContact, int endContact);
+    void ApplyCorrections(int beginParticle, int endParticle);
+    static void SolveContactsJob(void *context, int begin, int end);
+    static void ApplyCorrectionsJob(void *context, int begin, int end);
+    void SaveContactCache();
+
+    // one thread's share of an iteration, indexed the same as the particle collection; only 
+    // the entries for particles in a contact are used, and they are all 0 between iterations
+    // Note: Padded to a cache line so that two threads' overlaps never share one.
+    struct ThreadCorrections
+    {
+        ThreadCorrections() :
+            _maxOverlap(0.0f)
+        {
+        }
+
+        std::vector<glm::vec2> _corrections;
+        std::vector<int> _correctionCounts;
+
+        // only the warm start counts touches
+        std::vector<int> _touchCounts;
+        float _maxOverlap;
+        char _padding[64 - (((3 * sizeof(std::vector<int>)) + sizeof(float)) % 64)];
+    };
+
+    int _numIterations;
+    float _relaxation;
+    float _warmStartFraction;
+
+    // pairs this far past their contact distance are already tracked so that they don't get 
+    // missed when another contact's correction pushes them together
+    static const float _CONTACT_MARGIN_IN_CONTACT_DISTANCES;
+
+    // this frame's contacts, sorted by key, and last frame's (key, accumulated correction)
+    std::vector<ParticleContact> _contacts;
+    std::vector<ParticleContact> _contactCache;
+
+    // by ParticleTaskScheduler::CurrentWorkerIndex()
+    std::vector<ThreadCorrections> _threadCorrections;
+
+    // indexed the same as the particle collection; only the entries for particles in a 
+    // contact are used
+    std::vector<glm::vec2> _totalCorrections;
+    std::vector<int> _contactParticleIndices;
+
+    // 0 unless the iterations run on a pool; the rest are only set during an iteration
+    ParticleTaskScheduler *_pScheduler;
+    std::atomic<int> *_pJoinCounter;
+    std::vector<Particle> *_pParticleCollection;
+    bool _isWarmStartIteration;
+
+    // a job keeps splitting its range until it is down to this many contacts or particles
+    static const int _ITEMS_PER_JOB = 256;
+
+    int _numWarmStartedContacts;
+    float _maxOverlap;
+};
@@ -29,6 +29,7 @@ ParticleEmitterBar::ParticleEmitterBar(const glm::vec2 &p1, const glm::vec2 &p2,
     //_velocityCalculator.SetDir(plus90Degrees);
     _originalEmitDirection = emitDir;
     _velocityCalculator.SetDir(emitDir);
+    _speciesId = 0;
 }
 
 /*-----------------------------------------------------------------------------------------------
@@ -74,3 +75,31 @@ void ParticleEmitterBar::SetTransform(const glm::mat4 &m)
     glm::vec2 newEmissionDir = glm::vec2(m * glm::vec4(_originalEmitDirection, 0.0f, 0.0f));
     _velocityCalculator.SetDir(newEmissionDir);
 }
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.  The species' properties are in ParticlePropertyStorage.
+Parameters:
+    speciesId   Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleEmitterBar::SetSpecies(unsigned char speciesId)
+{
+    _speciesId = speciesId;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    The species of the particles that this emitter sends out.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned char ParticleEmitterBar::GetSpecies() const
+{
+    return _speciesId;
+}
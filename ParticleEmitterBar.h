@@ -19,6 +19,8 @@ public:
         const float minVel, const float maxVel);
     virtual void ResetParticle(Particle *resetThis) const;
     virtual void SetTransform(const glm::mat4 &m);
+    virtual void SetSpecies(unsigned char speciesId);
+    virtual unsigned char GetSpecies() const;
 private:
     // I need the bar's start and start->end vector on every frame, but I don't need the end 
     // point except to calculate the start->end vector, so I'll calculate the later on class 
@@ -30,5 +32,6 @@ private:
 
     glm::vec2 _originalEmitDirection;
     MinMaxVelocity _velocityCalculator;
+    unsigned char _speciesId;
 };
 
@@ -20,6 +20,7 @@ ParticleEmitterPoint::ParticleEmitterPoint(const glm::vec2 &emitterPos, const fl
     _currentPosition = emitterPos;
     _velocityCalculator.SetMinMaxVelocity(minVel, maxVel);
     _velocityCalculator.UseRandomDir();
+    _speciesId = 0;
 }
 
 /*-----------------------------------------------------------------------------------------------
@@ -62,3 +63,31 @@ void ParticleEmitterPoint::SetTransform(const glm::mat4 &m)
 {
     _currentPosition = glm::vec2(m * glm::vec4(_originalPosition, 0.0f, 1.0f));
 }
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.  The species' properties are in ParticlePropertyStorage.
+Parameters:
+    speciesId   Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleEmitterPoint::SetSpecies(unsigned char speciesId)
+{
+    _speciesId = speciesId;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    The species of the particles that this emitter sends out.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned char ParticleEmitterPoint::GetSpecies() const
+{
+    return _speciesId;
+}
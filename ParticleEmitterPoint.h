@@ -18,8 +18,11 @@ public:
     ParticleEmitterPoint(const glm::vec2 &emitterPos, const float minVel, const float maxVel);
     virtual void ResetParticle(Particle *resetThis) const;
     virtual void SetTransform(const glm::mat4 &m);
+    virtual void SetSpecies(unsigned char speciesId);
+    virtual unsigned char GetSpecies() const;
 private:
     glm::vec2 _originalPosition;
     glm::vec2 _currentPosition;
     MinMaxVelocity _velocityCalculator;
+    unsigned char _speciesId;
 };
@@ -0,0 +1,86 @@
+#include "ParticleForceFieldGravityWell.h"
+
+#include <math.h>
+#include "glm/detail/func_geometric.hpp" // for glm::dot
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Ensures that the object starts object with initialized values.
+Parameters:
+    center          Self-explanatory.
+    strength        Positive pulls in.
+    softeningRadius Keeps the force finite near the center.  Must be greater than 0.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleForceFieldGravityWell::ParticleForceFieldGravityWell(const glm::vec2 &center, 
+    const float strength, const float softeningRadius) :
+    _center(center),
+    _strength(strength),
+    _softeningRadiusSqr(softeningRadius * softeningRadius),
+    _version(0)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.  The grid that this field is in will bake again.
+Parameters:
+    center  Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleForceFieldGravityWell::SetCenter(const glm::vec2 &center)
+{
+    _center = center;
+    _version++;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.  The grid that this field is in will bake again.
+Parameters:
+    strength    Positive pulls in.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleForceFieldGravityWell::SetStrength(const float strength)
+{
+    _strength = strength;
+    _version++;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Calculates the pull at a point.  It points at the center.
+Parameters:
+    position    Self-explanatory.
+Returns:
+    See description.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+glm::vec2 ParticleForceFieldGravityWell::ForceAt(const glm::vec2 &position) const
+{
+    glm::vec2 positionToCenter = _center - position;
+    float softenedDistanceSqr = glm::dot(positionToCenter, positionToCenter) + _softeningRadiusSqr;
+    float softenedDistance = sqrtf(softenedDistanceSqr);
+    return positionToCenter * (_strength / (softenedDistanceSqr * softenedDistance));
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many times the parameters have changed.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleForceFieldGravityWell::Version() const
+{
+    return _version;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "IParticleForceField.h"
+#include "glm/vec2.hpp"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Pulls particles toward a point with an inverse square force.  The softening radius keeps 
+    the force finite near the center: the pull is strength * r / (r^2 + softening^2)^(3/2), 
+    which is 0 at the center and becomes strength / r^2 well outside the softening radius.  A 
+    negative strength pushes particles away.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticleForceFieldGravityWell : public IParticleForceField
+{
+public:
+    ParticleForceFieldGravityWell(const glm::vec2 &center, const float strength, 
+        const float softeningRadius);
+    void SetCenter(const glm::vec2 &center);
+    void SetStrength(const float strength);
+    virtual glm::vec2 ForceAt(const glm::vec2 &position) const;
+    virtual unsigned int Version() const;
+
+private:
+    glm::vec2 _center;
+    float _strength;
+    float _softeningRadiusSqr;
+    unsigned int _version;
+};
@@ -0,0 +1,311 @@
+#include "ParticleForceFieldGrid.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Ensures that the object starts object with initialized values.  There is no region until 
+    SetRegion(...) is called, and until then the particles get no force.
+Parameters:
+    numCellsPerAxis     Finer grids follow sharp fields more closely.  At least 1.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleForceFieldGrid::ParticleForceFieldGrid(const int numCellsPerAxis) :
+    _numCellsPerAxis((numCellsPerAxis < 1) ? 1 : numCellsPerAxis),
+    _cellSize(0.0f),
+    _inverseCellSize(0.0f),
+    _regionChanged(false),
+    _numBakes(0)
+{
+    _numPointsPerAxis = _numCellsPerAxis + 1;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Covers the square around the particle region's circle with the grid.  The grid is baked 
+    again the next time that it is used.
+Parameters:
+    particleRegionCenter    Self-explanatory.
+    particleRegionRadius    Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleForceFieldGrid::SetRegion(const glm::vec2 &particleRegionCenter, 
+    const float particleRegionRadius)
+{
+    _regionMinCorner = particleRegionCenter - glm::vec2(particleRegionRadius);
+    _cellSize = 2.0f * particleRegionRadius / _numCellsPerAxis;
+    _inverseCellSize = 1.0f / _cellSize;
+    _regionChanged = true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Adds a field to the sum.  The grid is baked again the next time that it is used.
+Parameters:
+    pField  Must outlive the grid.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleForceFieldGrid::AddField(const IParticleForceField *pField)
+{
+    _allFields.push_back(pField);
+
+    // guaranteed to differ from the field's version, so the next use bakes
+    _bakedVersions.push_back(pField->Version() - 1);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Cleans up ApplyForces(...).  The same interpolation as SampleForce(...), but for an array 
+    of positions in one branch-free loop that the compiler can vectorize.
+
+    The outputs are __restrict (spelled the same in MSVC, GCC, and Clang) because the grid 
+    lookups are gathers, and the compiler won't vectorize a loop that stores while it gathers 
+    unless it is told that the stores can't land on the grid.  It has to be on the parameters 
+    of a function because GCC ignores it on local pointers.
+Parameters:
+    positionsX          Self-explanatory.
+    positionsY          Self-explanatory.
+    numPositions        Self-explanatory.
+    gridForceX          The baked grid's X forces, row-major with X fastest.
+    gridForceY          The baked grid's Y forces, same layout.
+    numCellsPerAxis     Self-explanatory.
+    regionMinCorner     The grid's bottom left corner.
+    inverseCellSize     Self-explanatory.
+    sampledForcesX      The X force at each position is written here.
+    sampledForcesY      The Y force at each position is written here.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+static void SampleGrid(const float *positionsX, const float *positionsY, const int numPositions, 
+    const float *gridForceX, const float *gridForceY, const int numCellsPerAxis, 
+    const glm::vec2 regionMinCorner, const float inverseCellSize, 
+    float *__restrict sampledForcesX, float *__restrict sampledForcesY)
+{
+    float regionMinX = regionMinCorner.x;
+    float regionMinY = regionMinCorner.y;
+    float maxCellPosition = (float)numCellsPerAxis;
+    int maxCell = numCellsPerAxis - 1;
+    int numPointsPerAxis = numCellsPerAxis + 1;
+    for (int particleIndex = 0; particleIndex < numPositions; particleIndex++)
+    {
+        float cellX = (positionsX[particleIndex] - regionMinX) * inverseCellSize;
+        float cellY = (positionsY[particleIndex] - regionMinY) * inverseCellSize;
+        cellX = (cellX < 0.0f) ? 0.0f : ((cellX > maxCellPosition) ? maxCellPosition : cellX);
+        cellY = (cellY < 0.0f) ? 0.0f : ((cellY > maxCellPosition) ? maxCellPosition : cellY);
+        int column = (int)cellX;
+        int row = (int)cellY;
+        column = (column > maxCell) ? maxCell : column;
+        row = (row > maxCell) ? maxCell : row;
+        float fractionX = cellX - column;
+        float fractionY = cellY - row;
+
+        int bottomLeft = (row * numPointsPerAxis) + column;
+        int topLeft = bottomLeft + numPointsPerAxis;
+        float weightBottomLeft = (1.0f - fractionX) * (1.0f - fractionY);
+        float weightBottomRight = fractionX * (1.0f - fractionY);
+        float weightTopLeft = (1.0f - fractionX) * fractionY;
+        float weightTopRight = fractionX * fractionY;
+
+        sampledForcesX[particleIndex] = 
+            (gridForceX[bottomLeft] * weightBottomLeft) + 
+            (gridForceX[bottomLeft + 1] * weightBottomRight) + 
+            (gridForceX[topLeft] * weightTopLeft) + 
+            (gridForceX[topLeft + 1] * weightTopRight);
+        sampledForcesY[particleIndex] = 
+            (gridForceY[bottomLeft] * weightBottomLeft) + 
+            (gridForceY[bottomLeft + 1] * weightBottomRight) + 
+            (gridForceY[topLeft] * weightTopLeft) + 
+            (gridForceY[topLeft + 1] * weightTopRight);
+    }
+
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Bakes the grid if anything has changed, then adds the field's force to the net force of 
+    every active, awake particle.  Call it after the net forces have been zeroed.
+
+    The sampling is the same as SampleForce(...), but for every particle at once in one 
+    branch-free loop over flat arrays.
+Parameters:
+    particleCollection  Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleForceFieldGrid::ApplyForces(std::vector<Particle> &particleCollection)
+{
+    if (_allFields.empty() || _cellSize == 0.0f)
+    {
+        return;
+    }
+
+    if (NeedsBake())
+    {
+        Bake();
+    }
+
+    int numParticles = (int)particleCollection.size();
+    if ((int)_positionsX.size() < numParticles)
+    {
+        _positionsX.resize(numParticles);
+        _positionsY.resize(numParticles);
+        _isSampled.resize(numParticles);
+        _sampledForcesX.resize(numParticles);
+        _sampledForcesY.resize(numParticles);
+    }
+
+    // gather
+    // Note: Particles that are skipped are sampled at the grid's corner instead of wherever 
+    // they were left, so that the sampling never sees a position that is off in the weeds.
+    for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        const Particle &p = particleCollection[particleIndex];
+        bool isSampled = p._isActive && !p._isAsleep;
+        _isSampled[particleIndex] = isSampled ? 1 : 0;
+        _positionsX[particleIndex] = isSampled ? p._position.x : _regionMinCorner.x;
+        _positionsY[particleIndex] = isSampled ? p._position.y : _regionMinCorner.y;
+    }
+
+    // sample
+    SampleGrid(_positionsX.data(), _positionsY.data(), numParticles, _forceX.data(), 
+        _forceY.data(), _numCellsPerAxis, _regionMinCorner, _inverseCellSize, 
+        _sampledForcesX.data(), _sampledForcesY.data());
+
+    // scatter
+    for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        if (_isSampled[particleIndex])
+        {
+            Particle &p = particleCollection[particleIndex];
+            p._netForce.x += _sampledForcesX[particleIndex];
+            p._netForce.y += _sampledForcesY[particleIndex];
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Interpolates the force at a point from the four grid points around it.  The grid must 
+    have been baked.
+Parameters:
+    position    Clamped to the grid.
+Returns:
+    The summed fields' force, approximately.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+glm::vec2 ParticleForceFieldGrid::SampleForce(const glm::vec2 &position) const
+{
+    // position in cells, clamped so that the cell and the one after it are both on the grid
+    float maxCellPosition = (float)_numCellsPerAxis;
+    float cellX = (position.x - _regionMinCorner.x) * _inverseCellSize;
+    float cellY = (position.y - _regionMinCorner.y) * _inverseCellSize;
+    cellX = (cellX < 0.0f) ? 0.0f : ((cellX > maxCellPosition) ? maxCellPosition : cellX);
+    cellY = (cellY < 0.0f) ? 0.0f : ((cellY > maxCellPosition) ? maxCellPosition : cellY);
+    int column = (int)cellX;
+    int row = (int)cellY;
+    column = (column == _numCellsPerAxis) ? column - 1 : column;
+    row = (row == _numCellsPerAxis) ? row - 1 : row;
+    float fractionX = cellX - column;
+    float fractionY = cellY - row;
+
+    // bilinear weights for the bottom left, bottom right, top left, and top right points
+    int bottomLeft = (row * _numPointsPerAxis) + column;
+    int topLeft = bottomLeft + _numPointsPerAxis;
+    float weightBottomLeft = (1.0f - fractionX) * (1.0f - fractionY);
+    float weightBottomRight = fractionX * (1.0f - fractionY);
+    float weightTopLeft = (1.0f - fractionX) * fractionY;
+    float weightTopRight = fractionX * fractionY;
+
+    glm::vec2 force;
+    force.x = (_forceX[bottomLeft] * weightBottomLeft) + (_forceX[bottomLeft + 1] * weightBottomRight) + 
+        (_forceX[topLeft] * weightTopLeft) + (_forceX[topLeft + 1] * weightTopRight);
+    force.y = (_forceY[bottomLeft] * weightBottomLeft) + (_forceY[bottomLeft + 1] * weightBottomRight) + 
+        (_forceY[topLeft] * weightTopLeft) + (_forceY[topLeft + 1] * weightTopRight);
+    return force;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.  If this goes up every frame, then a field is being changed every frame.
+Parameters: None
+Returns:
+    How many times the grid has been baked since construction.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleForceFieldGrid::NumBakes() const
+{
+    return _numBakes;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Checks whether the grid is out of date.
+Parameters: None
+Returns:
+    True if the region changed or any field's version differs from the one that was baked.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleForceFieldGrid::NeedsBake() const
+{
+    if (_regionChanged)
+    {
+        return true;
+    }
+
+    for (size_t fieldIndex = 0; fieldIndex < _allFields.size(); fieldIndex++)
+    {
+        if (_allFields[fieldIndex]->Version() != _bakedVersions[fieldIndex])
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Adds up every field at every grid point and remembers the fields' versions.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleForceFieldGrid::Bake()
+{
+    int numPoints = _numPointsPerAxis * _numPointsPerAxis;
+    _forceX.assign(numPoints, 0.0f);
+    _forceY.assign(numPoints, 0.0f);
+    for (int row = 0; row < _numPointsPerAxis; row++)
+    {
+        for (int column = 0; column < _numPointsPerAxis; column++)
+        {
+            glm::vec2 position = _regionMinCorner + (glm::vec2((float)column, (float)row) * _cellSize);
+            glm::vec2 force;
+            for (size_t fieldIndex = 0; fieldIndex < _allFields.size(); fieldIndex++)
+            {
+                force += _allFields[fieldIndex]->ForceAt(position);
+            }
+
+            int pointIndex = (row * _numPointsPerAxis) + column;
+            _forceX[pointIndex] = force.x;
+            _forceY[pointIndex] = force.y;
+        }
+    }
+
+    for (size_t fieldIndex = 0; fieldIndex < _allFields.size(); fieldIndex++)
+    {
+        _bakedVersions[fieldIndex] = _allFields[fieldIndex]->Version();
+    }
+    _regionChanged = false;
+    _numBakes++;
+}
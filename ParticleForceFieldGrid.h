@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include "Particle.h"
+#include "IParticleForceField.h"
+#include "glm/vec2.hpp"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Adds up any number of external force fields (wind, vortices, gravity wells, ...) on a 
+    regular grid over the particle region, and gives each particle the force at its position 
+    by bilinear interpolation between the four grid points around it.  However many fields 
+    there are, and however expensive they are, a particle only costs one gather of four grid 
+    points.
+
+    The grid is baked lazily: it is only recalculated when a field is added, the region 
+    changes, or one of the fields reports a new version number (see IParticleForceField).
+
+    The grid points are stored as separate arrays of X and Y so that the interpolation is the 
+    same few multiply-adds for both axes.  Particles outside the region get the force at the 
+    nearest edge.
+
+    Applying the forces is done in three passes instead of one over the particles.  The 
+    positions are gathered into separate arrays of X and Y, along with a mask of which 
+    particles are active and awake.  The interpolation is then one branch-free loop over those 
+    arrays, which the compiler can vectorize (the four grid points are still indexed loads, 
+    which are gathered one lane at a time unless the instruction set has gathers).  Finally 
+    the sampled forces are added to the masked particles' net forces.
+
+    Note: When this class goes "poof", it won't delete the given pointers.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticleForceFieldGrid
+{
+public:
+    ParticleForceFieldGrid(const int numCellsPerAxis = 64);
+    void SetRegion(const glm::vec2 &particleRegionCenter, const float particleRegionRadius);
+    void AddField(const IParticleForceField *pField);
+
+    void ApplyForces(std::vector<Particle> &particleCollection);
+    glm::vec2 SampleForce(const glm::vec2 &position) const;
+    int NumBakes() const;
+
+private:
+    bool NeedsBake() const;
+    void Bake();
+
+    // (cells + 1) grid points per axis
+    int _numCellsPerAxis;
+    int _numPointsPerAxis;
+    glm::vec2 _regionMinCorner;
+    float _cellSize;
+    float _inverseCellSize;
+    bool _regionChanged;
+
+    std::vector<const IParticleForceField *> _allFields;
+
+    // the version of each field that the grid was last baked with
+    std::vector<unsigned int> _bakedVersions;
+
+    // row-major, X fastest
+    std::vector<float> _forceX;
+    std::vector<float> _forceY;
+    int _numBakes;
+
+    // ApplyForces(...)'s scratch space, indexed the same as the particle collection
+    // Note: Only grows, and only when the particle collection does.
+    std::vector<float> _positionsX;
+    std::vector<float> _positionsY;
+    std::vector<unsigned char> _isSampled;
+    std::vector<float> _sampledForcesX;
+    std::vector<float> _sampledForcesY;
+};
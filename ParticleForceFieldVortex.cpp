@@ -0,0 +1,87 @@
+#include "ParticleForceFieldVortex.h"
+
+#include "glm/detail/func_geometric.hpp" // for glm::dot
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Ensures that the object starts object with initialized values.
+Parameters:
+    center      Self-explanatory.
+    strength    Positive is counterclockwise.
+    coreRadius  Where the push is strongest.  Must be greater than 0.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleForceFieldVortex::ParticleForceFieldVortex(const glm::vec2 &center, 
+    const float strength, const float coreRadius) :
+    _center(center),
+    _strength(strength),
+    _coreRadiusSqr(coreRadius * coreRadius),
+    _version(0)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.  The grid that this field is in will bake again.
+Parameters:
+    center  Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleForceFieldVortex::SetCenter(const glm::vec2 &center)
+{
+    _center = center;
+    _version++;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.  The grid that this field is in will bake again.
+Parameters:
+    strength    Positive is counterclockwise.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleForceFieldVortex::SetStrength(const float strength)
+{
+    _strength = strength;
+    _version++;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Calculates the push at a point.  It is perpendicular to the line from the center.
+Parameters:
+    position    Self-explanatory.
+Returns:
+    See description.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+glm::vec2 ParticleForceFieldVortex::ForceAt(const glm::vec2 &position) const
+{
+    glm::vec2 centerToPosition = position - _center;
+    float distanceSqr = glm::dot(centerToPosition, centerToPosition);
+
+    // rotate 90 degrees counterclockwise; the length is r, so this is strength * r / (...)
+    glm::vec2 tangent(-centerToPosition.y, centerToPosition.x);
+    return tangent * (_strength / (distanceSqr + _coreRadiusSqr));
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many times the parameters have changed.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleForceFieldVortex::Version() const
+{
+    return _version;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "IParticleForceField.h"
+#include "glm/vec2.hpp"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Pushes particles around a center point, counterclockwise for a positive strength.  The 
+    push is strength * r / (r^2 + core^2), which is 0 at the center, strongest at the core 
+    radius, and falls off as 1/r beyond it.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticleForceFieldVortex : public IParticleForceField
+{
+public:
+    ParticleForceFieldVortex(const glm::vec2 &center, const float strength, 
+        const float coreRadius);
+    void SetCenter(const glm::vec2 &center);
+    void SetStrength(const float strength);
+    virtual glm::vec2 ForceAt(const glm::vec2 &position) const;
+    virtual unsigned int Version() const;
+
+private:
+    glm::vec2 _center;
+    float _strength;
+    float _coreRadiusSqr;
+    unsigned int _version;
+};
@@ -0,0 +1,60 @@
+#include "ParticleForceFieldWind.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Ensures that the object starts object with initialized values.
+Parameters:
+    force   Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleForceFieldWind::ParticleForceFieldWind(const glm::vec2 &force) :
+    _force(force),
+    _version(0)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.  The grid that this field is in will bake again.
+Parameters:
+    force   Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleForceFieldWind::SetForce(const glm::vec2 &force)
+{
+    _force = force;
+    _version++;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.  The position doesn't matter.
+Parameters:
+    position    Ignored.
+Returns:
+    The wind's force.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+glm::vec2 ParticleForceFieldWind::ForceAt(const glm::vec2 &/*position*/) const
+{
+    return _force;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many times the parameters have changed.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleForceFieldWind::Version() const
+{
+    return _version;
+}
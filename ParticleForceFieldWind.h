@@ -0,0 +1,22 @@
+#pragma once
+
+#include "IParticleForceField.h"
+#include "glm/vec2.hpp"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The same force everywhere.  Pointed down, it is gravity.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticleForceFieldWind : public IParticleForceField
+{
+public:
+    ParticleForceFieldWind(const glm::vec2 &force);
+    void SetForce(const glm::vec2 &force);
+    virtual glm::vec2 ForceAt(const glm::vec2 &position) const;
+    virtual unsigned int Version() const;
+
+private:
+    glm::vec2 _force;
+    unsigned int _version;
+};
@@ -0,0 +1,165 @@
+#include "ParticleFrameExchange.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Ensures that the object starts object with initialized values.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleRenderFrame::ParticleRenderFrame() :
+    _numActiveParticles(0),
+    _numSleepingParticles(0),
+    _numTreeNodes(0),
+    _stepsPerSecond(0.0),
+    _stepSec(0.0f),
+    _numDroppedCollisionEvents(0),
+    _frameNumber(0)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Ensures that the object starts object with initialized values.  Nothing has been published
+    yet, so the first AcquireLatest() returns false until the simulation publishes.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleFrameExchange::ParticleFrameExchange() :
+    _latest(1),
+    _backIndex(0),
+    _numPublished(0),
+    _frontIndex(2),
+    _lastAcquiredFrameNumber(0),
+    _latencySec(0.0),
+    _queueDepth(0),
+    _numSkippedFrames(0)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The frame that the simulation thread fills out.  It belongs to the simulation thread until
+    the next Publish(), which hands it over and gives it a different one.
+Parameters: None
+Returns:
+    See description.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleRenderFrame &ParticleFrameExchange::BackFrame()
+{
+    return _frames[_backIndex];
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Makes the back frame the latest one.  The old latest frame becomes the new back frame,
+    whether or not the renderer ever saw it.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleFrameExchange::Publish()
+{
+    ParticleRenderFrame &frame = _frames[_backIndex];
+    frame._frameNumber = ++_numPublished;
+    frame._publishTime = ParticleRenderFrame::clock_type::now();
+
+    // release: the frame's contents are visible to whoever exchanges this index out
+    int previousLatest = _latest.exchange(_backIndex | _NEW_FRAME_FLAG, std::memory_order_acq_rel);
+    _backIndex = previousLatest & _FRAME_INDEX_MASK;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    If a frame has been published since the last call, it becomes the front frame, and the
+    latency and queue depth are measured.  Otherwise the front frame stays as it is.
+Parameters: None
+Returns:
+    True if the front frame changed.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleFrameExchange::AcquireLatest()
+{
+    if ((_latest.load(std::memory_order_relaxed) & _NEW_FRAME_FLAG) == 0)
+    {
+        return false;
+    }
+
+    // acquire: see everything that the simulation wrote before publishing
+    int latest = _latest.exchange(_frontIndex, std::memory_order_acq_rel);
+    _frontIndex = latest & _FRAME_INDEX_MASK;
+
+    const ParticleRenderFrame &frame = _frames[_frontIndex];
+    _latencySec = std::chrono::duration<double>(
+        ParticleRenderFrame::clock_type::now() - frame._publishTime).count();
+    _queueDepth = frame._frameNumber - _lastAcquiredFrameNumber;
+    _numSkippedFrames += _queueDepth - 1;
+    _lastAcquiredFrameNumber = frame._frameNumber;
+    return true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The frame that the render thread draws.  It belongs to the render thread until the next
+    AcquireLatest() that returns true.  Before the first one, it is empty.
+Parameters: None
+Returns:
+    See description.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleRenderFrame &ParticleFrameExchange::FrontFrame()
+{
+    return _frames[_frontIndex];
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How long the front frame had been published when it was acquired.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+double ParticleFrameExchange::LatencySecAtLastAcquire() const
+{
+    return _latencySec;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many frames were published between the last two acquired frames, counting the
+    acquired one.  More than 1 means that the simulation is publishing faster than the
+    renderer is drawing.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleFrameExchange::QueueDepthAtLastAcquire() const
+{
+    return _queueDepth;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many published frames were overwritten before the renderer got to them.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleFrameExchange::NumSkippedFrames() const
+{
+    return _numSkippedFrames;
+}
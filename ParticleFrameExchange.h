@@ -0,0 +1,90 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include "Particle.h"
+#include "GeometryData.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Everything that the renderer needs from one completed simulation frame.  The simulation
+    fills it out and then never touches it again until the renderer has moved on.
+
+    Note: The tree geometry only uses the vertex and index vectors.  The OpenGL buffers belong
+    to the renderer's own GeometryData, which the vectors are swapped into.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+struct ParticleRenderFrame
+{
+    typedef std::chrono::steady_clock clock_type;
+
+    ParticleRenderFrame();
+
+    std::vector<Particle> _particles;
+    GeometryData _treeGeometry;
+    int _numActiveParticles;
+    int _numSleepingParticles;
+    int _numTreeNodes;
+    double _stepsPerSecond;
+    float _stepSec;
+    unsigned int _numDroppedCollisionEvents;
+
+    // stamped by Publish()
+    unsigned int _frameNumber;
+    clock_type::time_point _publishTime;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Hands completed frames from the simulation thread to the render thread without either one
+    waiting on the other.  It is a triple buffer: the simulation writes into the back frame,
+    the renderer draws from the front frame, and the third frame is the latest one that has
+    been published.  Publish() swaps the back frame with the latest, and AcquireLatest() swaps
+    the front frame with the latest if it is newer than what is being drawn.  Both swaps are a
+    single atomic exchange of a frame index, so there are no locks, and the simulation can
+    publish as often as it likes.  Frames that are published faster than they are drawn are
+    overwritten and counted as skipped.
+
+    Reports how stale the drawn frame is (latency from Publish() to AcquireLatest()) and how
+    many frames were published since the last one that was drawn (queue depth; 1 means that the
+    renderer is keeping up).
+
+    One thread may produce and one other thread may consume.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticleFrameExchange
+{
+public:
+    ParticleFrameExchange();
+
+    // simulation thread
+    ParticleRenderFrame &BackFrame();
+    void Publish();
+
+    // render thread
+    bool AcquireLatest();
+    ParticleRenderFrame &FrontFrame();
+    double LatencySecAtLastAcquire() const;
+    unsigned int QueueDepthAtLastAcquire() const;
+    unsigned int NumSkippedFrames() const;
+
+private:
+    // the latest frame's index, plus a flag for whether the renderer has seen it yet
+    static const int _FRAME_INDEX_MASK = 3;
+    static const int _NEW_FRAME_FLAG = 4;
+
+    ParticleRenderFrame _frames[3];
+    std::atomic<int> _latest;
+
+    // only touched by the simulation thread
+    int _backIndex;
+    unsigned int _numPublished;
+
+    // only touched by the render thread
+    int _frontIndex;
+    unsigned int _lastAcquiredFrameNumber;
+    double _latencySec;
+    unsigned int _queueDepth;
+    unsigned int _numSkippedFrames;
+};
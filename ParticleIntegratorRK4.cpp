@@ -0,0 +1,166 @@
+#include "ParticleIntegratorRK4.h"
+
+#include "ParticlePropertyAccess.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.
+Parameters:
+    numSubsteps     Each step is split into this many equal substeps.  At least 1.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleIntegratorRK4::ParticleIntegratorRK4(const int numSubsteps) :
+    _numSubsteps((numSubsteps < 1) ? 1 : numSubsteps)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Advances every awake, active particle by delta time.
+Parameters:
+    forceEvaluator      Called four times per substep.
+    particleCollection  Self-explanatory.
+    particleProperties  Where the particle masses come from.
+    deltaTimeSec        Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleIntegratorRK4::Integrate(IParticleForceEvaluator &forceEvaluator,
+    std::vector<Particle> &particleCollection, 
+    const ParticlePropertyStorage &particleProperties, float deltaTimeSec)
+{
+    // only reallocates if the particle collection grew
+    if (_startPositions.size() < particleCollection.size())
+    {
+        _startPositions.resize(particleCollection.size());
+        _startVelocities.resize(particleCollection.size());
+        _positionDerivativeSums.resize(particleCollection.size());
+        _velocityDerivativeSums.resize(particleCollection.size());
+    }
+
+    float substepSec = deltaTimeSec / _numSubsteps;
+    for (int substepCount = 0; substepCount < _numSubsteps; substepCount++)
+    {
+        if (particleProperties.IsUniform())
+        {
+            UniformParticlePropertyAccess properties(particleProperties);
+            Substep(properties, forceEvaluator, particleCollection, particleProperties, 
+                substepSec);
+        }
+        else
+        {
+            SpeciesParticlePropertyAccess properties(particleProperties);
+            Substep(properties, forceEvaluator, particleCollection, particleProperties, 
+                substepSec);
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    One RK4 step of the state (x, v), whose derivative is (v, F(x, v) / m).
+
+    k1 = (v0, a0)                       a0 is the force on the way in
+    k2 = (v1, a1) at (x0 + k1 * h/2)
+    k3 = (v2, a2) at (x0 + k2 * h/2)
+    k4 = (v3, a3) at (x0 + k3 * h)
+    (x, v) = (x0, v0) + (h/6) * (k1 + 2 * k2 + 2 * k3 + k4)
+
+    Each stage moves the particles to where the next derivative is needed and asks for forces 
+    there.  The running sums of the derivatives are kept per particle.
+Parameters:
+    properties          One of the accessors in ParticlePropertyAccess.h.
+    forceEvaluator      Self-explanatory.
+    particleCollection  Self-explanatory.
+    particleProperties  Passed on to the force evaluator.
+    substepSec          Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<typename PROPERTIES>
+void ParticleIntegratorRK4::Substep(const PROPERTIES &properties, 
+    IParticleForceEvaluator &forceEvaluator, std::vector<Particle> &particleCollection, 
+    const ParticlePropertyStorage &particleProperties, float substepSec)
+{
+    const float halfSubstepSec = 0.5f * substepSec;
+    const size_t numParticles = particleCollection.size();
+
+    // stage 1: derivative at the start, then move to the midpoint along it
+    for (size_t particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        Particle &p = particleCollection[particleIndex];
+        if (!p._isActive || p._isAsleep)
+        {
+            continue;
+        }
+
+        glm::vec2 acceleration = p._netForce * properties.InverseMass(particleIndex);
+        _startPositions[particleIndex] = p._position;
+        _startVelocities[particleIndex] = p._velocity;
+        _positionDerivativeSums[particleIndex] = p._velocity;
+        _velocityDerivativeSums[particleIndex] = acceleration;
+        p._position = _startPositions[particleIndex] + (p._velocity * halfSubstepSec);
+        p._velocity = _startVelocities[particleIndex] + (acceleration * halfSubstepSec);
+    }
+    forceEvaluator.EvaluateForces(particleCollection, particleProperties, substepSec);
+
+    // stage 2: derivative at the first midpoint, then move to the second midpoint along it
+    for (size_t particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        Particle &p = particleCollection[particleIndex];
+        if (!p._isActive || p._isAsleep)
+        {
+            continue;
+        }
+
+        glm::vec2 acceleration = p._netForce * properties.InverseMass(particleIndex);
+        _positionDerivativeSums[particleIndex] += (2.0f * p._velocity);
+        _velocityDerivativeSums[particleIndex] += (2.0f * acceleration);
+        p._position = _startPositions[particleIndex] + (p._velocity * halfSubstepSec);
+        p._velocity = _startVelocities[particleIndex] + (acceleration * halfSubstepSec);
+    }
+    forceEvaluator.EvaluateForces(particleCollection, particleProperties, substepSec);
+
+    // stage 3: derivative at the second midpoint, then move to the end along it
+    for (size_t particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        Particle &p = particleCollection[particleIndex];
+        if (!p._isActive || p._isAsleep)
+        {
+            continue;
+        }
+
+        glm::vec2 acceleration = p._netForce * properties.InverseMass(particleIndex);
+        _positionDerivativeSums[particleIndex] += (2.0f * p._velocity);
+        _velocityDerivativeSums[particleIndex] += (2.0f * acceleration);
+        p._position = _startPositions[particleIndex] + (p._velocity * substepSec);
+        p._velocity = _startVelocities[particleIndex] + (acceleration * substepSec);
+    }
+    forceEvaluator.EvaluateForces(particleCollection, particleProperties, substepSec);
+
+    // stage 4: derivative at the end, then the weighted average of all four
+    const float sixthSubstepSec = substepSec / 6.0f;
+    for (size_t particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        Particle &p = particleCollection[particleIndex];
+        if (!p._isActive || p._isAsleep)
+        {
+            continue;
+        }
+
+        glm::vec2 acceleration = p._netForce * properties.InverseMass(particleIndex);
+        _positionDerivativeSums[particleIndex] += p._velocity;
+        _velocityDerivativeSums[particleIndex] += acceleration;
+        p._position = _startPositions[particleIndex] + 
+            (_positionDerivativeSums[particleIndex] * sixthSubstepSec);
+        p._velocity = _startVelocities[particleIndex] + 
+            (_velocityDerivativeSums[particleIndex] * sixthSubstepSec);
+    }
+
+    // leave the forces at the end state, as promised
+    forceEvaluator.EvaluateForces(particleCollection, particleProperties, substepSec);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "IParticleIntegrator.h"
+#include "glm/vec2.hpp"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Classic fourth order Runge-Kutta on position and velocity.  Four force evaluations per 
+    substep (the fourth leaves the forces at the end of the substep, which is the first stage 
+    of the next one).
+
+    The state at the start of the substep and the running weighted sums are kept in arrays 
+    that are allocated on the first step and reused afterwards.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticleIntegratorRK4 : public IParticleIntegrator
+{
+public:
+    ParticleIntegratorRK4(const int numSubsteps = 1);
+    virtual void Integrate(IParticleForceEvaluator &forceEvaluator, 
+        std::vector<Particle> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties, float deltaTimeSec);
+
+private:
+    // PROPERTIES is one of the accessors in ParticlePropertyAccess.h
+    template<typename PROPERTIES>
+    void Substep(const PROPERTIES &properties, IParticleForceEvaluator &forceEvaluator, 
+        std::vector<Particle> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties, float substepSec);
+
+    int _numSubsteps;
+
+    // indexed the same as the particle collection
+    std::vector<glm::vec2> _startPositions;
+    std::vector<glm::vec2> _startVelocities;
+    std::vector<glm::vec2> _positionDerivativeSums;
+    std::vector<glm::vec2> _velocityDerivativeSums;
+};
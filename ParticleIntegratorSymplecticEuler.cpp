@@ -0,0 +1,224 @@
+#include "ParticleIntegratorSymplecticEuler.h"
+
+#include "ParticlePropertyAccess.h"
+#include "ParticleTaskScheduler.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.
+Parameters:
+    numSubsteps     Each step is split into this many equal substeps.  At least 1.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleIntegratorSymplecticEuler::ParticleIntegratorSymplecticEuler(const int numSubsteps) :
+    _numSubsteps((numSubsteps < 1) ? 1 : numSubsteps),
+    _pScheduler(0),
+    _pJoinCounter(0),
+    _pParticleCollection(0),
+    _pParticleProperties(0),
+    _substepSec(0.0f)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Advances every awake, active particle by delta time.
+Parameters:
+    forceEvaluator      Called once per substep.
+    particleCollection  Self-explanatory.
+    particleProperties  Where the particle masses come from.
+    deltaTimeSec        Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleIntegratorSymplecticEuler::Integrate(IParticleForceEvaluator &forceEvaluator,
+    std::vector<Particle> &particleCollection, 
+    const ParticlePropertyStorage &particleProperties, float deltaTimeSec)
+{
+    float lastEvaluationSec = 0.0f;
+    IntegrateExceptLastEvaluation(forceEvaluator, particleCollection, particleProperties, 
+        deltaTimeSec, &lastEvaluationSec);
+    forceEvaluator.EvaluateForces(particleCollection, particleProperties, lastEvaluationSec);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Integrate(...) without the force evaluation after the last substep.
+Parameters:
+    forceEvaluator              Called after every substep but the last.
+    particleCollection          Self-explanatory.
+    particleProperties          Where the particle masses come from.
+    deltaTimeSec                Self-explanatory.
+    putLastEvaluationSecHere    The substep's length, which the caller's evaluation needs.
+Returns:
+    True.  This scheme always ends with a force evaluation.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleIntegratorSymplecticEuler::IntegrateExceptLastEvaluation(
+    IParticleForceEvaluator &forceEvaluator, std::vector<Particle> &particleCollection, 
+    const ParticlePropertyStorage &particleProperties, float deltaTimeSec, 
+    float *putLastEvaluationSecHere)
+{
+    float substepSec = deltaTimeSec / _numSubsteps;
+    for (int substepCount = 0; substepCount < _numSubsteps; substepCount++)
+    {
+        MoveParticles(particleCollection, particleProperties, substepSec);
+        if (substepCount < _numSubsteps - 1)
+        {
+            forceEvaluator.EvaluateForces(particleCollection, particleProperties, substepSec);
+        }
+    }
+
+    *putLastEvaluationSecHere = substepSec;
+    return true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.
+Parameters: 
+    pScheduler  The pool to move the chunks on.  0 to move them on the calling thread.  Must 
+                outlive its use.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleIntegratorSymplecticEuler::SetScheduler(ParticleTaskScheduler *pScheduler)
+{
+    _pScheduler = pScheduler;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Cleans up IntegrateExceptLastEvaluation(...).  Runs one substep over every chunk of 
+    particles, forked out on the pool if there is one.
+Parameters:
+    particleCollection  Self-explanatory.
+    particleProperties  Self-explanatory.
+    substepSec          Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleIntegratorSymplecticEuler::MoveParticles(std::vector<Particle> &particleCollection, 
+    const ParticlePropertyStorage &particleProperties, float substepSec)
+{
+    _pParticleCollection = &particleCollection;
+    _pParticleProperties = &particleProperties;
+    _substepSec = substepSec;
+
+    int numChunks = (int)((particleCollection.size() + _PARTICLES_PER_CHUNK - 1) / 
+        _PARTICLES_PER_CHUNK);
+    bool isForked = (_pScheduler != 0) && (_pScheduler->NumWorkerThreads() > 0);
+    if (isForked)
+    {
+        std::atomic<int> joinCounter(0);
+        _pJoinCounter = &joinCounter;
+        _pScheduler->Spawn(joinCounter, &MoveChunksJob, this, 0, numChunks);
+        _pScheduler->Wait(joinCounter);
+        _pJoinCounter = 0;
+    }
+    else
+    {
+        for (int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++)
+        {
+            MoveChunk(chunkIndex);
+        }
+    }
+
+    _pParticleCollection = 0;
+    _pParticleProperties = 0;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Cleans up MoveParticles(...).  Runs the substep over one chunk of particles.
+Parameters:
+    chunkIndex  Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleIntegratorSymplecticEuler::MoveChunk(int chunkIndex)
+{
+    std::vector<Particle> &particleCollection = *_pParticleCollection;
+    size_t beginIndex = (size_t)chunkIndex * _PARTICLES_PER_CHUNK;
+    size_t endIndex = beginIndex + _PARTICLES_PER_CHUNK;
+    endIndex = (endIndex < particleCollection.size()) ? endIndex : particleCollection.size();
+    if (_pParticleProperties->IsUniform())
+    {
+        UniformParticlePropertyAccess properties(*_pParticleProperties);
+        Substep(properties, particleCollection, _substepSec, beginIndex, endIndex);
+    }
+    else
+    {
+        SpeciesParticlePropertyAccess properties(*_pParticleProperties);
+        Substep(properties, particleCollection, _substepSec, beginIndex, endIndex);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    One forked job of a substep.  Splits its range of chunks in half, spawning the back half, 
+    until it is down to a single chunk, then moves that.
+Parameters:
+    context     The integrator.
+    begin, end  The range of chunks.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleIntegratorSymplecticEuler::MoveChunksJob(void *context, int begin, int end)
+{
+    ParticleIntegratorSymplecticEuler *pIntegrator = (ParticleIntegratorSymplecticEuler *)context;
+    while (end - begin > 1)
+    {
+        int middle = begin + (end - begin) / 2;
+        pIntegrator->_pScheduler->Spawn(*pIntegrator->_pJoinCounter, &MoveChunksJob, context, 
+            middle, end);
+        end = middle;
+    }
+
+    if (begin < end)
+    {
+        pIntegrator->MoveChunk(begin);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    velocity += acceleration * delta time
+    position += velocity * delta time
+Parameters:
+    properties          One of the accessors in ParticlePropertyAccess.h.
+    particleCollection  Self-explanatory.
+    substepSec          Self-explanatory.
+    beginIndex          The first particle to move.
+    endIndex            One past the last particle to move.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (7-4-2016)
+-----------------------------------------------------------------------------------------------*/
+template<typename PROPERTIES>
+void ParticleIntegratorSymplecticEuler::Substep(const PROPERTIES &properties, 
+    std::vector<Particle> &particleCollection, float substepSec, size_t beginIndex, 
+    size_t endIndex) const
+{
+    for (size_t particleIndex = beginIndex; particleIndex < endIndex; particleIndex++)
+    {
+        Particle &p = particleCollection[particleIndex];
+        if (!p._isActive || p._isAsleep)
+        {
+            continue;
+        }
+
+        // force = mass * acceleration => acceleration = force / mass
+        glm::vec2 acceleration = p._netForce * properties.InverseMass(particleIndex);
+        p._velocity += (acceleration * substepSec);
+        p._position += (p._velocity * substepSec);
+    }
+}
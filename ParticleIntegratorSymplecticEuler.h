@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include "IParticleIntegrator.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Semi-implicit (symplectic) Euler: update velocity with the current force, then position 
+    with the new velocity, then evaluate forces at the new position.  One force evaluation per 
+    substep.  This is what ParticleUpdater used to do.
+
+    Each particle only moves itself, so the particles are moved in chunks, which can run at 
+    the same time on a pool.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticleIntegratorSymplecticEuler : public IParticleIntegrator
+{
+public:
+    ParticleIntegratorSymplecticEuler(const int numSubsteps = 1);
+    virtual void Integrate(IParticleForceEvaluator &forceEvaluator, 
+        std::vector<Particle> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties, float deltaTimeSec);
+    virtual bool IntegrateExceptLastEvaluation(IParticleForceEvaluator &forceEvaluator, 
+        std::vector<Particle> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties, float deltaTimeSec, 
+        float *putLastEvaluationSecHere);
+    virtual void SetScheduler(ParticleTaskScheduler *pScheduler);
+
+private:
+    void MoveParticles(std::vector<Particle> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties, float substepSec);
+    void MoveChunk(int chunkIndex);
+    static void MoveChunksJob(void *context, int begin, int end);
+
+    // PROPERTIES is one of the accessors in ParticlePropertyAccess.h
+    template<typename PROPERTIES>
+    void Substep(const PROPERTIES &properties, std::vector<Particle> &particleCollection, 
+        float substepSec, size_t beginIndex, size_t endIndex) const;
+
+    int _numSubsteps;
+
+    // 0 unless the chunks are moved on a pool; the counter is only set during a substep
+    ParticleTaskScheduler *_pScheduler;
+    std::atomic<int> *_pJoinCounter;
+
+    // only set during a substep
+    std::vector<Particle> *_pParticleCollection;
+    const ParticlePropertyStorage *_pParticleProperties;
+    float _substepSec;
+
+    // the particles are moved in chunks of this many
+    static const int _PARTICLES_PER_CHUNK = 2048;
+};
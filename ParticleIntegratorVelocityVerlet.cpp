@@ -0,0 +1,115 @@
+#include "ParticleIntegratorVelocityVerlet.h"
+
+#include "ParticlePropertyAccess.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.
+Parameters:
+    numSubsteps     Each step is split into this many equal substeps.  At least 1.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleIntegratorVelocityVerlet::ParticleIntegratorVelocityVerlet(const int numSubsteps) :
+    _numSubsteps((numSubsteps < 1) ? 1 : numSubsteps)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Advances every awake, active particle by delta time.
+Parameters:
+    forceEvaluator      Called once per substep.
+    particleCollection  Self-explanatory.
+    particleProperties  Where the particle masses come from.
+    deltaTimeSec        Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleIntegratorVelocityVerlet::Integrate(IParticleForceEvaluator &forceEvaluator,
+    std::vector<Particle> &particleCollection, 
+    const ParticlePropertyStorage &particleProperties, float deltaTimeSec)
+{
+    float substepSec = deltaTimeSec / _numSubsteps;
+    for (int substepCount = 0; substepCount < _numSubsteps; substepCount++)
+    {
+        if (particleProperties.IsUniform())
+        {
+            UniformParticlePropertyAccess properties(particleProperties);
+            KickAndDrift(properties, particleCollection, substepSec);
+            forceEvaluator.EvaluateForces(particleCollection, particleProperties, substepSec);
+            Kick(properties, particleCollection, substepSec);
+        }
+        else
+        {
+            SpeciesParticlePropertyAccess properties(particleProperties);
+            KickAndDrift(properties, particleCollection, substepSec);
+            forceEvaluator.EvaluateForces(particleCollection, particleProperties, substepSec);
+            Kick(properties, particleCollection, substepSec);
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    velocity += acceleration * (delta time / 2)
+    position += velocity * delta time
+
+    Together that is position += v * dt + a * dt^2 / 2.
+Parameters:
+    properties          One of the accessors in ParticlePropertyAccess.h.
+    particleCollection  Self-explanatory.
+    substepSec          Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<typename PROPERTIES>
+void ParticleIntegratorVelocityVerlet::KickAndDrift(const PROPERTIES &properties, 
+    std::vector<Particle> &particleCollection, float substepSec) const
+{
+    float halfSubstepSec = 0.5f * substepSec;
+    for (size_t particleIndex = 0; particleIndex < particleCollection.size(); particleIndex++)
+    {
+        Particle &p = particleCollection[particleIndex];
+        if (!p._isActive || p._isAsleep)
+        {
+            continue;
+        }
+
+        glm::vec2 acceleration = p._netForce * properties.InverseMass(particleIndex);
+        p._velocity += (acceleration * halfSubstepSec);
+        p._position += (p._velocity * substepSec);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    velocity += (new acceleration) * (delta time / 2)
+Parameters:
+    properties          One of the accessors in ParticlePropertyAccess.h.
+    particleCollection  Self-explanatory.  Forces must have been evaluated at the new position.
+    substepSec          Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<typename PROPERTIES>
+void ParticleIntegratorVelocityVerlet::Kick(const PROPERTIES &properties, 
+    std::vector<Particle> &particleCollection, float substepSec) const
+{
+    float halfSubstepSec = 0.5f * substepSec;
+    for (size_t particleIndex = 0; particleIndex < particleCollection.size(); particleIndex++)
+    {
+        Particle &p = particleCollection[particleIndex];
+        if (!p._isActive || p._isAsleep)
+        {
+            continue;
+        }
+
+        glm::vec2 acceleration = p._netForce * properties.InverseMass(particleIndex);
+        p._velocity += (acceleration * halfSubstepSec);
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "IParticleIntegrator.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Velocity Verlet: half a kick with the current force, a full drift, a force evaluation at the 
+    new position, then the other half kick with the new force.  One force evaluation per 
+    substep, like symplectic Euler, but second order accurate for position-dependent forces.
+
+    Note: Velocity-dependent forces (elastic impulses, dashpots) see the half-kicked velocity.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticleIntegratorVelocityVerlet : public IParticleIntegrator
+{
+public:
+    ParticleIntegratorVelocityVerlet(const int numSubsteps = 1);
+    virtual void Integrate(IParticleForceEvaluator &forceEvaluator, 
+        std::vector<Particle> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties, float deltaTimeSec);
+
+private:
+    // PROPERTIES is one of the accessors in ParticlePropertyAccess.h
+    template<typename PROPERTIES>
+    void KickAndDrift(const PROPERTIES &properties, std::vector<Particle> &particleCollection, 
+        float substepSec) const;
+    template<typename PROPERTIES>
+    void Kick(const PROPERTIES &properties, std::vector<Particle> &particleCollection, 
+        float substepSec) const;
+
+    int _numSubsteps;
+};
@@ -0,0 +1,223 @@
+#include "ParticlePeriodicGhosts.h"
+
+#include <algorithm>
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Ensures that the object starts object with initialized values.  Periodic boundaries are 
+    off until SetRegion(...) is called.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticlePeriodicGhosts::ParticlePeriodicGhosts() :
+    _regionHalfWidth(0.0f),
+    _numRealParticles(0)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.  The region must fit inside the spatial tree's region with room to 
+    spare for the ghosts.
+Parameters:
+    regionCenter        Self-explanatory.
+    regionHalfWidth     Half the length of a side.  0 turns periodic boundaries off.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticlePeriodicGhosts::SetRegion(const glm::vec2 &regionCenter, 
+    const float regionHalfWidth)
+{
+    _regionCenter = regionCenter;
+    _regionHalfWidth = regionHalfWidth;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    True if there is a periodic region.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticlePeriodicGhosts::IsEnabled() const
+{
+    return _regionHalfWidth > 0.0f;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Picks the ghosts and fills out the scratch collection and properties.  An active particle 
+    within the band of one side gets a ghost across the opposite side.  If it is within the 
+    band of two sides (a corner), then it also gets a ghost across the opposite corner.
+Parameters:
+    particleCollection  The real particles.
+    particleProperties  The real particles' species.
+    bandWidth           Particles this close to a side get ghosts.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticlePeriodicGhosts::Build(const std::vector<Particle> &particleCollection, 
+    const ParticlePropertyStorage &particleProperties, float bandWidth)
+{
+    _numRealParticles = particleCollection.size();
+    _broadphaseParticles.assign(particleCollection.begin(), particleCollection.end());
+    _ghostSourceIndices.clear();
+    _ghostShifts.clear();
+
+    float width = 2.0f * _regionHalfWidth;
+    float bandStart = _regionHalfWidth - bandWidth;
+    for (size_t particleIndex = 0; particleIndex < _numRealParticles; particleIndex++)
+    {
+        const Particle &p = particleCollection[particleIndex];
+        if (!p._isActive)
+        {
+            continue;
+        }
+
+        // near the low side => ghost past the high side, and vice versa
+        glm::vec2 centerToParticle = p._position - _regionCenter;
+        float shiftX = (centerToParticle.x < -bandStart) ? width : 
+            ((centerToParticle.x > bandStart) ? -width : 0.0f);
+        float shiftY = (centerToParticle.y < -bandStart) ? width : 
+            ((centerToParticle.y > bandStart) ? -width : 0.0f);
+        if (shiftX != 0.0f)
+        {
+            AddGhost((int)particleIndex, p, glm::vec2(shiftX, 0.0f));
+        }
+        if (shiftY != 0.0f)
+        {
+            AddGhost((int)particleIndex, p, glm::vec2(0.0f, shiftY));
+        }
+        if (shiftX != 0.0f && shiftY != 0.0f)
+        {
+            AddGhost((int)particleIndex, p, glm::vec2(shiftX, shiftY));
+        }
+    }
+
+    _broadphaseProperties = particleProperties;
+    _broadphaseProperties.AppendCopiesOfParticles(_ghostSourceIndices);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Copies the real particles into the scratch collection again and moves each ghost to 
+    match its real particle.  The set of ghosts doesn't change.  Call it before every 
+    collision pass that reuses the tree.
+Parameters:
+    particleCollection  The real particles.  Same size as when Build(...) was called.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticlePeriodicGhosts::Refresh(const std::vector<Particle> &particleCollection)
+{
+    std::copy(particleCollection.begin(), particleCollection.begin() + _numRealParticles, 
+        _broadphaseParticles.begin());
+    for (size_t ghostCount = 0; ghostCount < _ghostSourceIndices.size(); ghostCount++)
+    {
+        Particle &ghost = _broadphaseParticles[_numRealParticles + ghostCount];
+        ghost = particleCollection[_ghostSourceIndices[ghostCount]];
+        ghost._position += _ghostShifts[ghostCount];
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Copies the real particles out of the scratch collection after a collision pass.  The 
+    ghosts are dropped.
+Parameters:
+    particleCollection  The real particles.  Same size as when Build(...) was called.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticlePeriodicGhosts::CopyBack(std::vector<Particle> &particleCollection) const
+{
+    std::copy(_broadphaseParticles.begin(), _broadphaseParticles.begin() + _numRealParticles, 
+        particleCollection.begin());
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.  The tree and the collision pass run on this.
+Parameters: None
+Returns:
+    The real particles followed by the ghosts.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+std::vector<Particle> &ParticlePeriodicGhosts::BroadphaseParticles()
+{
+    return _broadphaseParticles;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    The species of the real particles followed by those of the ghosts.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+const ParticlePropertyStorage &ParticlePeriodicGhosts::BroadphaseProperties() const
+{
+    return _broadphaseProperties;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many ghosts the last Build(...) made.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticlePeriodicGhosts::NumGhosts() const
+{
+    return (int)_ghostSourceIndices.size();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.  Lets anything that works on the broadphase collection turn a ghost's 
+    index back into its real particle's index.
+Parameters: None
+Returns:
+    One entry per ghost, in the order that they follow the real particles.  The index of the 
+    real particle that the ghost was copied from.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+const int *ParticlePeriodicGhosts::GhostSourceIndices() const
+{
+    return _ghostSourceIndices.data();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Cleans up Build(...).
+Parameters:
+    sourceIndex     The real particle's index.
+    source          The real particle.
+    shift           Added to the real particle's position.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticlePeriodicGhosts::AddGhost(int sourceIndex, const Particle &source, 
+    const glm::vec2 &shift)
+{
+    Particle ghost = source;
+    ghost._position += shift;
+    _broadphaseParticles.push_back(ghost);
+    _ghostSourceIndices.push_back(sourceIndex);
+    _ghostShifts.push_back(shift);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+#include "Particle.h"
+#include "ParticleProperties.h"
+#include "glm/vec2.hpp"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The broadphase's view of a periodic (wrap-around) square region.  Particles that leave one 
+    side of the region come back in on the other (see ParticleUpdater::SetPeriodicRegion(...)), 
+    so a particle near one side has neighbors just across the seam on the opposite side.  The 
+    spatial tree only knows about positions, so it is given ghost copies of every particle 
+    within a band of a side, moved by one region width to just outside the opposite side.
+
+    The ghosts never go into the particle storage.  This keeps a scratch collection that is 
+    the real particles (same indices) followed by the ghosts, and a matching copy of the 
+    particle properties so that a ghost has the same species as its real particle.  The tree 
+    and the collision pass run on the scratch collection, and then only the real particles 
+    are copied back.  Whatever was done to the ghosts is thrown away.
+
+    That is enough because every particle near a seam has a ghost on the other side: a real 
+    particle gets its force from the ghost of its neighbor across the seam, and that neighbor 
+    gets its force from the real particle's ghost.  Each side of the pair is calculated once.
+
+    Note: The ghosts are picked when the tree is built, and their positions are updated from 
+    their real particles while the tree is reused, so the band has to include how far the 
+    particles can move before the tree is rebuilt.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticlePeriodicGhosts
+{
+public:
+    ParticlePeriodicGhosts();
+    void SetRegion(const glm::vec2 &regionCenter, const float regionHalfWidth);
+    bool IsEnabled() const;
+
+    void Build(const std::vector<Particle> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties, float bandWidth);
+    void Refresh(const std::vector<Particle> &particleCollection);
+    void CopyBack(std::vector<Particle> &particleCollection) const;
+
+    std::vector<Particle> &BroadphaseParticles();
+    const ParticlePropertyStorage &BroadphaseProperties() const;
+    int NumGhosts() const;
+    const int *GhostSourceIndices() const;
+
+private:
+    void AddGhost(int sourceIndex, const Particle &source, const glm::vec2 &shift);
+
+    // 0 if periodic boundaries are off
+    glm::vec2 _regionCenter;
+    float _regionHalfWidth;
+
+    // real particles first, then ghosts
+    std::vector<Particle> _broadphaseParticles;
+    ParticlePropertyStorage _broadphaseProperties;
+    size_t _numRealParticles;
+
+    // one entry per ghost
+    std::vector<int> _ghostSourceIndices;
+    std::vector<glm::vec2> _ghostShifts;
+};
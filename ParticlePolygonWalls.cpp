@@ -0,0 +1,424 @@
+#include "ParticlePolygonWalls.h"
+
+#include <algorithm>
+#include <math.h>
+#include "glload/include/glload/gl_4_4.h"   // for GL draw style in GenerateGeometry(...)
+#include "glm/detail/func_common.hpp" // for glm::min and glm::max
+#include "glm/detail/func_geometric.hpp" // for glm::dot
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Ensures that the object starts object with initialized values.  The walls start out empty.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticlePolygonWalls::ParticlePolygonWalls() :
+    _restitution(0.8f),
+    _numParticlesBounced(0)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Adds a closed loop of edges from each corner to the next and from the last back to the 
+    first.  The winding order doesn't matter because the edges are two-sided.  Nothing is 
+    collided against it until the next Build().
+Parameters:
+    corners     At least 2.  Fewer are ignored.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticlePolygonWalls::AddPolygon(const std::vector<glm::vec2> &corners)
+{
+    if (corners.size() < 2)
+    {
+        return;
+    }
+
+    _allPolygons.push_back(corners);
+    for (size_t cornerIndex = 0; cornerIndex < corners.size(); cornerIndex++)
+    {
+        _edgeStarts.push_back(corners[cornerIndex]);
+        _edgeEnds.push_back(corners[(cornerIndex + 1) % corners.size()]);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.  The wall's half of the restitution; it is averaged with the 
+    particle's own, like a particle-particle pair.
+Parameters:
+    restitution     0 is perfectly inelastic, 1 is perfectly elastic.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticlePolygonWalls::SetRestitution(const float restitution)
+{
+    _restitution = restitution;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Builds the BVH over all the edges that have been added so far and lays out the edges in 
+    leaf order.  Call it once after the last AddPolygon(...).  It is not cheap, but the walls 
+    are static.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticlePolygonWalls::Build()
+{
+    _bvhNodes.clear();
+    if (_edgeStarts.empty())
+    {
+        return;
+    }
+
+    // a binary tree with N leaves has 2N - 1 nodes, and there is at most one leaf per edge
+    _bvhNodes.reserve(2 * _edgeStarts.size());
+    _bvhNodes.push_back(BvhNode());
+    BuildNode(0, 0, (int)_edgeStarts.size());
+
+    // now that the edges are sorted, lay them out for the leaf loops
+    size_t numEdges = _edgeStarts.size();
+    _edgeStartX.resize(numEdges);
+    _edgeStartY.resize(numEdges);
+    _edgeDirectionX.resize(numEdges);
+    _edgeDirectionY.resize(numEdges);
+    _edgeInverseLengthSqr.resize(numEdges);
+    for (size_t edgeIndex = 0; edgeIndex < numEdges; edgeIndex++)
+    {
+        glm::vec2 direction = _edgeEnds[edgeIndex] - _edgeStarts[edgeIndex];
+        float lengthSqr = glm::dot(direction, direction);
+        _edgeStartX[edgeIndex] = _edgeStarts[edgeIndex].x;
+        _edgeStartY[edgeIndex] = _edgeStarts[edgeIndex].y;
+        _edgeDirectionX[edgeIndex] = direction.x;
+        _edgeDirectionY[edgeIndex] = direction.y;
+
+        // a zero-length edge is a point; the projection is then 0 and the distance is to 
+        // the start
+        _edgeInverseLengthSqr[edgeIndex] = (lengthSqr > 0.0f) ? (1.0f / lengthSqr) : 0.0f;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Pushes every active, awake particle that is overlapping an edge back out of it and 
+    bounces it off.  Run this after the particles have moved.
+Parameters:
+    particleCollection  Self-explanatory.
+    particleProperties  Radius and restitution by species.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticlePolygonWalls::CollideParticles(std::vector<Particle> &particleCollection,
+    const ParticlePropertyStorage &particleProperties) const
+{
+    _numParticlesBounced = 0;
+    if (_bvhNodes.empty())
+    {
+        return;
+    }
+
+    // a few floats per species, so look them up once instead of once per particle
+    float radiusBySpecies[MAX_PARTICLE_SPECIES];
+    float restitutionBySpecies[MAX_PARTICLE_SPECIES];
+    for (int speciesId = 0; speciesId < MAX_PARTICLE_SPECIES; speciesId++)
+    {
+        const ParticleProperties &properties = particleProperties.GetSpeciesProperties((unsigned char)speciesId);
+        radiusBySpecies[speciesId] = properties._radiusOfInfluence;
+        restitutionBySpecies[speciesId] = 0.5f * (_restitution + properties._restitution);
+    }
+
+    bool isUniform = particleProperties.IsUniform();
+    unsigned char uniformSpecies = particleProperties.UniformSpecies();
+    const unsigned char *allSpeciesIds = particleProperties.AllSpecies();
+    for (size_t particleIndex = 0; particleIndex < particleCollection.size(); particleIndex++)
+    {
+        Particle &p = particleCollection[particleIndex];
+        if (!p._isActive || p._isAsleep)
+        {
+            continue;
+        }
+
+        unsigned char species = isUniform ? uniformSpecies : allSpeciesIds[particleIndex];
+        if (CollideParticle(p, radiusBySpecies[species], restitutionBySpecies[species]))
+        {
+            _numParticlesBounced++;
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Generates lines for every polygon.  The walls don't change, so call this once during 
+    setup and then GeometryData::Init(...).
+Parameters: 
+    putDataHere     Self-explanatory
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticlePolygonWalls::GenerateGeometry(GeometryData *putDataHere) const
+{
+    putDataHere->_verts.clear();
+    putDataHere->_indices.clear();
+    putDataHere->_drawStyle = GL_LINES;
+
+    // 2 vertices per line
+    // Note: These are lines, so there is no concern about clockwise or counterclockwise.
+    for (size_t polygonIndex = 0; polygonIndex < _allPolygons.size(); polygonIndex++)
+    {
+        const std::vector<glm::vec2> &corners = _allPolygons[polygonIndex];
+        unsigned short firstCornerIndex = (unsigned short)putDataHere->_verts.size();
+        for (size_t cornerIndex = 0; cornerIndex < corners.size(); cornerIndex++)
+        {
+            MyVertex v;
+            v._position = corners[cornerIndex];
+            putDataHere->_verts.push_back(v);
+
+            putDataHere->_indices.push_back((unsigned short)(firstCornerIndex + cornerIndex));
+            putDataHere->_indices.push_back((unsigned short)(firstCornerIndex + 
+                ((cornerIndex + 1) % corners.size())));
+        }
+    }
+
+    // used for glBufferData(...) and glBufferSubData(...)
+    putDataHere->_vertexBufferSizeBytes = putDataHere->_verts.size() * sizeof(putDataHere->_verts[0]);
+    putDataHere->_elementBufferSizeBytes = putDataHere->_indices.size() * sizeof(putDataHere->_indices[0]);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    The number of edges in all polygons.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticlePolygonWalls::NumEdges() const
+{
+    return (int)_edgeStarts.size();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.  Used to show how busy the walls are.
+Parameters: None
+Returns:
+    The number of particles that were pushed out of a wall by the last CollideParticles(...).
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticlePolygonWalls::NumParticlesBouncedLastCollide() const
+{
+    return _numParticlesBounced;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Fills out a node for the given range of edges and, if there are too many edges for one 
+    leaf, sorts them about the median along the longer axis of their centers and recurses.  
+    The two children are added next to each other.
+Parameters:
+    nodeIndex   Already allocated.
+    firstEdge   Self-explanatory.
+    numEdges    At least 1.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticlePolygonWalls::BuildNode(int nodeIndex, int firstEdge, int numEdges)
+{
+    glm::vec2 minCorner = glm::min(_edgeStarts[firstEdge], _edgeEnds[firstEdge]);
+    glm::vec2 maxCorner = glm::max(_edgeStarts[firstEdge], _edgeEnds[firstEdge]);
+    glm::vec2 minCenter = 0.5f * (_edgeStarts[firstEdge] + _edgeEnds[firstEdge]);
+    glm::vec2 maxCenter = minCenter;
+    for (int edgeIndex = firstEdge + 1; edgeIndex < firstEdge + numEdges; edgeIndex++)
+    {
+        minCorner = glm::min(minCorner, glm::min(_edgeStarts[edgeIndex], _edgeEnds[edgeIndex]));
+        maxCorner = glm::max(maxCorner, glm::max(_edgeStarts[edgeIndex], _edgeEnds[edgeIndex]));
+        glm::vec2 center = 0.5f * (_edgeStarts[edgeIndex] + _edgeEnds[edgeIndex]);
+        minCenter = glm::min(minCenter, center);
+        maxCenter = glm::max(maxCenter, center);
+    }
+    _bvhNodes[nodeIndex]._minCorner = minCorner;
+    _bvhNodes[nodeIndex]._maxCorner = maxCorner;
+
+    if (numEdges <= _MAX_EDGES_PER_LEAF)
+    {
+        _bvhNodes[nodeIndex]._firstChildOrEdge = firstEdge;
+        _bvhNodes[nodeIndex]._numEdges = numEdges;
+        return;
+    }
+
+    // sort an index list and then shuffle both edge arrays to match
+    int axis = ((maxCenter.x - minCenter.x) >= (maxCenter.y - minCenter.y)) ? 0 : 1;
+    std::vector<int> order(numEdges);
+    for (int i = 0; i < numEdges; i++)
+    {
+        order[i] = firstEdge + i;
+    }
+    int numLeft = numEdges / 2;
+    const std::vector<glm::vec2> &starts = _edgeStarts;
+    const std::vector<glm::vec2> &ends = _edgeEnds;
+    std::nth_element(order.begin(), order.begin() + numLeft, order.end(),
+        [&starts, &ends, axis](int a, int b) 
+    {
+        // comparing the sums is the same as comparing the centers
+        return (starts[a][axis] + ends[a][axis]) < (starts[b][axis] + ends[b][axis]);
+    });
+
+    std::vector<glm::vec2> sortedStarts(numEdges);
+    std::vector<glm::vec2> sortedEnds(numEdges);
+    for (int i = 0; i < numEdges; i++)
+    {
+        sortedStarts[i] = _edgeStarts[order[i]];
+        sortedEnds[i] = _edgeEnds[order[i]];
+    }
+    std::copy(sortedStarts.begin(), sortedStarts.end(), _edgeStarts.begin() + firstEdge);
+    std::copy(sortedEnds.begin(), sortedEnds.end(), _edgeEnds.begin() + firstEdge);
+
+    // the left child's subtree would otherwise come between the two children, so make both 
+    // slots first and then fill them in
+    int leftIndex = (int)_bvhNodes.size();
+    _bvhNodes.push_back(BvhNode());
+    _bvhNodes.push_back(BvhNode());
+    _bvhNodes[nodeIndex]._firstChildOrEdge = leftIndex;
+    _bvhNodes[nodeIndex]._numEdges = 0;
+    BuildNode(leftIndex, firstEdge, numLeft);
+    BuildNode(leftIndex + 1, firstEdge + numLeft, numEdges - numLeft);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Walks the BVH for the leaves that the particle's circle of influence overlaps and finds 
+    the closest point on any edge in them.  Each leaf is a single pass over its edges with no 
+    branches, and the closest one is picked after the pass.  If the closest point is inside 
+    the radius, the particle is moved out to the radius and bounced.
+
+    Note: Only the closest edge is resolved.  A particle wedged into a corner is pushed out 
+    of one edge this step and the other next step, which is fine at the speeds that the 
+    demo uses.
+Parameters:
+    p           Self-explanatory.
+    radius      The particle's radius of influence.
+    restitution Combined wall and particle restitution.
+Returns:
+    True if the particle was touching an edge.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticlePolygonWalls::CollideParticle(Particle &p, float radius, float restitution) const
+{
+    glm::vec2 boxMin = p._position - glm::vec2(radius);
+    glm::vec2 boxMax = p._position + glm::vec2(radius);
+    float px = p._position.x;
+    float py = p._position.y;
+
+    // closest so far, as the offset from the closest point to the particle
+    float closestDistanceSqr = radius * radius;
+    float closestOffsetX = 0.0f;
+    float closestOffsetY = 0.0f;
+    int closestEdge = -1;
+
+    int nodeStack[_MAX_BVH_DEPTH];
+    int stackSize = 0;
+    nodeStack[stackSize++] = 0;
+    while (stackSize > 0)
+    {
+        const BvhNode &node = _bvhNodes[nodeStack[--stackSize]];
+        if (boxMin.x > node._maxCorner.x || boxMax.x < node._minCorner.x ||
+            boxMin.y > node._maxCorner.y || boxMax.y < node._minCorner.y)
+        {
+            continue;
+        }
+
+        if (node._numEdges == 0)
+        {
+            // a median split is balanced, so this can't overflow, but don't trust it
+            if (stackSize + 2 <= _MAX_BVH_DEPTH)
+            {
+                nodeStack[stackSize++] = node._firstChildOrEdge;
+                nodeStack[stackSize++] = node._firstChildOrEdge + 1;
+            }
+            continue;
+        }
+
+        // offset from the closest point on each edge to the particle
+        // Note: Clamping the projection to [0,1] is a min and a max, so there are no branches 
+        // in this loop.
+        float offsetX[_MAX_EDGES_PER_LEAF];
+        float offsetY[_MAX_EDGES_PER_LEAF];
+        float distanceSqr[_MAX_EDGES_PER_LEAF];
+        const float *startX = &_edgeStartX[node._firstChildOrEdge];
+        const float *startY = &_edgeStartY[node._firstChildOrEdge];
+        const float *directionX = &_edgeDirectionX[node._firstChildOrEdge];
+        const float *directionY = &_edgeDirectionY[node._firstChildOrEdge];
+        const float *inverseLengthSqr = &_edgeInverseLengthSqr[node._firstChildOrEdge];
+        int numEdges = node._numEdges;
+        for (int i = 0; i < numEdges; i++)
+        {
+            float toParticleX = px - startX[i];
+            float toParticleY = py - startY[i];
+            float t = (toParticleX * directionX[i] + toParticleY * directionY[i]) * inverseLengthSqr[i];
+            t = std::min(std::max(t, 0.0f), 1.0f);
+            offsetX[i] = toParticleX - t * directionX[i];
+            offsetY[i] = toParticleY - t * directionY[i];
+            distanceSqr[i] = offsetX[i] * offsetX[i] + offsetY[i] * offsetY[i];
+        }
+
+        for (int i = 0; i < numEdges; i++)
+        {
+            if (distanceSqr[i] < closestDistanceSqr)
+            {
+                closestDistanceSqr = distanceSqr[i];
+                closestOffsetX = offsetX[i];
+                closestOffsetY = offsetY[i];
+                closestEdge = node._firstChildOrEdge + i;
+            }
+        }
+    }
+
+    if (closestEdge < 0)
+    {
+        return false;
+    }
+
+    glm::vec2 normal;
+    float distance = sqrtf(closestDistanceSqr);
+    if (distance > 0.0f)
+    {
+        normal = glm::vec2(closestOffsetX, closestOffsetY) / distance;
+    }
+    else
+    {
+        // right on the line, so there is no side to push it out on; use the edge's normal on 
+        // the side that the particle came from
+        glm::vec2 direction(_edgeDirectionX[closestEdge], _edgeDirectionY[closestEdge]);
+        normal = glm::vec2(-direction.y, direction.x) * sqrtf(_edgeInverseLengthSqr[closestEdge]);
+        if (glm::dot(normal, p._velocity) > 0.0f)
+        {
+            normal = -normal;
+        }
+    }
+
+    p._position += normal * (radius - distance);
+
+    float normalSpeed = glm::dot(p._velocity, normal);
+    if (normalSpeed < 0.0f)
+    {
+        p._velocity -= (1.0f + restitution) * normalSpeed * normal;
+    }
+
+    // counted like a particle-particle collision
+    p._collisionCountThisFrame += 1;
+    return true;
+}
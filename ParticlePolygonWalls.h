@@ -0,0 +1,90 @@
+#pragma once
+
+#include <vector>
+#include "Particle.h"
+#include "ParticleProperties.h"
+#include "GeometryData.h"
+#include "glm/vec2.hpp"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Static polygonal walls and obstacles that particles bounce off.  Each polygon is a closed 
+    loop of edges, and every edge is two-sided, so the same polygon works as a container (the 
+    particles are inside it) or as an obstacle (they are outside it).
+
+    The edges don't move, so they are indexed once in Build() by a bounding volume hierarchy: 
+    a binary tree of boxes, split at the median edge along the longest axis, with at most 
+    _MAX_EDGES_PER_LEAF edges per leaf.  A particle only looks at the leaves whose boxes it 
+    overlaps, so a complicated container costs about log(number of edges) per particle.
+
+    The edges are stored leaf by leaf as separate arrays of floats (start x, start y, 
+    direction x, ...) instead of as an array of edge structures.  Each leaf's distance tests 
+    are one branch-free loop over those arrays, which the compiler can vectorize, and the 
+    closest edge is picked afterwards.
+
+    A particle that is closer to an edge than its radius of influence is pushed back out to 
+    the radius and, if it is moving into the edge, its velocity along the edge's normal is 
+    reflected with the restitution.
+
+    Note: Like the particle-particle collisions, this only looks at where the particles are at 
+    the end of the step, so a particle that moves further than its radius in one step can pass 
+    through a wall.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticlePolygonWalls
+{
+public:
+    ParticlePolygonWalls();
+    void AddPolygon(const std::vector<glm::vec2> &corners);
+    void SetRestitution(const float restitution);
+    void Build();
+
+    void CollideParticles(std::vector<Particle> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties) const;
+
+    void GenerateGeometry(GeometryData *putDataHere) const;
+    int NumEdges() const;
+    int NumParticlesBouncedLastCollide() const;
+
+private:
+    struct BvhNode
+    {
+        glm::vec2 _minCorner;
+        glm::vec2 _maxCorner;
+
+        // if this is a leaf, the first edge; otherwise the first of the two children, which 
+        // are next to each other
+        int _firstChildOrEdge;
+
+        // 0 if this is not a leaf
+        int _numEdges;
+    };
+
+    void BuildNode(int nodeIndex, int firstEdge, int numEdges);
+    bool CollideParticle(Particle &p, float radius, float restitution) const;
+
+    static const int _MAX_EDGES_PER_LEAF = 8;
+
+    // depth of the traversal's stack; a median split keeps the tree well short of this
+    static const int _MAX_BVH_DEPTH = 64;
+
+    // as given, for drawing
+    std::vector<std::vector<glm::vec2> > _allPolygons;
+
+    // edges as (start, end) pairs until Build() sorts them into leaves
+    std::vector<glm::vec2> _edgeStarts;
+    std::vector<glm::vec2> _edgeEnds;
+
+    // leaf order, one float per edge per array
+    std::vector<float> _edgeStartX;
+    std::vector<float> _edgeStartY;
+    std::vector<float> _edgeDirectionX;
+    std::vector<float> _edgeDirectionY;
+    std::vector<float> _edgeInverseLengthSqr;
+
+    std::vector<BvhNode> _bvhNodes;
+    float _restitution;
+
+    // a count for the display; the walls are otherwise const while colliding
+    mutable int _numParticlesBounced;
+};
@@ -0,0 +1,335 @@
+#include "ParticleProperties.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Ensures that the object starts object with initialized values.  Every species has the
+    default properties and every pair of species interacts at full strength.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticlePropertyStorage::ParticlePropertyStorage() :
+    _numSpeciesInUse(0),
+    _uniformSpecies(0)
+{
+    // species properties already have their own initializers
+    for (int species1 = 0; species1 < MAX_PARTICLE_SPECIES; species1++)
+    {
+        _numParticlesPerSpecies[species1] = 0;
+        for (int species2 = 0; species2 < MAX_PARTICLE_SPECIES; species2++)
+        {
+            _interactionCoefficients[species1][species2] = 1.0f;
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Allocates space for every particle and makes them all species 0.
+Parameters:
+    numParticles    Self-explanatory.
+    defaultSpecies  The properties of species 0.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticlePropertyStorage::Init(unsigned int numParticles,
+    const ParticleProperties &defaultSpecies)
+{
+    _allSpeciesIds.assign(numParticles, 0);
+    _allSpecies[0] = defaultSpecies;
+
+    for (int speciesId = 0; speciesId < MAX_PARTICLE_SPECIES; speciesId++)
+    {
+        _numParticlesPerSpecies[speciesId] = 0;
+    }
+    _numParticlesPerSpecies[0] = numParticles;
+    _numSpeciesInUse = (numParticles > 0) ? 1 : 0;
+    _uniformSpecies = 0;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.  Out-of-range species IDs are ignored.
+Parameters:
+    speciesId   Self-explanatory.
+    properties  Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticlePropertyStorage::SetSpeciesProperties(unsigned char speciesId,
+    const ParticleProperties &properties)
+{
+    if (speciesId >= MAX_PARTICLE_SPECIES)
+    {
+        return;
+    }
+
+    _allSpecies[speciesId] = properties;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets how strongly two species interact.  The table is symmetric, so the order of the two
+    species doesn't matter.  Out-of-range species IDs are ignored.
+Parameters:
+    species1, species2  Self-explanatory.
+    coefficient         Scales the collision response's force.  1 is the default.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticlePropertyStorage::SetInteractionCoefficient(unsigned char species1,
+    unsigned char species2, float coefficient)
+{
+    if (species1 >= MAX_PARTICLE_SPECIES || species2 >= MAX_PARTICLE_SPECIES)
+    {
+        return;
+    }
+
+    _interactionCoefficients[species1][species2] = coefficient;
+    _interactionCoefficients[species2][species1] = coefficient;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Changes the species of a single particle and keeps track of how many species are in use.
+    A scenario that stops mixing species goes back to the fast path once the last particle of
+    the other species is changed.  Out-of-range species IDs are ignored.
+Parameters:
+    particleIndex   Self-explanatory.
+    speciesId       Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticlePropertyStorage::SetSpecies(unsigned int particleIndex, unsigned char speciesId)
+{
+    unsigned char currentSpecies = _allSpeciesIds[particleIndex];
+    if (speciesId == currentSpecies || speciesId >= MAX_PARTICLE_SPECIES)
+    {
+        return;
+    }
+
+    _numParticlesPerSpecies[currentSpecies]--;
+    if (_numParticlesPerSpecies[currentSpecies] == 0)
+    {
+        _numSpeciesInUse--;
+    }
+
+    if (_numParticlesPerSpecies[speciesId] == 0)
+    {
+        _numSpeciesInUse++;
+    }
+    _numParticlesPerSpecies[speciesId]++;
+
+    _allSpeciesIds[particleIndex] = speciesId;
+
+    if (_numSpeciesInUse == 1)
+    {
+        // whichever one still has particles
+        for (int id = 0; id < MAX_PARTICLE_SPECIES; id++)
+        {
+            if (_numParticlesPerSpecies[id] > 0)
+            {
+                _uniformSpecies = (unsigned char)id;
+                break;
+            }
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Adds particles to the end of the collection with the same species as existing ones.  Used 
+    for copies of particles that only exist for the collisions (see ParticlePeriodicGhosts).  
+    The copies are of species that are already in use, so the uniform fast path is unchanged.
+Parameters:
+    sourceParticleIndices   One entry per new particle.  Each must be an existing particle.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticlePropertyStorage::AppendCopiesOfParticles(const std::vector<int> &sourceParticleIndices)
+{
+    for (unsigned int copyCount = 0; copyCount < sourceParticleIndices.size(); copyCount++)
+    {
+        unsigned char speciesId = _allSpeciesIds[sourceParticleIndices[copyCount]];
+        _allSpeciesIds.push_back(speciesId);
+        _numParticlesPerSpecies[speciesId]++;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Moves every particle's species to the particle's new slot after the particle collection 
+    has been reordered (see ParticleSpatialReorder).  The species counts don't change.
+Parameters:
+    oldIndexOfNew   For each slot, the slot that its particle was in before.  One entry per 
+                    particle.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticlePropertyStorage::PermuteParticles(const std::vector<int> &oldIndexOfNew)
+{
+    std::vector<unsigned char> permutedSpeciesIds(_allSpeciesIds.size());
+    for (unsigned int newIndex = 0; newIndex < oldIndexOfNew.size(); newIndex++)
+    {
+        permutedSpeciesIds[newIndex] = _allSpeciesIds[oldIndexOfNew[newIndex]];
+    }
+    _allSpeciesIds.swap(permutedSpeciesIds);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    True if only one species has particles.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticlePropertyStorage::IsUniform() const
+{
+    return _numSpeciesInUse <= 1;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    If IsUniform(), then the species of every particle.  Otherwise meaningless.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned char ParticlePropertyStorage::UniformSpecies() const
+{
+    return _uniformSpecies;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters:
+    particleIndex   Self-explanatory.
+Returns:
+    See description.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned char ParticlePropertyStorage::GetSpecies(unsigned int particleIndex) const
+{
+    return _allSpeciesIds[particleIndex];
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the mixed-species path, which reads species by particle index.
+Parameters: None
+Returns:
+    A pointer to the first particle's species ID.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+const unsigned char *ParticlePropertyStorage::AllSpecies() const
+{
+    return _allSpeciesIds.data();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters:
+    speciesId   Must be less than MAX_PARTICLE_SPECIES.
+Returns:
+    See description.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+const ParticleProperties &ParticlePropertyStorage::GetSpeciesProperties(
+    unsigned char speciesId) const
+{
+    return _allSpecies[speciesId];
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters:
+    species1, species2  Must be less than MAX_PARTICLE_SPECIES.
+Returns:
+    See description.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+float ParticlePropertyStorage::InteractionCoefficient(unsigned char species1,
+    unsigned char species2) const
+{
+    return _interactionCoefficients[species1][species2];
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters:
+    speciesId   Must be less than MAX_PARTICLE_SPECIES.
+Returns:
+    True if at least one particle is of this species.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticlePropertyStorage::SpeciesInUse(unsigned char speciesId) const
+{
+    return _numParticlesPerSpecies[speciesId] > 0;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Used to size neighbor searches.
+Parameters: None
+Returns:
+    The largest radius of influence of any species that has particles.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+float ParticlePropertyStorage::MaxRadiusOfInfluence() const
+{
+    float maxRadius = 0.0f;
+    for (int speciesId = 0; speciesId < MAX_PARTICLE_SPECIES; speciesId++)
+    {
+        if (_numParticlesPerSpecies[speciesId] > 0 &&
+            _allSpecies[speciesId]._radiusOfInfluence > maxRadius)
+        {
+            maxRadius = _allSpecies[speciesId]._radiusOfInfluence;
+        }
+    }
+    return maxRadius;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Used to pick a delta time that keeps the smallest particles from tunneling.
+Parameters: None
+Returns:
+    The smallest radius of influence of any species that has particles, or 0 if there are no 
+    particles.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+float ParticlePropertyStorage::MinRadiusOfInfluence() const
+{
+    float minRadius = 0.0f;
+    for (int speciesId = 0; speciesId < MAX_PARTICLE_SPECIES; speciesId++)
+    {
+        if (_numParticlesPerSpecies[speciesId] > 0 && 
+            (minRadius == 0.0f || _allSpecies[speciesId]._radiusOfInfluence < minRadius))
+        {
+            minRadius = _allSpecies[speciesId]._radiusOfInfluence;
+        }
+    }
+    return minRadius;
+}
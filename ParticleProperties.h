@@ -0,0 +1,113 @@
+#pragma once
+
+#include <vector>
+
+// species IDs are stored as one byte per particle, but the tables are kept small enough to
+// stay in cache
+const int MAX_PARTICLE_SPECIES = 8;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The physical properties of a particle species.  These used to be members of Particle, but
+    most scenes have every particle identical, and then they are just more floats per particle
+    for every pair test to load.  Now each particle only has a species ID (see
+    ParticlePropertyStorage), away from the position and velocity that are touched every frame.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+struct ParticleProperties
+{
+    ParticleProperties() :
+        _mass(0.1f),
+        _radiusOfInfluence(0.01f),
+        _restitution(1.0f)
+    {
+    }
+
+    ParticleProperties(float mass, float radiusOfInfluence, float restitution = 1.0f) :
+        _mass(mass),
+        _radiusOfInfluence(radiusOfInfluence),
+        _restitution(restitution)
+    {
+    }
+
+    float _mass;
+
+    // used for collision detection because a particle's position is float values, so two
+    // particles' positions are almost never going to be exactly equal
+    float _radiusOfInfluence;
+
+    // 1 is perfectly elastic, 0 is perfectly inelastic
+    // Note: Only impulse-based responses use it.  Soft contacts have their own damping.
+    float _restitution;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    What a collision response needs to know about a pair of particles.  One of these is
+    calculated per pair of species at the start of a collision pass (see
+    ParticlePropertyAccess.h), so the pair test only looks it up.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+struct ParticlePairProperties
+{
+    float _mass1;
+    float _mass2;
+
+    // m1 * m2 / (m1 + m2)
+    float _reducedMass;
+
+    // r1 + r2; the regions of influence touch at this distance
+    float _contactDistance;
+
+    // pairs closer than this interact; depends on the collision response
+    float _interactionDistanceSqr;
+
+    // average of the two species' restitution
+    float _restitution;
+
+    // from the species interaction table; scales the response's force (0 means the two species
+    // pass through each other)
+    float _interactionCoefficient;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Stores the species of every particle in a collection, the properties of each species, and
+    a species x species table of interaction coefficients.  Keeps track of how many particles
+    are of each species so that the updater and the collision engines can automatically switch
+    to the uniform fast path when only one species is in use (see ParticlePropertyAccess.h).
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticlePropertyStorage
+{
+public:
+    ParticlePropertyStorage();
+    void Init(unsigned int numParticles, const ParticleProperties &defaultSpecies);
+    void SetSpeciesProperties(unsigned char speciesId, const ParticleProperties &properties);
+    void SetInteractionCoefficient(unsigned char species1, unsigned char species2, float coefficient);
+    void SetSpecies(unsigned int particleIndex, unsigned char speciesId);
+    void AppendCopiesOfParticles(const std::vector<int> &sourceParticleIndices);
+    void PermuteParticles(const std::vector<int> &oldIndexOfNew);
+
+    bool IsUniform() const;
+    unsigned char UniformSpecies() const;
+    unsigned char GetSpecies(unsigned int particleIndex) const;
+    const unsigned char *AllSpecies() const;
+    const ParticleProperties &GetSpeciesProperties(unsigned char speciesId) const;
+    float InteractionCoefficient(unsigned char species1, unsigned char species2) const;
+    bool SpeciesInUse(unsigned char speciesId) const;
+    float MaxRadiusOfInfluence() const;
+    float MinRadiusOfInfluence() const;
+
+private:
+    // one byte per particle
+    std::vector<unsigned char> _allSpeciesIds;
+
+    ParticleProperties _allSpecies[MAX_PARTICLE_SPECIES];
+    float _interactionCoefficients[MAX_PARTICLE_SPECIES][MAX_PARTICLE_SPECIES];
+
+    // the collection is uniform when only one species has particles
+    unsigned int _numParticlesPerSpecies[MAX_PARTICLE_SPECIES];
+    int _numSpeciesInUse;
+    unsigned char _uniformSpecies;
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "ParticleProperties.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    How the collision kernel and the updater get at particle masses and radii.  There are two
+    versions, and the code that uses them is templated on which one, so there is no runtime
+    check in the inner loops:
+    - UniformParticlePropertyAccess: Only one species is in use.  The mass, inverse mass, and
+    the whole pair setup (reduced mass, contact distance, interaction distance, restitution,
+    interaction coefficient) are worked out once in the constructor and every particle index
+    returns the same values.  The species IDs are never touched.
+    - SpeciesParticlePropertyAccess: Species are mixed.  The constructor works out the pair
+    setup for every pair of species into a small table, and each pair test reads the two
+    particles' species IDs (one byte each) and looks up its entry.
+
+    ParticlePropertyStorage::IsUniform() decides which one is used for each pass.
+
+    Both are built on the stack once per pass.  The "range" argument is the collision
+    response's interaction range in contact distances (1 for the updater, which doesn't care).
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+
+// calculates one entry of the pair table; used by both accessors
+inline ParticlePairProperties MakeParticlePairProperties(const ParticleProperties &p1,
+    const ParticleProperties &p2, float interactionCoefficient,
+    float interactionRangeInContactDistances)
+{
+    ParticlePairProperties pair;
+    pair._mass1 = p1._mass;
+    pair._mass2 = p2._mass;
+    pair._reducedMass = (p1._mass * p2._mass) / (p1._mass + p2._mass);
+    pair._contactDistance = p1._radiusOfInfluence + p2._radiusOfInfluence;
+    float interactionDistance = pair._contactDistance * interactionRangeInContactDistances;
+    pair._interactionDistanceSqr = interactionDistance * interactionDistance;
+    pair._restitution = 0.5f * (p1._restitution + p2._restitution);
+    pair._interactionCoefficient = interactionCoefficient;
+    return pair;
+}
+
+class UniformParticlePropertyAccess
+{
+public:
+    UniformParticlePropertyAccess(const ParticlePropertyStorage &storage,
+        float interactionRangeInContactDistances = 1.0f)
+    {
+        unsigned char species = storage.UniformSpecies();
+        const ParticleProperties &properties = storage.GetSpeciesProperties(species);
+        _inverseMass = 1.0f / properties._mass;
+        _maxInteractionDistance = 2.0f * properties._radiusOfInfluence * interactionRangeInContactDistances;
+        _pair = MakeParticlePairProperties(properties, properties,
+            storage.InteractionCoefficient(species, species), interactionRangeInContactDistances);
+    }
+
+    float InverseMass(int /*particleIndex*/) const
+    {
+        return _inverseMass;
+    }
+
+    float MaxInteractionDistance() const
+    {
+        return _maxInteractionDistance;
+    }
+
+    float InteractionDistanceSqr(int /*p1Index*/, int /*p2Index*/) const
+    {
+        return _pair._interactionDistanceSqr;
+    }
+
+    const ParticlePairProperties &PairProperties(int /*p1Index*/, int /*p2Index*/) const
+    {
+        return _pair;
+    }
+
+private:
+    float _inverseMass;
+    float _maxInteractionDistance;
+    ParticlePairProperties _pair;
+};
+
+class SpeciesParticlePropertyAccess
+{
+public:
+    SpeciesParticlePropertyAccess(const ParticlePropertyStorage &storage,
+        float interactionRangeInContactDistances = 1.0f) :
+        _allSpeciesIds(storage.AllSpecies()),
+        _maxInteractionDistance(2.0f * storage.MaxRadiusOfInfluence() * interactionRangeInContactDistances)
+    {
+        for (unsigned char species1 = 0; species1 < MAX_PARTICLE_SPECIES; species1++)
+        {
+            const ParticleProperties &p1 = storage.GetSpeciesProperties(species1);
+            _inverseMass[species1] = 1.0f / p1._mass;
+            for (unsigned char species2 = 0; species2 < MAX_PARTICLE_SPECIES; species2++)
+            {
+                _pairTable[species1][species2] = MakeParticlePairProperties(p1,
+                    storage.GetSpeciesProperties(species2),
+                    storage.InteractionCoefficient(species1, species2),
+                    interactionRangeInContactDistances);
+            }
+        }
+    }
+
+    float InverseMass(int particleIndex) const
+    {
+        return _inverseMass[_allSpeciesIds[particleIndex]];
+    }
+
+    float MaxInteractionDistance() const
+    {
+        return _maxInteractionDistance;
+    }
+
+    float InteractionDistanceSqr(int p1Index, int p2Index) const
+    {
+        return PairProperties(p1Index, p2Index)._interactionDistanceSqr;
+    }
+
+    const ParticlePairProperties &PairProperties(int p1Index, int p2Index) const
+    {
+        return _pairTable[_allSpeciesIds[p1Index]][_allSpeciesIds[p2Index]];
+    }
+
+private:
+    const unsigned char *_allSpeciesIds;
+    float _maxInteractionDistance;
+    float _inverseMass[MAX_PARTICLE_SPECIES];
+    ParticlePairProperties _pairTable[MAX_PARTICLE_SPECIES][MAX_PARTICLE_SPECIES];
+};
@@ -1,5 +1,12 @@
 
 #include "ParticleQuadTree.h"
+
+#include <algorithm>
+#include <math.h>
+#include "ParticleCollisionKernel.h"
+#include "ParticleContactGatherKernel.h"
+#include "ParticleTaskScheduler.h"
+#include "ParticleStats.h"
 #include "glload/include/glload/gl_4_4.h"   // for GL draw style in GenerateGeometry(...)
 #include "glm/detail/func_geometric.hpp" // for normalizing glm vectors
 
@@ -30,24 +37,37 @@ Returns:    None
 Exception:  Safe
 Creator:    John Cox (12-17-2016)
 -----------------------------------------------------------------------------------------------*/
-ParticleQuadTree::ParticleQuadTree() :
+template<int DIM>
+ParticleSpatialTree<DIM>::ParticleSpatialTree() :
+    _numCellsPerAxisInitial(8),
+    _pendingNumCellsPerAxisInitial(8),
+    _numStartingNodes(IntegerPower(8, DIM)),
     _numNodesInUse(0),
+    _numParticlesNotAdded(0),
+    _numSubdivisionFailures(0),
+    _pStats(0),
+    _leafCapacity(DEFAULT_PARTICLES_PER_QUAD_TREE_NODE),
+    _minNodeSize(0.0f),
     _particleRegionRadius(0.0f)
 {
     // other structures already have initializers to 0
+    _allQuadTreeNodes.resize(_MAX_NODES);
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Sets up the initial tree subdivision with _NUM_ROWS_IN_TREE_INITIAL by 
-    _NUM_COLUMNS_IN_TREE_INITIAL nodes.  Boundaries are determined by the particle region center 
-    and the particle region radius.  The ParticleUpdater should constrain particles to this 
-    region, and the quad tree will subdivide within this region.
+    Sets up the initial tree subdivision with _numCellsPerAxisInitial nodes along each 
+    axis.  Boundaries are determined by the particle region center and the particle region 
+    radius.  The ParticleUpdater should constrain particles to this region, and the tree will 
+    subdivide within this region.
 
     Note: I considered and heavily entertained the idea of starting every frame with one node 
     and subdividing as necessary, but I abandoned that idea because there will be many particles 
     in all but the initial frames.  It took some extra calculations up front, but the initial 
     subdivision should cut down on the subdivisions that are needed on every frame.
+
+    Also Note: Starting nodes are numbered with the X axis varying fastest, then Y, then Z.  
+    Cell (0, 0) is the min X, min Y corner of the region.
 Parameters:
     particleRegionCenter    In world space
     particleRegionRadius    In world space
@@ -55,149 +75,117 @@ Returns:    None
 Exception:  Safe
 Creator:    John Cox (12-17-2016)
 -----------------------------------------------------------------------------------------------*/
-void ParticleQuadTree::InitializeTree(const glm::vec2 &particleRegionCenter, float particleRegionRadius)
+template<int DIM>
+void ParticleSpatialTree<DIM>::InitializeTree(const vec_type &particleRegionCenter, 
+    float particleRegionRadius)
 {
     _particleRegionCenter = particleRegionCenter;
     _particleRegionRadius = particleRegionRadius;
 
-    // starting in the upper left corner of the 2D particle region, where X is minimal and Y is 
-    // maximal because OpenGL's rectangle origins are the bottom left corner, unlike most 
-    // rectangles in graphical programming, where the top left is min x and min y
-    float xBegin = particleRegionCenter.x - particleRegionRadius;
-    float yBegin = particleRegionCenter.y + particleRegionRadius;
+    vec_type regionMinCorner = particleRegionCenter - vec_type(particleRegionRadius);
+    float incrementPerNode = 2.0f * particleRegionRadius / _numCellsPerAxisInitial;
 
-    float xIncrementPerNode = 2.0f * particleRegionRadius / _NUM_COLUMNS_IN_TREE_INITIAL;
-    float yIncrementPerNode = 2.0f * particleRegionRadius / _NUM_ROWS_IN_TREE_INITIAL;
-
-    float y = yBegin;
-    for (int row = 0; row < _NUM_ROWS_IN_TREE_INITIAL; row++)
+    for (int nodeIndex = 0; nodeIndex < _numStartingNodes; nodeIndex++)
     {
-        float x = xBegin;
-        for (int column = 0; column < _NUM_COLUMNS_IN_TREE_INITIAL; column++)
+        node_type &node = _allQuadTreeNodes[nodeIndex];
+        node._inUse = true;
+
+        // which cell this is along each axis
+        int cell[DIM];
+        int axisStride = 1;
+        for (int axis = 0; axis < DIM; axis++)
         {
-            int nodeIndex = (row * _NUM_COLUMNS_IN_TREE_INITIAL) + column;
-            QuadTreeNode &node = _allQuadTreeNodes[nodeIndex];
-            node._inUse = true;
+            cell[axis] = (nodeIndex / axisStride) % _numCellsPerAxisInitial;
+            axisStride *= _numCellsPerAxisInitial;
 
             // set the borders of the node
-            node._leftEdge = x;
-            node._rightEdge = x + xIncrementPerNode;
-            node._topEdge = y;
-            node._bottomEdge = y - yIncrementPerNode;
-
-            // assign neighbors
-            // Note: Nodes on the edge of the initial tree have three null neighbors.  There may 
-            // be other ways to calculate these, but I chose the following because it is spelled 
-            // out verbosely.
-            // Ex: a top - row node has null top left, top, and top right neighbors.
-
-            // left edge does not have a "left" neighbor
-            if (column > 0)
-            {
-                node._neighborIndexLeft = nodeIndex - 1;
-            }
-
-            // left and top edges do not have a "top left" neighbor
-            if (row > 0 && column > 0)
-            {
-                // "top left" neighbor = current node - 1 row - 1 column
-                node._neighborIndexTopLeft = nodeIndex - _NUM_COLUMNS_IN_TREE_INITIAL - 1;
-            }
-
-            // top row does not have a "top" neighbor
-            if (row > 0)
-            {
-                node._neighborIndexTop = nodeIndex - _NUM_COLUMNS_IN_TREE_INITIAL;
-            }
-
-            // right and top edges do not have a "top right" neighbor
-            if (row > 0 && column < (_NUM_COLUMNS_IN_TREE_INITIAL - 1))
-            {
-                // "top right" neighbor = current node - 1 row + 1 column
-                node._neighborIndexTopRight = nodeIndex - _NUM_COLUMNS_IN_TREE_INITIAL + 1;
-            }
-
-            // right edge does not have a "right" neighbor
-            if (column < (_NUM_COLUMNS_IN_TREE_INITIAL - 1))
-            {
-                node._neighborIndexRight = nodeIndex + 1;
-            }
-
-            // right and bottom edges do not have a "bottom right" neighbor
-            if (row < (_NUM_ROWS_IN_TREE_INITIAL - 1) &&
-                column < (_NUM_COLUMNS_IN_TREE_INITIAL - 1))
-            {
-                // "bottom right" neighbor = current node + 1 row + 1 column
-                node._neighborIndexBottomRight = nodeIndex + _NUM_COLUMNS_IN_TREE_INITIAL + 1;
-            }
-
-            // bottom edge does not have a "bottom" neighbor
-            if (row < (_NUM_ROWS_IN_TREE_INITIAL - 1))
-            {
-                node._neighborIndexBottom = nodeIndex + _NUM_COLUMNS_IN_TREE_INITIAL;
-            }
+            node._minCorner[axis] = regionMinCorner[axis] + (cell[axis] * incrementPerNode);
+            node._maxCorner[axis] = node._minCorner[axis] + incrementPerNode;
+        }
 
-            // left and bottom edges do not have a "bottom left" neighbor
-            if (row < (_NUM_ROWS_IN_TREE_INITIAL - 1) && column > 0)
+        // assign neighbors
+        // Note: Nodes on the edge of the initial tree have null neighbors in any direction that 
+        // steps off the grid.
+        // Ex: a node on the top row has null top left, top, and top right neighbors.
+        for (int neighborIndex = 0; neighborIndex < stencil_type::NUM_NEIGHBORS; neighborIndex++)
+        {
+            int neighborNodeIndex = 0;
+            axisStride = 1;
+            for (int axis = 0; axis < DIM; axis++)
             {
-                // bottom left neighbor = current node + 1 row - 1 column
-                node._neighborIndexBottomLeft = nodeIndex + _NUM_COLUMNS_IN_TREE_INITIAL - 1;
+                int neighborCell = cell[axis] + stencil_type::NeighborOffset(neighborIndex, axis);
+                if (neighborCell < 0 || neighborCell >= _numCellsPerAxisInitial)
+                {
+                    neighborNodeIndex = -1;
+                    break;
+                }
+                neighborNodeIndex += neighborCell * axisStride;
+                axisStride *= _numCellsPerAxisInitial;
             }
-
-
-            // setup for next node
-            x += xIncrementPerNode;
+            node._neighborIndices[neighborIndex] = neighborNodeIndex;
         }
-
-        // end of row, increment to the next one
-        y -= yIncrementPerNode;
     }
 
-    _numNodesInUse = _NUM_STARTING_NODES;
-
-
+    _numNodesInUse = _numStartingNodes;
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Resets the tree to only use _NUM_ROWS_IN_TREE_INITIAL by _NUM_COLUMNS_IN_TREE_INITIAL nodes.
-    After this, any calls to SubdivideNode(...) will run over previously subdivided nodes.
+    Resets the tree to only use the _numStartingNodes initial nodes.  After this, any calls to 
+    SubdivideNode(...) will run over previously subdivided nodes.
 
-    Ex: Start with 64 nodes, each with calculated bounds.  There are 256 nodes total.  Calling
+    Ex: Start with 64 nodes, each with calculated bounds.  There are 2048 nodes total.  Calling
     Reset() will set the number of nodes in use back to 64.  The next SubdivideNode(...) will 
-    then modify nodes 65, 66, 67, and 68.  Their previous values will be run over.
+    then modify nodes 64, 65, 66, and 67.  Their previous values will be run over.
 Parameters: None
 Returns:    None
 Exception:  Safe
 Creator:    John Cox (12-17-2016)
 -----------------------------------------------------------------------------------------------*/
-void ParticleQuadTree::ResetTree()
+template<int DIM>
+void ParticleSpatialTree<DIM>::ResetTree()
 {
-    for (int nodeIndex = 0; nodeIndex < _MAX_NODES; nodeIndex++)
+    // Note: Nodes past the ones in use were reset when they stopped being used.
+    for (int nodeIndex = 0; nodeIndex < _numNodesInUse; nodeIndex++)
     {
-        QuadTreeNode &node = _allQuadTreeNodes[nodeIndex];
+        node_type &node = _allQuadTreeNodes[nodeIndex];
         node._numCurrentParticles = 0;
         
         // not subdivided
         node._isSubdivided = 0;
-        node._childNodeIndexTopLeft = -1;
-        node._childNodeIndexTopRight = -1;
-        node._childNodeIndexBottomRight = -1;
-        node._childNodeIndexBottomLeft = -1;
+        for (int childIndex = 0; childIndex < stencil_type::NUM_CHILDREN; childIndex++)
+        {
+            node._childNodeIndices[childIndex] = -1;
+        }
 
         // all excess nodes are turned off
-        if (nodeIndex > _NUM_STARTING_NODES)
+        if (nodeIndex >= _numStartingNodes)
         {
             node._inUse = false;
         }
     }
 
-    _numNodesInUse = _NUM_STARTING_NODES;
+    _numNodesInUse = _numStartingNodes;
+    _numParticlesNotAdded = 0;
+    _numSubdivisionFailures = 0;
+
+    // every node was cleared with the old grid, so the new one can be laid out over them
+    if (_pendingNumCellsPerAxisInitial != _numCellsPerAxisInitial)
+    {
+        int oldNumStartingNodes = _numStartingNodes;
+        _numCellsPerAxisInitial = _pendingNumCellsPerAxisInitial;
+        _numStartingNodes = IntegerPower(_numCellsPerAxisInitial, DIM);
+        for (int nodeIndex = _numStartingNodes; nodeIndex < oldNumStartingNodes; nodeIndex++)
+        {
+            _allQuadTreeNodes[nodeIndex]._inUse = false;
+        }
+        InitializeTree(_particleRegionCenter, _particleRegionRadius);
+    }
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Governs the addition of particles to the quad tree.  It calculates which of the default tree 
+    Governs the addition of particles to the tree.  It calculates which of the default tree 
     nodes the particle is in, and then adds the particle to it.  AddParticleToNode(...) will 
     handle subdivision and addition of particles to child nodes.
 Parameters: 
@@ -206,104 +194,553 @@ Returns:    None
 Exception:  Safe
 Creator:    John Cox (12-17-2016)
 -----------------------------------------------------------------------------------------------*/
-void ParticleQuadTree::AddParticlestoTree(std::vector<Particle> &particleCollection)
+template<int DIM>
+void ParticleSpatialTree<DIM>::AddParticlestoTree(std::vector<particle_type> &particleCollection)
 {
-    float xIncrementPerColumn = 2.0f * _particleRegionRadius / _NUM_COLUMNS_IN_TREE_INITIAL;
-    float yIncrementPerRow = 2.0f * _particleRegionRadius / _NUM_ROWS_IN_TREE_INITIAL;
+    float incrementPerNode = 2.0f * _particleRegionRadius / _numCellsPerAxisInitial;
 
     // is inverted to save on division cost for every particle on every frame
-    float inverseXIncrementPerColumn = 1.0f / xIncrementPerColumn;
-    float inverseYIncrementPerRow = 1.0f / yIncrementPerRow;
+    float inverseIncrementPerNode = 1.0f / incrementPerNode;
+
+    vec_type regionMinCorner = _particleRegionCenter - vec_type(_particleRegionRadius);
 
     for (size_t particleIndex = 0; particleIndex < particleCollection.size(); particleIndex++)
     {
-        Particle &p = particleCollection[particleIndex];
+        particle_type &p = particleCollection[particleIndex];
         if (p._isActive == 0)
         {
             // only add active particles
             continue;
         }
 
-        // I can't think of an intuitive explanation for why the following math works, but it 
-        // does (I worked it out by hand, got it wrong, experimented, and got it right)
-        // Note: Row bounds are on the Y axis, column bounds are on the X axis.  I always get 
-        // them mixed up because a row is horizontal and a column is vertical.
-        // Also Note:
-        //  col index   = (int)((p.pos.x - quadTreeLeftEdge) / xIncrementPerColumn)
-        //  row index   = (int)((quadTreeTopEdge - p.pos.y) / yIncrementPerRow);
-        //
-        //  Let c = particle region center
-        //  Let r = particle region radius
-        //  Let p = particle
-        //  Then:
-        //  col index = (int)((p.pos.x - (c.x - r)) / xIncrementPerColumn);
-        //  row index = (int)(((c.y + r) - p.pos.y) / yIncrementPerRow);
-        //
-        // Also Also Note: The integer rounding should NOT be to the nearest integer.  Array 
-        // indices start at 0, so any value between 0 and 1 is considered to be in the 0th index.
-
-        // column 
-        float leftEdge = _particleRegionCenter.x - _particleRegionRadius;
-        float xDiff = p._position.x - leftEdge;
-        float colFloat = xDiff * inverseXIncrementPerColumn;
-        int colInt = int(colFloat);
-
-        float topEdge = _particleRegionCenter.y + _particleRegionRadius;
-        float yDiff = topEdge - p._position.y;
-        float rowFloat = yDiff * inverseYIncrementPerRow;
-        int rowInt = int(rowFloat);
+        // cell index along an axis = (int)((p.pos - regionMin) / incrementPerNode)
+        // Note: The integer rounding should NOT be to the nearest integer.  Array indices start 
+        // at 0, so any value between 0 and 1 is considered to be in the 0th index.
+        // Also Note: The particle updater constrains particles to a circle inside this region, 
+        // but a particle sitting right on the boundary can still compute to one past the last 
+        // cell, so clamp it.
+        int nodeIndex = 0;
+        int axisStride = 1;
+        for (int axis = 0; axis < DIM; axis++)
+        {
+            float diff = p._position[axis] - regionMinCorner[axis];
+            int cell = int(diff * inverseIncrementPerNode);
+            cell = (cell < 0) ? 0 : cell;
+            cell = (cell >= _numCellsPerAxisInitial) ? _numCellsPerAxisInitial - 1 : cell;
+
+            // same index calulation as in InitializeTree(...)
+            nodeIndex += cell * axisStride;
+            axisStride *= _numCellsPerAxisInitial;
+        }
 
-        // same index calulation as in InitializeTree(...)
-        int nodeIndex = (rowInt * _NUM_COLUMNS_IN_TREE_INITIAL) + colInt;
-        AddParticleToNode(particleIndex, nodeIndex, particleCollection);
+        if (!AddParticleToNode(particleIndex, nodeIndex, particleCollection))
+        {
+            // the node pool ran out, so this particle won't collide with anything
+            _numParticlesNotAdded++;
+        }
     }
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Is the root function of the particle-particle collisions.
+    Is the root function of the particle-particle collisions.  Starts at each of the initial 
+    nodes and recurses down through any subdivisions.
+
+    The kernel decides what happens to each pair that is close enough to check (see 
+    ParticleCollisionKernel and ParticleCollisionResponse.h).  It is a template parameter so 
+    that the response is inlined into the traversal.
+
+    If particles have moved since they were added to the tree, then the tree's picture of 
+    where they are is stale.  Particles only look at the particles in their own node and the 
+    neighboring nodes, so they can't have gone far, but a pair that is within range now could 
+    have been further apart than that when the tree was built.  The search padding widens the 
+    neighbor search to make up for it.
 Parameters: 
-    deltaTimeSec        Self-explanatory.
+    kernel              Collides a single pair.
     particleCollection  A container for all particles in use by this program.
+    searchPadding       The furthest that any particle has moved since it was added.
 Returns:    None
 Exception:  Safe
 Creator:    John Cox (12-17-2016)
 -----------------------------------------------------------------------------------------------*/
-void ParticleQuadTree::DoTheParticleParticleCollisions(float deltaTimeSec, 
-    std::vector<Particle> &particleCollection) const
+template<int DIM>
+template<typename KERNEL>
+void ParticleSpatialTree<DIM>::DoTheParticleParticleCollisions(const KERNEL &kernel, 
+    std::vector<particle_type> &particleCollection, float searchPadding) const
 {
-    for (int nodeIndex = 0; nodeIndex < _numNodesInUse; nodeIndex++)
+    float searchDistance = kernel.NeighborSearchDistance() + searchPadding;
+    float searchDistanceSqr = searchDistance * searchDistance;
+
+    // Note: Only iterate over the starting nodes.  Child nodes are reached through their 
+    // parents, and iterating over them here as well would collide their particles twice.
+    ParticleCollisionCounters counters;
+    for (int nodeIndex = 0; nodeIndex < _numStartingNodes; nodeIndex++)
+    {
+        ParticleCollisionsWithinNode(nodeIndex, searchDistanceSqr, kernel, particleCollection, 
+            counters);
+    }
+
+    if (_pStats != 0)
+    {
+        _pStats->AddCounters(counters);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The same collisions as DoTheParticleParticleCollisions(...), spread over a work-stealing 
+    pool.  Particles are not spread evenly over the starting nodes (ex: where two emitter 
+    streams meet, a few starting nodes have most of the particles and are subdivided several 
+    times), so each starting node with more than the cutoff's worth of particles is split 
+    into its children, and those into theirs, until every piece is at or below the cutoff or 
+    is a leaf.  Each piece is a job that runs the ordinary serial recursion.
+
+    The kernel writes to both particles of a pair, and a pair can straddle two pieces, so two 
+    pieces that are close together can't run at the same time.  A piece only writes to 
+    particles within one search distance of its box (its own particles have moved at most 
+    the padding, and their partners are within the interaction distance of them), so pieces 
+    whose boxes are at least two search distances apart never write to the same particle.  
+    The pieces are colored so that no two of the same color are closer than that, and the 
+    colors run one after another, each one forked out on the pool.  With the usual search 
+    distances, that is a handful of colors, each with lots of pieces in it.
+
+    Each particle gets its forces added up in the same order no matter how many threads there 
+    are or which one runs what, so the results don't change from run to run.  They can differ 
+    from the serial traversal's in the last bits, since the order isn't the same as that.
+Parameters: 
+    kernel              Collides a single pair.
+    particleCollection  A container for all particles in use by this program.
+    scheduler           The pool.  The calling thread helps.
+    serialCutoff        Subtrees with this many particles or fewer are not split up.
+    searchPadding       The furthest that any particle has moved since it was added.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+template<typename KERNEL>
+void ParticleSpatialTree<DIM>::DoTheParticleParticleCollisionsForkJoin(const KERNEL &kernel, 
+    std::vector<particle_type> &particleCollection, ParticleTaskScheduler &scheduler, 
+    int serialCutoff, float searchPadding) const
+{
+    float searchDistance = kernel.NeighborSearchDistance() + searchPadding;
+    if (scheduler.NumWorkerThreads() == 0)
+    {
+        DoTheParticleParticleCollisions(kernel, particleCollection, searchPadding);
+        return;
+    }
+
+    // Note: Nodes past the ones in use are never reached, and there are at most a few 
+    // thousand nodes, so the scratch space is small.
+    std::vector<int> subtreeCounts(_numNodesInUse, 0);
+    std::vector<int> subtreeRoots;
+    std::vector<int> colorEnds;
+    subtreeRoots.reserve(_numNodesInUse);
+    for (int nodeIndex = 0; nodeIndex < _numStartingNodes; nodeIndex++)
+    {
+        CountSubtreeParticles(nodeIndex, subtreeCounts);
+        SplitSubtreesAboveCutoff(nodeIndex, serialCutoff, subtreeCounts, subtreeRoots);
+    }
+    ColorSubtrees(2.0f * searchDistance, subtreeCounts, subtreeRoots, colorEnds);
+
+    std::atomic<int> joinCounter(0);
+    ForkJoinCollisionPass<KERNEL> pass;
+    pass._tree = this;
+    pass._kernel = &kernel;
+    pass._particleCollection = &particleCollection;
+    pass._scheduler = &scheduler;
+    pass._joinCounter = &joinCounter;
+    pass._subtreeRoots = subtreeRoots.data();
+    pass._searchDistanceSqr = searchDistance * searchDistance;
+
+    int colorBegin = 0;
+    for (size_t colorCount = 0; colorCount < colorEnds.size(); colorCount++)
+    {
+        int colorEnd = colorEnds[colorCount];
+        scheduler.Spawn(joinCounter, &ForkJoinCollisionJob<KERNEL>, &pass, colorBegin, colorEnd);
+        scheduler.Wait(joinCounter);
+        colorBegin = colorEnd;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Finds every active particle whose current position is inside an axis-aligned box.  Only 
+    the starting nodes that overlap the box are searched, and only the children of those that 
+    overlap it too.
+
+    Particles are filed by where they were when they were added, so a particle that has moved 
+    since then may be in a node that doesn't overlap the box.  The search padding grows the box 
+    for the node checks to make up for it.
+
+    Nothing is allocated.  If there are more particles than fit in the caller's buffer, the 
+    rest are counted but not written, so the caller can make the buffer bigger and try again.
+Parameters: 
+    boxMin, boxMax      The box's corners.
+    particleCollection  Self-explanatory.
+    putIndicesHere      Receives the particle indices.
+    maxIndices          How many indices fit in the buffer.
+    searchPadding       The furthest that any particle has moved since it was added.
+Returns:
+    The number of particles in the box, which may be more than maxIndices.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+int ParticleSpatialTree<DIM>::FindParticlesInBox(const vec_type &boxMin, 
+    const vec_type &boxMax, const std::vector<particle_type> &particleCollection, 
+    int *putIndicesHere, int maxIndices, float searchPadding) const
+{
+    int numFound = 0;
+    auto recordIfInside = [&](const node_type &leaf)
     {
-        if (nodeIndex == 19)
+        for (int particleCount = 0; particleCount < leaf._numCurrentParticles; particleCount++)
         {
-            printf("");
+            int particleIndex = leaf._indicesForContainedParticles[particleCount];
+            const vec_type &position = particleCollection[particleIndex]._position;
+            bool inside = true;
+            for (int axis = 0; axis < DIM; axis++)
+            {
+                inside &= (position[axis] >= boxMin[axis]) && (position[axis] <= boxMax[axis]);
+            }
+
+            if (inside)
+            {
+                if (numFound < maxIndices)
+                {
+                    putIndicesHere[numFound] = particleIndex;
+                }
+                numFound++;
+            }
         }
-        const QuadTreeNode &node = _allQuadTreeNodes[nodeIndex];
+    };
+
+    VisitLeavesOverlappingBox(boxMin - vec_type(searchPadding), boxMax + vec_type(searchPadding), 
+        recordIfInside);
+    return numFound;
+}
 
-        if (!node._inUse)
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Finds every active particle whose current position is within a distance of a point.  The 
+    same as FindParticlesInBox(...) with the box around the circle (sphere in 3D), plus a 
+    distance check.
+Parameters: 
+    center              Self-explanatory.
+    radius              Self-explanatory.
+    particleCollection  Self-explanatory.
+    putIndicesHere      Receives the particle indices.
+    maxIndices          How many indices fit in the buffer.
+    searchPadding       The furthest that any particle has moved since it was added.
+Returns:
+    The number of particles within the radius, which may be more than maxIndices.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+int ParticleSpatialTree<DIM>::FindParticlesInRadius(const vec_type &center, float radius, 
+    const std::vector<particle_type> &particleCollection, int *putIndicesHere, 
+    int maxIndices, float searchPadding) const
+{
+    float radiusSqr = radius * radius;
+    int numFound = 0;
+    auto recordIfWithin = [&](const node_type &leaf)
+    {
+        for (int particleCount = 0; particleCount < leaf._numCurrentParticles; particleCount++)
         {
-            continue;
+            int particleIndex = leaf._indicesForContainedParticles[particleCount];
+            vec_type centerToParticle = particleCollection[particleIndex]._position - center;
+            if (glm::dot(centerToParticle, centerToParticle) <= radiusSqr)
+            {
+                if (numFound < maxIndices)
+                {
+                    putIndicesHere[numFound] = particleIndex;
+                }
+                numFound++;
+            }
         }
-        else if (node._isSubdivided)
+    };
+
+    float nodeSearchRadius = radius + searchPadding;
+    VisitLeavesOverlappingBox(center - vec_type(nodeSearchRadius), 
+        center + vec_type(nodeSearchRadius), recordIfWithin);
+    return numFound;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Finds the k active particles that are closest to a point, nearest first.
+
+    The search starts with a box of about half a starting cell around the point and doubles it 
+    until it holds k particles within its radius (then nothing outside of it can be closer) or 
+    until it covers the whole tree.  The k best so far are kept sorted in the caller's buffers 
+    by insertion, which is cheap for the small k that this is meant for.
+Parameters: 
+    point               Self-explanatory.
+    k                   How many particles to find.  The buffers must hold this many.
+    particleCollection  Self-explanatory.
+    putIndicesHere      Receives the particle indices, nearest first.
+    putDistancesSqrHere Receives the squared distance to each one.
+    searchPadding       The furthest that any particle has moved since it was added.
+Returns:
+    The number of particles found.  Only less than k if there are fewer active particles.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+int ParticleSpatialTree<DIM>::FindNearestParticles(const vec_type &point, int k, 
+    const std::vector<particle_type> &particleCollection, int *putIndicesHere, 
+    float *putDistancesSqrHere, float searchPadding) const
+{
+    if (k <= 0)
+    {
+        return 0;
+    }
+
+    int numFound = 0;
+    float radiusSqr = 0.0f;
+    auto keepIfNearer = [&](const node_type &leaf)
+    {
+        for (int particleCount = 0; particleCount < leaf._numCurrentParticles; particleCount++)
         {
-            // check the children
-            ParticleCollisionsWithinNode(node._childNodeIndexTopLeft, deltaTimeSec, particleCollection);
-            ParticleCollisionsWithinNode(node._childNodeIndexTopRight, deltaTimeSec, particleCollection);
-            ParticleCollisionsWithinNode(node._childNodeIndexBottomRight, deltaTimeSec, particleCollection);
-            ParticleCollisionsWithinNode(node._childNodeIndexBottomLeft, deltaTimeSec, particleCollection);
+            int particleIndex = leaf._indicesForContainedParticles[particleCount];
+            vec_type pointToParticle = particleCollection[particleIndex]._position - point;
+            float distanceSqr = glm::dot(pointToParticle, pointToParticle);
+            if (distanceSqr > radiusSqr || 
+                (numFound == k && distanceSqr >= putDistancesSqrHere[k - 1]))
+            {
+                continue;
+            }
+
+            // shift the further ones down to make room; the furthest falls off if it is full
+            int insertAt = (numFound < k) ? numFound : k - 1;
+            while (insertAt > 0 && putDistancesSqrHere[insertAt - 1] > distanceSqr)
+            {
+                putIndicesHere[insertAt] = putIndicesHere[insertAt - 1];
+                putDistancesSqrHere[insertAt] = putDistancesSqrHere[insertAt - 1];
+                insertAt--;
+            }
+            putIndicesHere[insertAt] = particleIndex;
+            putDistancesSqrHere[insertAt] = distanceSqr;
+            numFound = (numFound < k) ? numFound + 1 : k;
         }
-        else if (!node._numCurrentParticles == 0)
+    };
+
+    // far enough that the box covers every cell, wherever the point is
+    float incrementPerNode = 2.0f * _particleRegionRadius / _numCellsPerAxisInitial;
+    vec_type regionToPoint = point - _particleRegionCenter;
+    float furthestRadius = 2.0f * _particleRegionRadius + sqrtf(glm::dot(regionToPoint, regionToPoint));
+    float radius = 0.5f * incrementPerNode;
+    while (true)
+    {
+        numFound = 0;
+        radiusSqr = radius * radius;
+        float nodeSearchRadius = radius + searchPadding;
+        VisitLeavesOverlappingBox(point - vec_type(nodeSearchRadius), 
+            point + vec_type(nodeSearchRadius), keepIfNearer);
+        if (numFound == k || radius >= furthestRadius)
         {
-            // check for collisions within this node only
-            ParticleCollisionsWithinNode(nodeIndex, deltaTimeSec, particleCollection);
+            // Note: The last try also takes any particle that has drifted outside of the tree's 
+            // region since it was added.
+            break;
         }
+        radius = (2.0f * radius < furthestRadius) ? 2.0f * radius : furthestRadius;
+    }
+
+    return numFound;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Finds the first particle that a ray hits, treating each particle as a circle (sphere in 
+    3D) of its radius of influence.
+
+    Nodes are checked against the ray with the slab test after being grown by the largest 
+    radius (a particle in a node can stick out of it by that much) plus the search padding.  
+    A node that the ray enters after the nearest hit so far is skipped.
+Parameters: 
+    origin              Self-explanatory.
+    direction           Does not need to be normalized.  Must not be 0.
+    maxDistance         How far along the ray to look, in the same units as the positions.
+    particleCollection  Self-explanatory.
+    particleProperties  For the radii.
+    putDistanceHere     If not 0, receives the distance along the ray to the hit.
+    searchPadding       The furthest that any particle has moved since it was added.
+Returns:
+    The index of the particle that was hit first, or -1 if none were.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+int ParticleSpatialTree<DIM>::RaycastParticles(const vec_type &origin, 
+    const vec_type &direction, float maxDistance, 
+    const std::vector<particle_type> &particleCollection, 
+    const ParticlePropertyStorage &particleProperties, float *putDistanceHere, 
+    float searchPadding) const
+{
+    RaycastState state;
+    state._origin = origin;
+    state._direction = direction / sqrtf(glm::dot(direction, direction));
+    for (int axis = 0; axis < DIM; axis++)
+    {
+        // Note: A direction of 0 along an axis is infinity here, which the slab test handles.
+        state._inverseDirection[axis] = 1.0f / state._direction[axis];
+    }
+    state._nodePadding = particleProperties.MaxRadiusOfInfluence() + searchPadding;
+    state._nearestDistance = maxDistance;
+    state._nearestIndex = -1;
+
+    // Note: Only start at the starting nodes.  Children are reached through their parents.
+    for (int nodeIndex = 0; nodeIndex < _numStartingNodes; nodeIndex++)
+    {
+        RaycastWithinNode(nodeIndex, particleCollection, particleProperties, &state);
+    }
+
+    if (putDistanceHere != 0 && state._nearestIndex >= 0)
+    {
+        *putDistanceHere = state._nearestDistance;
+    }
+    return state._nearestIndex;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs FindParticlesInBox(...) for several boxes.  The results are written one after the 
+    other into the same buffer, and each query's end in the buffer is recorded so that query 
+    N's results are from the end of query N-1 (or 0) to the end of query N.
+
+    If the buffer runs out, the ends keep counting as if it hadn't, so the last end is the 
+    size that the buffer needs to be.
+Parameters: 
+    boxMins, boxMaxes   One box per query.
+    numQueries          Self-explanatory.
+    particleCollection  Self-explanatory.
+    putIndicesHere      Receives the particle indices for all queries.
+    maxIndices          How many indices fit in the buffer.
+    putQueryEndsHere    Receives one end per query.
+    searchPadding       The furthest that any particle has moved since it was added.
+Returns:
+    The total number of particles found, which may be more than maxIndices.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+int ParticleSpatialTree<DIM>::FindParticlesInBoxes(const vec_type *boxMins, 
+    const vec_type *boxMaxes, int numQueries, 
+    const std::vector<particle_type> &particleCollection, int *putIndicesHere, 
+    int maxIndices, int *putQueryEndsHere, float searchPadding) const
+{
+    int numFound = 0;
+    for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+    {
+        int numWritten = (numFound < maxIndices) ? numFound : maxIndices;
+        numFound += FindParticlesInBox(boxMins[queryIndex], boxMaxes[queryIndex], 
+            particleCollection, putIndicesHere + numWritten, maxIndices - numWritten, 
+            searchPadding);
+        putQueryEndsHere[queryIndex] = numFound;
+    }
+    return numFound;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs FindParticlesInRadius(...) for several points.  The results are laid out the same way 
+    as for FindParticlesInBoxes(...).
+Parameters: 
+    centers, radii      One point and radius per query.
+    numQueries          Self-explanatory.
+    particleCollection  Self-explanatory.
+    putIndicesHere      Receives the particle indices for all queries.
+    maxIndices          How many indices fit in the buffer.
+    putQueryEndsHere    Receives one end per query.
+    searchPadding       The furthest that any particle has moved since it was added.
+Returns:
+    The total number of particles found, which may be more than maxIndices.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+int ParticleSpatialTree<DIM>::FindParticlesInRadii(const vec_type *centers, 
+    const float *radii, int numQueries, const std::vector<particle_type> &particleCollection, 
+    int *putIndicesHere, int maxIndices, int *putQueryEndsHere, float searchPadding) const
+{
+    int numFound = 0;
+    for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+    {
+        int numWritten = (numFound < maxIndices) ? numFound : maxIndices;
+        numFound += FindParticlesInRadius(centers[queryIndex], radii[queryIndex], 
+            particleCollection, putIndicesHere + numWritten, maxIndices - numWritten, 
+            searchPadding);
+        putQueryEndsHere[queryIndex] = numFound;
+    }
+    return numFound;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs FindNearestParticles(...) for several points.  Query N's results start at N * k.
+Parameters: 
+    points              One per query.
+    numQueries          Self-explanatory.
+    k                   How many particles to find per point.
+    particleCollection  Self-explanatory.
+    putIndicesHere      Receives (numQueries * k) particle indices.
+    putDistancesSqrHere Receives (numQueries * k) squared distances.
+    putCountsHere       Receives how many were found for each query.
+    searchPadding       The furthest that any particle has moved since it was added.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+void ParticleSpatialTree<DIM>::FindNearestParticlesBatch(const vec_type *points, 
+    int numQueries, int k, const std::vector<particle_type> &particleCollection, 
+    int *putIndicesHere, float *putDistancesSqrHere, int *putCountsHere, 
+    float searchPadding) const
+{
+    for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+    {
+        putCountsHere[queryIndex] = FindNearestParticles(points[queryIndex], k, 
+            particleCollection, putIndicesHere + (queryIndex * k), 
+            putDistancesSqrHere + (queryIndex * k), searchPadding);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs RaycastParticles(...) for several rays.
+Parameters: 
+    origins, directions One ray per query.
+    numQueries          Self-explanatory.
+    maxDistance         How far along every ray to look.
+    particleCollection  Self-explanatory.
+    particleProperties  For the radii.
+    putIndicesHere      Receives one particle index (or -1) per ray.
+    putDistancesHere    Receives one distance per ray.  Meaningless for a miss.
+    searchPadding       The furthest that any particle has moved since it was added.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+void ParticleSpatialTree<DIM>::RaycastParticlesBatch(const vec_type *origins, 
+    const vec_type *directions, int numQueries, float maxDistance, 
+    const std::vector<particle_type> &particleCollection, 
+    const ParticlePropertyStorage &particleProperties, int *putIndicesHere, 
+    float *putDistancesHere, float searchPadding) const
+{
+    for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+    {
+        putIndicesHere[queryIndex] = RaycastParticles(origins[queryIndex], 
+            directions[queryIndex], maxDistance, particleCollection, particleProperties, 
+            putDistancesHere + queryIndex, searchPadding);
     }
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
     Generates lines for the bounds of all nodes in use.  Used to draw a visualization of the 
-    quad tree.
+    tree.  The octree's boxes are flattened onto the XY plane.
 
     Note: There are many duplicate nodes and lines, but this is just a demo.  I won't concern 
     myself with trying to optimize this aspect of the program.
@@ -314,8 +751,14 @@ Returns:    None
 Exception:  Safe
 Creator:    John Cox (12-17-2016)
 -----------------------------------------------------------------------------------------------*/
-void ParticleQuadTree::GenerateGeometry(GeometryData *putDataHere, bool firstTime)
+template<int DIM>
+void ParticleSpatialTree<DIM>::GenerateGeometry(GeometryData *putDataHere, bool firstTime)
 {
+    // a box in DIM dimensions has 2^DIM corners, and each edge connects two corners that only 
+    // differ along one axis
+    static const int NUM_CORNERS = stencil_type::NUM_CHILDREN;
+    static const int NUM_EDGES = DIM * (NUM_CORNERS / 2);
+
     // the data changes potentially every frame, so have to clear out the existing data
     putDataHere->_verts.clear();
     putDataHere->_indices.clear();
@@ -330,50 +773,43 @@ void ParticleQuadTree::GenerateGeometry(GeometryData *putDataHere, bool firstTim
     {
         putDataHere->_drawStyle = GL_LINES;
 
-        // 4 corners per box
-        putDataHere->_verts.resize(_MAX_NODES * 4);
+        // 4 corners per box in 2D, 8 in 3D
+        putDataHere->_verts.resize(_MAX_NODES * NUM_CORNERS);
 
-        // 4 lines per box, 2 vertices per line
-        putDataHere->_indices.resize(_MAX_NODES * 4 * 2);
+        // 4 lines per box in 2D (12 in 3D), 2 vertices per line
+        putDataHere->_indices.resize(_MAX_NODES * NUM_EDGES * 2);
     }
     else
     {
         unsigned short vertexIndex = 0;
         for (int nodeCounter = 0; nodeCounter < _numNodesInUse; nodeCounter++)
         {
-            QuadTreeNode &node = _allQuadTreeNodes[nodeCounter];
-
-            // 4 corners per box
-            MyVertex topLeft;
-            unsigned short topLeftIndex = vertexIndex++;
-            topLeft._position = glm::vec2(node._leftEdge, node._topEdge);
-            putDataHere->_verts.push_back(topLeft);
+            node_type &node = _allQuadTreeNodes[nodeCounter];
 
-            MyVertex topRight;
-            unsigned short topRightIndex = vertexIndex++;
-            topRight._position = glm::vec2(node._rightEdge, node._topEdge);
-            putDataHere->_verts.push_back(topRight);
-
-            MyVertex bottomRight;
-            unsigned short bottomRightIndex = vertexIndex++;
-            bottomRight._position = glm::vec2(node._rightEdge, node._bottomEdge);
-            putDataHere->_verts.push_back(bottomRight);
-
-            MyVertex bottomLeft;
-            unsigned short bottomeLeftIndex = vertexIndex++;
-            bottomLeft._position = glm::vec2(node._leftEdge, node._bottomEdge);
-            putDataHere->_verts.push_back(bottomLeft);
+            // corners are numbered like children: bit N set => max edge along axis N
+            unsigned short firstCornerIndex = vertexIndex;
+            for (int corner = 0; corner < NUM_CORNERS; corner++)
+            {
+                MyVertex v;
+                v._position.x = stencil_type::ChildSide(corner, 0) ? node._maxCorner[0] : node._minCorner[0];
+                v._position.y = stencil_type::ChildSide(corner, 1) ? node._maxCorner[1] : node._minCorner[1];
+                putDataHere->_verts.push_back(v);
+                vertexIndex++;
+            }
 
-            // 4 lines per box, 2 vertices per line
+            // 2 vertices per line
             // Note: These are lines, so there is no concern about clockwise or counterclockwise
-            putDataHere->_indices.push_back(topLeftIndex);
-            putDataHere->_indices.push_back(topRightIndex);
-            putDataHere->_indices.push_back(topRightIndex);
-            putDataHere->_indices.push_back(bottomRightIndex);
-            putDataHere->_indices.push_back(bottomRightIndex);
-            putDataHere->_indices.push_back(bottomeLeftIndex);
-            putDataHere->_indices.push_back(bottomeLeftIndex);
-            putDataHere->_indices.push_back(topLeftIndex);
+            for (int corner = 0; corner < NUM_CORNERS; corner++)
+            {
+                for (int axis = 0; axis < DIM; axis++)
+                {
+                    if (stencil_type::ChildSide(corner, axis) == 0)
+                    {
+                        putDataHere->_indices.push_back(firstCornerIndex + corner);
+                        putDataHere->_indices.push_back(firstCornerIndex + (corner | (1 << axis)));
+                    }
+                }
+            }
         }
 
     }
@@ -385,7 +821,7 @@ void ParticleQuadTree::GenerateGeometry(GeometryData *putDataHere, bool firstTim
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    A simple getter.  Used when printing the number of current quad tree nodes to the screen.
+    A simple getter.  Used when printing the number of current tree nodes to the screen.
 
     Note: _numNodesInUse is modified in InitializeTree(...), ResetTree(), and SubdivideNode(...).
 Parameters: Node
@@ -394,240 +830,396 @@ Returns:
 Exception:  Safe
 Creator:    John Cox (12-17-2016)
 -----------------------------------------------------------------------------------------------*/
-int ParticleQuadTree::NumNodesInUse() const
+template<int DIM>
+int ParticleSpatialTree<DIM>::NumNodesInUse() const
 {
     return _numNodesInUse;
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Adds the specified particle to the specified node.  If the new particle will push the node 
-    over its particle containment limit, then it subdivides and populates its new children with 
-    its own particles.
+    A simple getter.
+Parameters: None
+Returns:    
+    How many particles were left out of the tree since it was last reset because a leaf 
+    needed to subdivide and there were no nodes left.  These particles don't collide.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+int ParticleSpatialTree<DIM>::NumParticlesNotAdded() const
+{
+    return _numParticlesNotAdded;
+}
 
-    Note: I could have passed the arguments by reference, but I'm keeping them as indices as a 
-    reminder for myself of how to pass values in the GPU version.  Compute shaders don't have 
-    pointers or references, so their must used indices.
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.
+Parameters: 
+    pStats  The collision passes add what they counted to this.  0 doesn't count.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+void ParticleSpatialTree<DIM>::SetStats(ParticleStats *pStats)
+{
+    _pStats = pStats;
+}
 
-    Also Note: This function does not sanitize the input.  The purpose of this function is to 
-    create a connection between a particle and a node.  Be nice to it and check particle bounds 
-    first.
-    TODO: particles should not contain a link to its node; particle collisions will be calculated for each particle within a node, not for each particle overall
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:    
+    How many times since the tree was last reset that a node needed to subdivide and there 
+    weren't enough nodes left.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+int ParticleSpatialTree<DIM>::NumSubdivisionFailures() const
+{
+    return _numSubdivisionFailures;
+}
 
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Walks the tree and counts its leaves by depth and by how many particles they hold.  A 
+    tree that is working well has most of its particles in leaves that are close to full and 
+    not much deeper than they have to be.
 Parameters: 
-    particleIndex   The particle that needs to be added.
-    nodeIndex       The quad tree node to add the particle to.
-    particleCollection  Self-explanatory
+    putShapeHere    Self-explanatory.
 Returns:    None
 Exception:  Safe
-Creator:    John Cox (12-17-2016)
+Creator:    John Cox (10-19-2026)
 -----------------------------------------------------------------------------------------------*/
-bool ParticleQuadTree::AddParticleToNode(int particleIndex, int nodeIndex, std::vector<Particle> &particleCollection)
+template<int DIM>
+void ParticleSpatialTree<DIM>::MeasureShape(SpatialTreeShape *putShapeHere) const
 {
-    Particle &p = particleCollection[particleIndex];
-    QuadTreeNode &node = _allQuadTreeNodes[nodeIndex];
-    int destinationNodeIndex = -1;
-
-    if (node._isSubdivided == 0)
+    SpatialTreeShape &shape = *putShapeHere;
+    shape._numLeaves = 0;
+    shape._maxDepth = 0;
+    shape._maxOccupancy = 0;
+    shape._meanOccupancy = 0.0f;
+    for (int depth = 0; depth <= SpatialTreeShape::MAX_DEPTH; depth++)
     {
-        // not subdivided (yet), so add the particle to the provided node
-        int numParticlesThisNode = node._numCurrentParticles;
-        if (numParticlesThisNode == MAX_PARTICLES_PER_QUAD_TREE_NODE)
-        {
-            // ran out of space, so split the node and add the particles to its children
-            if (!SubdivideNode(nodeIndex, particleCollection))
-            {
-                // no space left
-                return false;
-            }
-
-            //node._numCurrentParticles = 0;
-            // add the particle to this same node again, which will use the "is subdivided" logic
-            destinationNodeIndex = nodeIndex;
-        }
-        else
-        {
-            // END RECURSION
-            // Note: It's ok to use this as an index because the "== MAX" check was already done.
-            node._indicesForContainedParticles[numParticlesThisNode] = particleIndex;
-            node._numCurrentParticles++;
-            p._currentQuadTreeIndex = nodeIndex;
-            return true;
-        }
+        shape._leavesAtDepth[depth] = 0;
     }
-    else
+    for (int bucket = 0; bucket < SpatialTreeShape::NUM_OCCUPANCY_BUCKETS; bucket++)
     {
-        // the node is subdivided, so add the particle to the child nodes
-        float nodeXCenter = (node._leftEdge + node._rightEdge) * 0.5f;
-        float nodeYCenter = (node._bottomEdge + node._topEdge) * 0.5f;
+        shape._leavesWithOccupancy[bucket] = 0;
+    }
+
+    // the mean is summed up in it until the end
+    for (int nodeIndex = 0; nodeIndex < _numStartingNodes; nodeIndex++)
+    {
+        MeasureShapeWithinNode(nodeIndex, 0, putShapeHere);
+    }
+    if (shape._numLeaves > 0)
+    {
+        shape._meanOccupancy /= shape._numLeaves;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets how many particles a leaf holds before it subdivides.  Fewer means more, smaller 
+    leaves, so each particle checks fewer particles that are out of range, but the tree takes 
+    longer to build and to walk, and runs out of nodes sooner.
+Parameters: 
+    leafCapacity    From 1 to MAX_PARTICLES_PER_QUAD_TREE_NODE.
+Returns:    
+    False if it is out of range, in which case nothing is changed.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+bool ParticleSpatialTree<DIM>::SetLeafCapacity(int leafCapacity)
+{
+    if (leafCapacity < 1 || leafCapacity > (int)MAX_PARTICLES_PER_QUAD_TREE_NODE)
+    {
+        return false;
+    }
+
+    _leafCapacity = leafCapacity;
+    return true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets how many starting nodes there are along each axis.  More means that dense areas need 
+    fewer subdivisions, but every pass has more starting nodes to visit, most of which are 
+    empty if the particles are bunched up.
+
+    The tree that is already built is left alone so that it can still be used (and drawn).  
+    The next ResetTree() lays the new grid out over the same region.
+Parameters: 
+    numCellsPerAxis     From 1 to MaxNumCellsPerAxisInitial().
+Returns:    
+    False if it is out of range, in which case nothing is changed.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+bool ParticleSpatialTree<DIM>::SetNumCellsPerAxisInitial(int numCellsPerAxis)
+{
+    if (numCellsPerAxis < 1 || numCellsPerAxis > _MAX_CELLS_PER_AXIS_INITIAL)
+    {
+        return false;
+    }
+
+    _pendingNumCellsPerAxisInitial = numCellsPerAxis;
+    return true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets how narrow a node may get.  A particle usually only looks in its own leaf and the 
+    leaves next to it, and in a leaf that is narrower than the neighbor search distance it has 
+    to search the tree around itself instead, which is slower.  Where particles are packed 
+    tighter than that, a small leaf capacity would subdivide until that happens.  Instead, 
+    nodes stop subdividing at this size and their leaves hold more than the leaf capacity, up 
+    to MAX_PARTICLES_PER_QUAD_TREE_NODE, after which they subdivide anyway.
+Parameters: 
+    minNodeSize     The furthest that any collision searches for neighbors.  0 lets nodes 
+                    subdivide as far as they need to.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+void ParticleSpatialTree<DIM>::SetMinNodeSize(float minNodeSize)
+{
+    _minNodeSize = minNodeSize;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:    
+    How many particles a leaf holds before it subdivides.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+int ParticleSpatialTree<DIM>::LeafCapacity() const
+{
+    return _leafCapacity;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:    
+    How many starting nodes there are along each axis.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+int ParticleSpatialTree<DIM>::NumCellsPerAxisInitial() const
+{
+    return _numCellsPerAxisInitial;
+}
 
-        if (p._position.x < nodeXCenter)
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:    
+    The most starting nodes along each axis that the node pool has room for.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+int ParticleSpatialTree<DIM>::MaxNumCellsPerAxisInitial()
+{
+    return _MAX_CELLS_PER_AXIS_INITIAL;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Adds the specified particle to the specified node.  If the new particle will push the node 
+    over its particle containment limit, then it subdivides and populates its new children with 
+    its own particles.
+
+    Note: I could have passed the arguments by reference, but I'm keeping them as indices as a 
+    reminder for myself of how to pass values in the GPU version.  Compute shaders don't have 
+    pointers or references, so their must used indices.
+
+    Also Note: This function does not sanitize the input.  The purpose of this function is to 
+    create a connection between a particle and a node.  Be nice to it and check particle bounds 
+    first.
+    TODO: particles should not contain a link to its node; particle collisions will be calculated for each particle within a node, not for each particle overall
+
+Parameters: 
+    particleIndex   The particle that needs to be added.
+    nodeIndex       The tree node to add the particle to.
+    particleCollection  Self-explanatory
+Returns:    
+    False if the node needed to subdivide and there were no nodes left, otherwise true.
+Exception:  Safe
+Creator:    John Cox (12-17-2016)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+bool ParticleSpatialTree<DIM>::AddParticleToNode(int particleIndex, int nodeIndex, 
+    std::vector<particle_type> &particleCollection)
+{
+    particle_type &p = particleCollection[particleIndex];
+    node_type &node = _allQuadTreeNodes[nodeIndex];
+    int destinationNodeIndex = -1;
+
+    if (node._isSubdivided == 0)
+    {
+        // not subdivided (yet), so add the particle to the provided node
+        int numParticlesThisNode = node._numCurrentParticles;
+
+        // a node's children shouldn't be narrower than the minimum, so a node that is already 
+        // less than twice that keeps taking particles past the leaf capacity, up to as many as 
+        // it has room for
+        // Note: The nodes are square, so one axis is enough.
+        // Also Note: Particles that are piled up that tightly will still subdivide it once it 
+        // is full.  The collisions search around the particles in leaves that are too narrow 
+        // for their neighbors to cover (see ParticleCollisionsWithinNode(...)).
+        bool isSmallest = (node._maxCorner[0] - node._minCorner[0]) < (2.0f * _minNodeSize);
+        int capacity = isSmallest ? (int)MAX_PARTICLES_PER_QUAD_TREE_NODE : _leafCapacity;
+        if (numParticlesThisNode >= capacity)
         {
-            // left half
-            if (p._position.y > nodeYCenter)
-            {
-                // top half
-                destinationNodeIndex = node._childNodeIndexTopLeft;
-            }
-            else
+            // ran out of space, so split the node and add the particles to its children
+            if (!SubdivideNode(nodeIndex, particleCollection))
             {
-                // bottom half 
-                destinationNodeIndex = node._childNodeIndexBottomLeft;
+                // no space left
+                return false;
             }
+
+            // add the particle to this same node again, which will use the "is subdivided" logic
+            destinationNodeIndex = nodeIndex;
         }
         else
         {
-            // right half 
-            if (p._position.y > nodeYCenter)
-            {
-                // top half 
-                destinationNodeIndex = node._childNodeIndexTopRight;
-            }
-            else
-            {
-                // bottom half 
-                destinationNodeIndex = node._childNodeIndexBottomRight;
-            }
+            // END RECURSION
+            // Note: It's ok to use this as an index because the capacity check was already done.
+            node._indicesForContainedParticles[numParticlesThisNode] = particleIndex;
+            node._numCurrentParticles++;
+            p._currentQuadTreeIndex = nodeIndex;
+            return true;
         }
     }
+    else
+    {
+        // the node is subdivided, so add the particle to the child nodes
+        destinationNodeIndex = node._childNodeIndices[ChildIndexForPosition(node, p._position)];
+    }
 
     return AddParticleToNode(particleIndex, destinationNodeIndex, particleCollection);
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Grabs four unused nodes from the "all nodes" array, sets their bounds as four quadrants of 
-    the parent node that needs to be subdivided, populates them with that node's particles, and 
-    empties the parent node.
+    Grabs 2^DIM unused nodes from the "all nodes" array, sets their bounds as the quadrants 
+    (octants in 3D) of the parent node that needs to be subdivided, populates them with that 
+    node's particles, and empties the parent node.
+
+    Children inherit the neighbors of their parent in any direction that leaves the parent.  
+    Directions that stay inside the parent lead to a sibling.
+    Ex: The top left child's right neighbor is the top right child, but its top right neighbor 
+    is the parent's top neighbor.
     // TODO: get rid of "neighbors" 
 Parameters: 
-    nodeIndex       The quad tree node to split
+    nodeIndex       The tree node to split
     particleCollection  Self-explanatory.
-Returns:    None
+Returns:    
+    False if there were not enough unused nodes left, otherwise true.
 Exception:  Safe
 Creator:    John Cox (12-17-2016)
 -----------------------------------------------------------------------------------------------*/
-bool ParticleQuadTree::SubdivideNode(int nodeIndex, std::vector<Particle> &particleCollection)
+template<int DIM>
+bool ParticleSpatialTree<DIM>::SubdivideNode(int nodeIndex, 
+    std::vector<particle_type> &particleCollection)
 {
-    QuadTreeNode &node = _allQuadTreeNodes[nodeIndex];
+    node_type &node = _allQuadTreeNodes[nodeIndex];
 
-    if (_numNodesInUse > (_MAX_NODES - 4))
+    if (_numNodesInUse > (_MAX_NODES - stencil_type::NUM_CHILDREN))
     {
         // not enough to nodes to subdivide again
+        _numSubdivisionFailures++;
         return false;
     }
 
-    int childNodeIndexTopLeft = _numNodesInUse++;
-    int childNodeIndexTopRight = _numNodesInUse++;
-    int childNodeIndexBottomRight = _numNodesInUse++;
-    int childNodeIndexBottomLeft = _numNodesInUse++;
-
     node._isSubdivided = 1;
-    node._childNodeIndexTopLeft = childNodeIndexTopLeft;
-    node._childNodeIndexTopRight = childNodeIndexTopRight;
-    node._childNodeIndexBottomRight = childNodeIndexBottomRight;
-    node._childNodeIndexBottomLeft = childNodeIndexBottomLeft;
-
-    float nodeXCenter = (node._leftEdge + node._rightEdge) * 0.5f;
-    float nodeYCenter = (node._bottomEdge + node._topEdge) * 0.5f;
-
-    // assign neighbors
-    // Note: This is going to get really messy when I move to 3D and have to use octrees, each 
-    // with 26 neighbors ((3 * 3 * 3) - 1 center node).
-
-    QuadTreeNode &childTopLeft = _allQuadTreeNodes[childNodeIndexTopLeft];
-    childTopLeft._neighborIndexLeft = node._neighborIndexLeft;
-    childTopLeft._neighborIndexTopLeft = node._neighborIndexTopLeft;
-    childTopLeft._neighborIndexTop = node._neighborIndexTop;
-    childTopLeft._neighborIndexTopRight = node._neighborIndexTop;
-    childTopLeft._neighborIndexRight = childNodeIndexTopRight;
-    childTopLeft._neighborIndexBottomRight = childNodeIndexBottomRight;
-    childTopLeft._neighborIndexBottom = childNodeIndexBottomLeft;
-    childTopLeft._neighborIndexBottomLeft = node._neighborIndexLeft;
-    childTopLeft._leftEdge = node._leftEdge;
-    childTopLeft._topEdge = node._topEdge;
-    childTopLeft._rightEdge = nodeXCenter;
-    childTopLeft._bottomEdge = nodeYCenter;
-
-    QuadTreeNode &childTopRight = _allQuadTreeNodes[childNodeIndexTopRight];
-    childTopRight._neighborIndexLeft = childNodeIndexTopLeft;
-    childTopRight._neighborIndexTopLeft = node._neighborIndexTop;
-    childTopRight._neighborIndexTop = node._neighborIndexTop;
-    childTopRight._neighborIndexTopRight = node._neighborIndexTopRight;
-    childTopRight._neighborIndexRight = node._neighborIndexRight;
-    childTopRight._neighborIndexBottomRight = node._neighborIndexRight;
-    childTopRight._neighborIndexBottom = childNodeIndexBottomRight;
-    childTopRight._neighborIndexBottomLeft = childNodeIndexBottomLeft;
-    childTopRight._leftEdge = nodeXCenter;
-    childTopRight._topEdge = node._topEdge;
-    childTopRight._rightEdge = node._rightEdge;
-    childTopRight._bottomEdge = nodeYCenter;
-
-    QuadTreeNode &childBottomRight = _allQuadTreeNodes[childNodeIndexBottomRight];
-    childBottomRight._neighborIndexLeft = childNodeIndexBottomLeft;
-    childBottomRight._neighborIndexTopLeft = childNodeIndexTopLeft;
-    childBottomRight._neighborIndexTop = childNodeIndexTopRight;
-    childBottomRight._neighborIndexTopRight = node._neighborIndexRight;
-    childBottomRight._neighborIndexRight = node._neighborIndexRight;
-    childBottomRight._neighborIndexBottomRight = node._neighborIndexBottomRight;
-    childBottomRight._neighborIndexBottom = node._neighborIndexBottom;
-    childBottomRight._neighborIndexBottomLeft = node._neighborIndexBottom;
-    childBottomRight._leftEdge = nodeXCenter;
-    childBottomRight._topEdge = nodeYCenter;
-    childBottomRight._rightEdge = node._rightEdge;
-    childBottomRight._bottomEdge = node._bottomEdge;
-
-    QuadTreeNode &childBottomLeft = _allQuadTreeNodes[childNodeIndexBottomLeft];
-    childBottomLeft._neighborIndexLeft = node._neighborIndexLeft;
-    childBottomLeft._neighborIndexTopLeft = node._neighborIndexLeft;
-    childBottomLeft._neighborIndexTop = childNodeIndexTopLeft;
-    childBottomLeft._neighborIndexTopRight = childNodeIndexTopRight;
-    childBottomLeft._neighborIndexRight = childNodeIndexBottomRight;
-    childBottomLeft._neighborIndexBottomRight = node._neighborIndexBottom;
-    childBottomLeft._neighborIndexBottom = node._neighborIndexBottom;
-    childBottomLeft._neighborIndexBottomLeft = node._neighborIndexBottomLeft;
-    childBottomLeft._leftEdge = node._leftEdge;
-    childBottomLeft._topEdge = nodeYCenter;
-    childBottomLeft._rightEdge = nodeXCenter;
-    childBottomLeft._bottomEdge = node._bottomEdge;
+    for (int childIndex = 0; childIndex < stencil_type::NUM_CHILDREN; childIndex++)
+    {
+        node._childNodeIndices[childIndex] = _numNodesInUse++;
+    }
 
-    // add all particles to children
-    for (int particleCount = 0; particleCount < node._numCurrentParticles; particleCount++)
+    vec_type nodeCenter = (node._minCorner + node._maxCorner) * 0.5f;
+
+    for (int childIndex = 0; childIndex < stencil_type::NUM_CHILDREN; childIndex++)
     {
-        int particleIndex = node._indicesForContainedParticles[particleCount];
-        Particle &p = particleCollection[particleIndex];
+        node_type &child = _allQuadTreeNodes[node._childNodeIndices[childIndex]];
+        child._inUse = true;
 
-        // the node is subdivided, so add the particle to the child nodes
-        int childNodeIndex = -1;
-        if (p._position.x < nodeXCenter)
+        for (int axis = 0; axis < DIM; axis++)
         {
-            // left half of the node
-            if (p._position.y > nodeYCenter)
-            {
-                // top half of the node
-                childNodeIndex = node._childNodeIndexTopLeft;
-            }
-            else
-            {
-                // bottom half of the node
-                childNodeIndex = node._childNodeIndexBottomLeft;
-            }
+            bool positiveSide = stencil_type::ChildSide(childIndex, axis) != 0;
+            child._minCorner[axis] = positiveSide ? nodeCenter[axis] : node._minCorner[axis];
+            child._maxCorner[axis] = positiveSide ? node._maxCorner[axis] : nodeCenter[axis];
         }
-        else
+
+        // assign neighbors
+        for (int neighborIndex = 0; neighborIndex < stencil_type::NUM_NEIGHBORS; neighborIndex++)
         {
-            // right half of the node
-            if (p._position.y > nodeYCenter)
+            // a step along an axis leaves the parent if it goes further toward the side that 
+            // the child is already on
+            int siblingIndex = childIndex;
+            int parentNeighborStencilCell = 0;
+            bool leavesParent = false;
+            for (int axis = 0; axis < DIM; axis++)
+            {
+                int offset = stencil_type::NeighborOffset(neighborIndex, axis);
+                int side = stencil_type::ChildSide(childIndex, axis);
+                bool leavesAlongThisAxis = (offset == +1 && side == 1) || (offset == -1 && side == 0);
+                if (leavesAlongThisAxis)
+                {
+                    leavesParent = true;
+                    parentNeighborStencilCell += (offset + 1) * IntegerPower(3, axis);
+                }
+                else
+                {
+                    // stays inside the parent along this axis (the offset may still flip the 
+                    // child to the other half)
+                    parentNeighborStencilCell += 1 * IntegerPower(3, axis);
+                    if (offset != 0)
+                    {
+                        siblingIndex ^= (1 << axis);
+                    }
+                }
+            }
+
+            if (leavesParent)
             {
-                // top half of the node
-                childNodeIndex = node._childNodeIndexTopRight;
+                // stencil cell -> neighbor index skips over the center cell
+                int parentNeighborIndex = (parentNeighborStencilCell > stencil_type::CENTER_STENCIL_CELL) ? 
+                    parentNeighborStencilCell - 1 : parentNeighborStencilCell;
+                child._neighborIndices[neighborIndex] = node._neighborIndices[parentNeighborIndex];
             }
             else
             {
-                // bottom half of the node
-                childNodeIndex = node._childNodeIndexBottomRight;
+                child._neighborIndices[neighborIndex] = node._childNodeIndices[siblingIndex];
             }
         }
+    }
+
+    // add all particles to children
+    for (int particleCount = 0; particleCount < node._numCurrentParticles; particleCount++)
+    {
+        int particleIndex = node._indicesForContainedParticles[particleCount];
+        particle_type &p = particleCollection[particleIndex];
 
+        // the node is subdivided, so add the particle to the child nodes
+        int childNodeIndex = node._childNodeIndices[ChildIndexForPosition(node, p._position)];
         AddParticleToNode(particleIndex, childNodeIndex, particleCollection);
 
         // not actually necessary because the array will be run over on the next update, but I 
@@ -641,40 +1233,117 @@ bool ParticleQuadTree::SubdivideNode(int nodeIndex, std::vector<Particle> &parti
     return true;
 }
 
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Figures out which of a subdivided node's children would contain the given position.  There 
+    is no branching on the axes.  Each axis contributes one bit of the child index.
+Parameters: 
+    node        A subdivided node.
+    position    Self-explanatory.
+Returns:    
+    An index into the node's _childNodeIndices array.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+int ParticleSpatialTree<DIM>::ChildIndexForPosition(const node_type &node, 
+    const vec_type &position) const
+{
+    int childIndex = 0;
+    for (int axis = 0; axis < DIM; axis++)
+    {
+        float center = (node._minCorner[axis] + node._maxCorner[axis]) * 0.5f;
+        childIndex |= int(position[axis] >= center) << axis;
+    }
+    return childIndex;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The recursive part of MeasureShape(...).
+Parameters: 
+    nodeIndex   Self-explanatory.
+    depth       How many subdivisions down from a starting node it is.
+    shape       Adds the node's leaves to this.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+void ParticleSpatialTree<DIM>::MeasureShapeWithinNode(int nodeIndex, int depth, 
+    SpatialTreeShape *shape) const
+{
+    const node_type &node = _allQuadTreeNodes[nodeIndex];
+    if (node._isSubdivided)
+    {
+        for (int childIndex = 0; childIndex < stencil_type::NUM_CHILDREN; childIndex++)
+        {
+            MeasureShapeWithinNode(node._childNodeIndices[childIndex], depth + 1, shape);
+        }
+        return;
+    }
+
+    int occupancy = node._numCurrentParticles;
+    int bucket = (occupancy + SpatialTreeShape::OCCUPANCY_BUCKET_WIDTH - 1) / 
+        SpatialTreeShape::OCCUPANCY_BUCKET_WIDTH;
+    int clampedDepth = (depth > SpatialTreeShape::MAX_DEPTH) ? SpatialTreeShape::MAX_DEPTH : depth;
+    shape->_numLeaves++;
+    shape->_leavesAtDepth[clampedDepth]++;
+    shape->_leavesWithOccupancy[bucket]++;
+    shape->_maxDepth = (depth > shape->_maxDepth) ? depth : shape->_maxDepth;
+    shape->_maxOccupancy = (occupancy > shape->_maxOccupancy) ? occupancy : shape->_maxOccupancy;
+    shape->_meanOccupancy += (float)occupancy;
+}
+
 /*-----------------------------------------------------------------------------------------------
 Description:
     Governs the particle-particle collisions within this node and for each particle with the 
-    node's neighbor, if necessary.
+    node's neighbors, if necessary.
+
+    Note: Each pair is only supposed to be collided once.  Pairs within the node are taken care 
+    of by starting the inner loop after the outer particle.  Pairs that straddle two nodes are 
+    found from both sides, so ParticleCollisionsWithNeighboringNode(...) only takes the pair 
+    from the side with the lower particle index.
+
+    Also Note: The neighbors only cover one node's width around the node.  A leaf that had to 
+    subdivide below the minimum node size can be narrower than the search distance, so a 
+    particle whose search reaches past its neighbors searches the tree around itself instead 
+    (see VisitLeavesOverlappingBox(...)).  Every particle finds all of its partners either 
+    way, so the "lower index" rule still collides each pair once.
 Parameters: 
-    nodeIndex       The quad tree node whose particles will be collided.
-    deltaTimeSec    Self-explanatory.
+    nodeIndex       The tree node whose particles will be collided.
+    searchDistanceSqr   Particles closer than this to a neighbor are checked against it.
+    kernel          Collides a single pair.
     particleCollection  Self-explanatory.
+    counters        The calling job's statistics.
 Returns:    None
 Exception:  Safe
 Creator:    John Cox (1-3-2017)
 -----------------------------------------------------------------------------------------------*/
-void ParticleQuadTree::ParticleCollisionsWithinNode(int nodeIndex, float deltaTimeSec, 
-    std::vector<Particle> &particleCollection) const
+template<int DIM>
+template<typename KERNEL>
+void ParticleSpatialTree<DIM>::ParticleCollisionsWithinNode(int nodeIndex, 
+    float searchDistanceSqr, const KERNEL &kernel, 
+    std::vector<particle_type> &particleCollection, ParticleCollisionCounters &counters) const
 {
-    const QuadTreeNode &node = _allQuadTreeNodes[nodeIndex];
+    const node_type &node = _allQuadTreeNodes[nodeIndex];
 
     if (node._isSubdivided)
     {
         // only check the children
-        ParticleCollisionsWithinNode(node._childNodeIndexTopLeft, deltaTimeSec, particleCollection);
-        ParticleCollisionsWithinNode(node._childNodeIndexTopRight, deltaTimeSec, particleCollection);
-        ParticleCollisionsWithinNode(node._childNodeIndexBottomRight, deltaTimeSec, particleCollection);
-        ParticleCollisionsWithinNode(node._childNodeIndexBottomLeft, deltaTimeSec, particleCollection);
+        for (int childIndex = 0; childIndex < stencil_type::NUM_CHILDREN; childIndex++)
+        {
+            ParticleCollisionsWithinNode(node._childNodeIndices[childIndex], searchDistanceSqr, 
+                kernel, particleCollection, counters);
+        }
 
         return;
     }
 
+    float searchDistance = sqrtf(searchDistanceSqr);
+
     // check all particles in the node for collisions against all other particles in the node
-    // Note: The -1 prevents array overrun with the inner loop that starts at 
-    // particleCount + 1.
-    for (int particleCount = 0;
-        particleCount < (node._numCurrentParticles - 1);
-        particleCount++)
+    for (int particleCount = 0; particleCount < node._numCurrentParticles; particleCount++)
     {
         int particle1Index = node._indicesForContainedParticles[particleCount];
 
@@ -690,190 +1359,591 @@ void ParticleQuadTree::ParticleCollisionsWithinNode(int nodeIndex, float deltaTi
         {
             int particle2Index = node._indicesForContainedParticles[particleCompareCount];
 
-            ParticleCollisionP1WithP2(particle1Index, particle2Index, deltaTimeSec, particleCollection);
+            counters._numPairTests++;
+            if (kernel.CollideP1WithP2(particle1Index, particle2Index, particleCollection))
+            {
+                counters._numPairsCollided++;
+            }
         }
 
-        // check against all 8 neighbors
-        // Note: If a particle is in a corner of a small particle region, it is possible for its 
-        // region of influence to extend into multiple neighbors, so just use if(...) and not 
-        // else if(...).
-        Particle &p1 = particleCollection[particle1Index];
+        // sleeping particles don't go looking for neighbors; any awake particle close enough 
+        // to bother them will find them (see ParticleCollisionsWithNeighboringNode(...))
+        const particle_type &p1 = particleCollection[particle1Index];
+        if (p1._isAsleep)
+        {
+            continue;
+        }
 
-        float x = p1._position.x;
-        float y = p1._position.y;
-        float r = p1._radiusOfInfluence;
+        // check against all neighbors
+        // Note: If a particle is in a corner of a small node, it is possible for its region of 
+        // influence to extend into multiple neighbors, so every neighbor gets its own check.
+        // Also Note: The particle's region of influence is circular (spherical in 3D).  The 
+        // distance to a diagonal neighbor is the distance to the corner (or edge in 3D) that it 
+        // touches, so add up the squared distances to the node's faces along each axis that 
+        // the neighbor steps along.
+        // Also Note: A particle that has moved out of its node since the tree was built is 0 
+        // away from the faces that it crossed.
+        float distanceToMinFace[DIM];
+        float distanceToMaxFace[DIM];
+        bool searchFitsInNeighbors = true;
+        for (int axis = 0; axis < DIM; axis++)
+        {
+            float toMin = p1._position[axis] - node._minCorner[axis];
+            float toMax = node._maxCorner[axis] - p1._position[axis];
+            distanceToMinFace[axis] = (toMin > 0.0f) ? toMin : 0.0f;
+            distanceToMaxFace[axis] = (toMax > 0.0f) ? toMax : 0.0f;
+
+            // the neighbors reach one node width past each face
+            float nodeWidth = node._maxCorner[axis] - node._minCorner[axis];
+            searchFitsInNeighbors &= (toMin + nodeWidth >= searchDistance) && 
+                (toMax + nodeWidth >= searchDistance);
+        }
 
-        // sin(45) == cos(45) == sqrt(2) / 2
-        // Note: The particle's region of influence is circular.  Use a radius value modified by 
-        // sin(45) to check whether the diagonal radius extends into a neighbor.
-        float sqrt2Over2 = 0.70710678118f;
-        float diagonalR = p1._radiusOfInfluence * sqrt2Over2;
+        if (!searchFitsInNeighbors)
+        {
+            // too narrow a leaf; look at every leaf that the search reaches
+            auto collideWithLeaf = [&](const node_type &leaf)
+            {
+                int leafNodeIndex = (int)(&leaf - _allQuadTreeNodes.data());
+                if (leafNodeIndex != nodeIndex)
+                {
+                    ParticleCollisionsWithNeighboringNode(particle1Index, leafNodeIndex, 
+                        searchDistanceSqr, kernel, particleCollection, counters);
+                }
+            };
+            VisitLeavesOverlappingBox(p1._position - vec_type(searchDistance), 
+                p1._position + vec_type(searchDistance), collideWithLeaf);
+            continue;
+        }
 
-        // remember that y increases from top to bottom (y = 0 at top, y = 1 at bottom)
-        bool xWithinThisNode = (x > node._leftEdge) && (x < node._rightEdge);
-        bool xLeft = x - r < node._leftEdge;
-        bool xRight = x + r > node._rightEdge;
-        bool xDiagonalLeft = x - diagonalR < node._leftEdge;
-        bool xDiagonalRight = x + diagonalR > node._leftEdge;
+        // Note: Neighbors that were inherited from a parent can be shared by several 
+        // directions (ex: the top left child's top and top right neighbors are both the 
+        // parent's top neighbor), so only visit each neighboring node once.
+        int visitedNeighbors[stencil_type::NUM_NEIGHBORS];
+        int numVisitedNeighbors = 0;
+        for (int neighborIndex = 0; neighborIndex < stencil_type::NUM_NEIGHBORS; neighborIndex++)
+        {
+            float distanceToNeighborSqr = 0.0f;
+            for (int axis = 0; axis < DIM; axis++)
+            {
+                int offset = stencil_type::NeighborOffset(neighborIndex, axis);
+                float d = (offset < 0) ? distanceToMinFace[axis] : 
+                    ((offset > 0) ? distanceToMaxFace[axis] : 0.0f);
+                distanceToNeighborSqr += d * d;
+            }
 
-        bool yWithinThisNode = (y > node._topEdge) && (y < node._bottomEdge);
-        bool yTop = y - r < node._topEdge;
-        bool yBottom = y + r > node._bottomEdge;
-        bool yDiagonalTop = y - diagonalR < node._topEdge;
-        bool yDiagonalBottom = y + diagonalR > node._bottomEdge;
+            int neighborNodeIndex = node._neighborIndices[neighborIndex];
+            if (distanceToNeighborSqr >= searchDistanceSqr || neighborNodeIndex < 0)
+            {
+                continue;
+            }
 
-        bool topLeft = xDiagonalLeft && yDiagonalTop;
-        bool top = xWithinThisNode && yTop;
-        bool topRight = xDiagonalRight && yDiagonalTop;
-        bool right = xRight && yWithinThisNode;
-        bool bottomRight = xDiagonalRight && yDiagonalBottom;
-        bool bottom = xWithinThisNode && yBottom;
-        bool bottomLeft = xDiagonalLeft && yDiagonalBottom;
-        bool left = xLeft && yWithinThisNode;
+            bool alreadyVisited = false;
+            for (int visitedCount = 0; visitedCount < numVisitedNeighbors; visitedCount++)
+            {
+                alreadyVisited |= (visitedNeighbors[visitedCount] == neighborNodeIndex);
+            }
 
-        if (topLeft)
-        {
-            ParticleCollisionsWithNeighboringNode(particleCount, node._neighborIndexTopLeft, deltaTimeSec, particleCollection);
+            if (!alreadyVisited)
+            {
+                visitedNeighbors[numVisitedNeighbors++] = neighborNodeIndex;
+                ParticleCollisionsWithNeighboringNode(particle1Index, neighborNodeIndex, 
+                    searchDistanceSqr, kernel, particleCollection, counters);
+            }
         }
+    }
+}
 
-        if (top)
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Governs the particle-particle collisions of a single particle with all the particles in 
+    another node.  This is used for particle-particle collisions with a neighboring node.
+
+    Neighbors can be larger than the particle's node, and they can have subdivided since the 
+    neighbor relationship was made, so descend into any children that are close enough to the 
+    particle.
+Parameters: 
+    particleIndex   The particle to check.
+    nodeIndex       The tree node whose particles will be collided.  Can be -1 (no neighbor).
+    searchDistanceSqr   Only descend into children that are closer than this.
+    kernel          Collides a single pair.
+    particleCollection  Self-explanatory.
+    counters        The calling job's statistics.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (1-3-2017)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+template<typename KERNEL>
+void ParticleSpatialTree<DIM>::ParticleCollisionsWithNeighboringNode(int particleIndex, 
+    int nodeIndex, float searchDistanceSqr, const KERNEL &kernel, 
+    std::vector<particle_type> &particleCollection, ParticleCollisionCounters &counters) const
+{
+    if (nodeIndex < 0)
+    {
+        // edge of the tree
+        return;
+    }
+
+    const node_type &node = _allQuadTreeNodes[nodeIndex];
+
+    if (node._isSubdivided)
+    {
+        const vec_type &p1Position = particleCollection[particleIndex]._position;
+        for (int childIndex = 0; childIndex < stencil_type::NUM_CHILDREN; childIndex++)
         {
-            ParticleCollisionsWithNeighboringNode(particleCount, node._neighborIndexTop, deltaTimeSec, particleCollection);
+            int childNodeIndex = node._childNodeIndices[childIndex];
+            const node_type &child = _allQuadTreeNodes[childNodeIndex];
+
+            // distance from the particle to the child's box
+            float distanceSqr = 0.0f;
+            for (int axis = 0; axis < DIM; axis++)
+            {
+                float belowMin = child._minCorner[axis] - p1Position[axis];
+                float aboveMax = p1Position[axis] - child._maxCorner[axis];
+                float d = (belowMin > 0.0f) ? belowMin : ((aboveMax > 0.0f) ? aboveMax : 0.0f);
+                distanceSqr += d * d;
+            }
+
+            if (distanceSqr < searchDistanceSqr)
+            {
+                ParticleCollisionsWithNeighboringNode(particleIndex, childNodeIndex, 
+                    searchDistanceSqr, kernel, particleCollection, counters);
+            }
         }
 
-        if (topRight)
+        return;
+    }
+
+    counters._numNeighborNodeVisits++;
+    for (int particleCompareCount = 0;
+        particleCompareCount < node._numCurrentParticles;
+        particleCompareCount++)
+    {
+        int particle2Index = node._indicesForContainedParticles[particleCompareCount];
+
+        // the other particle will find this pair too when it checks its own neighbors, unless 
+        // it is asleep, in which case it isn't looking
+        if (particleIndex < particle2Index || particleCollection[particle2Index]._isAsleep)
         {
-            ParticleCollisionsWithNeighboringNode(particleCount, node._neighborIndexTopRight, deltaTimeSec, particleCollection);
+            counters._numPairTests++;
+            if (kernel.CollideP1WithP2(particleIndex, particle2Index, particleCollection))
+            {
+                counters._numPairsCollided++;
+            }
         }
+    }
 
-        if (right)
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Calls the visitor with every leaf node that overlaps a box.  The starting cells that the 
+    box covers are counted through like an odometer, and each one is descended into.  Used by 
+    the box, radius, and nearest-particle queries, which only differ in what they do with the 
+    particles in each leaf.
+Parameters: 
+    nodeSearchMin, nodeSearchMax    The box, already padded.
+    visitor             Called as visitor(const node_type &leaf).
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+template<typename VISITOR>
+void ParticleSpatialTree<DIM>::VisitLeavesOverlappingBox(const vec_type &nodeSearchMin, 
+    const vec_type &nodeSearchMax, VISITOR &visitor) const
+{
+    // the range of starting cells along each axis
+    // Note: Same cell calculation as in AddParticlestoTree(...).
+    float inverseIncrementPerNode = _numCellsPerAxisInitial / (2.0f * _particleRegionRadius);
+    vec_type regionMinCorner = _particleRegionCenter - vec_type(_particleRegionRadius);
+    int minCell[DIM];
+    int maxCell[DIM];
+    for (int axis = 0; axis < DIM; axis++)
+    {
+        float minDiff = (nodeSearchMin[axis] - regionMinCorner[axis]) * inverseIncrementPerNode;
+        float maxDiff = (nodeSearchMax[axis] - regionMinCorner[axis]) * inverseIncrementPerNode;
+        minCell[axis] = (minDiff < 0.0f) ? 0 : 
+            ((minDiff >= _numCellsPerAxisInitial) ? _numCellsPerAxisInitial : (int)minDiff);
+        maxCell[axis] = (maxDiff < 0.0f) ? -1 : 
+            ((maxDiff >= _numCellsPerAxisInitial) ? _numCellsPerAxisInitial - 1 : (int)maxDiff);
+        if (minCell[axis] > maxCell[axis])
         {
-            ParticleCollisionsWithNeighboringNode(particleCount, node._neighborIndexRight, deltaTimeSec, particleCollection);
+            // entirely outside the region
+            return;
         }
+    }
 
-        if (bottomRight)
+    // count through the cells like an odometer, with the X axis turning fastest
+    int cell[DIM];
+    for (int axis = 0; axis < DIM; axis++)
+    {
+        cell[axis] = minCell[axis];
+    }
+    while (true)
+    {
+        // same index calulation as in InitializeTree(...)
+        int nodeIndex = 0;
+        int axisStride = 1;
+        for (int axis = 0; axis < DIM; axis++)
         {
-            ParticleCollisionsWithNeighboringNode(particleCount, node._neighborIndexBottomRight, deltaTimeSec, particleCollection);
+            nodeIndex += cell[axis] * axisStride;
+            axisStride *= _numCellsPerAxisInitial;
         }
 
-        if (bottom)
+        VisitLeavesOverlappingBoxWithinNode(nodeIndex, nodeSearchMin, nodeSearchMax, visitor);
+
+        int axis = 0;
+        while (axis < DIM && cell[axis] == maxCell[axis])
+        {
+            cell[axis] = minCell[axis];
+            axis++;
+        }
+        if (axis == DIM)
         {
-            ParticleCollisionsWithNeighboringNode(particleCount, node._neighborIndexBottom, deltaTimeSec, particleCollection);
+            break;
         }
+        cell[axis]++;
+    }
+}
 
-        if (bottomLeft)
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Descends into the children that overlap the box and calls the visitor with each leaf.
+Parameters: 
+    nodeIndex           The node to search.
+    nodeSearchMin, nodeSearchMax    The box, already padded.
+    visitor             Called as visitor(const node_type &leaf).
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+template<typename VISITOR>
+void ParticleSpatialTree<DIM>::VisitLeavesOverlappingBoxWithinNode(int nodeIndex, 
+    const vec_type &nodeSearchMin, const vec_type &nodeSearchMax, VISITOR &visitor) const
+{
+    const node_type &node = _allQuadTreeNodes[nodeIndex];
+    if (!node._isSubdivided)
+    {
+        visitor(node);
+        return;
+    }
+
+    for (int childIndex = 0; childIndex < stencil_type::NUM_CHILDREN; childIndex++)
+    {
+        int childNodeIndex = node._childNodeIndices[childIndex];
+        const node_type &child = _allQuadTreeNodes[childNodeIndex];
+        bool overlaps = true;
+        for (int axis = 0; axis < DIM; axis++)
         {
-            ParticleCollisionsWithNeighboringNode(particleCount, node._neighborIndexBottomLeft, deltaTimeSec, particleCollection);
+            overlaps &= (child._minCorner[axis] <= nodeSearchMax[axis]) && 
+                (child._maxCorner[axis] >= nodeSearchMin[axis]);
         }
 
-        if (left)
+        if (overlaps)
         {
-            ParticleCollisionsWithNeighboringNode(particleCount, node._neighborIndexLeft, deltaTimeSec, particleCollection);
+            VisitLeavesOverlappingBoxWithinNode(childNodeIndex, nodeSearchMin, nodeSearchMax, 
+                visitor);
         }
     }
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Governs the particle-particle collisions of a single particle with all the particles in 
-    another node.  This is used for particle-particle collisions with a neighboring node.
+    Checks the ray against a node's (padded) box and, if it enters the box before the nearest 
+    hit so far, either descends into the children or checks the particles.
 Parameters: 
-    particleIndex   The particle to check.
-    nodeIndex       The quad tree node whose particles will be collided.
-    deltaTimeSec    Self-explanatory.
+    nodeIndex           The node to search.
     particleCollection  Self-explanatory.
+    particleProperties  For the radii.
+    state               The ray and the nearest hit so far.
 Returns:    None
 Exception:  Safe
-Creator:    John Cox (1-3-2017)
+Creator:    John Cox (10-19-2026)
 -----------------------------------------------------------------------------------------------*/
-void ParticleQuadTree::ParticleCollisionsWithNeighboringNode(int particleIndex, int nodeIndex, 
-    float deltaTimeSec, std::vector<Particle> &particleCollection) const
+template<int DIM>
+void ParticleSpatialTree<DIM>::RaycastWithinNode(int nodeIndex, 
+    const std::vector<particle_type> &particleCollection, 
+    const ParticlePropertyStorage &particleProperties, RaycastState *state) const
 {
-    const QuadTreeNode &node = _allQuadTreeNodes[nodeIndex];
+    const node_type &node = _allQuadTreeNodes[nodeIndex];
 
-    for (int particleCompareCount = 0;
-        particleCompareCount < node._numCurrentParticles;
-        particleCompareCount++)
+    // slab test: the ray is inside the box between the latest entry and the earliest exit 
+    // over all axes
+    float entryDistance = 0.0f;
+    float exitDistance = state->_nearestDistance;
+    for (int axis = 0; axis < DIM; axis++)
     {
-        int particle2Index = node._indicesForContainedParticles[particleCompareCount];
+        float slabMin = node._minCorner[axis] - state->_nodePadding;
+        float slabMax = node._maxCorner[axis] + state->_nodePadding;
+        if (state->_direction[axis] == 0.0f)
+        {
+            // parallel to the slab, so it is either always in it or never
+            if (state->_origin[axis] < slabMin || state->_origin[axis] > slabMax)
+            {
+                return;
+            }
+            continue;
+        }
+
+        float distance1 = (slabMin - state->_origin[axis]) * state->_inverseDirection[axis];
+        float distance2 = (slabMax - state->_origin[axis]) * state->_inverseDirection[axis];
+        entryDistance = std::max(entryDistance, std::min(distance1, distance2));
+        exitDistance = std::min(exitDistance, std::max(distance1, distance2));
+    }
+    if (entryDistance > exitDistance)
+    {
+        return;
+    }
 
-        ParticleCollisionP1WithP2(particleIndex, particle2Index, deltaTimeSec, particleCollection);
+    if (node._isSubdivided)
+    {
+        for (int childIndex = 0; childIndex < stencil_type::NUM_CHILDREN; childIndex++)
+        {
+            RaycastWithinNode(node._childNodeIndices[childIndex], particleCollection, 
+                particleProperties, state);
+        }
+        return;
     }
 
+    for (int particleCount = 0; particleCount < node._numCurrentParticles; particleCount++)
+    {
+        int particleIndex = node._indicesForContainedParticles[particleCount];
+        float radius = particleProperties.GetSpeciesProperties(
+            particleProperties.GetSpecies(particleIndex))._radiusOfInfluence;
+
+        // the closest that the ray comes to the particle's center, and then back up to where 
+        // it crosses the circle
+        vec_type originToParticle = particleCollection[particleIndex]._position - state->_origin;
+        float closestDistance = glm::dot(originToParticle, state->_direction);
+        float missDistanceSqr = glm::dot(originToParticle, originToParticle) - 
+            (closestDistance * closestDistance);
+        float radiusSqr = radius * radius;
+        if (missDistanceSqr > radiusSqr)
+        {
+            continue;
+        }
+
+        float halfChord = sqrtf(radiusSqr - missDistanceSqr);
+        if (closestDistance + halfChord < 0.0f)
+        {
+            // entirely behind the origin
+            continue;
+        }
+
+        // a ray that starts inside a particle hits it right away
+        float hitDistance = closestDistance - halfChord;
+        hitDistance = (hitDistance < 0.0f) ? 0.0f : hitDistance;
+        if (hitDistance < state->_nearestDistance)
+        {
+            state->_nearestDistance = hitDistance;
+            state->_nearestIndex = particleIndex;
+        }
+    }
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Calculates and adds force for P1 on P2 and P2 on P1.  An N^2 particle collision approach 
-    will result in duplicate force calculations.  
+    Adds up the particles in a node and everything under it, and records the total for it 
+    and for every node under it.
 Parameters: 
-    p1Index     Self-explanatory
-    p2Index     Self-explanatory
-    deltaTimeSec    Self-explanatory.
-    particleCollection  Self-explanatory.
-Returns:    None
+    nodeIndex       Self-explanatory.
+    subtreeCounts   One entry per node in use.
+Returns:
+    The node's total.
 Exception:  Safe
-Creator:    John Cox (1-3-2017)
+Creator:    John Cox (10-19-2026)
 -----------------------------------------------------------------------------------------------*/
-void ParticleQuadTree::ParticleCollisionP1WithP2(int p1Index, int p2Index, float deltaTimeSec, 
-    std::vector<Particle> &particleCollection) const
+template<int DIM>
+int ParticleSpatialTree<DIM>::CountSubtreeParticles(int nodeIndex, 
+    std::vector<int> &subtreeCounts) const
 {
-    Particle &p1 = particleCollection[p1Index];
-    Particle &p2 = particleCollection[p2Index];
-
-    glm::vec2 p1ToP2 = p2._position - p1._position;
-
-    // partial pythagorean theorem
-    float distanceBetweenSqr = (p1ToP2.x * p1ToP2.x) + (p1ToP2.y * p1ToP2.y);
+    const node_type &node = _allQuadTreeNodes[nodeIndex];
+    int count = node._numCurrentParticles;
+    if (node._isSubdivided)
+    {
+        for (int childIndex = 0; childIndex < stencil_type::NUM_CHILDREN; childIndex++)
+        {
+            count += CountSubtreeParticles(node._childNodeIndices[childIndex], subtreeCounts);
+        }
+    }
 
-    float minDistanceForCollisionSqr = (p1._radiusOfInfluence + p2._radiusOfInfluence);
-    minDistanceForCollisionSqr = minDistanceForCollisionSqr * minDistanceForCollisionSqr;
+    subtreeCounts[nodeIndex] = count;
+    return count;
+}
 
-    if (distanceBetweenSqr < minDistanceForCollisionSqr)
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Cuts a node's subtree into pieces that are each run by one job.  A subdivided node that 
+    has more than the cutoff's worth of particles under it is cut into its children, and so 
+    on down.  Empty pieces are left out.
+Parameters: 
+    nodeIndex       Self-explanatory.
+    serialCutoff    Self-explanatory.
+    subtreeCounts   From CountSubtreeParticles(...).
+    putSubtreesHere Gets the root node of each piece.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+void ParticleSpatialTree<DIM>::SplitSubtreesAboveCutoff(int nodeIndex, int serialCutoff, 
+    const std::vector<int> &subtreeCounts, std::vector<int> &putSubtreesHere) const
+{
+    if (subtreeCounts[nodeIndex] == 0)
     {
-        // elastic collision with conservation of momentum
-        // Note: For an elastic collision between two particles of equal mass, the 
-        // velocities of the two will be exchanged.  I could use this simplified 
-        // idea for this demo, but I want to eventually have the option of different 
-        // masses of particles, so I will use the general case elastic collision 
-        // calculations (bottom of page at link).
-        // http://hyperphysics.phy-astr.gsu.edu/hbase/colsta.html
+        return;
+    }
 
-        // for elastic collisions between two masses (ignoring rotation because 
-        // these particles are points), use the calculations from this article (I 
-        // followed them on paper too and it seems legit)
-        // http://www.gamasutra.com/view/feature/3015/pool_hall_lessons_fast_accurate_.php?page=3
+    const node_type &node = _allQuadTreeNodes[nodeIndex];
+    if (!node._isSubdivided || subtreeCounts[nodeIndex] <= serialCutoff)
+    {
+        putSubtreesHere.push_back(nodeIndex);
+        return;
+    }
 
-        // Note: I tried using a fast inverse square root calculation instead, but it didn't 
-        // seem to save any frames, so I'm just using GLM's normalize.
-        glm::vec2 normalizedLineOfContact = glm::normalize(p1ToP2);
+    for (int childIndex = 0; childIndex < stencil_type::NUM_CHILDREN; childIndex++)
+    {
+        SplitSubtreesAboveCutoff(node._childNodeIndices[childIndex], serialCutoff, 
+            subtreeCounts, putSubtreesHere);
+    }
+}
 
-        float a1 = glm::dot(p1._velocity, p1ToP2);
-        float a2 = glm::dot(p2._velocity, p1ToP2);
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Greedily colors the pieces so that no two of the same color have boxes that are closer 
+    together than the gap, then sorts them by color.  The biggest pieces are colored first so 
+    that they land in the first colors and, within each color, come first, where the calling 
+    thread and the first thieves pick them up.
+Parameters: 
+    minGap          Self-explanatory.
+    subtreeCounts   From CountSubtreeParticles(...).
+    subtreeRoots    In: the pieces.  Out: the same pieces, sorted by color.
+    putColorEndsHere    Gets where each color's pieces end in subtreeRoots.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+void ParticleSpatialTree<DIM>::ColorSubtrees(float minGap, 
+    const std::vector<int> &subtreeCounts, std::vector<int> &subtreeRoots, 
+    std::vector<int> &putColorEndsHere) const
+{
+    std::stable_sort(subtreeRoots.begin(), subtreeRoots.end(), [&](int a, int b)
+    {
+        return subtreeCounts[a] > subtreeCounts[b];
+    });
 
-        // ??what else do I call it??
-        float fraction = (2.0f * (a1 - a2)) / (p1._mass + p2._mass);
+    float minGapSqr = minGap * minGap;
+    std::vector<std::vector<int> > colors;
+    for (size_t rootCount = 0; rootCount < subtreeRoots.size(); rootCount++)
+    {
+        const node_type &node = _allQuadTreeNodes[subtreeRoots[rootCount]];
+        size_t colorIndex = 0;
+        for (; colorIndex < colors.size(); colorIndex++)
+        {
+            bool fits = true;
+            const std::vector<int> &members = colors[colorIndex];
+            for (size_t memberCount = 0; fits && memberCount < members.size(); memberCount++)
+            {
+                const node_type &other = _allQuadTreeNodes[members[memberCount]];
+                float gapSqr = 0.0f;
+                for (int axis = 0; axis < DIM; axis++)
+                {
+                    float gapBelow = other._minCorner[axis] - node._maxCorner[axis];
+                    float gapAbove = node._minCorner[axis] - other._maxCorner[axis];
+                    float gap = (gapBelow > 0.0f) ? gapBelow : ((gapAbove > 0.0f) ? gapAbove : 0.0f);
+                    gapSqr += gap * gap;
+                }
+                fits = (gapSqr >= minGapSqr);
+            }
 
-        // keep the intermediate "prime" values around for debugging
-        glm::vec2 v1Prime = p1._velocity - (fraction * p2._mass) * normalizedLineOfContact;
-        glm::vec2 v2Prime = p2._velocity + (fraction * p1._mass) * normalizedLineOfContact;
+            if (fits)
+            {
+                break;
+            }
+        }
 
-        glm::vec2 p1InitialMomentum = p1._velocity * p1._mass;
-        glm::vec2 p2InitialMomentum = p2._velocity * p2._mass;
-        glm::vec2 p1FinalMomentum = v1Prime * p1._mass;
-        glm::vec2 p2FinalMomentum = v2Prime * p2._mass;
+        if (colorIndex == colors.size())
+        {
+            colors.push_back(std::vector<int>());
+        }
+        colors[colorIndex].push_back(subtreeRoots[rootCount]);
+    }
 
-        // delta momentum (impulse) = force * delta time
-        // therefore force = delta momentum / delta time
-        glm::vec2 p1Force = (p1FinalMomentum - p1InitialMomentum) / deltaTimeSec;
-        glm::vec2 p2Force = (p2FinalMomentum - p2InitialMomentum) / deltaTimeSec;
+    subtreeRoots.clear();
+    putColorEndsHere.clear();
+    for (size_t colorIndex = 0; colorIndex < colors.size(); colorIndex++)
+    {
+        subtreeRoots.insert(subtreeRoots.end(), colors[colorIndex].begin(), 
+            colors[colorIndex].end());
+        putColorEndsHere.push_back((int)subtreeRoots.size());
+    }
+}
 
-        //p1._velocity = v1Prime;
-        //p2._velocity = v2Prime;
-        p1._netForce += p1Force;
-        p2._netForce += p2Force;
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs a range of one color's pieces.  Ranges of more than one piece are halved, and the 
+    back half is spawned for someone else to steal, until only one piece is left, which runs 
+    the serial recursion.
+Parameters: 
+    context     The ForkJoinCollisionPass<KERNEL>.
+    begin, end  Indices into the pass's pieces, with end not included.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+template<typename KERNEL>
+void ParticleSpatialTree<DIM>::ForkJoinCollisionJob(void *context, int begin, int end)
+{
+    const ForkJoinCollisionPass<KERNEL> &pass = *(const ForkJoinCollisionPass<KERNEL> *)context;
+    while (end - begin > 1)
+    {
+        int middle = begin + (end - begin) / 2;
+        pass._scheduler->Spawn(*pass._joinCounter, &ForkJoinCollisionJob<KERNEL>, context, 
+            middle, end);
+        end = middle;
+    }
 
-        p1._collisionCountThisFrame += 1;
-        p2._collisionCountThisFrame += 1;
+    ParticleCollisionCounters counters;
+    pass._tree->ParticleCollisionsWithinNode(pass._subtreeRoots[begin], 
+        pass._searchDistanceSqr, *pass._kernel, *pass._particleCollection, counters);
+    if (pass._tree->_pStats != 0)
+    {
+        pass._tree->_pStats->AddCounters(counters);
     }
 }
+
+// the only two spaces that this program deals with
+template class ParticleSpatialTree<2>;
+template class ParticleSpatialTree<3>;
+
+// one collision traversal per pre-instantiated collision engine and property access
+#define INSTANTIATE_TREE_COLLISIONS(DIM, RESPONSE) \
+    template void ParticleSpatialTree<DIM>::DoTheParticleParticleCollisions( \
+        const ParticleCollisionKernel<DIM, RESPONSE, UniformParticlePropertyAccess> &kernel, \
+        std::vector<GenericParticle<DIM> > &particleCollection, float searchPadding) const; \
+    template void ParticleSpatialTree<DIM>::DoTheParticleParticleCollisions( \
+        const ParticleCollisionKernel<DIM, RESPONSE, SpeciesParticlePropertyAccess> &kernel, \
+        std::vector<GenericParticle<DIM> > &particleCollection, float searchPadding) const; \
+    template void ParticleSpatialTree<DIM>::DoTheParticleParticleCollisionsForkJoin( \
+        const ParticleCollisionKernel<DIM, RESPONSE, UniformParticlePropertyAccess> &kernel, \
+        std::vector<GenericParticle<DIM> > &particleCollection, \
+        ParticleTaskScheduler &scheduler, int serialCutoff, float searchPadding) const; \
+    template void ParticleSpatialTree<DIM>::DoTheParticleParticleCollisionsForkJoin( \
+        const ParticleCollisionKernel<DIM, RESPONSE, SpeciesParticlePropertyAccess> &kernel, \
+        std::vector<GenericParticle<DIM> > &particleCollection, \
+        ParticleTaskScheduler &scheduler, int serialCutoff, float searchPadding) const;
+FOR_EACH_COLLISION_RESPONSE(INSTANTIATE_TREE_COLLISIONS, 2)
+FOR_EACH_COLLISION_RESPONSE(INSTANTIATE_TREE_COLLISIONS, 3)
+
+// the position-based contact solver's contact gathering is 2D only
+template void ParticleSpatialTree<2>::DoTheParticleParticleCollisions(
+    const ParticleContactGatherKernel<UniformParticlePropertyAccess> &kernel, 
+    std::vector<GenericParticle<2> > &particleCollection, float searchPadding) const;
+template void ParticleSpatialTree<2>::DoTheParticleParticleCollisions(
+    const ParticleContactGatherKernel<SpeciesParticlePropertyAccess> &kernel, 
+    std::vector<GenericParticle<2> > &particleCollection, float searchPadding) const;
@@ -1,50 +1,219 @@
 #pragma once
 
 #include <vector>
+#include <atomic>
 #include "Particle.h"
-#include "glm\vec2.hpp"
+#include "glm/vec2.hpp"
 #include "ParticleQuadTreeNode.h"
 #include "GeometryData.h"
+#include "ParticleProperties.h"
+
+class ParticleTaskScheduler;
+class ParticleStats;
+struct ParticleCollisionCounters;
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Responsible for generating a quad tree that can contain all the currently active particles.
+    How the particles are spread over a spatial tree's leaves (see 
+    ParticleSpatialTree::MeasureShape(...)).  The starting nodes are at depth 0.  Occupancy 
+    bucket 0 is empty leaves, and bucket N is leaves with ((N - 1) * width, N * width] 
+    particles.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+struct SpatialTreeShape
+{
+    // leaves that are any deeper are counted at this depth
+    static const int MAX_DEPTH = 15;
+    static const int OCCUPANCY_BUCKET_WIDTH = 8;
+    static const int NUM_OCCUPANCY_BUCKETS = 
+        1 + (MAX_PARTICLES_PER_QUAD_TREE_NODE / OCCUPANCY_BUCKET_WIDTH);
+
+    int _numLeaves;
+    int _maxDepth;
+    int _maxOccupancy;
+    float _meanOccupancy;
+    int _leavesAtDepth[MAX_DEPTH + 1];
+    int _leavesWithOccupancy[NUM_OCCUPANCY_BUCKETS];
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Responsible for generating a spatial tree that can contain all the currently active
+    particles and for running the particle-particle collisions with it.
+
+    The tree is templated on the number of dimensions.  The 2D version is the quad tree (4
+    children per node, 8 neighbors, initial 8x8 grid) and the 3D version is an octree (8
+    children per node, 26 neighbors, initial 8x8x8 grid).  The size of the initial grid and how 
+    many particles a leaf holds before it subdivides can be changed at runtime (see 
+    ParticleTreeAutotuner), but nodes only subdivide below the minimum node size when 
+    particles are piled up too tightly to fit otherwise, so a leaf is rarely narrower than the 
+    neighbor search.  Particles in those leaves search the tree around themselves instead of 
+    only the neighbors.  All the per-axis work is in loops with a constant trip count, so 
+    there is no runtime check on which dimension is in use.
+
+    Once the particles are added, the spatial queries (box, radius, nearest, ray) only read 
+    the tree, so any number of them can run at the same time as long as nothing is adding to 
+    or resetting it.  They write into buffers from the caller and allocate nothing.
 Creator:    John Cox (12-17-2016)
 -----------------------------------------------------------------------------------------------*/
-class ParticleQuadTree
+template<int DIM>
+class ParticleSpatialTree
 {
 public:
-    ParticleQuadTree();
-    void InitializeTree(const glm::vec2 &particleRegionCenter, float particleRegionRadius);
+    typedef GenericParticle<DIM> particle_type;
+    typedef typename ParticleDimension<DIM>::vec_type vec_type;
+    typedef SpatialTreeNode<DIM> node_type;
+    typedef SpatialTreeStencil<DIM> stencil_type;
+
+    ParticleSpatialTree();
+    void InitializeTree(const vec_type &particleRegionCenter, float particleRegionRadius);
     void ResetTree();
-    void AddParticlestoTree(std::vector<Particle> &particleCollection);
-    void DoTheParticleParticleCollisions(float deltaTimeSec, std::vector<Particle> &particleCollection) const;
+    void AddParticlestoTree(std::vector<particle_type> &particleCollection);
+
+    // KERNEL is a ParticleCollisionKernel<DIM, ...>; see IParticleCollisionEngine
+    // Note: The kernel also decides how far to search into neighboring nodes.
+    // Note: The search padding allows the particles to have moved since they were added.
+    template<typename KERNEL>
+    void DoTheParticleParticleCollisions(const KERNEL &kernel, std::vector<particle_type> &particleCollection, float searchPadding = 0.0f) const;
+
+    // the same collisions, but subtrees with more than the cutoff's worth of particles are 
+    // split up and run as jobs on the scheduler's work-stealing deques
+    // Note: The kernel must only write to the pair that it is given.
+    template<typename KERNEL>
+    void DoTheParticleParticleCollisionsForkJoin(const KERNEL &kernel, std::vector<particle_type> &particleCollection, ParticleTaskScheduler &scheduler, int serialCutoff, float searchPadding = 0.0f) const;
+
+    // the active particles whose current positions are inside the box
+    // Note: The search padding is the same as for the collisions.  It is added to the box 
+    // when deciding which nodes to look in, but not when checking particle positions.
+    int FindParticlesInBox(const vec_type &boxMin, const vec_type &boxMax, 
+        const std::vector<particle_type> &particleCollection, int *putIndicesHere, 
+        int maxIndices, float searchPadding = 0.0f) const;
+    int FindParticlesInRadius(const vec_type &center, float radius, 
+        const std::vector<particle_type> &particleCollection, int *putIndicesHere, 
+        int maxIndices, float searchPadding = 0.0f) const;
+    int FindNearestParticles(const vec_type &point, int k, 
+        const std::vector<particle_type> &particleCollection, int *putIndicesHere, 
+        float *putDistancesSqrHere, float searchPadding = 0.0f) const;
+    int RaycastParticles(const vec_type &origin, const vec_type &direction, float maxDistance, 
+        const std::vector<particle_type> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties, float *putDistanceHere = 0, 
+        float searchPadding = 0.0f) const;
+
+    // many queries of one kind in one call
+    // Note: The box and radius results are packed one query after another, with each query's 
+    // end written to putQueryEndsHere.  The nearest-particle results are k per query.
+    int FindParticlesInBoxes(const vec_type *boxMins, const vec_type *boxMaxes, int numQueries, 
+        const std::vector<particle_type> &particleCollection, int *putIndicesHere, 
+        int maxIndices, int *putQueryEndsHere, float searchPadding = 0.0f) const;
+    int FindParticlesInRadii(const vec_type *centers, const float *radii, int numQueries, 
+        const std::vector<particle_type> &particleCollection, int *putIndicesHere, 
+        int maxIndices, int *putQueryEndsHere, float searchPadding = 0.0f) const;
+    void FindNearestParticlesBatch(const vec_type *points, int numQueries, int k, 
+        const std::vector<particle_type> &particleCollection, int *putIndicesHere, 
+        float *putDistancesSqrHere, int *putCountsHere, float searchPadding = 0.0f) const;
+    void RaycastParticlesBatch(const vec_type *origins, const vec_type *directions, 
+        int numQueries, float maxDistance, const std::vector<particle_type> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties, int *putIndicesHere, 
+        float *putDistancesHere, float searchPadding = 0.0f) const;
 
     void GenerateGeometry(GeometryData *putDataHere, bool firstTime = false);
     int NumNodesInUse() const;
+    int NumParticlesNotAdded() const;
+
+    // statistics (see ParticleStats)
+    // Note: The collision passes count into the stats' per-thread slots.  0 doesn't count.
+    void SetStats(ParticleStats *pStats);
+    int NumSubdivisionFailures() const;
+    void MeasureShape(SpatialTreeShape *putShapeHere) const;
+
+    // the subdivision parameters
+    // Note: The leaf capacity takes effect the next time that particles are added, and the 
+    // initial grid the next time that the tree is reset.
+    bool SetLeafCapacity(int leafCapacity);
+    bool SetNumCellsPerAxisInitial(int numCellsPerAxis);
+    void SetMinNodeSize(float minNodeSize);
+    int LeafCapacity() const;
+    int NumCellsPerAxisInitial() const;
+    static int MaxNumCellsPerAxisInitial();
 
 private:
-    bool AddParticleToNode(int particleIndex, int nodeIndex, std::vector<Particle> &particleCollection);
-    bool SubdivideNode(int nodeIndex, std::vector<Particle> &particleCollection);
+    bool AddParticleToNode(int particleIndex, int nodeIndex, std::vector<particle_type> &particleCollection);
+    bool SubdivideNode(int nodeIndex, std::vector<particle_type> &particleCollection);
+    int ChildIndexForPosition(const node_type &node, const vec_type &position) const;
+    void MeasureShapeWithinNode(int nodeIndex, int depth, SpatialTreeShape *shape) const;
+
+    // the box, radius, and nearest-particle queries only differ in what they do with each leaf
+    template<typename VISITOR>
+    void VisitLeavesOverlappingBox(const vec_type &nodeSearchMin, const vec_type &nodeSearchMax, 
+        VISITOR &visitor) const;
+    template<typename VISITOR>
+    void VisitLeavesOverlappingBoxWithinNode(int nodeIndex, const vec_type &nodeSearchMin, 
+        const vec_type &nodeSearchMax, VISITOR &visitor) const;
+
+    // lives on the stack of RaycastParticles(...) so that rays don't share anything
+    struct RaycastState
+    {
+        vec_type _origin;
+        vec_type _direction;
+        vec_type _inverseDirection;
+        float _nodePadding;
+        float _nearestDistance;
+        int _nearestIndex;
+    };
+    void RaycastWithinNode(int nodeIndex, const std::vector<particle_type> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties, RaycastState *state) const;
+
+    // fork-join collisions; see DoTheParticleParticleCollisionsForkJoin(...)
+    int CountSubtreeParticles(int nodeIndex, std::vector<int> &subtreeCounts) const;
+    void SplitSubtreesAboveCutoff(int nodeIndex, int serialCutoff, 
+        const std::vector<int> &subtreeCounts, std::vector<int> &putSubtreesHere) const;
+    void ColorSubtrees(float minGap, const std::vector<int> &subtreeCounts, 
+        std::vector<int> &subtreeRoots, std::vector<int> &putColorEndsHere) const;
+    template<typename KERNEL>
+    struct ForkJoinCollisionPass
+    {
+        const ParticleSpatialTree *_tree;
+        const KERNEL *_kernel;
+        std::vector<particle_type> *_particleCollection;
+        ParticleTaskScheduler *_scheduler;
+        std::atomic<int> *_joinCounter;
+        const int *_subtreeRoots;
+        float _searchDistanceSqr;
+    };
+    template<typename KERNEL>
+    static void ForkJoinCollisionJob(void *context, int begin, int end);
 
     //int NodeLookUp(const glm::vec2 &position);
-    void ParticleCollisionsWithinNode(int nodeIndex, float deltaTimeSec, std::vector<Particle> &particleCollection) const;
-    void ParticleCollisionsWithNeighboringNode(int particleIndex, int nodeIndex, float deltaTimeSec, std::vector<Particle> &particleCollection) const;
-    void ParticleCollisionP1WithP2(int thisParticleIndex, int otherParticleIndex, float deltaTimeSec, std::vector<Particle> &particleCollection) const;
+    template<typename KERNEL>
+    void ParticleCollisionsWithinNode(int nodeIndex, float searchDistanceSqr, const KERNEL &kernel, std::vector<particle_type> &particleCollection, ParticleCollisionCounters &counters) const;
+    template<typename KERNEL>
+    void ParticleCollisionsWithNeighboringNode(int particleIndex, int nodeIndex, float searchDistanceSqr, const KERNEL &kernel, std::vector<particle_type> &particleCollection, ParticleCollisionCounters &counters) const;
 
     // increase the number of additional nodes as necessary to handle more subdivision
-    // Note: This algorithm was built with the compute shader's implementation in mind.  These 
-    // structures are meant to be used as if a compute shader was running it, hence all the 
+    // Note: This algorithm was built with the compute shader's implementation in mind.  These
+    // structures are meant to be used as if a compute shader was running it, hence all the
     // arrays and a complete lack of runtime memory reallocation.
-    static const int _NUM_ROWS_IN_TREE_INITIAL = 8;
-    static const int _NUM_COLUMNS_IN_TREE_INITIAL = 8;
-    static const int _NUM_STARTING_NODES = _NUM_ROWS_IN_TREE_INITIAL * _NUM_COLUMNS_IN_TREE_INITIAL;
-    static const int _MAX_NODES = _NUM_STARTING_NODES * 8;
-    
-    QuadTreeNode _allQuadTreeNodes[_MAX_NODES];
-    int _numNodesInUse = _NUM_STARTING_NODES;
-    glm::vec2 _particleRegionCenter;
+    // Also Note: The node array is allocated once in the constructor.  The octree's node pool
+    // is well over a megabyte, which is too big to be a member array of a stack object.
+    // Also Note: The initial grid can be changed at runtime, up to a maximum, so the pool is 
+    // sized for the maximum.  The default is 8 cells per axis.
+    static const int _MAX_CELLS_PER_AXIS_INITIAL = (DIM == 2) ? 16 : 8;
+    static const int _MAX_STARTING_NODES = IntegerPower(_MAX_CELLS_PER_AXIS_INITIAL, DIM);
+    static const int _MAX_NODES = _MAX_STARTING_NODES * 8;
+
+    std::vector<node_type> _allQuadTreeNodes;
+    int _numCellsPerAxisInitial;
+    int _pendingNumCellsPerAxisInitial;
+    int _numStartingNodes;
+    int _numNodesInUse;
+    int _numParticlesNotAdded;
+    int _numSubdivisionFailures;
+    ParticleStats *_pStats;
+    int _leafCapacity;
+    float _minNodeSize;
+    vec_type _particleRegionCenter;
     float _particleRegionRadius;
 };
 
-
+typedef ParticleSpatialTree<2> ParticleQuadTree;
+typedef ParticleSpatialTree<3> ParticleOctree;
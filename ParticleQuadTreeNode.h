@@ -1,42 +1,87 @@
 #pragma once
 
 #include <memory>
+#include <string.h>     // for memset(...)
+#include "Particle.h"
 
-const unsigned int MAX_PARTICLES_PER_QUAD_TREE_NODE = 25;
+// a leaf's capacity is set at runtime (see ParticleSpatialTree::SetLeafCapacity(...)), but 
+// every node has room for the most that it can be set to
+const unsigned int MAX_PARTICLES_PER_QUAD_TREE_NODE = 64;
+const unsigned int DEFAULT_PARTICLES_PER_QUAD_TREE_NODE = 25;
+
+// base^exponent, usable in constant expressions
+// Note: Single return statement because C++11 constexpr functions can't have anything else.
+constexpr int IntegerPower(int base, int exponent)
+{
+    return (exponent == 0) ? 1 : base * IntegerPower(base, exponent - 1);
+}
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Contains all info necessary for a single node of the quad tree.  It is a dumb container 
-    meant for use only by ParticleQuadTree.
-Creator:    John Cox (12-17-2016)
+    The child and neighbor layout of a spatial tree node in DIM dimensions.  Everything is
+    derived from the dimension at compile time so that the loops over children and neighbors
+    have constant trip counts and the per-axis decisions are constant expressions.
+
+    Children: A node is split in half along every axis.  Bit N of a child's index is set if the
+    child is on the positive side of the parent's center along axis N.  In 2D that is 4
+    children (quad tree), in 3D it is 8 (octree).
+
+    Neighbors: The (3 * 3 * ...) block of same-sized cells around a node, minus the node
+    itself.  In 2D that is 8 neighbors, in 3D it is 26.  A stencil cell's offset along axis N
+    is digit N of its base-3 index, shifted from [0,2] to [-1,+1].
+Creator:    John Cox (10-19-2026)
 -----------------------------------------------------------------------------------------------*/
+template<int DIM>
+struct SpatialTreeStencil
+{
+    static const int NUM_CHILDREN = 1 << DIM;
+    static const int NUM_STENCIL_CELLS = IntegerPower(3, DIM);
+    static const int NUM_NEIGHBORS = NUM_STENCIL_CELLS - 1;
 
-// TODO: get rid of neighbors
-struct QuadTreeNode
+    // the stencil cell in the middle is the node itself and is not a neighbor
+    static const int CENTER_STENCIL_CELL = NUM_STENCIL_CELLS / 2;
+
+    // 0 if the child is on the negative side along the axis, 1 if on the positive side
+    static constexpr int ChildSide(int childIndex, int axis)
+    {
+        return (childIndex >> axis) & 1;
+    }
+
+    // -1, 0, or +1
+    static constexpr int NeighborOffset(int neighborIndex, int axis)
+    {
+        return (((neighborIndex < CENTER_STENCIL_CELL) ? neighborIndex : neighborIndex + 1) /
+            IntegerPower(3, axis)) % 3 - 1;
+    }
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Contains all info necessary for a single node of the quad tree (2D) or octree (3D).  It is
+    a dumb container meant for use only by ParticleSpatialTree.
+Creator:    John Cox (12-17-2016)
+-----------------------------------------------------------------------------------------------*/
+template<int DIM>
+struct SpatialTreeNode
 {
-    QuadTreeNode() :
+    typedef typename ParticleDimension<DIM>::vec_type vec_type;
+    typedef SpatialTreeStencil<DIM> stencil_type;
+
+    SpatialTreeNode() :
         _numCurrentParticles(0),
         //_startingParticleIndex(0),
         _inUse(0),
-        _isSubdivided(0),
-        _childNodeIndexTopLeft(-1),
-        _childNodeIndexTopRight(-1),
-        _childNodeIndexBottomRight(-1),
-        _childNodeIndexBottomLeft(-1),
-        _leftEdge(0.0f),
-        _topEdge(0.0f),
-        _rightEdge(0.0f),
-        _bottomEdge(0.0f),
-        _neighborIndexLeft(-1),
-        _neighborIndexTopLeft(-1),
-        _neighborIndexTop(-1),
-        _neighborIndexTopRight(-1),
-        _neighborIndexRight(-1),
-        _neighborIndexBottomRight(-1),
-        _neighborIndexBottom(-1),
-        _neighborIndexBottomLeft(-1)
+        _isSubdivided(0)
     {
         memset(_indicesForContainedParticles, 0, sizeof(int) * MAX_PARTICLES_PER_QUAD_TREE_NODE);
+        for (int childIndex = 0; childIndex < stencil_type::NUM_CHILDREN; childIndex++)
+        {
+            _childNodeIndices[childIndex] = -1;
+        }
+        for (int neighborIndex = 0; neighborIndex < stencil_type::NUM_NEIGHBORS; neighborIndex++)
+        {
+            _neighborIndices[neighborIndex] = -1;
+        }
     }
 
     int _indicesForContainedParticles[MAX_PARTICLES_PER_QUAD_TREE_NODE];
@@ -45,24 +90,15 @@ struct QuadTreeNode
 
     int _inUse;
     int _isSubdivided;
-    int _childNodeIndexTopLeft;
-    int _childNodeIndexTopRight;
-    int _childNodeIndexBottomRight;
-    int _childNodeIndexBottomLeft;
-
-    // left and right edges implicitly X, top and bottom implicitly Y
-    float _leftEdge;
-    float _topEdge;
-    float _rightEdge;
-    float _bottomEdge;
-
-    int _neighborIndexLeft;
-    int _neighborIndexTopLeft;
-    int _neighborIndexTop;
-    int _neighborIndexTopRight;
-    int _neighborIndexRight;
-    int _neighborIndexBottomRight;
-    int _neighborIndexBottom;
-    int _neighborIndexBottomLeft;
-
-};
\ No newline at end of file
+    int _childNodeIndices[stencil_type::NUM_CHILDREN];
+
+    // the old left/right/bottom/top edges, but for any number of axes
+    vec_type _minCorner;
+    vec_type _maxCorner;
+
+    // -1 if there is no neighbor in that direction (edge of the tree)
+    int _neighborIndices[stencil_type::NUM_NEIGHBORS];
+};
+
+typedef SpatialTreeNode<2> QuadTreeNode;
+typedef SpatialTreeNode<3> OctreeNode;
@@ -0,0 +1,1005 @@
+#include "ParticleSimulation.h"
+
+#include <math.h>
+#include <chrono>
+#include "glm/detail/func_geometric.hpp" // for glm::dot
+#include "ParticlePropertyAccess.h"
+
+const float ParticleSimulation::_MAX_STALE_TREE_DISPLACEMENT = 0.5f;
+const float ParticleSimulation::_FAST_PARTICLE_FLAG = 2.0f;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Ensures that the object starts object with initialized values.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleSimulation::ParticleSimulation() :
+    _pUpdater(0),
+    _pTree(0),
+    _pCollisionEngine(0),
+    _pIntegrator(0),
+    _pContactSolver(0),
+    _pWalls(0),
+    _pForceField(0),
+    _pCollisionEvents(0),
+    _pParticleIds(0),
+    _pBroadphase(0),
+    _treeBuiltThisStep(false),
+    _frameNumber(0),
+    _numTreeBuildsThisStep(0),
+    _numForceEvaluationsThisStep(0),
+    _collisionSecThisStep(0.0),
+    _searchPadding(0.0f),
+    _forcesAreDeferred(false),
+    _deferredForcesSec(0.0f),
+    _continuousCollisionsEnabled(false),
+    _numFastParticlesThisStep(0),
+    _numTimeOfImpactHitsThisStep(0)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.  The tree must already be initialized with the particle region.
+Parameters:
+    pUpdater            Self-explanatory.
+    pTree               Self-explanatory.
+    pCollisionEngine    Self-explanatory.
+    pIntegrator         Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSimulation::Init(ParticleUpdater *pUpdater, ParticleQuadTree *pTree, 
+    const IParticleCollisionEngine<2> *pCollisionEngine, IParticleIntegrator *pIntegrator)
+{
+    _pUpdater = pUpdater;
+    _pTree = pTree;
+    _pCollisionEngine = pCollisionEngine;
+    _pIntegrator = pIntegrator;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Advances the simulation by delta time.
+Parameters:
+    particleCollection  Self-explanatory.
+    particleProperties  Self-explanatory.
+    deltaTimeSec        Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSimulation::Step(std::vector<Particle> &particleCollection, 
+    ParticlePropertyStorage &particleProperties, float deltaTimeSec)
+{
+    BeginStep(particleCollection, particleProperties);
+    IntegrateStep(particleCollection, particleProperties, deltaTimeSec);
+    BuildTreeForStep(particleCollection, particleProperties);
+    CollideStep(particleCollection, particleProperties);
+    EndStep(particleCollection, particleProperties, deltaTimeSec);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The first phase of a step.  Runs the updater and starts the step's counts over.
+Parameters:
+    particleCollection  Self-explanatory.
+    particleProperties  Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSimulation::BeginStep(std::vector<Particle> &particleCollection, 
+    ParticlePropertyStorage &particleProperties)
+{
+    // check bounds, emit, and sleep/wake
+    _pUpdater->Update(particleCollection, particleProperties, 0, particleCollection.size());
+
+    if (_continuousCollisionsEnabled)
+    {
+        _positionsAtStepStart.resize(particleCollection.size());
+        for (size_t particleIndex = 0; particleIndex < particleCollection.size(); particleIndex++)
+        {
+            _positionsAtStepStart[particleIndex] = particleCollection[particleIndex]._position;
+        }
+    }
+
+    _frameNumber++;
+    _treeBuiltThisStep = false;
+    _numTreeBuildsThisStep = 0;
+    _numForceEvaluationsThisStep = 0;
+    _collisionSecThisStep = 0.0;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The second phase of a step.  Runs the integrator, but if it ends with a force evaluation, 
+    that one is left to BuildTreeForStep(...) and CollideStep(...).
+Parameters:
+    particleCollection  Self-explanatory.
+    particleProperties  Self-explanatory.
+    deltaTimeSec        Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSimulation::IntegrateStep(std::vector<Particle> &particleCollection, 
+    const ParticlePropertyStorage &particleProperties, float deltaTimeSec)
+{
+    _forcesAreDeferred = _pIntegrator->IntegrateExceptLastEvaluation(*this, particleCollection, 
+        particleProperties, deltaTimeSec, &_deferredForcesSec);
+    if (!_forcesAreDeferred)
+    {
+        _pIntegrator->Integrate(*this, particleCollection, particleProperties, deltaTimeSec);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The third phase of a step.  If the integrator left its last force evaluation, this 
+    starts it: the forces are zeroed, the force fields are added, and the tree is brought up 
+    to date.
+Parameters:
+    particleCollection  Self-explanatory.
+    particleProperties  Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSimulation::BuildTreeForStep(std::vector<Particle> &particleCollection, 
+    const ParticlePropertyStorage &particleProperties)
+{
+    if (_forcesAreDeferred)
+    {
+        PrepareForces(particleCollection, particleProperties);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The fourth phase of a step.  If the integrator left its last force evaluation, this 
+    finishes it with the particle-particle collisions.
+Parameters:
+    particleCollection  Self-explanatory.
+    particleProperties  Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSimulation::CollideStep(std::vector<Particle> &particleCollection, 
+    const ParticlePropertyStorage &particleProperties)
+{
+    if (_forcesAreDeferred)
+    {
+        CollideForces(particleCollection, particleProperties, _deferredForcesSec);
+        _forcesAreDeferred = false;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The last phase of a step.  Runs everything that comes after the integrator: the contact 
+    solver, continuous collisions, and the walls, and evaluates the forces again if any of 
+    them moved the particles.
+Parameters:
+    particleCollection  Self-explanatory.
+    particleProperties  Self-explanatory.
+    deltaTimeSec        Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSimulation::EndStep(std::vector<Particle> &particleCollection, 
+    const ParticlePropertyStorage &particleProperties, float deltaTimeSec)
+{
+    // the forces' last evaluation kept the tree from getting any staler than this
+    float treePadding = 
+        _MAX_STALE_TREE_DISPLACEMENT * particleProperties.MaxRadiusOfInfluence();
+    if (_pContactSolver != 0)
+    {
+        std::chrono::steady_clock::time_point collisionStart = std::chrono::steady_clock::now();
+        float searchPadding = UpdateTree(particleCollection, particleProperties);
+        if (_periodicGhosts.IsEnabled())
+        {
+            _pContactSolver->Solve(*_pTree, searchPadding, _periodicGhosts.BroadphaseParticles(), 
+                _periodicGhosts.BroadphaseProperties(), deltaTimeSec);
+            _periodicGhosts.CopyBack(particleCollection);
+        }
+        else
+        {
+            _pContactSolver->Solve(*_pTree, searchPadding, particleCollection, 
+                particleProperties, deltaTimeSec);
+        }
+
+        // the corrections moved the particles after the tree was checked, maybe by as much 
+        // as a radius, so it has to be checked again before anything else searches it
+        if (_continuousCollisionsEnabled)
+        {
+            treePadding = UpdateTree(particleCollection, particleProperties);
+        }
+        _collisionSecThisStep += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - collisionStart).count();
+    }
+
+    // Note: The integrator left the net force for the end-of-step positions, so if anything 
+    // moves the particles after it, the forces need to be evaluated again.
+    bool particlesMoved = false;
+    _numFastParticlesThisStep = 0;
+    _numTimeOfImpactHitsThisStep = 0;
+    if (_continuousCollisionsEnabled)
+    {
+        particlesMoved = DoContinuousCollisions(particleCollection, particleProperties, 
+            treePadding);
+    }
+
+    if (_pWalls != 0)
+    {
+        _pWalls->CollideParticles(particleCollection, particleProperties);
+        particlesMoved = particlesMoved || (_pWalls->NumParticlesBouncedLastCollide() > 0);
+    }
+
+    if (particlesMoved)
+    {
+        EvaluateForces(particleCollection, particleProperties, deltaTimeSec);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Zeroes the net force on every active particle, adds the external force fields if there 
+    are any, and runs the particle-particle collisions at the particles' current positions, 
+    unless the contact solver is taking care of those.
+Parameters:
+    particleCollection  Self-explanatory.
+    particleProperties  Self-explanatory.
+    deltaTimeSec        The time that the integrator will apply these forces over.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSimulation::EvaluateForces(std::vector<Particle> &particleCollection, 
+    const ParticlePropertyStorage &particleProperties, float deltaTimeSec)
+{
+    PrepareForces(particleCollection, particleProperties);
+    CollideForces(particleCollection, particleProperties, deltaTimeSec);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The first half of EvaluateForces(...).  Zeroes the net forces, adds the force fields, and 
+    brings the tree up to date if the collisions will need it.
+Parameters:
+    particleCollection  Self-explanatory.
+    particleProperties  Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSimulation::PrepareForces(std::vector<Particle> &particleCollection, 
+    const ParticlePropertyStorage &particleProperties)
+{
+    _numForceEvaluationsThisStep++;
+    _searchPadding = 0.0f;
+
+    for (size_t particleIndex = 0; particleIndex < particleCollection.size(); particleIndex++)
+    {
+        Particle &p = particleCollection[particleIndex];
+        if (p._isActive)
+        {
+            p._netForce = glm::vec2();
+        }
+    }
+
+    if (_pForceField != 0)
+    {
+        _pForceField->ApplyForces(particleCollection);
+    }
+
+    if (_pContactSolver != 0)
+    {
+        return;
+    }
+
+    // a pair that is in range now was at most (range + displacement) apart, as far as the 
+    // tree knows
+    // Note: The other broadphases don't need the tree, but continuous collisions search it 
+    // later in the step and the periodic ghosts are made when it is built.
+    bool needsTree = (_pBroadphase == 0) || (_pBroadphase->Type() == BROADPHASE_TREE) || 
+        _continuousCollisionsEnabled || _periodicGhosts.IsEnabled();
+    if (needsTree)
+    {
+        std::chrono::steady_clock::time_point treeStart = std::chrono::steady_clock::now();
+        _searchPadding = UpdateTree(particleCollection, particleProperties);
+        _collisionSecThisStep += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - treeStart).count();
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The second half of EvaluateForces(...).  Runs the particle-particle collisions on what 
+    PrepareForces(...) left, unless the contact solver is taking care of them.
+Parameters:
+    particleCollection  Self-explanatory.
+    particleProperties  Self-explanatory.
+    deltaTimeSec        The time that the integrator will apply these forces over.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSimulation::CollideForces(std::vector<Particle> &particleCollection, 
+    const ParticlePropertyStorage &particleProperties, float deltaTimeSec)
+{
+    if (_pContactSolver != 0)
+    {
+        return;
+    }
+
+    std::chrono::steady_clock::time_point collisionStart = std::chrono::steady_clock::now();
+
+    // only the first evaluation of a step reports collision events
+    ParticleCollisionEvents *pEvents = 
+        (_numForceEvaluationsThisStep == 1) ? _pCollisionEvents : 0;
+    if (pEvents != 0)
+    {
+        pEvents->BeginPass(_frameNumber, (int)particleCollection.size(), 
+            _periodicGhosts.IsEnabled() ? _periodicGhosts.GhostSourceIndices() : 0, 
+            _pParticleIds);
+    }
+
+    if (_periodicGhosts.IsEnabled())
+    {
+        // the net forces were zeroed before the tree's copy was made
+        _pCollisionEngine->DoTheParticleParticleCollisions(*_pTree, 
+            _periodicGhosts.BroadphaseProperties(), deltaTimeSec, _searchPadding, 
+            _periodicGhosts.BroadphaseParticles(), pEvents);
+        _periodicGhosts.CopyBack(particleCollection);
+    }
+    else
+    {
+        _pCollisionEngine->DoTheParticleParticleCollisions(*_pTree, particleProperties, 
+            deltaTimeSec, _searchPadding, particleCollection, pEvents);
+    }
+
+    if (pEvents != 0)
+    {
+        pEvents->EndPass();
+    }
+
+    _collisionSecThisStep += std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - collisionStart).count();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Builds the tree if it hasn't been built yet this step or if particles have moved too far 
+    since it was built.  Otherwise the tree is reused.
+
+    With periodic boundaries, the tree holds the ghosts' scratch collection instead of the 
+    particle collection, and this brings it up to date either way.
+Parameters:
+    particleCollection  Self-explanatory.
+    particleProperties  Self-explanatory.
+Returns:
+    How far the furthest-moved particle is from where the tree thinks it is.  Searches in the 
+    tree must be widened by this much.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+float ParticleSimulation::UpdateTree(std::vector<Particle> &particleCollection, 
+    const ParticlePropertyStorage &particleProperties)
+{
+    if (!_treeBuiltThisStep)
+    {
+        RebuildTree(particleCollection, particleProperties);
+        return 0.0f;
+    }
+
+    float maxDisplacementSqr = 0.0f;
+    for (size_t particleIndex = 0; particleIndex < particleCollection.size(); particleIndex++)
+    {
+        const Particle &p = particleCollection[particleIndex];
+        if (p._isActive)
+        {
+            glm::vec2 displacement = p._position - _positionsAtTreeBuild[particleIndex];
+            float displacementSqr = glm::dot(displacement, displacement);
+            maxDisplacementSqr = (displacementSqr > maxDisplacementSqr) ? 
+                displacementSqr : maxDisplacementSqr;
+        }
+    }
+
+    float maxDisplacement = sqrtf(maxDisplacementSqr);
+    float maxStaleDisplacement = 
+        _MAX_STALE_TREE_DISPLACEMENT * particleProperties.MaxRadiusOfInfluence();
+    if (maxDisplacement > maxStaleDisplacement)
+    {
+        RebuildTree(particleCollection, particleProperties);
+        return 0.0f;
+    }
+
+    if (_periodicGhosts.IsEnabled())
+    {
+        _periodicGhosts.Refresh(particleCollection);
+    }
+
+    return maxDisplacement;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.  The solver is used in place of the collision engine until this is 
+    called again with 0.
+Parameters:
+    pContactSolver  Self-explanatory.  Can be 0.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSimulation::SetContactSolver(ParticleContactSolver *pContactSolver)
+{
+    _pContactSolver = pContactSolver;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.  The walls must already be built.
+Parameters:
+    pWalls  Self-explanatory.  Can be 0.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSimulation::SetWalls(const ParticlePolygonWalls *pWalls)
+{
+    _pWalls = pWalls;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.  The fields are added to the forces every time that they are 
+    evaluated.
+Parameters:
+    pForceField     Self-explanatory.  Can be 0.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSimulation::SetForceField(ParticleForceFieldGrid *pForceField)
+{
+    _pForceField = pForceField;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.  The stream's consumer drains it whenever it likes.
+Parameters:
+    pCollisionEvents    Self-explanatory.  Can be 0.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSimulation::SetCollisionEvents(ParticleCollisionEvents *pCollisionEvents)
+{
+    _pCollisionEvents = pCollisionEvents;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.  Collision events are stamped with these IDs as well as with the 
+    particle indices.
+Parameters:
+    pParticleIds    One per particle (see ParticleSpatialReorder::ParticleIds()).  0 if the 
+                    IDs are the indices.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSimulation::SetParticleIds(const unsigned int *pParticleIds)
+{
+    _pParticleIds = pParticleIds;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.  This must be the same broadphase that the collision engine was given 
+    so that the tree isn't built on steps that don't use it.
+Parameters:
+    pBroadphase     Self-explanatory.  0 if the collision engine always uses the tree.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSimulation::SetBroadphase(const ParticleBroadphase<2> *pBroadphase)
+{
+    _pBroadphase = pBroadphase;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Makes the particle region a periodic square: particles that leave one side come back in on 
+    the other and interact with particles across the seam.  Tells the updater too, so call 
+    this after Init(...).
+
+    Note: The square plus a few particle radii must fit inside the tree's region, which is 
+    where the ghosts go.
+Parameters:
+    regionCenter        Self-explanatory.
+    regionHalfWidth     Half the length of a side.  0 turns periodic boundaries off.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSimulation::SetPeriodicRegion(const glm::vec2 &regionCenter, 
+    const float regionHalfWidth)
+{
+    _periodicGhosts.SetRegion(regionCenter, regionHalfWidth);
+    _pUpdater->SetPeriodicRegion(regionCenter, regionHalfWidth);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many ghost particles the tree was last built with.  0 without periodic boundaries.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleSimulation::NumPeriodicGhosts() const
+{
+    return _periodicGhosts.IsEnabled() ? _periodicGhosts.NumGhosts() : 0;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.  Adds up every tree update and collision pass in the step, or the contact 
+    solver's, so this is how long the step spent on collisions.
+Parameters: None
+Returns:
+    See description.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+double ParticleSimulation::CollisionSecLastStep() const
+{
+    return _collisionSecThisStep;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.  Off by default.
+Parameters:
+    enabled     Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSimulation::SetContinuousCollisions(const bool enabled)
+{
+    _continuousCollisionsEnabled = enabled;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many times the tree was built during the last Step(...).
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleSimulation::NumTreeBuildsLastStep() const
+{
+    return _numTreeBuildsThisStep;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many times the integrator asked for forces during the last Step(...).
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleSimulation::NumForceEvaluationsLastStep() const
+{
+    return _numForceEvaluationsThisStep;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many particles moved further than their radius of influence during the last 
+    Step(...).  0 if continuous collisions are disabled.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleSimulation::NumFastParticlesLastStep() const
+{
+    return _numFastParticlesThisStep;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many pairs the continuous collision detection caught during the last Step(...).
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleSimulation::NumTimeOfImpactHitsLastStep() const
+{
+    return _numTimeOfImpactHitsThisStep;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Rebuilds the tree from the particles' current positions and remembers those positions.
+
+    With periodic boundaries, the ghosts are picked again first.  A particle needs a ghost if 
+    something across the seam could interact with it before the tree is rebuilt again, so 
+    the band is the interaction distance plus how far particles may move in the meantime.
+Parameters:
+    particleCollection  Self-explanatory.
+    particleProperties  Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSimulation::RebuildTree(std::vector<Particle> &particleCollection, 
+    const ParticlePropertyStorage &particleProperties)
+{
+    // the furthest that anything searches the tree for neighbors before it is rebuilt again
+    float maxRadius = particleProperties.MaxRadiusOfInfluence();
+    float range = (_pContactSolver != 0) ? 
+        _pContactSolver->InteractionRangeInContactDistances() : 
+        _pCollisionEngine->InteractionRangeInContactDistances();
+    float maxSearchDistance = 
+        (2.0f * maxRadius * range) + (_MAX_STALE_TREE_DISPLACEMENT * maxRadius);
+
+    _pTree->ResetTree();
+    _pTree->SetMinNodeSize(maxSearchDistance);
+    if (_periodicGhosts.IsEnabled())
+    {
+        _periodicGhosts.Build(particleCollection, particleProperties, maxSearchDistance);
+        _pTree->AddParticlestoTree(_periodicGhosts.BroadphaseParticles());
+    }
+    else
+    {
+        _pTree->AddParticlestoTree(particleCollection);
+    }
+
+    if (_positionsAtTreeBuild.size() < particleCollection.size())
+    {
+        _positionsAtTreeBuild.resize(particleCollection.size());
+    }
+    for (size_t particleIndex = 0; particleIndex < particleCollection.size(); particleIndex++)
+    {
+        _positionsAtTreeBuild[particleIndex] = particleCollection[particleIndex]._position;
+    }
+
+    _treeBuiltThisStep = true;
+    _numTreeBuildsThisStep++;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Finds the fast particles, looks for the first thing that each one hit along its path, 
+    moves both particles of every hit back to where they were at the time of impact, and 
+    bounces them off each other.
+
+    A fast particle's neighbors are found with the tree, which is at most a little stale, and 
+    the caller says how stale.  Anything that a fast particle could have touched along the way 
+    is now within (contact distance + however far the other particle moved) of its path.  Slow 
+    particles moved less than their radius, and the fast ones are all measured here anyway.
+
+    Note: A particle that is moved back may now overlap something that it didn't overlap 
+    before.  It is an approximation, but a far better one than passing through.
+    Also Note: The integrator left the net force for the end-of-step positions.  If anything 
+    was moved, the caller has to evaluate the forces again so that that stays true.
+Parameters:
+    particleCollection  Self-explanatory.
+    particleProperties  Self-explanatory.
+    treePadding         How far any particle may be from where the tree thinks it is.
+Returns:
+    True if any particles were moved.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleSimulation::DoContinuousCollisions(std::vector<Particle> &particleCollection, 
+    const ParticlePropertyStorage &particleProperties, float treePadding)
+{
+    // a particle is fast if it moved further than its radius of influence
+    // Note: Keep a flag per particle (the time of impact is set to 2) so that the candidates 
+    // can be checked without recalculating their displacement.
+    if (_timesOfImpact.size() != particleCollection.size())
+    {
+        _timesOfImpact.assign(particleCollection.size(), 1.0f);
+    }
+    _fastParticleIndices.clear();
+    float maxDisplacementSqr = 0.0f;
+    for (size_t particleIndex = 0; particleIndex < particleCollection.size(); particleIndex++)
+    {
+        const Particle &p = particleCollection[particleIndex];
+        if (!p._isActive || p._isAsleep)
+        {
+            continue;
+        }
+
+        float radius = particleProperties.GetSpeciesProperties(
+            particleProperties.GetSpecies(particleIndex))._radiusOfInfluence;
+        glm::vec2 displacement = p._position - _positionsAtStepStart[particleIndex];
+        float displacementSqr = glm::dot(displacement, displacement);
+        if (displacementSqr > (radius * radius))
+        {
+            _fastParticleIndices.push_back(particleIndex);
+            _timesOfImpact[particleIndex] = _FAST_PARTICLE_FLAG;
+            maxDisplacementSqr = (displacementSqr > maxDisplacementSqr) ? 
+                displacementSqr : maxDisplacementSqr;
+        }
+    }
+
+    _numFastParticlesThisStep = (int)_fastParticleIndices.size();
+    if (_fastParticleIndices.empty())
+    {
+        return false;
+    }
+
+    if (_nearbyParticleIndices.empty())
+    {
+        _nearbyParticleIndices.resize(256);
+    }
+    _clampedParticleIndices.clear();
+    _timeOfImpactHits.clear();
+
+    // if two paths came within contact distance of each other, then where either particle 
+    // ended up is within (contact distance + how far the other one moved) of the other's path
+    // Note: That goes both ways, so a pair of fast particles is found from both sides and is 
+    // only taken from the side with the lower index.
+    float maxRadius = particleProperties.MaxRadiusOfInfluence();
+    float maxDisplacement = sqrtf(maxDisplacementSqr);
+    float pathPadding = (2.0f * maxRadius) + 
+        ((maxDisplacement > maxRadius) ? maxDisplacement : maxRadius);
+
+    // with periodic boundaries, the tree holds the ghosts' scratch collection, so that is what 
+    // it has to check positions in
+    // Note: Ghosts are skipped.  A fast particle's path is not followed across the seam.
+    std::vector<Particle> *pTreeParticles = &particleCollection;
+    if (_periodicGhosts.IsEnabled())
+    {
+        _periodicGhosts.Refresh(particleCollection);
+        pTreeParticles = &_periodicGhosts.BroadphaseParticles();
+    }
+
+    for (size_t fastCount = 0; fastCount < _fastParticleIndices.size(); fastCount++)
+    {
+        int p1Index = _fastParticleIndices[fastCount];
+        const glm::vec2 &start = _positionsAtStepStart[p1Index];
+        const glm::vec2 &end = particleCollection[p1Index]._position;
+        glm::vec2 boxMin(((start.x < end.x) ? start.x : end.x) - pathPadding, 
+            ((start.y < end.y) ? start.y : end.y) - pathPadding);
+        glm::vec2 boxMax(((start.x > end.x) ? start.x : end.x) + pathPadding, 
+            ((start.y > end.y) ? start.y : end.y) + pathPadding);
+
+        int maxNearby = (int)_nearbyParticleIndices.size();
+        int numNearby = _pTree->FindParticlesInBox(boxMin, boxMax, *pTreeParticles, 
+            _nearbyParticleIndices.data(), maxNearby, treePadding);
+        if (numNearby > maxNearby)
+        {
+            _nearbyParticleIndices.resize(numNearby);
+            numNearby = _pTree->FindParticlesInBox(boxMin, boxMax, *pTreeParticles, 
+                _nearbyParticleIndices.data(), numNearby, treePadding);
+        }
+
+        for (int nearbyCount = 0; nearbyCount < numNearby; nearbyCount++)
+        {
+            int p2Index = _nearbyParticleIndices[nearbyCount];
+            if (p2Index >= (int)particleCollection.size())
+            {
+                // a ghost
+                continue;
+            }
+
+            bool p2IsFast = (_timesOfImpact[p2Index] == _FAST_PARTICLE_FLAG);
+            if (p2Index == p1Index || (p2IsFast && p2Index < p1Index))
+            {
+                continue;
+            }
+
+            float timeOfImpact = 1.0f;
+            if (TimeOfImpact(p1Index, p2Index, particleCollection, particleProperties, 
+                &timeOfImpact))
+            {
+                TimeOfImpactHit hit = { p1Index, p2Index, timeOfImpact };
+                _timeOfImpactHits.push_back(hit);
+            }
+        }
+    }
+
+    // the flags have done their job
+    for (size_t fastCount = 0; fastCount < _fastParticleIndices.size(); fastCount++)
+    {
+        _timesOfImpact[_fastParticleIndices[fastCount]] = 1.0f;
+    }
+    for (size_t hitCount = 0; hitCount < _timeOfImpactHits.size(); hitCount++)
+    {
+        const TimeOfImpactHit &hit = _timeOfImpactHits[hitCount];
+        ClampToTimeOfImpact(hit._p1Index, hit._timeOfImpact);
+        ClampToTimeOfImpact(hit._p2Index, hit._timeOfImpact);
+    }
+
+    _numTimeOfImpactHitsThisStep = (int)_timeOfImpactHits.size();
+    if (_timeOfImpactHits.empty())
+    {
+        return false;
+    }
+
+    // the paths are still needed for the contact normals, so bounce before backing up
+    for (size_t hitCount = 0; hitCount < _timeOfImpactHits.size(); hitCount++)
+    {
+        const TimeOfImpactHit &hit = _timeOfImpactHits[hitCount];
+        RespondAtTimeOfImpact(hit._p1Index, hit._p2Index, hit._timeOfImpact, 
+            particleCollection, particleProperties);
+    }
+
+    // back up along the path, and reset the scratch values for the next step
+    for (size_t clampedCount = 0; clampedCount < _clampedParticleIndices.size(); clampedCount++)
+    {
+        int particleIndex = _clampedParticleIndices[clampedCount];
+        Particle &p = particleCollection[particleIndex];
+        const glm::vec2 &start = _positionsAtStepStart[particleIndex];
+        p._position = start + ((p._position - start) * _timesOfImpact[particleIndex]);
+        _timesOfImpact[particleIndex] = 1.0f;
+    }
+
+    return true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Both particles are assumed to have moved in a straight line at a constant speed during the 
+    step.  Solves |(x2 - x1) + t * (d2 - d1)| = r1 + r2 for the first t on [0,1], where x is a 
+    position at the start of the step and d is the displacement over it.
+Parameters:
+    p1Index, p2Index    Self-explanatory.
+    particleCollection  Self-explanatory.
+    particleProperties  Self-explanatory.
+    putTimeHere         Receives the time of impact as a fraction of the step.
+Returns:
+    True if the two came into contact during the step and weren't already touching at the 
+    start of it.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleSimulation::TimeOfImpact(int p1Index, int p2Index, 
+    const std::vector<Particle> &particleCollection, 
+    const ParticlePropertyStorage &particleProperties, float *putTimeHere) const
+{
+    const glm::vec2 &start1 = _positionsAtStepStart[p1Index];
+    const glm::vec2 &start2 = _positionsAtStepStart[p2Index];
+    glm::vec2 relativeStart = start2 - start1;
+    glm::vec2 relativeDisplacement = (particleCollection[p2Index]._position - start2) - 
+        (particleCollection[p1Index]._position - start1);
+    const ParticleProperties &p1Properties = 
+        particleProperties.GetSpeciesProperties(particleProperties.GetSpecies(p1Index));
+    const ParticleProperties &p2Properties = 
+        particleProperties.GetSpeciesProperties(particleProperties.GetSpecies(p2Index));
+    if (particleProperties.InteractionCoefficient(particleProperties.GetSpecies(p1Index), 
+        particleProperties.GetSpecies(p2Index)) == 0.0f)
+    {
+        // these two species pass through each other anyway
+        return false;
+    }
+    float contactDistance = p1Properties._radiusOfInfluence + p2Properties._radiusOfInfluence;
+
+    // a*t^2 + 2*b*t + c = 0
+    float a = glm::dot(relativeDisplacement, relativeDisplacement);
+    float b = glm::dot(relativeStart, relativeDisplacement);
+    float c = glm::dot(relativeStart, relativeStart) - (contactDistance * contactDistance);
+    if (c <= 0.0f || b >= 0.0f)
+    {
+        // already touching (the regular collisions take care of it) or moving apart
+        return false;
+    }
+
+    float discriminant = (b * b) - (a * c);
+    if (discriminant < 0.0f)
+    {
+        // closest approach is further than the contact distance
+        return false;
+    }
+
+    // the smaller root is when they first touch
+    // Note: Written as c / (-b + sqrt(...)) instead of (-b - sqrt(...)) / a to avoid losing 
+    // precision when the two barely move relative to each other.
+    float timeOfImpact = c / (-b + sqrtf(discriminant));
+    if (timeOfImpact > 1.0f)
+    {
+        return false;
+    }
+
+    *putTimeHere = timeOfImpact;
+    return true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Records the earliest time of impact for a particle.  It is applied once all hits are 
+    known.
+Parameters:
+    particleIndex   Self-explanatory.
+    timeOfImpact    As a fraction of the step.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSimulation::ClampToTimeOfImpact(int particleIndex, float timeOfImpact)
+{
+    float &currentTime = _timesOfImpact[particleIndex];
+    if (currentTime >= 1.0f)
+    {
+        _clampedParticleIndices.push_back(particleIndex);
+    }
+    currentTime = (timeOfImpact < currentTime) ? timeOfImpact : currentTime;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Applies the elastic response's impulse to a pair that met during the step, using their 
+    line of contact at the time of impact.  Nothing happens if an earlier hit in the same step 
+    already has them moving apart.
+Parameters:
+    p1Index, p2Index    Self-explanatory.
+    timeOfImpact        As a fraction of the step.
+    particleCollection  Self-explanatory.
+    particleProperties  Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSimulation::RespondAtTimeOfImpact(int p1Index, int p2Index, float timeOfImpact, 
+    std::vector<Particle> &particleCollection, 
+    const ParticlePropertyStorage &particleProperties)
+{
+    Particle &p1 = particleCollection[p1Index];
+    Particle &p2 = particleCollection[p2Index];
+    const glm::vec2 &start1 = _positionsAtStepStart[p1Index];
+    const glm::vec2 &start2 = _positionsAtStepStart[p2Index];
+    glm::vec2 contact1 = start1 + ((p1._position - start1) * timeOfImpact);
+    glm::vec2 contact2 = start2 + ((p2._position - start2) * timeOfImpact);
+    glm::vec2 lineOfContact = contact2 - contact1;
+    float distance = sqrtf(glm::dot(lineOfContact, lineOfContact));
+    if (distance == 0.0f)
+    {
+        return;
+    }
+    glm::vec2 normal = lineOfContact / distance;
+
+    // same as ElasticCollisionResponse, but as a change in velocity instead of a force
+    unsigned char species1 = particleProperties.GetSpecies(p1Index);
+    unsigned char species2 = particleProperties.GetSpecies(p2Index);
+    ParticlePairProperties pair = MakeParticlePairProperties(
+        particleProperties.GetSpeciesProperties(species1), 
+        particleProperties.GetSpeciesProperties(species2), 
+        particleProperties.InteractionCoefficient(species1, species2), 1.0f);
+    float approachSpeed = glm::dot(p1._velocity - p2._velocity, normal);
+    if (approachSpeed <= 0.0f)
+    {
+        return;
+    }
+
+    float impulse = (1.0f + pair._restitution) * approachSpeed * pair._reducedMass * 
+        pair._interactionCoefficient;
+    p1._velocity -= normal * (impulse / pair._mass1);
+    p2._velocity += normal * (impulse / pair._mass2);
+    p1._collisionCountThisFrame += 1;
+    p2._collisionCountThisFrame += 1;
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <vector>
+#include "Particle.h"
+#include "ParticleProperties.h"
+#include "ParticleUpdater.h"
+#include "ParticleQuadTree.h"
+#include "ParticleCollisionEngine.h"
+#include "IParticleIntegrator.h"
+#include "ParticleContactSolver.h"
+#include "ParticlePolygonWalls.h"
+#include "ParticlePeriodicGhosts.h"
+#include "ParticleForceFieldGrid.h"
+#include "ParticleCollisionEvents.h"
+#include "ParticleBroadphase.h"
+#include "glm/vec2.hpp"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs one simulation step in the right order: the updater's once-per-frame bookkeeping 
+    (bounds, emission, sleeping), then the integrator, which asks this object for forces as 
+    many times as its scheme needs.
+
+    Forces are the particle-particle collisions plus, optionally, external force fields that 
+    are sampled from a grid (see ParticleForceFieldGrid).  The spatial tree is built on the 
+    first force evaluation of a step and reused for the rest of them as long as that is safe: 
+    particles may have moved since it was built, so the neighbor search is widened by the 
+    furthest any particle has moved, and once that gets too big compared to the particles' 
+    radius of influence the tree is rebuilt anyway.
+
+    Optionally, collisions are handled by a position-based contact solver instead of by the 
+    collision engine's forces (see ParticleContactSolver).  The forces then leave the 
+    collisions out, and the solver runs on the tree after the integrator is done.
+
+    Optionally, fast particles get continuous collision detection after the integrator is 
+    done.  A particle that moved further than its radius of influence in one step can pass 
+    right through another one without the two ever being close enough at the end of a step to 
+    collide.  Only those particles pay for it: each one's path over the step is boxed, the tree 
+    is asked for everything near that box, and the first time of impact along the two 
+    straight-line paths is found for each.  Particles that hit something are moved back to 
+    where they were at that time, touching, and get an impulse along the line of contact with 
+    the pair's restitution, the same as the elastic response would give them.
+
+    Optionally, the region is a periodic square instead of a circle that particles are lost 
+    from.  The tree and the collisions then work on a copy of the particles plus ghost copies 
+    of the ones near each side (see ParticlePeriodicGhosts).
+
+    Optionally, the collision engine's pairs are reported as events (see 
+    ParticleCollisionEventStream).  Only the first force evaluation of a step reports, so an 
+    integrator that evaluates forces several times per step doesn't report a collision more 
+    than once, and events are stamped with the step's frame number.  The contact solver 
+    doesn't report events.
+
+    Optionally, the collision engine finds its pairs with something other than the tree (see 
+    ParticleBroadphase).  The tree is then only built if something else needs it this step 
+    (continuous collisions or periodic ghosts).
+
+    Optionally, particles bounce off static polygonal walls (see ParticlePolygonWalls) at the 
+    end of the step.
+
+    A step can also be run one phase at a time, so that each phase can be its own task: the 
+    update, the integrator's moves, the tree, the collisions, and whatever comes after the 
+    integrator.  If the integrator ends with a force evaluation, that evaluation is left to 
+    the tree and collision phases; otherwise the integrator's phase evaluates the forces 
+    itself and those two do nothing.  Step(...) runs the same phases, so the results are the 
+    same either way.
+
+    Note: When this class goes "poof", it won't delete the given pointers.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticleSimulation : public IParticleForceEvaluator
+{
+public:
+    ParticleSimulation();
+    void Init(ParticleUpdater *pUpdater, ParticleQuadTree *pTree, 
+        const IParticleCollisionEngine<2> *pCollisionEngine, IParticleIntegrator *pIntegrator);
+
+    void Step(std::vector<Particle> &particleCollection, 
+        ParticlePropertyStorage &particleProperties, float deltaTimeSec);
+
+    // Step(...) one phase at a time; each must be called once per step, in this order
+    void BeginStep(std::vector<Particle> &particleCollection, 
+        ParticlePropertyStorage &particleProperties);
+    void IntegrateStep(std::vector<Particle> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties, float deltaTimeSec);
+    void BuildTreeForStep(std::vector<Particle> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties);
+    void CollideStep(std::vector<Particle> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties);
+    void EndStep(std::vector<Particle> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties, float deltaTimeSec);
+
+    virtual void EvaluateForces(std::vector<Particle> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties, float deltaTimeSec);
+
+    void SetContactSolver(ParticleContactSolver *pContactSolver);
+    void SetWalls(const ParticlePolygonWalls *pWalls);
+    void SetForceField(ParticleForceFieldGrid *pForceField);
+    void SetCollisionEvents(ParticleCollisionEvents *pCollisionEvents);
+    void SetParticleIds(const unsigned int *pParticleIds);
+    void SetBroadphase(const ParticleBroadphase<2> *pBroadphase);
+    void SetPeriodicRegion(const glm::vec2 &regionCenter, const float regionHalfWidth);
+    void SetContinuousCollisions(const bool enabled);
+    int NumTreeBuildsLastStep() const;
+    int NumForceEvaluationsLastStep() const;
+    int NumFastParticlesLastStep() const;
+    int NumTimeOfImpactHitsLastStep() const;
+    int NumPeriodicGhosts() const;
+    double CollisionSecLastStep() const;
+
+private:
+    void PrepareForces(std::vector<Particle> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties);
+    void CollideForces(std::vector<Particle> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties, float deltaTimeSec);
+    float UpdateTree(std::vector<Particle> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties);
+    void RebuildTree(std::vector<Particle> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties);
+    bool DoContinuousCollisions(std::vector<Particle> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties, float treePadding);
+    bool TimeOfImpact(int p1Index, int p2Index, const std::vector<Particle> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties, float *putTimeHere) const;
+    void ClampToTimeOfImpact(int particleIndex, float timeOfImpact);
+    void RespondAtTimeOfImpact(int p1Index, int p2Index, float timeOfImpact, 
+        std::vector<Particle> &particleCollection, 
+        const ParticlePropertyStorage &particleProperties);
+
+    struct TimeOfImpactHit
+    {
+        int _p1Index;
+        int _p2Index;
+        float _timeOfImpact;
+    };
+
+    ParticleUpdater *_pUpdater;
+    ParticleQuadTree *_pTree;
+    const IParticleCollisionEngine<2> *_pCollisionEngine;
+    IParticleIntegrator *_pIntegrator;
+
+    // 0 unless position-based contacts are in use
+    ParticleContactSolver *_pContactSolver;
+
+    // 0 unless there are walls
+    const ParticlePolygonWalls *_pWalls;
+
+    // 0 unless there are external force fields
+    ParticleForceFieldGrid *_pForceField;
+
+    // 0 unless collision events are being reported
+    ParticleCollisionEvents *_pCollisionEvents;
+
+    // 0 unless particles have IDs that aren't their indices
+    const unsigned int *_pParticleIds;
+
+    // 0 unless the collision engine might not be using the tree
+    const ParticleBroadphase<2> *_pBroadphase;
+
+    // off unless the region is periodic; the tree then holds these instead of the particles
+    ParticlePeriodicGhosts _periodicGhosts;
+
+    // the tree is rebuilt if any particle has moved further than this fraction of the largest 
+    // radius of influence since it was last built
+    static const float _MAX_STALE_TREE_DISPLACEMENT;
+
+    // marks the fast particles while continuous collisions look for candidates; any time of 
+    // impact is less than this
+    static const float _FAST_PARTICLE_FLAG;
+
+    // where the active particles were when the tree was built
+    // Note: Indexed the same as the particle collection.  Allocated on the first build.
+    std::vector<glm::vec2> _positionsAtTreeBuild;
+    bool _treeBuiltThisStep;
+    unsigned int _frameNumber;
+    int _numTreeBuildsThisStep;
+    int _numForceEvaluationsThisStep;
+    double _collisionSecThisStep;
+
+    // how far the tree's searches must be widened for the force evaluation in progress
+    float _searchPadding;
+
+    // true between IntegrateStep(...) and CollideStep(...) if the integrator left its last 
+    // force evaluation to them, along with the delta time to evaluate it with
+    bool _forcesAreDeferred;
+    float _deferredForcesSec;
+
+    // continuous collision detection; all indexed the same as the particle collection except 
+    // for the index lists
+    // Note: The scratch space is allocated on the first step that has it enabled.
+    bool _continuousCollisionsEnabled;
+    std::vector<glm::vec2> _positionsAtStepStart;
+    std::vector<float> _timesOfImpact;
+    std::vector<int> _fastParticleIndices;
+    std::vector<int> _clampedParticleIndices;
+    std::vector<int> _nearbyParticleIndices;
+    std::vector<TimeOfImpactHit> _timeOfImpactHits;
+    int _numFastParticlesThisStep;
+    int _numTimeOfImpactHitsThisStep;
+};
@@ -0,0 +1,383 @@
+#include "ParticleSpatialReorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include "glm/detail/func_common.hpp" // for glm::min and glm::max
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Ensures that the object starts object with initialized values.  There are no IDs until
+    Init(...).
+Parameters:
+    curveType           Hilbert keeps neighbors a little closer; Morton is cheaper to key.
+    minIntervalSteps    Never reorder more often than this.
+    maxIntervalSteps    Always reorder at least this often.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleSpatialReorder::ParticleSpatialReorder(SpaceFillingCurveType curveType,
+    int minIntervalSteps, int maxIntervalSteps) :
+    _curveType(curveType),
+    _minIntervalSteps((minIntervalSteps < 1) ? 1 : minIntervalSteps),
+    _maxIntervalSteps(maxIntervalSteps),
+    _baselineSecPerParticle(0.0),
+    _excessCollisionSec(0.0),
+    _lastReorderSec(0.0),
+    _stepsSinceReorder(0),
+    _lastIntervalSteps(0),
+    _numReorders(0)
+{
+    if (_maxIntervalSteps < _minIntervalSteps)
+    {
+        _maxIntervalSteps = _minIntervalSteps;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives every slot its ID, which to start with is the slot's index.
+Parameters:
+    numParticles    The size of the particle collection.  It must not change afterwards.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSpatialReorder::Init(unsigned int numParticles)
+{
+    _particleIds.resize(numParticles);
+    _particleIndices.resize(numParticles);
+    for (unsigned int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        _particleIds[particleIndex] = particleIndex;
+        _particleIndices[particleIndex] = (int)particleIndex;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Adds a step's collision time to the measurements.  The first few steps after a reorder
+    set the baseline, and every step after that adds however much it took beyond the baseline
+    to the running total.
+Parameters:
+    collisionSec        How long the step's tree building and collisions took.
+    numActiveParticles  Self-explanatory.  The baseline is per particle so that particles
+                        being emitted or lost aren't mistaken for lost locality.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSpatialReorder::RecordStep(double collisionSec, unsigned int numActiveParticles)
+{
+    _stepsSinceReorder++;
+    if (numActiveParticles == 0)
+    {
+        return;
+    }
+
+    double secPerParticle = collisionSec / (double)numActiveParticles;
+    if (_stepsSinceReorder <= _NUM_BASELINE_STEPS)
+    {
+        _baselineSecPerParticle += secPerParticle / (double)_NUM_BASELINE_STEPS;
+    }
+    else
+    {
+        // Note: Not clamped at 0.  A step that happens to be faster than the baseline makes up
+        // for one that happens to be slower.
+        _excessCollisionSec += collisionSec -
+            (_baselineSecPerParticle * (double)numActiveParticles);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Checks whether the time that has been lost to lost locality since the last reorder has
+    caught up with what the reorder cost.  Before the first reorder, that cost is taken to be
+    0, so the first one is due after the minimum interval.
+Parameters: None
+Returns:
+    True if Reorder(...) should be called before the next step.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleSpatialReorder::IsReorderDue() const
+{
+    if (_particleIds.empty() || _stepsSinceReorder < _minIntervalSteps)
+    {
+        return false;
+    }
+    if (_stepsSinceReorder >= _maxIntervalSteps)
+    {
+        return true;
+    }
+    return (_stepsSinceReorder > _NUM_BASELINE_STEPS) &&
+        (_excessCollisionSec >= _lastReorderSec);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sorts the particle collection along the space-filling curve through the active
+    particles' bounding box, with the inactive particles after the active ones in their
+    current order.  The properties and the IDs are permuted with them, and the measurements
+    start over.
+Parameters:
+    particleCollection  Must be the size given to Init(...).
+    particleProperties  Indexed the same as the particle collection.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleSpatialReorder::Reorder(std::vector<Particle> &particleCollection,
+    ParticlePropertyStorage &particleProperties)
+{
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    unsigned int numParticles = (unsigned int)particleCollection.size();
+
+    glm::vec2 boundsMin(0.0f, 0.0f);
+    glm::vec2 boundsMax(0.0f, 0.0f);
+    bool anyActive = false;
+    for (unsigned int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        const Particle &p = particleCollection[particleIndex];
+        if (!p._isActive)
+        {
+            continue;
+        }
+        boundsMin = anyActive ? glm::min(boundsMin, p._position) : p._position;
+        boundsMax = anyActive ? glm::max(boundsMax, p._position) : p._position;
+        anyActive = true;
+    }
+
+    // the curve has 2^15 cells per axis, so no active particle's key gets up to the inactive 
+    // particles' key
+    glm::vec2 extent = boundsMax - boundsMin;
+    float largestExtent = (extent.x > extent.y) ? extent.x : extent.y;
+    float cellsPerUnit = (largestExtent > 0.0f) ? (32767.0f / largestExtent) : 0.0f;
+
+    _sortKeys.resize(numParticles);
+    for (unsigned int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        const Particle &p = particleCollection[particleIndex];
+
+        // inactive particles go after everything on the curve
+        unsigned int curveKey = 0xFFFFFFFF;
+        if (p._isActive)
+        {
+            glm::vec2 cell = (p._position - boundsMin) * cellsPerUnit;
+            curveKey = CurveKey((unsigned int)cell.x, (unsigned int)cell.y);
+        }
+        _sortKeys[particleIndex] =
+            ((unsigned long long)curveKey << 32) | (unsigned long long)particleIndex;
+    }
+    std::sort(_sortKeys.begin(), _sortKeys.end());
+
+    _oldIndexOfNew.resize(numParticles);
+    _newIndexOfOld.resize(numParticles);
+    _reorderedParticles.resize(numParticles);
+    _reorderedIds.resize(numParticles);
+    for (unsigned int newIndex = 0; newIndex < numParticles; newIndex++)
+    {
+        int oldIndex = (int)(_sortKeys[newIndex] & 0xFFFFFFFF);
+        _oldIndexOfNew[newIndex] = oldIndex;
+        _newIndexOfOld[oldIndex] = (int)newIndex;
+        _reorderedParticles[newIndex] = particleCollection[oldIndex];
+        _reorderedIds[newIndex] = _particleIds[oldIndex];
+        _particleIndices[_reorderedIds[newIndex]] = (int)newIndex;
+    }
+
+    // swap instead of copy; the old collection's memory is the next reorder's scratch space
+    particleCollection.swap(_reorderedParticles);
+    std::copy(_reorderedIds.begin(), _reorderedIds.end(), _particleIds.begin());
+    particleProperties.PermuteParticles(_oldIndexOfNew);
+
+    _lastReorderSec = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - startTime).count();
+    _lastIntervalSteps = _stepsSinceReorder;
+    _stepsSinceReorder = 0;
+    _baselineSecPerParticle = 0.0;
+    _excessCollisionSec = 0.0;
+    _numReorders++;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    For each slot before the last reorder, the slot that its particle is in now.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+const std::vector<int> &ParticleSpatialReorder::NewIndexOfOld() const
+{
+    return _newIndexOfOld;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters:
+    particleIndex   A slot in the particle collection.
+Returns:
+    The ID of the particle in that slot.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleSpatialReorder::IdOfIndex(int particleIndex) const
+{
+    return _particleIds[particleIndex];
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters:
+    particleId  Self-explanatory.
+Returns:
+    The slot in the particle collection that the particle with that ID is in now.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleSpatialReorder::IndexOfId(unsigned int particleId) const
+{
+    return _particleIndices[particleId];
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.  The pointer stays valid, and always has the current IDs, until Init(...)
+    is called again.
+Parameters: None
+Returns:
+    The ID of the particle in each slot.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+const unsigned int *ParticleSpatialReorder::ParticleIds() const
+{
+    return _particleIds.data();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many times Reorder(...) has been called.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleSpatialReorder::NumReorders() const
+{
+    return _numReorders;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many steps have been recorded since the last reorder.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleSpatialReorder::StepsSinceReorder() const
+{
+    return _stepsSinceReorder;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.  This is the interval that the measurements picked.
+Parameters: None
+Returns:
+    How many steps there were between the last two reorders.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleSpatialReorder::LastIntervalSteps() const
+{
+    return _lastIntervalSteps;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How long the last reorder took.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+double ParticleSpatialReorder::LastReorderSec() const
+{
+    return _lastReorderSec;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How much longer the collisions have taken since the last reorder than they would have at
+    the baseline.  The next reorder is due when this catches up with LastReorderSec().
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+double ParticleSpatialReorder::ExcessCollisionSec() const
+{
+    return _excessCollisionSec;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Turns a cell on the 2^15 x 2^15 grid into its distance along the curve.
+
+    Morton interleaves the bits of x and y.  Hilbert goes through the same levels, but
+    rotates and flips each quadrant so that consecutive cells are always next to each other,
+    where Morton jumps at the end of each quadrant.
+Parameters:
+    x, y    The cell.  Each less than 2^15.
+Returns:
+    See description.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleSpatialReorder::CurveKey(unsigned int x, unsigned int y) const
+{
+    if (_curveType == SPACE_FILLING_CURVE_MORTON)
+    {
+        // spread the bits of each out to every other bit
+        x = (x | (x << 8)) & 0x00FF00FF;
+        x = (x | (x << 4)) & 0x0F0F0F0F;
+        x = (x | (x << 2)) & 0x33333333;
+        x = (x | (x << 1)) & 0x55555555;
+        y = (y | (y << 8)) & 0x00FF00FF;
+        y = (y | (y << 4)) & 0x0F0F0F0F;
+        y = (y | (y << 2)) & 0x33333333;
+        y = (y | (y << 1)) & 0x55555555;
+        return x | (y << 1);
+    }
+
+    unsigned int distance = 0;
+    for (unsigned int halfWidth = 1u << 14; halfWidth > 0; halfWidth >>= 1)
+    {
+        unsigned int inRightHalf = ((x & halfWidth) != 0) ? 1 : 0;
+        unsigned int inTopHalf = ((y & halfWidth) != 0) ? 1 : 0;
+        distance += halfWidth * halfWidth * ((3 * inRightHalf) ^ inTopHalf);
+
+        // rotate the quadrant so that the curve inside it lines up with the one above it
+        if (inTopHalf == 0)
+        {
+            if (inRightHalf == 1)
+            {
+                x = 0x7FFF - x;
+                y = 0x7FFF - y;
+            }
+            unsigned int temp = x;
+            x = y;
+            y = temp;
+        }
+    }
+    return distance;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <vector>
+#include "Particle.h"
+#include "ParticleProperties.h"
+
+// the order that particles are put in
+enum SpaceFillingCurveType
+{
+    SPACE_FILLING_CURVE_MORTON = 0,
+    SPACE_FILLING_CURVE_HILBERT
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Particles stay in whatever slot they were emitted into, so particles that are next to each
+    other in space end up all over the particle collection, and every pair that the collision
+    pass tests is a cache miss waiting to happen.  This every so often sorts the collection
+    along a space-filling curve (Morton or Hilbert) through the active particles' bounding
+    box, so that particles that are close together in space are close together in memory.
+    The active particles come first, in curve order, and the inactive ones after them.  The
+    particle properties are permuted along with them.
+
+    Anything outside of the simulation that holds on to a particle uses its ID instead of its
+    slot.  A particle's ID starts out as the slot that it was in when Init(...) was called and
+    follows it through every reorder.  IDs belong to slots, not to particles' lifetimes, so
+    when a particle is deactivated, the next particle that is emitted into its slot gets its
+    ID.  Anything that keeps slot indices across steps (ex: the contact solver's warm start
+    cache) is given the permutation after each reorder.
+
+    How often to reorder is worked out from measurements rather than guessed.  Right after a
+    reorder, the collision pass's time per active particle is as good as it is going to get.
+    As particles move, it goes up, mostly from cache misses.  Every step adds how much more
+    the collisions took than that best time to a running total, and once the total is more
+    than the last reorder took, the next one is due.  That spends about as much time on
+    reordering as is lost to waiting for it, which is never more than twice the best that
+    any interval could do.  The interval is clamped to a minimum and maximum number of steps.
+
+    Only one thread may use this at a time, and it must not be reordering while anything else
+    is reading the particle collection.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticleSpatialReorder
+{
+public:
+    ParticleSpatialReorder(SpaceFillingCurveType curveType = SPACE_FILLING_CURVE_HILBERT,
+        int minIntervalSteps = 8, int maxIntervalSteps = 2048);
+    void Init(unsigned int numParticles);
+
+    // called after every step with how long its collisions took
+    void RecordStep(double collisionSec, unsigned int numActiveParticles);
+    bool IsReorderDue() const;
+    void Reorder(std::vector<Particle> &particleCollection,
+        ParticlePropertyStorage &particleProperties);
+
+    // the last reorder's permutation; only valid right after Reorder(...)
+    const std::vector<int> &NewIndexOfOld() const;
+
+    // stable IDs
+    unsigned int IdOfIndex(int particleIndex) const;
+    int IndexOfId(unsigned int particleId) const;
+    const unsigned int *ParticleIds() const;
+
+    int NumReorders() const;
+    int StepsSinceReorder() const;
+    int LastIntervalSteps() const;
+    double LastReorderSec() const;
+    double ExcessCollisionSec() const;
+
+private:
+    unsigned int CurveKey(unsigned int x, unsigned int y) const;
+
+    SpaceFillingCurveType _curveType;
+    int _minIntervalSteps;
+    int _maxIntervalSteps;
+
+    // _particleIds[slot] is the ID in that slot and _particleIndices[ID] is its slot
+    // Note: Permuted in place so that the pointer from ParticleIds() doesn't change.
+    std::vector<unsigned int> _particleIds;
+    std::vector<int> _particleIndices;
+
+    // scratch space for the reorder; allocated by the first one
+    // Note: Each sort key is the curve key in the high 32 bits and the old index in the low
+    // 32 bits, so sorting the keys sorts the indices along with them and breaks ties by slot.
+    std::vector<unsigned long long> _sortKeys;
+    std::vector<int> _oldIndexOfNew;
+    std::vector<int> _newIndexOfOld;
+    std::vector<Particle> _reorderedParticles;
+    std::vector<unsigned int> _reorderedIds;
+
+    // the collision cost right after the last reorder, per active particle, is the average of
+    // this many steps
+    static const int _NUM_BASELINE_STEPS = 4;
+    double _baselineSecPerParticle;
+    double _excessCollisionSec;
+    double _lastReorderSec;
+    int _stepsSinceReorder;
+    int _lastIntervalSteps;
+    int _numReorders;
+};
@@ -0,0 +1,292 @@
+#include "ParticleStats.h"
+
+#include <string.h>     // for memset(...)
+#include "ParticleTaskScheduler.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Zeroes everything, including the padding, so that the binary log doesn't pick up whatever
+    was on the stack.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleStatsFrame::ParticleStatsFrame()
+{
+    memset(this, 0, sizeof(ParticleStatsFrame));
+    _broadphaseType = -1;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Ensures that the object starts object with initialized values.  There is one counter slot
+    until Init(...) says otherwise.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleStats::ParticleStats() :
+    _threadCounters(1),
+    _logIsBinary(false),
+    _numFramesLogged(0)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Closes the log, if there is one, so that the last frames make it to the file.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleStats::~ParticleStats()
+{
+    CloseLog();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Makes one counter slot per thread that can run a collision pass.
+Parameters:
+    numWorkerThreads    The pool's workers (see ParticleTaskScheduler::NumWorkerThreads()).
+                        0 if the collisions only run on the simulation's thread.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleStats::Init(int numWorkerThreads)
+{
+    _threadCounters.assign((numWorkerThreads < 0) ? 1 : numWorkerThreads + 1,
+        ParticleCollisionCounters());
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Starts appending every frame to a file.  A log that was already open is closed first.
+Parameters:
+    filePath    Self-explanatory.  Overwritten if it exists.
+    binary      True for ParticleStatsFrame's bytes, false for CSV.
+Returns:
+    False if the file couldn't be opened.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleStats::OpenLog(const char *filePath, bool binary)
+{
+    CloseLog();
+    _log.open(filePath, binary ? (std::ios::out | std::ios::binary) : std::ios::out);
+    if (!_log.is_open())
+    {
+        return false;
+    }
+
+    _logIsBinary = binary;
+    _numFramesLogged = 0;
+    if (!_logIsBinary)
+    {
+        WriteCsvHeader();
+    }
+    return true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Flushes and closes the log.  Nothing happens if there isn't one.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleStats::CloseLog()
+{
+    if (_log.is_open())
+    {
+        _log.close();
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Clears every thread's counters for the frame's collision passes.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleStats::BeginFrame()
+{
+    for (size_t slotIndex = 0; slotIndex < _threadCounters.size(); slotIndex++)
+    {
+        _threadCounters[slotIndex] = ParticleCollisionCounters();
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Adds what one traversal (or one job of one) counted to the calling thread's slot.  Called
+    once per traversal, not per pair.
+Parameters:
+    counters    Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleStats::AddCounters(const ParticleCollisionCounters &counters)
+{
+    // Note: A thread from a bigger pool than the one that this was set up for would share a
+    // slot, so it gets 0's instead, which belongs to the simulation's thread.  That can only
+    // happen if Init(...) was given the wrong pool.
+    int slotIndex = ParticleTaskScheduler::CurrentWorkerIndex();
+    if (slotIndex >= (int)_threadCounters.size())
+    {
+        slotIndex = 0;
+    }
+
+    ParticleCollisionCounters &slot = _threadCounters[slotIndex];
+    slot._numPairTests += counters._numPairTests;
+    slot._numPairsCollided += counters._numPairsCollided;
+    slot._numNeighborNodeVisits += counters._numNeighborNodeVisits;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sums up the threads' counters, measures the tree, and puts together the frame's block.
+    It is logged if there is a log.
+Parameters:
+    frame               Self-explanatory.
+    numSteps            How many simulation steps the frame ran.
+    numActiveParticles  Self-explanatory.
+    collisionSec        The steps' tree building and collisions.
+    tree                As it was after the last step.
+    broadphaseType      See ParticleBroadphase.  -1 if it isn't selected per step.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleStats::EndFrame(unsigned int frame, int numSteps, int numActiveParticles,
+    double collisionSec, const ParticleQuadTree &tree, int broadphaseType)
+{
+    ParticleStatsFrame stats;
+    stats._frame = frame;
+    stats._numSteps = numSteps;
+    stats._numActiveParticles = numActiveParticles;
+    stats._collisionSec = collisionSec;
+    for (size_t slotIndex = 0; slotIndex < _threadCounters.size(); slotIndex++)
+    {
+        const ParticleCollisionCounters &slot = _threadCounters[slotIndex];
+        stats._numPairTests += slot._numPairTests;
+        stats._numPairsCollided += slot._numPairsCollided;
+        stats._numNeighborNodeVisits += slot._numNeighborNodeVisits;
+    }
+
+    stats._leafCapacity = tree.LeafCapacity();
+    stats._numCellsPerAxisInitial = tree.NumCellsPerAxisInitial();
+    stats._numNodesInUse = tree.NumNodesInUse();
+    stats._numSubdivisionFailures = tree.NumSubdivisionFailures();
+    stats._numParticlesNotAdded = tree.NumParticlesNotAdded();
+    tree.MeasureShape(&stats._treeShape);
+    stats._broadphaseType = broadphaseType;
+    _lastFrame = stats;
+
+    if (!_log.is_open())
+    {
+        return;
+    }
+
+    if (_logIsBinary)
+    {
+        _log.write((const char *)&stats, sizeof(ParticleStatsFrame));
+    }
+    else
+    {
+        WriteCsvRow(stats);
+    }
+    _numFramesLogged++;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    The block from the last EndFrame(...).  All 0's before the first one.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+const ParticleStatsFrame &ParticleStats::LastFrame() const
+{
+    return _lastFrame;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many frames have gone to the log since it was opened.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleStats::NumFramesLogged() const
+{
+    return _numFramesLogged;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The CSV's first row.  The columns are in the same order as ParticleStatsFrame's members,
+    with one column per depth and per occupancy bucket.  A bucket's column is named for the
+    most particles that a leaf in it can hold.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleStats::WriteCsvHeader()
+{
+    _log << "frame,steps,active,collision_sec,pair_tests,pairs_collided,neighbor_visits,"
+        "leaf_capacity,cells_per_axis,nodes,subdivision_failures,not_added,"
+        "leaves,max_depth,max_occupancy,mean_occupancy";
+    for (int depth = 0; depth <= SpatialTreeShape::MAX_DEPTH; depth++)
+    {
+        _log << ",depth_" << depth;
+    }
+    for (int bucket = 0; bucket < SpatialTreeShape::NUM_OCCUPANCY_BUCKETS; bucket++)
+    {
+        _log << ",occupancy_" << (bucket * SpatialTreeShape::OCCUPANCY_BUCKET_WIDTH);
+    }
+    _log << ",broadphase\n";
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    One frame's row of the CSV.
+Parameters:
+    stats   Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleStats::WriteCsvRow(const ParticleStatsFrame &stats)
+{
+    const SpatialTreeShape &shape = stats._treeShape;
+    _log << stats._frame << ',' << stats._numSteps << ',' << stats._numActiveParticles << ','
+        << stats._collisionSec << ',' << stats._numPairTests << ','
+        << stats._numPairsCollided << ',' << stats._numNeighborNodeVisits << ','
+        << stats._leafCapacity << ',' << stats._numCellsPerAxisInitial << ','
+        << stats._numNodesInUse << ',' << stats._numSubdivisionFailures << ','
+        << stats._numParticlesNotAdded << ',' << shape._numLeaves << ',' << shape._maxDepth
+        << ',' << shape._maxOccupancy << ',' << shape._meanOccupancy;
+    for (int depth = 0; depth <= SpatialTreeShape::MAX_DEPTH; depth++)
+    {
+        _log << ',' << shape._leavesAtDepth[depth];
+    }
+    for (int bucket = 0; bucket < SpatialTreeShape::NUM_OCCUPANCY_BUCKETS; bucket++)
+    {
+        _log << ',' << shape._leavesWithOccupancy[bucket];
+    }
+    _log << ',' << stats._broadphaseType << '\n';
+}
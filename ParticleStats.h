@@ -0,0 +1,115 @@
+#pragma once
+
+#include <vector>
+#include <fstream>
+#include "ParticleQuadTree.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    What one thread counted during the collision passes.  A traversal counts into one of
+    these on its own stack and adds it to its thread's slot when it is done (see
+    ParticleStats::AddCounters(...)), so the hot loop never touches anything shared.
+
+    Note: Padded to a cache line so that two threads' slots never share one.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+struct ParticleCollisionCounters
+{
+    ParticleCollisionCounters() :
+        _numPairTests(0),
+        _numPairsCollided(0),
+        _numNeighborNodeVisits(0)
+    {
+    }
+
+    // pairs handed to the kernel, and how many of those it applied a force to
+    unsigned long long _numPairTests;
+    unsigned long long _numPairsCollided;
+
+    // neighboring leaves (or grid cells) whose particles were checked
+    unsigned long long _numNeighborNodeVisits;
+
+    char _padding[64 - (3 * sizeof(unsigned long long))];
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    One frame's statistics.  The counts are summed over every step of the frame and every
+    thread, and the tree's shape is as it was after the frame's last step.
+
+    Note: Plain data with fixed-size arrays so that the binary log is just one of these after
+    another.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+struct ParticleStatsFrame
+{
+    ParticleStatsFrame();
+
+    unsigned int _frame;
+    int _numSteps;
+    int _numActiveParticles;
+    double _collisionSec;
+
+    unsigned long long _numPairTests;
+    unsigned long long _numPairsCollided;
+    unsigned long long _numNeighborNodeVisits;
+
+    // the tree's settings (see ParticleTreeAutotuner) and how it came out
+    int _leafCapacity;
+    int _numCellsPerAxisInitial;
+    int _numNodesInUse;
+    int _numSubdivisionFailures;
+    int _numParticlesNotAdded;
+    SpatialTreeShape _treeShape;
+
+    // -1 if the broadphase isn't selected per step (see ParticleBroadphaseSelector)
+    int _broadphaseType;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gathers a per-frame statistics block for the collisions and the tree, keeps the last one
+    for anyone who asks, and optionally appends every one to a log file.
+
+    The collision passes count on each thread separately.  There is one slot of counters per
+    thread in the pool that runs the collisions (see ParticleTaskScheduler), and a thread only
+    ever adds to its own, so nothing is atomic.  The slots are summed when the frame ends.
+
+    The log is either CSV, with a header row and then one row per frame, or binary, with
+    ParticleStatsFrame's bytes one frame after another.  The binary log is only meant to be
+    read back by the same build.
+
+    Note: BeginFrame() and EndFrame(...) must be called from the thread that runs the
+    simulation, and not while a collision pass is running.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticleStats
+{
+public:
+    ParticleStats();
+    ~ParticleStats();
+
+    // one slot for the thread that runs the simulation and one for each worker
+    void Init(int numWorkerThreads);
+    bool OpenLog(const char *filePath, bool binary);
+    void CloseLog();
+
+    void BeginFrame();
+    void AddCounters(const ParticleCollisionCounters &counters);
+    void EndFrame(unsigned int frame, int numSteps, int numActiveParticles, double collisionSec,
+        const ParticleQuadTree &tree, int broadphaseType = -1);
+
+    const ParticleStatsFrame &LastFrame() const;
+    int NumFramesLogged() const;
+
+private:
+    void WriteCsvHeader();
+    void WriteCsvRow(const ParticleStatsFrame &stats);
+
+    std::vector<ParticleCollisionCounters> _threadCounters;
+    ParticleStatsFrame _lastFrame;
+
+    std::ofstream _log;
+    bool _logIsBinary;
+    int _numFramesLogged;
+};
@@ -48,6 +48,10 @@ void ParticleStorage::Init(unsigned int programId, unsigned int numParticles)
 {
     // take care of the easy stuff first
     _allParticles.resize(numParticles);
+    _allParticleProperties.Init(numParticles, ParticleProperties());
+    _previousPositions.clear();
+    _previousIsActive.clear();
+    _renderParticles.resize(numParticles);
     _sizeBytes = sizeof(Particle) * numParticles;
     _drawStyle = GL_POINTS;
 
@@ -105,21 +109,8 @@ void ParticleStorage::Init(unsigned int programId, unsigned int numParticles)
     glEnableVertexAttribArray(vertexArrayIndex);
     glVertexAttribPointer(vertexArrayIndex, numItems, itemType, GL_FALSE, bytesPerStep, (void *)bufferStartOffset);
 
-    // mass
-    itemType = GL_FLOAT;
-    numItems = sizeof(Particle::_mass) / sizeof(float);
-    bufferStartOffset += sizeof(Particle::_collisionCountThisFrame);
-    vertexArrayIndex++;
-    glEnableVertexAttribArray(vertexArrayIndex);
-    glVertexAttribPointer(vertexArrayIndex, numItems, itemType, GL_FALSE, bytesPerStep, (void *)bufferStartOffset);
-
-    // radius of influence
-    itemType = GL_FLOAT;
-    numItems = sizeof(Particle::_radiusOfInfluence) / sizeof(float);
-    bufferStartOffset += sizeof(Particle::_mass);
-    vertexArrayIndex++;
-    glEnableVertexAttribArray(vertexArrayIndex);
-    glVertexAttribPointer(vertexArrayIndex, numItems, itemType, GL_FALSE, bytesPerStep, (void *)bufferStartOffset);
+    // mass and radius of influence are no longer in the particle structure (see 
+    // ParticleProperties), so they aren't attributes anymore
 
     // ignoring the "is active" flag by not telling OpenGL that there is an item here 
     // Note: Does this waste bytes? Yes, but it would be more work to pluck out the position and 
@@ -139,6 +130,30 @@ void ParticleStorage::Init(unsigned int programId, unsigned int numParticles)
     glUseProgram(0);    // always last
 }
 
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Remembers where every particle is so that the rendered frame can be blended between this 
+    state and the one after the next simulation step.  Call it just before the last step that 
+    runs before a frame is displayed.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleStorage::SavePreviousState()
+{
+    _previousPositions.resize(_allParticles.size());
+    _previousIsActive.resize(_allParticles.size());
+    for (size_t particleIndex = 0; particleIndex < _allParticles.size(); particleIndex++)
+    {
+        _previousPositions[particleIndex] = _allParticles[particleIndex]._position;
+        _previousIsActive[particleIndex] = _allParticles[particleIndex]._isActive;
+    }
+
+    // sized here so that packing, which may be split between threads, never resizes it
+    _renderParticles.resize(_allParticles.size());
+}
+
 /*-----------------------------------------------------------------------------------------------
 Description:
     Like the comparable method of GeometryData::UpdateBufferData(), this uploads buffer data on 
@@ -146,17 +161,108 @@ Description:
 
     Note: The maximum buffer size is determined in Init(...), so unlike the GeometryData 
     version, there is no need to check to see if a bigger buffer needs to be allocated.
-Parameters: None
+
+    If SavePreviousState() has been called, the uploaded positions are blended between the 
+    saved state and the current one.  A particle that was emitted or moved back to its emitter 
+    since then is drawn where it is now rather than sliding across the screen.
+Parameters:
+    interpolationAlpha  0 draws the saved state, 1 draws the current state.
 Returns:    None
 Exception:  Safe
 Creator:    John Cox (12-17-2016)
 -----------------------------------------------------------------------------------------------*/
-void ParticleStorage::UpdateBufferData()
+void ParticleStorage::UpdateBufferData(float interpolationAlpha)
+{
+    PackRenderParticles(interpolationAlpha, 0, (unsigned int)_allParticles.size());
+    UploadRenderParticles(interpolationAlpha);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The CPU half of UpdateBufferData(...): blends a range of particles between the saved state 
+    and the current one.  Different ranges can be packed on different threads at the same 
+    time.  Does nothing if there is no blending to do.
+Parameters:
+    interpolationAlpha  0 draws the saved state, 1 draws the current state.
+    begin, end          The particle range, with end not included.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleStorage::PackRenderParticles(float interpolationAlpha, unsigned int begin, 
+    unsigned int end)
 {
+    if (!IsBlending(interpolationAlpha))
+    {
+        return;
+    }
+
+    for (unsigned int particleIndex = begin; particleIndex < end; particleIndex++)
+    {
+        const Particle &current = _allParticles[particleIndex];
+        Particle &rendered = _renderParticles[particleIndex];
+        rendered = current;
+        if (current._isActive && _previousIsActive[particleIndex])
+        {
+            const glm::vec2 &previousPosition = _previousPositions[particleIndex];
+            rendered._position = previousPosition + 
+                ((current._position - previousPosition) * interpolationAlpha);
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The GPU half of UpdateBufferData(...): uploads the packed particles, or the current ones if 
+    there was no blending to do.
+Parameters:
+    interpolationAlpha  The same one that the particles were packed with.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleStorage::UploadRenderParticles(float interpolationAlpha)
+{
+    const Particle *uploadThis = IsBlending(interpolationAlpha) ? 
+        _renderParticles.data() : _allParticles.data();
+
     glBindBuffer(GL_ARRAY_BUFFER, _arrayBufferId);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, _sizeBytes, uploadThis);
+
+    // cleanup
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
 
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Cleans up the pack and upload.
+Parameters:
+    interpolationAlpha  Self-explanatory.
+Returns:
+    True if SavePreviousState() has been called and the frame isn't exactly on the current 
+    state.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleStorage::IsBlending(float interpolationAlpha) const
+{
+    return (_previousPositions.size() == _allParticles.size()) && (interpolationAlpha < 1.0f);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Uploads a copy of the particles instead of _allParticles.  Used when the simulation runs on 
+    another thread and owns _allParticles (see ParticleFrameExchange).
+Parameters:
+    renderParticles     Must be the same size as _allParticles.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleStorage::UpdateBufferData(const std::vector<Particle> &renderParticles)
+{
     glBindBuffer(GL_ARRAY_BUFFER, _arrayBufferId);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, _sizeBytes, _allParticles.data());
+    glBufferSubData(GL_ARRAY_BUFFER, 0, _sizeBytes, renderParticles.data());
 
     // cleanup
     glBindBuffer(GL_ARRAY_BUFFER, 0);
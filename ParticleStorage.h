@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Particle.h"
+#include "ParticleProperties.h"
 #include <vector>
 
 /*-----------------------------------------------------------------------------------------------
@@ -20,7 +21,11 @@ public:
     ParticleStorage();
     ~ParticleStorage();
     void Init(unsigned int programId, unsigned int numParticles);
-    void UpdateBufferData();
+    void SavePreviousState();
+    void UpdateBufferData(float interpolationAlpha = 1.0f);
+    void PackRenderParticles(float interpolationAlpha, unsigned int begin, unsigned int end);
+    void UploadRenderParticles(float interpolationAlpha);
+    void UpdateBufferData(const std::vector<Particle> &renderParticles);
 
     // save on the large header inclusion of OpenGL and write out these primitive types instead 
     // of using the OpenGL typedefs
@@ -31,5 +36,19 @@ public:
     unsigned int _drawStyle;    // GL_TRIANGLES, GL_LINES, etc.
     unsigned int _sizeBytes;    // useful for glBufferSubData(...)
     std::vector<Particle> _allParticles;
+
+    // indexed the same as _allParticles, but not uploaded to the GPU
+    ParticlePropertyStorage _allParticleProperties;
+
+private:
+    bool IsBlending(float interpolationAlpha) const;
+
+    // the simulation runs at a fixed time step that doesn't line up with the displayed frames, 
+    // so the renderer blends the positions from before and after the last step
+    // Note: Only the positions and "is active" flags are saved.  The rest of the uploaded 
+    // particle is the current state.
+    std::vector<glm::vec2> _previousPositions;
+    std::vector<int> _previousIsActive;
+    std::vector<Particle> _renderParticles;
 };
 
@@ -0,0 +1,719 @@
+#include "ParticleTaskScheduler.h"
+
+// which deque the current thread pushes to and pops from
+// Note: 0 for any thread that isn't one of the pool's workers, which is how the thread that
+// calls Run() gets deque 0.
+static thread_local int tWorkerIndex = 0;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Starts the worker threads.  They sleep until the first Run().
+Parameters:
+    numWorkerThreads    Not counting the thread that calls Run().  Negative means one less
+                        than the number of hardware threads.  0 runs everything on the
+                        thread that calls Run().
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleTaskScheduler::ParticleTaskScheduler(int numWorkerThreads) :
+    _numTasksRemaining(0),
+    _numQueuedJobs(0),
+    _numSteals(0),
+    _numSleepingWorkers(0),
+    _stopping(false),
+    _lastRunSec(0.0),
+    _criticalPathSec(0.0)
+{
+    if (numWorkerThreads < 0)
+    {
+        // Note: hardware_concurrency() is allowed to return 0 if it doesn't know.
+        int numHardwareThreads = (int)std::thread::hardware_concurrency();
+        numWorkerThreads = (numHardwareThreads > 1) ? numHardwareThreads - 1 : 0;
+    }
+
+    for (int dequeCount = 0; dequeCount < numWorkerThreads + 1; dequeCount++)
+    {
+        _deques.push_back(new WorkerDeque());
+    }
+    for (int workerIndex = 1; workerIndex <= numWorkerThreads; workerIndex++)
+    {
+        _workerThreads.push_back(std::thread(&ParticleTaskScheduler::WorkerLoop, this,
+            workerIndex));
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Wakes up the workers, tells them to quit, and waits for them.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleTaskScheduler::~ParticleTaskScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _stopping = true;
+    }
+    _wakeCondition.notify_all();
+    for (size_t threadCount = 0; threadCount < _workerThreads.size(); threadCount++)
+    {
+        _workerThreads[threadCount].join();
+    }
+
+    for (size_t dequeCount = 0; dequeCount < _deques.size(); dequeCount++)
+    {
+        delete _deques[dequeCount];
+    }
+    for (size_t taskCount = 0; taskCount < _tasks.size(); taskCount++)
+    {
+        delete _tasks[taskCount];
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Adds a task that runs as a single piece.
+Parameters:
+    name    For the report.
+    work    Self-explanatory.
+Returns:
+    The task's ID, for AddDependency(...) and the report.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleTaskScheduler::AddTask(const char *name, const std::function<void()> &work)
+{
+    std::function<void()> wrappedWork = work;
+    return AddParallelTask(name, 1, 1, [wrappedWork](int, int) { wrappedWork(); });
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Adds a task whose items can be worked on in any order.  The items are split into chunks,
+    and each chunk is a separate job that any worker can pick up.
+Parameters:
+    name            For the report.
+    numItems        Self-explanatory.
+    itemsPerChunk   Self-explanatory.  Too small and the jobs cost more than the work.
+    work            Called as work(begin, end) for each chunk, with end not included.
+Returns:
+    The task's ID, for AddDependency(...) and the report.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleTaskScheduler::AddParallelTask(const char *name, int numItems, int itemsPerChunk,
+    const std::function<void(int, int)> &work)
+{
+    Task *task = new Task();
+    task->_scheduler = this;
+    task->_name = name;
+    task->_work = work;
+    task->_numItems = (numItems < 1) ? 1 : numItems;
+    task->_itemsPerChunk = (itemsPerChunk < 1) ? 1 : itemsPerChunk;
+    task->_numPredecessors = 0;
+    task->_numPredecessorsRemaining = 0;
+    task->_numChunksRemaining = 0;
+
+    int numChunks = (task->_numItems + task->_itemsPerChunk - 1) / task->_itemsPerChunk;
+    task->_chunkStartNs.resize(numChunks);
+    task->_chunkEndNs.resize(numChunks);
+    task->_startSec = 0.0;
+    task->_endSec = 0.0;
+    task->_busySec = 0.0;
+    task->_isOnCriticalPath = false;
+
+    _tasks.push_back(task);
+    return (int)_tasks.size() - 1;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Says that one task can't start until another one is done.
+Parameters:
+    beforeTaskId    Self-explanatory.
+    afterTaskId     Must have been added after the "before" task.
+Returns:
+    False if the IDs are out of order or out of range, in which case nothing is changed.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleTaskScheduler::AddDependency(int beforeTaskId, int afterTaskId)
+{
+    if (beforeTaskId < 0 || afterTaskId >= (int)_tasks.size() || beforeTaskId >= afterTaskId)
+    {
+        return false;
+    }
+
+    _tasks[beforeTaskId]->_successorIds.push_back(afterTaskId);
+    _tasks[afterTaskId]->_numPredecessors++;
+    return true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs every task once, each after everything that it depends on.  The calling thread works
+    alongside the pool and this returns when everything is done.  Then works out the report.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleTaskScheduler::Run()
+{
+    tWorkerIndex = 0;
+    _runStartTime = std::chrono::steady_clock::now();
+
+    // reset everything first; a released task can finish and release others right away
+    _numTasksRemaining.store((int)_tasks.size());
+    for (size_t taskId = 0; taskId < _tasks.size(); taskId++)
+    {
+        _tasks[taskId]->_numPredecessorsRemaining.store(_tasks[taskId]->_numPredecessors);
+    }
+
+    for (size_t taskId = 0; taskId < _tasks.size(); taskId++)
+    {
+        if (_tasks[taskId]->_numPredecessors == 0)
+        {
+            ReleaseTask((int)taskId);
+        }
+    }
+
+    RunUntilDone(_numTasksRemaining);
+
+    _lastRunSec = (double)NowNs() * 1.0e-9;
+    CalculateReport();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    See description.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleTaskScheduler::NumTasks() const
+{
+    return (int)_tasks.size();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters:
+    taskId  Self-explanatory.
+Returns:
+    See description.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+const char *ParticleTaskScheduler::TaskName(int taskId) const
+{
+    return _tasks[taskId]->_name.c_str();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters:
+    taskId  Self-explanatory.
+Returns:
+    When the task's first chunk started during the last Run().
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+double ParticleTaskScheduler::TaskStartSec(int taskId) const
+{
+    return _tasks[taskId]->_startSec;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters:
+    taskId  Self-explanatory.
+Returns:
+    When the task's last chunk finished during the last Run().
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+double ParticleTaskScheduler::TaskEndSec(int taskId) const
+{
+    return _tasks[taskId]->_endSec;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.  For a task with chunks that ran in parallel, this is more than its end
+    minus its start.
+Parameters:
+    taskId  Self-explanatory.
+Returns:
+    The total time spent in the task's chunks during the last Run().
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+double ParticleTaskScheduler::TaskBusySec(int taskId) const
+{
+    return _tasks[taskId]->_busySec;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters:
+    taskId  Self-explanatory.
+Returns:
+    True if the task was on the critical path of the last Run().
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleTaskScheduler::IsOnCriticalPath(int taskId) const
+{
+    return _tasks[taskId]->_isOnCriticalPath;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.  If this is close to LastRunSec(), then more threads won't help and the
+    tasks on the critical path need to be faster or split up.
+Parameters: None
+Returns:
+    The total time of the tasks on the critical path of the last Run().
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+double ParticleTaskScheduler::CriticalPathSec() const
+{
+    return _criticalPathSec;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How long the last Run() took.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+double ParticleTaskScheduler::LastRunSec() const
+{
+    return _lastRunSec;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    The size of the pool, not counting the thread that calls Run().
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleTaskScheduler::NumWorkerThreads() const
+{
+    return (int)_workerThreads.size();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    Which of the pool's deques the calling thread uses.  Threads that aren't workers share 0.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleTaskScheduler::CurrentWorkerIndex()
+{
+    return tWorkerIndex;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many jobs were taken from another worker's deque since construction.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleTaskScheduler::NumSteals() const
+{
+    return _numSteals.load();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Puts a job on the current thread's deque for whichever worker gets to it first.  The
+    job may spawn more jobs on the same counter, so a recursion can split itself up as it
+    goes, and idle workers steal the oldest (biggest) pieces.
+Parameters:
+    joinCounter     Counts the job until it is done.  Must outlive the job.
+    function        Called as function(context, begin, end).
+    context         Self-explanatory.  Must outlive the job.
+    begin, end      Passed along.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleTaskScheduler::Spawn(std::atomic<int> &joinCounter, job_function function,
+    void *context, int begin, int end)
+{
+    // counted before it can possibly run, so the counter can't touch 0 early
+    joinCounter.fetch_add(1, std::memory_order_relaxed);
+
+    Job job;
+    job._function = function;
+    job._context = context;
+    job._begin = begin;
+    job._end = end;
+    job._joinCounter = &joinCounter;
+    Push(job);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs jobs on the current thread until everything spawned on the counter is done.  The
+    jobs that it picks up aren't necessarily the ones that it is waiting on, but they all need
+    doing, and it keeps the thread busy instead of blocked.
+Parameters:
+    joinCounter     Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleTaskScheduler::Wait(std::atomic<int> &joinCounter)
+{
+    RunUntilDone(joinCounter);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The job function for every task chunk.  Times the chunk and, if it was the task's last
+    one, finishes the task.
+Parameters:
+    context     The task.
+    begin, end  The chunk's items.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleTaskScheduler::RunTaskChunk(void *context, int begin, int end)
+{
+    Task &task = *(Task *)context;
+    int chunkIndex = begin / task._itemsPerChunk;
+    task._chunkStartNs[chunkIndex] = task._scheduler->NowNs();
+    task._work(begin, end);
+    task._chunkEndNs[chunkIndex] = task._scheduler->NowNs();
+
+    // acq_rel: whoever finishes the task sees every chunk's results
+    if (task._numChunksRemaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        task._scheduler->FinishTask(task);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Everything that the task depends on is done, so push its chunks.
+Parameters:
+    taskId  Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleTaskScheduler::ReleaseTask(int taskId)
+{
+    Task &task = *_tasks[taskId];
+    int numChunks = (int)task._chunkStartNs.size();
+    task._numChunksRemaining.store(numChunks);
+    for (int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++)
+    {
+        Job job;
+        job._function = &ParticleTaskScheduler::RunTaskChunk;
+        job._context = &task;
+        job._begin = chunkIndex * task._itemsPerChunk;
+        job._end = job._begin + task._itemsPerChunk;
+        job._end = (job._end > task._numItems) ? task._numItems : job._end;
+        job._joinCounter = 0;
+        Push(job);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Releases every task that was only waiting on this one, and counts it as done.
+Parameters:
+    task    Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleTaskScheduler::FinishTask(Task &task)
+{
+    for (size_t successorCount = 0; successorCount < task._successorIds.size(); successorCount++)
+    {
+        int successorId = task._successorIds[successorCount];
+        if (_tasks[successorId]->_numPredecessorsRemaining.fetch_sub(1,
+            std::memory_order_acq_rel) == 1)
+        {
+            ReleaseTask(successorId);
+        }
+    }
+
+    _numTasksRemaining.fetch_sub(1, std::memory_order_release);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Puts a job on the back of the current thread's deque and wakes a worker if any are
+    asleep.
+
+    Note: The sleeping count and the queued count are both sequentially consistent, so either
+    this sees the worker going to sleep and wakes it, or the worker sees the new job and
+    doesn't go to sleep.  Taking the sleep mutex before notifying makes sure that a worker that
+    is between checking and waiting gets the notification.
+Parameters:
+    job     Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleTaskScheduler::Push(const Job &job)
+{
+    WorkerDeque &deque = *_deques[tWorkerIndex];
+    {
+        std::lock_guard<std::mutex> lock(deque._mutex);
+        deque._jobs.push_back(job);
+    }
+    _numQueuedJobs.fetch_add(1);
+
+    if (_numSleepingWorkers.load() > 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+        }
+        _wakeCondition.notify_one();
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Takes the newest job from this worker's own deque, or else the oldest job from another
+    worker's deque.  Newest-first keeps a worker on data that it just touched, and stealing
+    oldest-first takes the biggest pieces of whatever is left.
+Parameters:
+    workerIndex     Self-explanatory.
+    putJobHere      Self-explanatory.
+Returns:
+    False if every deque was empty.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleTaskScheduler::PopOrSteal(int workerIndex, Job *putJobHere)
+{
+    if (_numQueuedJobs.load(std::memory_order_relaxed) == 0)
+    {
+        return false;
+    }
+
+    int numDeques = (int)_deques.size();
+    for (int dequeCount = 0; dequeCount < numDeques; dequeCount++)
+    {
+        int dequeIndex = (workerIndex + dequeCount) % numDeques;
+        WorkerDeque &deque = *_deques[dequeIndex];
+        std::lock_guard<std::mutex> lock(deque._mutex);
+        if (deque._jobs.empty())
+        {
+            continue;
+        }
+
+        if (dequeCount == 0)
+        {
+            *putJobHere = deque._jobs.back();
+            deque._jobs.pop_back();
+        }
+        else
+        {
+            *putJobHere = deque._jobs.front();
+            deque._jobs.pop_front();
+            _numSteals.fetch_add(1, std::memory_order_relaxed);
+        }
+        _numQueuedJobs.fetch_sub(1);
+        return true;
+    }
+
+    return false;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs a job that came off a deque and, if it was spawned, counts it off.
+Parameters:
+    job     Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleTaskScheduler::RunJob(const Job &job)
+{
+    job._function(job._context, job._begin, job._end);
+
+    // release: whoever waits on the counter sees what the job wrote
+    if (job._joinCounter != 0)
+    {
+        job._joinCounter->fetch_sub(1, std::memory_order_release);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs jobs on the current thread until a counter gets to 0.  If there is nothing to run,
+    then the jobs that the counter is waiting on are running on other threads, so just let
+    them.
+Parameters:
+    numRemaining    Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleTaskScheduler::RunUntilDone(std::atomic<int> &numRemaining)
+{
+    int workerIndex = tWorkerIndex;
+    while (numRemaining.load(std::memory_order_acquire) > 0)
+    {
+        Job job;
+        if (PopOrSteal(workerIndex, &job))
+        {
+            RunJob(job);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A worker thread.  Runs jobs while there are any and sleeps when there aren't.
+Parameters:
+    workerIndex     Its deque.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleTaskScheduler::WorkerLoop(int workerIndex)
+{
+    tWorkerIndex = workerIndex;
+    while (true)
+    {
+        Job job;
+        if (PopOrSteal(workerIndex, &job))
+        {
+            RunJob(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _numSleepingWorkers.fetch_add(1);
+        while (!_stopping && _numQueuedJobs.load() == 0)
+        {
+            _wakeCondition.wait(lock);
+        }
+        _numSleepingWorkers.fetch_sub(1);
+        if (_stopping)
+        {
+            return;
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Cleans up timing.
+Parameters: None
+Returns:
+    Nanoseconds since the current Run() started.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+long long ParticleTaskScheduler::NowNs() const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - _runStartTime).count();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Works out each task's times from its chunks' times, then finds the critical path.  The
+    tasks are already in an order where every dependency comes first, so the longest chain
+    that ends at each task is its own time plus the longest chain that ends at any of the
+    tasks that it depends on.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleTaskScheduler::CalculateReport()
+{
+    int numTasks = (int)_tasks.size();
+    for (int taskId = 0; taskId < numTasks; taskId++)
+    {
+        Task &task = *_tasks[taskId];
+        long long startNs = task._chunkStartNs[0];
+        long long endNs = task._chunkEndNs[0];
+        long long busyNs = 0;
+        for (size_t chunkIndex = 0; chunkIndex < task._chunkStartNs.size(); chunkIndex++)
+        {
+            startNs = (task._chunkStartNs[chunkIndex] < startNs) ? task._chunkStartNs[chunkIndex] : startNs;
+            endNs = (task._chunkEndNs[chunkIndex] > endNs) ? task._chunkEndNs[chunkIndex] : endNs;
+            busyNs += task._chunkEndNs[chunkIndex] - task._chunkStartNs[chunkIndex];
+        }
+        task._startSec = (double)startNs * 1.0e-9;
+        task._endSec = (double)endNs * 1.0e-9;
+        task._busySec = (double)busyNs * 1.0e-9;
+        task._isOnCriticalPath = false;
+    }
+
+    // the longest chain ending at each task, and which task came before it on that chain
+    // Note: A task's length is its end minus its start, which is how long it held up whatever
+    // came after it.
+    std::vector<double> chainSec(numTasks, 0.0);
+    std::vector<int> chainPrevious(numTasks, -1);
+    for (int taskId = 0; taskId < numTasks; taskId++)
+    {
+        const Task &task = *_tasks[taskId];
+        chainSec[taskId] += task._endSec - task._startSec;
+        for (size_t successorCount = 0; successorCount < task._successorIds.size(); successorCount++)
+        {
+            int successorId = task._successorIds[successorCount];
+            if (chainSec[taskId] > chainSec[successorId])
+            {
+                chainSec[successorId] = chainSec[taskId];
+                chainPrevious[successorId] = taskId;
+            }
+        }
+    }
+
+    int chainEnd = -1;
+    _criticalPathSec = 0.0;
+    for (int taskId = 0; taskId < numTasks; taskId++)
+    {
+        if (chainSec[taskId] > _criticalPathSec)
+        {
+            _criticalPathSec = chainSec[taskId];
+            chainEnd = taskId;
+        }
+    }
+    for (int taskId = chainEnd; taskId >= 0; taskId = chainPrevious[taskId])
+    {
+        _tasks[taskId]->_isOnCriticalPath = true;
+    }
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <functional>
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs a frame's phases as a graph of tasks on a small work-stealing thread pool.
+
+    The graph is built once: each task has a name and its work, and a dependency says that
+    one task's output is another's input.  A task can also be split into chunks over a range
+    of items (particles, for example), and the chunks run in parallel.  Run() then executes the
+    whole graph: tasks start as soon as everything that they depend on is done, so independent
+    tasks overlap, and Run() returns when every task is done.  The thread that calls Run()
+    helps with the work instead of waiting.
+
+    Work that only finds out how it splits up as it goes (a recursion over the spatial tree,
+    for example) can use the same pool through Spawn(...) and Wait(...) instead of the graph.
+
+    Every worker has its own deque of jobs.  A worker takes the newest job from its own deque
+    and, when that is empty, steals the oldest job from someone else's.  Idle workers sleep
+    until there is work, so the pool costs nothing between frames.
+
+    After each Run(), every task's start time, end time, and busy time (summed over its chunks)
+    are available, along with the critical path: the chain of dependencies with the most time
+    in it, which is the shortest that the frame could take with unlimited threads.
+
+    Note: Dependencies must go from an earlier task to a later one, so the order that the
+    tasks were added in is already a valid order to run them in.
+    Also Note: Only one thread may call Run() at a time.  The graph must not be changed while
+    it is running.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticleTaskScheduler
+{
+public:
+    ParticleTaskScheduler(int numWorkerThreads = -1);
+    ~ParticleTaskScheduler();
+
+    // building the graph
+    int AddTask(const char *name, const std::function<void()> &work);
+    int AddParallelTask(const char *name, int numItems, int itemsPerChunk,
+        const std::function<void(int, int)> &work);
+    bool AddDependency(int beforeTaskId, int afterTaskId);
+
+    void Run();
+
+    // timings from the last Run(), in seconds since it started
+    int NumTasks() const;
+    const char *TaskName(int taskId) const;
+    double TaskStartSec(int taskId) const;
+    double TaskEndSec(int taskId) const;
+    double TaskBusySec(int taskId) const;
+    bool IsOnCriticalPath(int taskId) const;
+    double CriticalPathSec() const;
+    double LastRunSec() const;
+
+    int NumWorkerThreads() const;
+
+    // 0 for the thread that calls Run() (or any thread that isn't a worker), and 1 through 
+    // NumWorkerThreads() for the workers, so per-thread data can be an array
+    static int CurrentWorkerIndex();
+    unsigned int NumSteals() const;
+
+    // fork-join, from inside a task, from inside a spawned job, or from any other thread
+    // Note: Spawn(...) counts the job on the join counter and the job counts itself off when
+    // it is done.  Wait(...) runs jobs, anyone's, until the counter gets to 0.
+    typedef void(*job_function)(void *context, int begin, int end);
+    void Spawn(std::atomic<int> &joinCounter, job_function function, void *context, int begin,
+        int end);
+    void Wait(std::atomic<int> &joinCounter);
+
+private:
+    // one unit of work on a deque
+    // Note: A plain function and context instead of std::function, so pushing a job never
+    // allocates.
+    struct Job
+    {
+        job_function _function;
+        void *_context;
+        int _begin;
+        int _end;
+
+        // 0 for task chunks, which count themselves off their task
+        std::atomic<int> *_joinCounter;
+    };
+
+    struct Task
+    {
+        ParticleTaskScheduler *_scheduler;
+        std::string _name;
+        std::function<void(int, int)> _work;
+        int _numItems;
+        int _itemsPerChunk;
+        std::vector<int> _successorIds;
+        int _numPredecessors;
+
+        // reset by every Run()
+        std::atomic<int> _numPredecessorsRemaining;
+        std::atomic<int> _numChunksRemaining;
+
+        // one entry per chunk, each written by the job that ran it, in nanoseconds
+        std::vector<long long> _chunkStartNs;
+        std::vector<long long> _chunkEndNs;
+
+        // worked out after Run()
+        double _startSec;
+        double _endSec;
+        double _busySec;
+        bool _isOnCriticalPath;
+    };
+
+    static void RunTaskChunk(void *context, int begin, int end);
+    void ReleaseTask(int taskId);
+    void FinishTask(Task &task);
+    void Push(const Job &job);
+    bool PopOrSteal(int workerIndex, Job *putJobHere);
+    void RunJob(const Job &job);
+    void RunUntilDone(std::atomic<int> &numRemaining);
+    void WorkerLoop(int workerIndex);
+    long long NowNs() const;
+    void CalculateReport();
+
+    // Note: Pointers so that the tasks don't move when more are added (they have atomics).
+    std::vector<Task *> _tasks;
+    std::atomic<int> _numTasksRemaining;
+
+    // one per worker thread plus one for the thread that calls Run(), which is index 0
+    struct WorkerDeque
+    {
+        std::mutex _mutex;
+        std::deque<Job> _jobs;
+    };
+    std::vector<WorkerDeque *> _deques;
+    std::vector<std::thread> _workerThreads;
+    std::atomic<int> _numQueuedJobs;
+    std::atomic<unsigned int> _numSteals;
+
+    // idle workers wait here
+    std::mutex _sleepMutex;
+    std::condition_variable _wakeCondition;
+    std::atomic<int> _numSleepingWorkers;
+    bool _stopping;
+
+    std::chrono::steady_clock::time_point _runStartTime;
+    double _lastRunSec;
+    double _criticalPathSec;
+};
@@ -0,0 +1,394 @@
+#include "ParticleTreeAutotuner.h"
+
+// from least to most; includes the tree's default
+const int ParticleTreeAutotuner::_LEAF_CAPACITIES[ParticleTreeAutotuner::_NUM_LEAF_CAPACITIES] =
+{
+    4, 8, 12, 16, 20, 25, 32, 40, 48, 64
+};
+
+const float ParticleTreeAutotuner::_MIN_IMPROVEMENT = 0.03f;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Ensures that the object starts object with initialized values.  Nothing is tuned until
+    Init(...).
+Parameters:
+    stepsPerMeasurement     How many steps each setting is measured for in a round, not
+                            counting the one that is thrown away.
+    minStepsBetweenRounds   The time between rounds while they keep finding something better.
+    maxStepsBetweenRounds   The longest that the time between rounds grows to once they stop.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleTreeAutotuner::ParticleTreeAutotuner(int stepsPerMeasurement,
+    int minStepsBetweenRounds, int maxStepsBetweenRounds) :
+    _pTree(0),
+    _stepsPerMeasurement((stepsPerMeasurement < 1) ? 1 : stepsPerMeasurement),
+    _minStepsBetweenRounds((minStepsBetweenRounds < 1) ? 1 : minStepsBetweenRounds),
+    _maxStepsBetweenRounds(maxStepsBetweenRounds),
+    _bestSecPerParticle(0.0),
+    _trialIndex(-1),
+    _numStepsMeasured(0),
+    _measuredCollisionSec(0.0),
+    _measuredParticles(0.0),
+    _stepsUntilNextRound(0),
+    _stepsBetweenRounds(0),
+    _numRounds(0),
+    _numSettingChanges(0)
+{
+    if (_maxStepsBetweenRounds < _minStepsBetweenRounds)
+    {
+        _maxStepsBetweenRounds = _minStepsBetweenRounds;
+    }
+    _stepsBetweenRounds = _minStepsBetweenRounds;
+    _stepsUntilNextRound = _minStepsBetweenRounds;
+    _bestSetting._leafCapacityIndex = 0;
+    _bestSetting._numCellsPerAxis = 0;
+    for (int trialIndex = 0; trialIndex < _NUM_TRIALS; trialIndex++)
+    {
+        _trialSettings[trialIndex] = _bestSetting;
+        _trialSecPerParticle[trialIndex] = 0.0;
+        _trialIsValid[trialIndex] = false;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Starts from the tree's current settings, with its leaf capacity moved to the nearest one
+    that this tries.  The first round starts after the minimum time between rounds so that
+    the simulation has a chance to get going first.
+Parameters:
+    pTree   The tree to tune.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleTreeAutotuner::Init(ParticleQuadTree *pTree)
+{
+    _pTree = pTree;
+
+    int leafCapacity = pTree->LeafCapacity();
+    int nearestIndex = 0;
+    for (int capacityIndex = 1; capacityIndex < _NUM_LEAF_CAPACITIES; capacityIndex++)
+    {
+        int diff = _LEAF_CAPACITIES[capacityIndex] - leafCapacity;
+        int nearestDiff = _LEAF_CAPACITIES[nearestIndex] - leafCapacity;
+        if ((diff * diff) < (nearestDiff * nearestDiff))
+        {
+            nearestIndex = capacityIndex;
+        }
+    }
+    _bestSetting._leafCapacityIndex = nearestIndex;
+    _bestSetting._numCellsPerAxis = pTree->NumCellsPerAxisInitial();
+    Apply(_bestSetting);
+
+    _trialIndex = -1;
+    _stepsBetweenRounds = _minStepsBetweenRounds;
+    _stepsUntilNextRound = _minStepsBetweenRounds;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Counts down to the next round between rounds, and during one adds the step to the current
+    setting's measurement.  When a measurement is done, the next setting is given to the tree,
+    and it is used from the next step on, since the tree is rebuilt every step.
+
+    A setting that ran the tree out of nodes, so that some particles were left out of it, is
+    thrown out no matter how fast it was.  It was only fast because it skipped collisions.
+Parameters:
+    collisionSec        How long the step's tree building and collisions took.
+    numActiveParticles  Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleTreeAutotuner::RecordStep(double collisionSec, unsigned int numActiveParticles)
+{
+    if (_pTree == 0)
+    {
+        return;
+    }
+
+    if (_trialIndex < 0)
+    {
+        _stepsUntilNextRound--;
+        if (_stepsUntilNextRound > 0)
+        {
+            return;
+        }
+
+        // start a round with the current setting, which is already in the tree
+        _numRounds++;
+        for (int trialIndex = 0; trialIndex < _NUM_TRIALS; trialIndex++)
+        {
+            _trialIsValid[trialIndex] = TrialSetting(trialIndex, &_trialSettings[trialIndex]);
+            _trialSecPerParticle[trialIndex] = 0.0;
+        }
+        _trialIndex = 0;
+        _numStepsMeasured = 0;
+        _measuredCollisionSec = 0.0;
+        _measuredParticles = 0.0;
+        return;
+    }
+
+    _numStepsMeasured++;
+    if (_pTree->NumParticlesNotAdded() > 0)
+    {
+        _trialIsValid[_trialIndex] = false;
+    }
+    if (_numStepsMeasured > 1)
+    {
+        // the first step is thrown away
+        _measuredCollisionSec += collisionSec;
+        _measuredParticles += (double)numActiveParticles;
+    }
+    if (_numStepsMeasured <= _stepsPerMeasurement)
+    {
+        return;
+    }
+
+    // this setting is done
+    if (_measuredParticles > 0.0)
+    {
+        _trialSecPerParticle[_trialIndex] = _measuredCollisionSec / _measuredParticles;
+    }
+    else
+    {
+        // nothing to measure
+        _trialIsValid[_trialIndex] = false;
+    }
+
+    do
+    {
+        _trialIndex++;
+    } while (_trialIndex < _NUM_TRIALS && !_trialIsValid[_trialIndex]);
+
+    if (_trialIndex < _NUM_TRIALS)
+    {
+        Apply(_trialSettings[_trialIndex]);
+        _numStepsMeasured = 0;
+        _measuredCollisionSec = 0.0;
+        _measuredParticles = 0.0;
+    }
+    else
+    {
+        FinishRound();
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    The leaf capacity that is used between rounds.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleTreeAutotuner::BestLeafCapacity() const
+{
+    return _LEAF_CAPACITIES[_bestSetting._leafCapacityIndex];
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    The number of starting cells per axis that is used between rounds.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleTreeAutotuner::BestNumCellsPerAxis() const
+{
+    return _bestSetting._numCellsPerAxis;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    What the best setting's tree building and collisions cost per active particle per step
+    in the last round, in seconds.  0 until the first round is done.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+double ParticleTreeAutotuner::BestSecPerParticle() const
+{
+    return _bestSecPerParticle;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    True if settings are being tried, in which case the tree may not be using the best one.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleTreeAutotuner::IsRoundRunning() const
+{
+    return _trialIndex >= 0;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many rounds have started.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleTreeAutotuner::NumRounds() const
+{
+    return _numRounds;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many rounds found a better setting.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleTreeAutotuner::NumSettingChanges() const
+{
+    return _numSettingChanges;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many steps the tuner waits after a round before starting the next one.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+int ParticleTreeAutotuner::StepsBetweenRounds() const
+{
+    return _stepsBetweenRounds;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Works out one of the settings that a round tries, relative to the current best.
+    0   The current best.
+    1   One notch less leaf capacity.
+    2   One notch more leaf capacity.
+    3   Fewer starting cells per axis.
+    4   More starting cells per axis.
+Parameters:
+    trialIndex      From 0 to _NUM_TRIALS - 1.
+    putSettingHere  Self-explanatory.
+Returns:
+    False if that setting would be out of range, in which case it isn't tried.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleTreeAutotuner::TrialSetting(int trialIndex, Setting *putSettingHere) const
+{
+    Setting setting = _bestSetting;
+    if (trialIndex == 1)
+    {
+        setting._leafCapacityIndex--;
+    }
+    else if (trialIndex == 2)
+    {
+        setting._leafCapacityIndex++;
+    }
+    else if (trialIndex == 3)
+    {
+        setting._numCellsPerAxis -= _CELLS_PER_AXIS_STEP;
+    }
+    else if (trialIndex == 4)
+    {
+        setting._numCellsPerAxis += _CELLS_PER_AXIS_STEP;
+    }
+
+    *putSettingHere = setting;
+    if (setting._leafCapacityIndex < 0 || setting._leafCapacityIndex >= _NUM_LEAF_CAPACITIES)
+    {
+        return false;
+    }
+
+    // a 1x1 grid is just a tree with a single root, which one more subdivision makes anyway
+    if (setting._numCellsPerAxis < 2 ||
+        setting._numCellsPerAxis > ParticleQuadTree::MaxNumCellsPerAxisInitial())
+    {
+        return false;
+    }
+    return true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives a setting to the tree.  It takes effect the next time that the tree is rebuilt.
+Parameters:
+    setting     Must be in range.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleTreeAutotuner::Apply(const Setting &setting)
+{
+    _pTree->SetLeafCapacity(_LEAF_CAPACITIES[setting._leafCapacityIndex]);
+    _pTree->SetNumCellsPerAxisInitial(setting._numCellsPerAxis);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Picks the fastest setting from the round.  A neighbor has to beat the current setting by
+    more than the noise margin to replace it, unless the current setting was thrown out.  If
+    the setting changed, the next round comes soon, since the one after it may be better
+    still.  If not, the time until the next round doubles.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleTreeAutotuner::FinishRound()
+{
+    int fastestIndex = -1;
+    for (int trialIndex = 0; trialIndex < _NUM_TRIALS; trialIndex++)
+    {
+        if (_trialIsValid[trialIndex] && (fastestIndex < 0 ||
+            _trialSecPerParticle[trialIndex] < _trialSecPerParticle[fastestIndex]))
+        {
+            fastestIndex = trialIndex;
+        }
+    }
+
+    if (fastestIndex < 0)
+    {
+        // nothing was measured (ex: no particles), so try again later
+    }
+    else if (fastestIndex == 0 || (_trialIsValid[0] && _trialSecPerParticle[fastestIndex] >
+        _trialSecPerParticle[0] * (1.0 - _MIN_IMPROVEMENT)))
+    {
+        // converged
+        _bestSecPerParticle = _trialSecPerParticle[0];
+        _stepsBetweenRounds *= 2;
+        if (_stepsBetweenRounds > _maxStepsBetweenRounds)
+        {
+            _stepsBetweenRounds = _maxStepsBetweenRounds;
+        }
+    }
+    else
+    {
+        _bestSetting = _trialSettings[fastestIndex];
+        _bestSecPerParticle = _trialSecPerParticle[fastestIndex];
+        _numSettingChanges++;
+        _stepsBetweenRounds = _minStepsBetweenRounds;
+    }
+
+    Apply(_bestSetting);
+    _trialIndex = -1;
+    _stepsUntilNextRound = _stepsBetweenRounds;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "ParticleQuadTree.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Picks the quad tree's leaf capacity and initial grid size by trying them out on the live
+    simulation.  The best values depend on how densely the particles are packed and on the
+    machine, and both change while the program runs, so they aren't worth picking by hand.
+
+    It is a hill climb over the two settings.  Every so often a round of trials starts: the
+    current settings are measured for a few steps, then each neighboring setting (one notch
+    more or less leaf capacity, one notch more or fewer starting cells per axis) is measured
+    for the same number of steps.  The measurement is the step's tree building plus
+    collisions, per active particle, so that particles being emitted or lost aren't mistaken
+    for a better or worse setting.  The fastest one is kept if it beats the current one by
+    enough to not be noise.  While rounds keep finding something better, they come
+    quickly.  When a round doesn't, the settings have converged, and the time until the next
+    round doubles, up to a maximum, so that a converged tuner costs almost nothing but still
+    notices when the particles change.
+
+    The first step of each measurement is thrown away, since it is the one that pays for
+    the change.
+
+    Note: When this class goes "poof", it won't delete the given pointer.
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticleTreeAutotuner
+{
+public:
+    ParticleTreeAutotuner(int stepsPerMeasurement = 8, int minStepsBetweenRounds = 60,
+        int maxStepsBetweenRounds = 3840);
+    void Init(ParticleQuadTree *pTree);
+
+    // called after every step with how long its tree building and collisions took; may
+    // change the tree's settings for the next step
+    void RecordStep(double collisionSec, unsigned int numActiveParticles);
+
+    // the settings that are kept between rounds
+    int BestLeafCapacity() const;
+    int BestNumCellsPerAxis() const;
+    double BestSecPerParticle() const;
+
+    bool IsRoundRunning() const;
+    int NumRounds() const;
+    int NumSettingChanges() const;
+    int StepsBetweenRounds() const;
+
+private:
+    struct Setting
+    {
+        int _leafCapacityIndex;
+        int _numCellsPerAxis;
+    };
+
+    bool TrialSetting(int trialIndex, Setting *putSettingHere) const;
+    void Apply(const Setting &setting);
+    void FinishRound();
+
+    ParticleQuadTree *_pTree;
+    int _stepsPerMeasurement;
+    int _minStepsBetweenRounds;
+    int _maxStepsBetweenRounds;
+
+    // the leaf capacities to try, from least to most
+    static const int _NUM_LEAF_CAPACITIES = 10;
+    static const int _LEAF_CAPACITIES[_NUM_LEAF_CAPACITIES];
+
+    // the initial grid steps by this many cells per axis
+    static const int _CELLS_PER_AXIS_STEP = 2;
+
+    // a trial has to be this much faster (fraction) to replace the current setting
+    static const float _MIN_IMPROVEMENT;
+
+    Setting _bestSetting;
+    double _bestSecPerParticle;
+
+    // trial 0 is the current setting and the rest are its neighbors; -1 between rounds
+    static const int _NUM_TRIALS = 5;
+    int _trialIndex;
+    Setting _trialSettings[_NUM_TRIALS];
+    double _trialSecPerParticle[_NUM_TRIALS];
+    bool _trialIsValid[_NUM_TRIALS];
+
+    // the current measurement; totals so that the average is weighted by particle count
+    int _numStepsMeasured;
+    double _measuredCollisionSec;
+    double _measuredParticles;
+
+    int _stepsUntilNextRound;
+    int _stepsBetweenRounds;
+    int _numRounds;
+    int _numSettingChanges;
+};
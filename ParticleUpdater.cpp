@@ -1,5 +1,9 @@
 #include "ParticleUpdater.h"
 
+#include <math.h>
+#include "glm/detail/func_geometric.hpp" // for glm::dot
+#include "ParticleTaskScheduler.h"
+
 /*-----------------------------------------------------------------------------------------------
 Description:
     Ensures that the object starts object with initialized values.
@@ -12,6 +16,7 @@ ParticleUpdater::ParticleUpdater()
 {
     // glm structures have their own initializers
     _particleRegionRadiusSqr = 0.0f;
+    _periodicRegionHalfWidth = 0.0f;
 
     for (size_t emitterIndex = 0; emitterIndex < MAX_EMITTERS; emitterIndex++)
     {
@@ -19,7 +24,21 @@ ParticleUpdater::ParticleUpdater()
         _maxParticlesEmittedPerFrame[emitterIndex] = 0;
     }
     _numActiveParticles = 0;
+    _numSleepingParticles = 0;
+    _maxSpeed = 0.0f;
+    _maxAcceleration = 0.0f;
     _emitterCount = 0;
+    _conservationTotalsEnabled = false;
+    _pScheduler = 0;
+    _pJoinCounter = 0;
+    _pParticleCollection = 0;
+    _pParticleProperties = 0;
+    _updateStartIndex = 0;
+    _updateEndIndex = 0;
+    _maxEmittedPerUpdate = 0;
+
+    // demo-scaled: particles are emitted at 0.1-0.5 and weigh 0.1
+    SetSleepThresholds(0.005f, 0.001f, 30);
 }
 
 /*-----------------------------------------------------------------------------------------------
@@ -38,6 +57,27 @@ void ParticleUpdater::SetRegion(const glm::vec2 &particleRegionCenter,
     _particleRegionRadiusSqr = particleRegionRadius * particleRegionRadius;
 }
 
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.  While there is a periodic region, particles that leave it wrap 
+    around to the opposite side and are never deactivated, so the number of active particles 
+    only goes up until every particle has been emitted.
+
+    Note: The circular region must still be set.  Emitters only emit if it is.
+Parameters: 
+    periodicRegionCenter        Self-explanatory.
+    periodicRegionHalfWidth     Half the length of a side.  0 turns it off.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleUpdater::SetPeriodicRegion(const glm::vec2 &periodicRegionCenter, 
+    const float periodicRegionHalfWidth)
+{
+    _periodicRegionCenter = periodicRegionCenter;
+    _periodicRegionHalfWidth = periodicRegionHalfWidth;
+}
+
 /*-----------------------------------------------------------------------------------------------
 Description:
     A simple assignment.
@@ -62,25 +102,104 @@ void ParticleUpdater::AddEmitter(const IParticleEmitter *pEmitter,
     _emitterCount++;
 }
 
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets when a particle is considered to be at rest and how long it, and everything it touches, 
+    has to stay that way before it is put to sleep.
+Parameters: 
+    maxSpeed        Self-explanatory.
+    maxNetForce     Self-explanatory.
+    framesAtRest    Number of consecutive updates.  0 turns sleeping off.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleUpdater::SetSleepThresholds(const float maxSpeed, const float maxNetForce, 
+    const int framesAtRest)
+{
+    _sleepMaxSpeedSqr = maxSpeed * maxSpeed;
+    _sleepMaxNetForceSqr = maxNetForce * maxNetForce;
+    _sleepFramesAtRest = framesAtRest;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.  The totals cost a few adds per active particle, so they are off
+    unless something is going to look at them.
+Parameters: 
+    enabled     Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleUpdater::SetConservationTotalsEnabled(const bool enabled)
+{
+    _conservationTotalsEnabled = enabled;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple assignment.
+Parameters: 
+    pScheduler  The pool to update the chunks on.  0 to update them on the calling thread.  
+                Must outlive its use.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleUpdater::SetScheduler(ParticleTaskScheduler *pScheduler)
+{
+    _pScheduler = pScheduler;
+}
+
 /*-----------------------------------------------------------------------------------------------
 Description:
     Checks if each particle is out of bounds, and if so, tells the emitter to reset it.  If the 
     emitter hasn't reached its quota for emitted particles, then the particle is sent back out 
-    again.  Lastly, if the particle is active, then its position is updated with its velocity and
-    the provided delta time.
+    again.
+
+    This used to integrate the active particles too, but that is now up to the integrator (see 
+    IParticleIntegrator and ParticleSimulation), which may need to evaluate forces several times 
+    per frame.  This is the once-per-frame bookkeeping that happens before integration.
+
+    Sleeping particles are left alone unless a collision pushed on them since the last update, 
+    in which case they are woken up.  An awake particle that has been at rest long enough is put 
+    to sleep.
+
+    Emitted particles take on the emitter's species.
+
+    The same pass also finds the largest speed and acceleration among the particles that will 
+    move in the coming step, so that the next delta time can be picked without another pass 
+    over every particle.
+
+    The particles are split into chunks, which can be updated at the same time on a pool.  
+    Each chunk keeps its own counts and largest speed and acceleration, and they are added up 
+    once every chunk is done.  Emitting is the exception: each emitter has a quota per update 
+    and fills it from the first inactive particles it finds, so it can't be split up.  Each 
+    chunk instead keeps its first few inactive particles (no more than could be emitted), and 
+    they are emitted in chunk order afterwards, which picks the same particles that a single 
+    pass would have.
+
+    If they are enabled, the same pass also sums the active particles' mass, momentum, and 
+    kinetic energy, both as it found them and as it left them (see 
+    ParticleConservationTotals).  The sums are compensated so that they are good to about a 
+    float's precision no matter how many particles there are.  Each chunk sums its own, and 
+    the chunks' totals are merged in chunk order, so which thread updated which chunk doesn't 
+    change them.
 Parameters:
     particleCollection  The particle collection that will be updated.
+    particleProperties  The species of every particle in the collection.
     startIndex          Used in case the user wanted to adapt the updater to use multiple 
                         emitters and then wanted to split the number of particles between these 
                         emitters.
     numToUpdate         Same idea as "start index".
-    deltaTimeSec        Self-explanatory
 Returns:    None
 Exception:  Safe
 Creator:    John Cox (7-4-2016)
 -----------------------------------------------------------------------------------------------*/
 void ParticleUpdater::Update(std::vector<Particle> &particleCollection, 
-    const unsigned int startIndex, const unsigned int numToUpdate, const float deltaTimeSec)
+    ParticlePropertyStorage &particleProperties, const unsigned int startIndex, 
+    const unsigned int numToUpdate)
 {
     // if the radius is 0, then SetRegion(...) has not been called
     if (_emitterCount == 0 || _particleRegionRadiusSqr == 0.0f)
@@ -88,16 +207,6 @@ void ParticleUpdater::Update(std::vector<Particle> &particleCollection,
         return;
     }
 
-    // for all particles:
-    // - if it has gone out of bounds, reset it and deactivate it
-    // - if it is inactive and the emitter hasn't used up its quota for emitted particles this 
-    //  frame, reactivate it
-    // - if it is active, update its position with its velocity
-    // Note: If if() statements are used for each situation, then a particle has a chance to go 
-    // out of bounds and get reset, get reactivated, and emit again in the same frame.  If 
-    // else-if() statements are used, then only one of those situations will be run per frame.  
-    // I did the former, but it doesn't really matter which approach is chosen.
-
     // simply called "end" because I want to keep using the "< end" notation on the loop end 
     // condition
     unsigned int endIndex = startIndex + numToUpdate;
@@ -106,45 +215,298 @@ void ParticleUpdater::Update(std::vector<Particle> &particleCollection,
         // if "end" was already == particle collection size, then all is good
         endIndex = particleCollection.size();
     }
+    if (startIndex >= endIndex)
+    {
+        return;
+    }
 
-    // when using multiple emitters, it looks best to cycle between all emitters one by one, but 
-    // that is also more difficult to deal with and requires a number of different checks and 
-    // conditions, and provided the total number of particles to update exceeds the total number 
-    // of max particles emitted per frame across all emitters, then it will look just as good to 
-    // "fill up" each emitter one by one, and that is much easier to implement
-    unsigned int particleEmitCounter = 0;
-    int emitterIndex = 0;
-    unsigned int numActiveParticles = 0;
+    _pParticleCollection = &particleCollection;
+    _pParticleProperties = &particleProperties;
+    _updateStartIndex = startIndex;
+    _updateEndIndex = endIndex;
+
+    for (unsigned char speciesId = 0; speciesId < MAX_PARTICLE_SPECIES; speciesId++)
+    {
+        _speciesMass[speciesId] = particleProperties.GetSpeciesProperties(speciesId)._mass;
+        float inverseMass = 1.0f / _speciesMass[speciesId];
+        _inverseMassSqr[speciesId] = inverseMass * inverseMass;
+    }
+
+    // every emitter emits at least one before EmitParticles(...) moves on to the next one
+    _maxEmittedPerUpdate = 0;
+    for (int emitterIndex = 0; emitterIndex < MAX_EMITTERS; emitterIndex++)
+    {
+        if (_pEmitters[emitterIndex] != 0)
+        {
+            unsigned int quota = _maxParticlesEmittedPerFrame[emitterIndex];
+            _maxEmittedPerUpdate += (quota > 0) ? quota : 1;
+        }
+    }
+
+    // Note: The chunks' results and emit candidates only need to grow, and only do when the 
+    // particle collection does.
+    int numChunks = (int)((endIndex - startIndex + _PARTICLES_PER_CHUNK - 1) / _PARTICLES_PER_CHUNK);
+    if ((int)_chunkResults.size() < numChunks)
+    {
+        _chunkResults.resize(numChunks);
+    }
+    if (_emitCandidates.size() < (size_t)numChunks * _maxEmittedPerUpdate)
+    {
+        _emitCandidates.resize((size_t)numChunks * _maxEmittedPerUpdate);
+    }
+
+    bool isForked = (_pScheduler != 0) && (_pScheduler->NumWorkerThreads() > 0);
+    if (isForked)
+    {
+        std::atomic<int> joinCounter(0);
+        _pJoinCounter = &joinCounter;
+        _pScheduler->Spawn(joinCounter, &UpdateChunksJob, this, 0, numChunks);
+        _pScheduler->Wait(joinCounter);
+        _pJoinCounter = 0;
+    }
+    else
+    {
+        for (int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++)
+        {
+            UpdateChunk(chunkIndex);
+        }
+    }
+
+    // Note: The emitted particles' totals are merged last, after every chunk's.
+    UpdateChunkResults emitted;
+    EmitParticles(emitted);
+    UpdateChunkResults total;
+    for (int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++)
+    {
+        const UpdateChunkResults &chunk = _chunkResults[chunkIndex];
+        total._numActiveParticles += chunk._numActiveParticles;
+        total._numSleepingParticles += chunk._numSleepingParticles;
+        total._maxSpeedSqr = (chunk._maxSpeedSqr > total._maxSpeedSqr) ? 
+            chunk._maxSpeedSqr : total._maxSpeedSqr;
+        total._maxAccelerationSqr = (chunk._maxAccelerationSqr > total._maxAccelerationSqr) ? 
+            chunk._maxAccelerationSqr : total._maxAccelerationSqr;
+        total._conservationTotals.Merge(chunk._conservationTotals);
+    }
+    total._maxSpeedSqr = (emitted._maxSpeedSqr > total._maxSpeedSqr) ? 
+        emitted._maxSpeedSqr : total._maxSpeedSqr;
+    total._conservationTotals.Merge(emitted._conservationTotals);
+
+    _numActiveParticles = total._numActiveParticles;
+    _numSleepingParticles = total._numSleepingParticles;
+    _maxSpeed = sqrtf(total._maxSpeedSqr);
+    _maxAcceleration = sqrtf(total._maxAccelerationSqr);
+    _conservationTotals = total._conservationTotals;
+
+    _pParticleCollection = 0;
+    _pParticleProperties = 0;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Cleans up Update(...).  Checks one chunk's active particles for bounds and sleep, and 
+    keeps the chunk's first few inactive ones for EmitParticles(...).  Only the chunk's 
+    particles and results are written, so any number of chunks can be updated at once.
+Parameters:
+    chunkIndex  Self-explanatory.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleUpdater::UpdateChunk(int chunkIndex)
+{
+    std::vector<Particle> &particleCollection = *_pParticleCollection;
+    const ParticlePropertyStorage &particleProperties = *_pParticleProperties;
+    unsigned int beginIndex = _updateStartIndex + (unsigned int)chunkIndex * _PARTICLES_PER_CHUNK;
+    unsigned int endIndex = beginIndex + _PARTICLES_PER_CHUNK;
+    endIndex = (endIndex < _updateEndIndex) ? endIndex : _updateEndIndex;
 
-    for (size_t particleIndex = startIndex; particleIndex < endIndex; particleIndex++)
+    // for all particles:
+    // - if it has gone out of bounds, reset it and deactivate it
+    // - if it is inactive, it may be emitted once the chunks are done
+    // Note: A particle that goes out of bounds now isn't emitted until the next update.
+    UpdateChunkResults results;
+    ParticleConservationTotals &conservationTotals = results._conservationTotals;
+    int *emitCandidates = _emitCandidates.data() + (size_t)chunkIndex * _maxEmittedPerUpdate;
+    bool measureConservation = _conservationTotalsEnabled;
+    for (size_t particleIndex = beginIndex; particleIndex < endIndex; particleIndex++)
     {
         Particle &p = particleCollection[particleIndex];
 
-        if (p._isActive)
+        if (!p._isActive)
+        {
+            if ((unsigned int)results._numEmitCandidates < _maxEmittedPerUpdate)
+            {
+                emitCandidates[results._numEmitCandidates++] = (int)particleIndex;
+            }
+            continue;
+        }
+
+        results._numActiveParticles++;
+
+        // as the last step left it
+        float mass = 0.0f;
+        if (measureConservation)
         {
-            numActiveParticles++;
+            mass = _speciesMass[particleProperties.GetSpecies(particleIndex)];
+            conservationTotals._asFound.AddParticle(mass, p._velocity);
+        }
+
+        if (p._isAsleep)
+        {
+            if (p._collisionCountThisFrame == 0)
+            {
+                // nothing has disturbed it, so it stays where it is
+                results._numSleepingParticles++;
+                if (measureConservation)
+                {
+                    conservationTotals._afterUpdate.AddRestingParticle(mass);
+                }
+                continue;
+            }
 
-            // velocity += acceleration * delta time
-            // force = mass * acceleration => acceleration = force / mass
-            glm::vec2 acceleration = p._netForce / p._mass;
-            p._velocity += (acceleration * deltaTimeSec);
-            p._position = p._position + (p._velocity * deltaTimeSec);
+            // something bumped into it
+            p._isAsleep = 0;
+            p._framesAtRest = 0;
+            conservationTotals._numDisturbedSleepers++;
+        }
 
-            // preparation for collision resolution
+        // the collision kernel resets the count if anything that this particle touches is 
+        // still moving, so it only reaches the threshold if the neighbors are settled too
+        // Note: The net force is from the last force evaluation, which was at the particle's 
+        // current position.
+        bool isAtRest = 
+            (glm::dot(p._velocity, p._velocity) < _sleepMaxSpeedSqr) &&
+            (glm::dot(p._netForce, p._netForce) < _sleepMaxNetForceSqr);
+        p._framesAtRest = isAtRest ? p._framesAtRest + 1 : 0;
+        if (_sleepFramesAtRest > 0 && p._framesAtRest >= _sleepFramesAtRest)
+        {
+            p._isAsleep = 1;
+            if (p._netForce != glm::vec2())
+            {
+                conservationTotals._numForcesDropped++;
+            }
+            p._velocity = glm::vec2();
             p._netForce = glm::vec2();
-            p._collisionCountThisFrame = 0;
+            results._numSleepingParticles++;
+        }
+        else
+        {
+            float speedSqr = glm::dot(p._velocity, p._velocity);
+            results._maxSpeedSqr = (speedSqr > results._maxSpeedSqr) ? 
+                speedSqr : results._maxSpeedSqr;
+            float accelerationSqr = glm::dot(p._netForce, p._netForce) * 
+                _inverseMassSqr[particleProperties.GetSpecies(particleIndex)];
+            results._maxAccelerationSqr = (accelerationSqr > results._maxAccelerationSqr) ? 
+                accelerationSqr : results._maxAccelerationSqr;
+        }
 
-            if (ParticleOutOfBounds(p))
+        // count this frame's collisions from scratch
+        p._collisionCountThisFrame = 0;
+
+        if (_periodicRegionHalfWidth > 0.0f)
+        {
+            WrapIntoPeriodicRegion(p);
+        }
+        else if (ParticleOutOfBounds(p))
+        {
+            p._isActive = false;
+            if (p._netForce != glm::vec2())
             {
-                p._isActive = false;
+                conservationTotals._numForcesDropped++;
             }
         }
-        else if (emitterIndex < MAX_EMITTERS)   // also implicitly, "is active" is false
+
+        if (measureConservation && p._isActive)
+        {
+            conservationTotals._afterUpdate.AddParticle(mass, p._velocity);
+        }
+    }
+
+    _chunkResults[chunkIndex] = results;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    One forked job of an update.  Splits its range of chunks in half, spawning the back half, 
+    until it is down to a single chunk, then updates that.
+Parameters:
+    context     The updater.
+    begin, end  The range of chunks.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleUpdater::UpdateChunksJob(void *context, int begin, int end)
+{
+    ParticleUpdater *pUpdater = (ParticleUpdater *)context;
+    while (end - begin > 1)
+    {
+        int middle = begin + (end - begin) / 2;
+        pUpdater->_pScheduler->Spawn(*pUpdater->_pJoinCounter, &UpdateChunksJob, context, 
+            middle, end);
+        end = middle;
+    }
+
+    if (begin < end)
+    {
+        pUpdater->UpdateChunk(begin);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Cleans up Update(...).  Hands the chunks' inactive particles, in order, to the emitters 
+    until they have all put out as many as they can this update.
+Parameters:
+    emitted     Gets the largest speed of the emitted particles and, if the totals are 
+                enabled, adds them to the "after update" sums.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleUpdater::EmitParticles(UpdateChunkResults &emitted)
+{
+    std::vector<Particle> &particleCollection = *_pParticleCollection;
+    ParticlePropertyStorage &particleProperties = *_pParticleProperties;
+
+    // when using multiple emitters, it looks best to cycle between all emitters one by one, but 
+    // that is also more difficult to deal with and requires a number of different checks and 
+    // conditions, and provided the total number of particles to update exceeds the total number 
+    // of max particles emitted per frame across all emitters, then it will look just as good to 
+    // "fill up" each emitter one by one, and that is much easier to implement
+    unsigned int particleEmitCounter = 0;
+    int emitterIndex = 0;
+    int numChunks = (int)((_updateEndIndex - _updateStartIndex + _PARTICLES_PER_CHUNK - 1) / 
+        _PARTICLES_PER_CHUNK);
+    for (int chunkIndex = 0; chunkIndex < numChunks && emitterIndex < MAX_EMITTERS; chunkIndex++)
+    {
+        const int *emitCandidates = 
+            _emitCandidates.data() + (size_t)chunkIndex * _maxEmittedPerUpdate;
+        int numEmitCandidates = _chunkResults[chunkIndex]._numEmitCandidates;
+        for (int candidateCount = 0; 
+            candidateCount < numEmitCandidates && emitterIndex < MAX_EMITTERS; 
+            candidateCount++)
         {
-            // if all emitters have put out all they can this frame, then this condition will 
-            // not be entered
+            int particleIndex = emitCandidates[candidateCount];
+            Particle &p = particleCollection[particleIndex];
             _pEmitters[emitterIndex]->ResetParticle(&p);
+            particleProperties.SetSpecies(particleIndex, _pEmitters[emitterIndex]->GetSpecies());
+            p._netForce = glm::vec2();
+            p._collisionCountThisFrame = 0;
             p._isActive = true;
+            p._isAsleep = 0;
+            p._framesAtRest = 0;
+
+            // it has no force on it yet, but it may come out fast
+            float speedSqr = glm::dot(p._velocity, p._velocity);
+            emitted._maxSpeedSqr = (speedSqr > emitted._maxSpeedSqr) ? 
+                speedSqr : emitted._maxSpeedSqr;
+
+            if (_conservationTotalsEnabled)
+            {
+                emitted._conservationTotals._afterUpdate.AddParticle(
+                    _speciesMass[particleProperties.GetSpecies(particleIndex)], p._velocity);
+            }
 
             particleEmitCounter++;
             if (particleEmitCounter >= _maxParticlesEmittedPerFrame[emitterIndex])
@@ -167,8 +529,6 @@ void ParticleUpdater::Update(std::vector<Particle> &particleCollection,
             }
         }
     }
-
-    _numActiveParticles = numActiveParticles;
 }
 
 /*-----------------------------------------------------------------------------------------------
@@ -186,6 +546,36 @@ unsigned int ParticleUpdater::NumActiveParticles() const
     return _numActiveParticles;
 }
 
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of active particles that were asleep after the last 
+    Update(...) call.
+Parameters: None
+Returns:    
+    See description.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleUpdater::NumSleepingParticles() const
+{
+    return _numSleepingParticles;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of active particles that were awake after the last 
+    Update(...) call.
+Parameters: None
+Returns:    
+    See description.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleUpdater::NumAwakeParticles() const
+{
+    return _numActiveParticles - _numSleepingParticles;
+}
+
 /*-----------------------------------------------------------------------------------------------
 Description:
     Used during initialization to give all particles initial values.  It would not do to have 
@@ -238,3 +628,70 @@ bool ParticleUpdater::ParticleOutOfBounds(const Particle &p) const
 
     return false;
 }
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Cleans up Update(...).  Moves a particle that has left the periodic region by a whole 
+    number of region widths along each axis so that it is back inside.
+Parameters:
+    p   The particle to wrap.
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleUpdater::WrapIntoPeriodicRegion(Particle &p) const
+{
+    float width = 2.0f * _periodicRegionHalfWidth;
+    glm::vec2 regionMinCorner = _periodicRegionCenter - glm::vec2(_periodicRegionHalfWidth);
+    for (int axis = 0; axis < 2; axis++)
+    {
+        float diff = p._position[axis] - regionMinCorner[axis];
+        if (diff < 0.0f || diff >= width)
+        {
+            p._position[axis] -= width * floorf(diff / width);
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:    
+    The speed of the fastest particle that was awake or emitted during the last Update(...).
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+float ParticleUpdater::MaxSpeed() const
+{
+    return _maxSpeed;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:    
+    The largest net force / mass on any particle that was awake during the last Update(...).
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+float ParticleUpdater::MaxAcceleration() const
+{
+    return _maxAcceleration;
+}
+
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:    
+    What the last Update(...) summed.  All 0's if the totals aren't enabled.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+const ParticleConservationTotals &ParticleUpdater::ConservationTotals() const
+{
+    return _conservationTotals;
+}
\ No newline at end of file
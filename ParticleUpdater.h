@@ -2,9 +2,14 @@
 
 #include "Particle.h"
 #include "IParticleEmitter.h"
+#include "ParticleProperties.h"
+#include "ParticleConservation.h"
 #include <vector>
+#include <atomic>
 #include "glm/vec2.hpp"
 
+class ParticleTaskScheduler;
+
 /*-----------------------------------------------------------------------------------------------
 Description:
     Encapsulates particle updating with a given emitter and region.  The main function is the 
@@ -20,16 +25,53 @@ public:
     ParticleUpdater();
     
     void SetRegion(const glm::vec2 &particleRegionCenter, const float particleRegionRadius);
+    void SetPeriodicRegion(const glm::vec2 &periodicRegionCenter, const float periodicRegionHalfWidth);
     void AddEmitter(const IParticleEmitter *pEmitter, const int maxParticlesEmittedPerFrame);
+    void SetSleepThresholds(const float maxSpeed, const float maxNetForce, const int framesAtRest);
+    void SetConservationTotalsEnabled(const bool enabled);
     // no "remove emitter" method because this is just a demo
 
-    void Update(std::vector<Particle> &particleCollection, const unsigned int startIndex, 
-        const unsigned int numToUpdate, const float deltaTimeSec);
+    // 0 updates on the calling thread
+    void SetScheduler(ParticleTaskScheduler *pScheduler);
+
+    void Update(std::vector<Particle> &particleCollection, 
+        ParticlePropertyStorage &particleProperties, const unsigned int startIndex, 
+        const unsigned int numToUpdate);
     unsigned int NumActiveParticles() const;
+    unsigned int NumSleepingParticles() const;
+    unsigned int NumAwakeParticles() const;
+    float MaxSpeed() const;
+    float MaxAcceleration() const;
+    const ParticleConservationTotals &ConservationTotals() const;
     void ResetAllParticles(std::vector<Particle> &particleCollection) const;
 
 private:
     bool ParticleOutOfBounds(const Particle &p) const;
+    void WrapIntoPeriodicRegion(Particle &p) const;
+
+    // what one chunk of an update found, or what the emitters did; added up at the end
+    struct UpdateChunkResults
+    {
+        UpdateChunkResults() :
+            _numActiveParticles(0),
+            _numSleepingParticles(0),
+            _maxSpeedSqr(0.0f),
+            _maxAccelerationSqr(0.0f),
+            _numEmitCandidates(0)
+        {
+        }
+
+        unsigned int _numActiveParticles;
+        unsigned int _numSleepingParticles;
+        float _maxSpeedSqr;
+        float _maxAccelerationSqr;
+        ParticleConservationTotals _conservationTotals;
+        int _numEmitCandidates;
+    };
+
+    void UpdateChunk(int chunkIndex);
+    static void UpdateChunksJob(void *context, int begin, int end);
+    void EmitParticles(UpdateChunkResults &emitted);
 
     // for future demos, the only region that is needed is a circle/sphere
     // Note: Future particle containment will be handled by particle-polygon collisions.
@@ -38,10 +80,58 @@ private:
     glm::vec2 _particleRegionCenter;
     float _particleRegionRadiusSqr;
 
+    // if the half width is not 0, then particles that leave this square come back in on the 
+    // opposite side instead of being deactivated
+    glm::vec2 _periodicRegionCenter;
+    float _periodicRegionHalfWidth;
+
+    // a particle is at rest while both its speed and the net force on it are below these
+    // Note: Squared for the same reason as the region radius.  A frame count of 0 disables 
+    // sleeping.
+    float _sleepMaxSpeedSqr;
+    float _sleepMaxNetForceSqr;
+    int _sleepFramesAtRest;
+
     // use arrays instead of std::vector<...> for the sake of cache coherency
     unsigned int _numActiveParticles;
+    unsigned int _numSleepingParticles;
+
+    // the fastest awake particle and the largest net force / mass on one, as of the last update
+    // Note: These are what an adaptive delta time is based on (see 
+    // AdaptiveTimestepController).
+    float _maxSpeed;
+    float _maxAcceleration;
+
+    // the active particles' mass, momentum, and kinetic energy, as of the last update
+    bool _conservationTotalsEnabled;
+    ParticleConservationTotals _conservationTotals;
+
     unsigned int _emitterCount;
     static const int MAX_EMITTERS = 5;
     const IParticleEmitter *_pEmitters[MAX_EMITTERS];
     unsigned int _maxParticlesEmittedPerFrame[MAX_EMITTERS];
+
+    // 0 unless the chunks are updated on a pool; the counter is only set during an update
+    ParticleTaskScheduler *_pScheduler;
+    std::atomic<int> *_pJoinCounter;
+
+    // only set during an update
+    std::vector<Particle> *_pParticleCollection;
+    ParticlePropertyStorage *_pParticleProperties;
+    unsigned int _updateStartIndex;
+    unsigned int _updateEndIndex;
+
+    // mass lookup is per species, so do the division once per update rather than per particle
+    float _speciesMass[MAX_PARTICLE_SPECIES];
+    float _inverseMassSqr[MAX_PARTICLE_SPECIES];
+
+    // the update is split into chunks of this many particles
+    static const int _PARTICLES_PER_CHUNK = 2048;
+    std::vector<UpdateChunkResults> _chunkResults;
+
+    // each chunk's first few inactive particles, which is as many as the emitters can emit in 
+    // one update, so that they can be emitted in order once the chunks are done
+    // Note: Chunk i's are at [i * _maxEmittedPerUpdate, (i + 1) * _maxEmittedPerUpdate).
+    std::vector<int> _emitCandidates;
+    unsigned int _maxEmittedPerUpdate;
 };
@@ -50,6 +50,34 @@
 #include "ParticleStorage.h"
 #include "ParticleUpdater.h"
 #include "ParticleQuadTree.h"
+#include "ParticleCollisionEngine.h"
+#include "ParticleIntegratorSymplecticEuler.h"
+#include "ParticleIntegratorVelocityVerlet.h"
+#include "ParticleIntegratorRK4.h"
+#include "ParticleSimulation.h"
+#include "ParticlePolygonWalls.h"
+#include "ParticleForceFieldGrid.h"
+#include "ParticleForceFieldWind.h"
+#include "ParticleForceFieldVortex.h"
+#include "ParticleForceFieldGravityWell.h"
+#include "FixedTimestepClock.h"
+#include "AdaptiveTimestepController.h"
+#include "ParticleFrameExchange.h"
+#include "ParticleTaskScheduler.h"
+#include "ParticleSpatialReorder.h"
+#include "ParticleTreeAutotuner.h"
+#include "ParticleBroadphaseSelector.h"
+#include "ParticleCollisionValidator.h"
+#include "ParticleStats.h"
+#include "ParticleConservation.h"
+#include "FrameTimeHistogram.h"
+
+// for running the simulation on its own thread
+#include <thread>
+#include <atomic>
+
+// for timing the frame's phases
+#include <chrono>
 
 // for moving the shapes around in window space
 #include "glm/gtc/matrix_transform.hpp"
@@ -71,6 +99,8 @@ GLint gUnifMatrixTransformLoc;
 // or behind door number 3 so that collision boxes could get at the vertex data
 GeometryData gCircleGeometry;
 GeometryData gQuadTreeGeometry;
+GeometryData gWallGeometry;
+GeometryData gPeriodicRegionGeometry;
 
 // in a bigger program, this would somehow be encapsulated and associated with both the circle
 // geometry and the circle particle region, and ditto for the polygon
@@ -82,6 +112,186 @@ IParticleEmitter *gpParticleEmitterBar1;
 IParticleEmitter *gpParticleEmitterBar2;
 ParticleUpdater gParticleUpdater;
 ParticleQuadTree gParticleQuadTree;
+IParticleCollisionEngine<2> *gpParticleCollisionEngine;
+IParticleIntegrator *gpParticleIntegrator;
+ParticleSimulation gParticleSimulation;
+
+// the interaction law is picked once at startup
+// Note: Change this to try out the other laws (see ParticleCollisionResponse.h).
+const CollisionResponseType PARTICLE_COLLISION_RESPONSE = COLLISION_RESPONSE_ELASTIC;
+
+// each frame's step is split into this many substeps by the integrator
+// Note: The integrator itself is picked in Init().
+const int NUM_INTEGRATOR_SUBSTEPS = 1;
+
+// the simulation runs in real time no matter how fast the frames are drawn
+// Note: If the machine can't keep up, then each frame runs at most this many steps and the 
+// simulation slows down rather than falling further and further behind.
+const float SIMULATION_STEP_SEC = 0.01f;
+const int MAX_SIMULATION_STEPS_PER_FRAME = 5;
+FixedTimestepClock gSimulationClock(SIMULATION_STEP_SEC, MAX_SIMULATION_STEPS_PER_FRAME);
+
+// when enabled, the step size follows how fast the particles are moving so that fast ones don't 
+// pass through each other and slow scenes don't waste steps
+// Note: This is meant for the soft contact responses.  The elastic response applies its full 
+// impulse on every step that a pair overlaps, so more steps means more impulses.
+const bool USE_ADAPTIVE_TIMESTEP = false;
+AdaptiveTimestepController gTimestepController(0.0025f, 0.02f, 0.5f);
+
+// particles that move further than their radius in one step get swept collision detection so 
+// that they can't pass through each other
+// Note: Off because this demo's particles are going fast enough that most of them would need 
+// it.  It is meant for scenes where a few fast particles would otherwise force a small step on 
+// everything.
+const bool USE_CONTINUOUS_COLLISIONS = false;
+
+// push overlapping particles apart directly instead of with the collision response's forces
+// Note: Contacts are then perfectly inelastic, so this demo's spray of particles clumps up.  It 
+// is meant for dense piles, which it keeps stable at a much bigger step.
+const bool USE_POSITION_BASED_CONTACTS = false;
+ParticleContactSolver gContactSolver(8);
+
+// particles that leave a square inside the circle come back in on the other side instead of 
+// being lost and re-emitted, so the number of particles only goes up
+// Note: The square and the ghosts just outside of it must fit inside the circle's bounding box, 
+// which is the tree's region.
+const bool USE_PERIODIC_BOUNDARIES = false;
+const float PERIODIC_REGION_HALF_WIDTH = 0.7f;
+
+// external forces, added up on a grid once and then sampled by every particle
+// Note: Off because the demo's particles are emitted to cross the region in a straight line.  
+// Turn it on for a light downward wind, a counterclockwise swirl around the center, and a 
+// pull toward a point near the bottom.
+const bool USE_FORCE_FIELDS = false;
+ParticleForceFieldWind gWindField(glm::vec2(0.0f, -0.05f));
+ParticleForceFieldVortex gVortexField(glm::vec2(0.0f, 0.0f), 0.02f, 0.2f);
+ParticleForceFieldGravityWell gGravityWellField(glm::vec2(0.0f, -0.5f), 0.005f, 0.1f);
+ParticleForceFieldGrid gForceFieldGrid;
+
+// collisions are reported as events, the way that audio or effects would hear about them
+// Note: The demo only counts them.  Gentle contacts are filtered out and only one in every few 
+// of the rest are kept so that reporting them doesn't slow down the collisions.
+const bool USE_COLLISION_EVENTS = false;
+ParticleCollisionEvents gCollisionEvents;
+ParticleCollisionEvent gDrainedCollisionEvents[1024];
+int gNumCollisionEventsLastFrame = 0;
+
+// every so often the particles are sorted along a Hilbert curve so that particles that are 
+// close together are close together in memory; how often is worked out from how much the 
+// collisions slow down between sorts
+// Note: Collision events carry the particles' IDs, which survive the sorting.
+const bool USE_SPATIAL_REORDER = false;
+ParticleSpatialReorder gSpatialReorder;
+
+// the tree's leaf capacity and starting grid are tuned while the simulation runs by trying the 
+// settings next to the current ones every so often and keeping whichever collides fastest
+const bool USE_TREE_AUTOTUNER = false;
+ParticleTreeAutotuner gTreeAutotuner;
+
+// each step, the collisions find their pairs with whichever of brute force, a uniform grid, 
+// and the tree has been measured to be cheapest for the number of particles
+// Note: Brute force wins while the emitters are just getting started.
+const bool USE_BROADPHASE_SELECTION = false;
+ParticleBroadphase<2> gBroadphase;
+ParticleBroadphaseSelector gBroadphaseSelector;
+
+// the simulation runs on its own thread and hands each finished frame to the renderer, which 
+// draws the latest one without waiting and without making the simulation wait
+// Note: The frames are then drawn as they were at the end of a step instead of being blended 
+// between steps.
+const bool USE_SIMULATION_THREAD = false;
+ParticleFrameExchange gFrameExchange;
+std::thread gSimulationThread;
+std::atomic<bool> gStopSimulationThread(false);
+
+// each frame's phases run as a graph of tasks on a thread pool: a simulation step's update, 
+// integration, tree build, and collisions one after the other (the update and the 
+// integration split into chunks on the pool), and then the particle blending (split into 
+// chunks), the quad tree overlay, and the collision events all at the same time
+// Note: The graph is one step.  A frame that owes several steps runs it once for each, and 
+// only the last run does anything after the step.  The overlay can start as soon as the tree 
+// is built if nothing later in the step can rebuild it (see TREE_OVERLAY_AFTER_TREE_BUILD).
+// Also Note: Ignored with the simulation thread, which runs the steps on its own.
+const bool USE_TASK_GRAPH = false;
+const int PARTICLE_PACK_CHUNK_SIZE = 2048;
+ParticleTaskScheduler *gpFrameScheduler = 0;
+bool gStepIsDue = false;
+bool gAnotherStepIsDue = false;
+
+// the particle-particle collisions' tree traversal is split into subtrees that are run as jobs 
+// on a work-stealing pool; subtrees with this many particles or fewer stay on one thread
+// Note: Uses the frame's pool if there is one so that the two don't fight over the cores.
+const bool USE_FORK_JOIN_COLLISIONS = false;
+const int FORK_JOIN_SERIAL_CUTOFF = 512;
+ParticleTaskScheduler *gpCollisionScheduler = 0;
+
+// every so often the step's collisions are run again on a copy of the state, once the way that 
+// they normally run and once with every pair checked, and any pairs or forces that don't match 
+// are printed
+// Note: Slow on purpose.  Ignored with periodic boundaries or position-based contacts.
+const bool USE_COLLISION_VALIDATION = false;
+const int COLLISION_VALIDATION_INTERVAL_STEPS = 60;
+ParticleCollisionValidator gCollisionValidator;
+int gStepsUntilCollisionValidation = COLLISION_VALIDATION_INTERVAL_STEPS;
+
+// each frame's collision counts and tree shape are gathered into a block that the HUD shows 
+// part of, and every block is appended to a log (CSV unless binary, none if there is no path)
+// Note: A frame with a collision validation counts the validation's passes too.
+const bool USE_PARTICLE_STATS = false;
+const char *PARTICLE_STATS_LOG_PATH = "particle_stats.csv";
+const bool PARTICLE_STATS_LOG_BINARY = false;
+ParticleStats gParticleStats;
+unsigned int gNumStatsFrames = 0;
+
+// the updater sums the particles' mass, momentum, and kinetic energy as it goes, and every step 
+// is checked for mass or momentum that came from nowhere; alarms are printed
+// Note: Momentum is only checked in steps where nothing but the particles pushed on the 
+// particles, so never with force fields, continuous collisions, or position-based contacts, 
+// and not in a step with a wall bounce.
+const bool USE_CONSERVATION_MONITOR = false;
+ParticleConservationMonitor gConservationMonitor;
+bool gLastStepWasClosed = false;
+
+// every frame's time, and the time of each phase of it, goes into a histogram so that the 
+// stalls show up in the 99th percentile and the maximum instead of being averaged away; 't' 
+// shows them, and they are printed on exit (with every bucket if asked for)
+// Note: The frame is from one Display() to the next.  Updating includes the simulation when 
+// it is on this thread, and the simulation and collisions are only recorded for frames that 
+// ran at least one step.
+enum FramePhase
+{
+    FRAME_PHASE_FRAME = 0,
+    FRAME_PHASE_UPDATE,
+    FRAME_PHASE_SIMULATE,
+    FRAME_PHASE_COLLIDE,
+    FRAME_PHASE_UPLOAD,
+    FRAME_PHASE_DRAW,
+    NUM_FRAME_PHASES
+};
+const char *FRAME_PHASE_NAMES[NUM_FRAME_PHASES] = 
+{ 
+    "frame", "update", "simulate", "collide", "upload", "draw" 
+};
+const bool PRINT_FRAME_TIME_BUCKETS_ON_EXIT = false;
+FrameTimeHistogram gFrameTimes[NUM_FRAME_PHASES];
+bool gShowFrameTimes = false;
+
+// the current frame's simulation steps so far
+std::chrono::steady_clock::time_point gSimulateStart;
+int gNumStepsThisFrame = 0;
+double gCollisionSecThisFrame = 0.0;
+
+// static obstacles in the middle of the region for the particles to bounce off
+// Note: A bounce at the end of the step evaluates the forces again, which can rebuild the tree 
+// (see TREE_OVERLAY_AFTER_TREE_BUILD).
+const bool USE_POLYGON_WALLS = true;
+ParticlePolygonWalls gParticleWalls;
+
+// the task graph's tree overlay only needs the tree unless something after the tree build can 
+// rebuild it: the end of the step can with walls, continuous collisions, or the contact 
+// solver, and the collision validation does on purpose
+const bool TREE_OVERLAY_AFTER_TREE_BUILD = !USE_POLYGON_WALLS && !USE_CONTINUOUS_COLLISIONS && 
+    !USE_POSITION_BASED_CONTACTS && !USE_COLLISION_VALIDATION;
 
 
 // TODO: change how things are run around here
@@ -175,6 +385,36 @@ void Init()
     gParticleQuadTree.GenerateGeometry(&gQuadTreeGeometry, true);
     gQuadTreeGeometry.Init(geometryProgramId);
 
+    // a diamond where the two bars' streams cross and a cup below it
+    // Note: Every polygon is closed, so the cup is a thin loop with an inside and an outside.
+    std::vector<glm::vec2> diamond;
+    diamond.push_back(glm::vec2(+0.0f, +0.15f));
+    diamond.push_back(glm::vec2(+0.1f, +0.25f));
+    diamond.push_back(glm::vec2(+0.0f, +0.35f));
+    diamond.push_back(glm::vec2(-0.1f, +0.25f));
+    gParticleWalls.AddPolygon(diamond);
+    std::vector<glm::vec2> cup;
+    cup.push_back(glm::vec2(-0.3f, -0.2f));
+    cup.push_back(glm::vec2(-0.2f, -0.45f));
+    cup.push_back(glm::vec2(+0.2f, -0.45f));
+    cup.push_back(glm::vec2(+0.3f, -0.2f));
+    cup.push_back(glm::vec2(+0.28f, -0.2f));
+    cup.push_back(glm::vec2(+0.18f, -0.43f));
+    cup.push_back(glm::vec2(-0.18f, -0.43f));
+    cup.push_back(glm::vec2(-0.28f, -0.2f));
+    gParticleWalls.AddPolygon(cup);
+    gParticleWalls.Build();
+    gParticleWalls.GenerateGeometry(&gWallGeometry);
+    gWallGeometry.Init(geometryProgramId);
+
+    std::vector<glm::vec2> periodicRegionCorners;
+    periodicRegionCorners.push_back(glm::vec2(-PERIODIC_REGION_HALF_WIDTH, -PERIODIC_REGION_HALF_WIDTH));
+    periodicRegionCorners.push_back(glm::vec2(+PERIODIC_REGION_HALF_WIDTH, -PERIODIC_REGION_HALF_WIDTH));
+    periodicRegionCorners.push_back(glm::vec2(+PERIODIC_REGION_HALF_WIDTH, +PERIODIC_REGION_HALF_WIDTH));
+    periodicRegionCorners.push_back(glm::vec2(-PERIODIC_REGION_HALF_WIDTH, +PERIODIC_REGION_HALF_WIDTH));
+    GeneratePolygonWireframe(&gPeriodicRegionGeometry, periodicRegionCorners, false);
+    gPeriodicRegionGeometry.Init(geometryProgramId);
+
     // stick the point emitter in the center (changing this would only require some 
     // addition/subtraction from the "circle center")
     gpParticleEmitterPoint = new ParticleEmitterPoint(glm::vec2(), 0.3f, 0.5f);
@@ -204,6 +444,14 @@ void Init()
     // the VAO.
     gParticleStorage.Init(particleProgramId, MAX_PARTICLE_COUNT);
 
+    // every particle is species 0 unless an emitter says otherwise
+    // Note: Uncomment to have the second bar emit heavier, bigger, less bouncy particles that 
+    // barely interact with the first bar's.  Mixing species switches the collisions and the 
+    // updater off the uniform fast path.
+    //gParticleStorage._allParticleProperties.SetSpeciesProperties(1, ParticleProperties(0.3f, 0.015f, 0.5f));
+    //gParticleStorage._allParticleProperties.SetInteractionCoefficient(0, 1, 0.2f);
+    //gpParticleEmitterBar2->SetSpecies(1);
+
     // starting up the particle updater
     gParticleUpdater.SetRegion(particleRegionCenter, particleRegionRadius);
     gParticleUpdater.AddEmitter(gpParticleEmitterBar1, 1);
@@ -213,36 +461,464 @@ void Init()
     
     // starting up the particle quad tree
     gParticleQuadTree.InitializeTree(particleRegionCenter, particleRegionRadius);
+    gpParticleCollisionEngine = NewParticleCollisionEngine<2>(PARTICLE_COLLISION_RESPONSE);
+
+    // the original integration scheme
+    // Note: Try ParticleIntegratorVelocityVerlet or ParticleIntegratorRK4 instead.
+    gpParticleIntegrator = new ParticleIntegratorSymplecticEuler(NUM_INTEGRATOR_SUBSTEPS);
+    gParticleSimulation.Init(&gParticleUpdater, &gParticleQuadTree, gpParticleCollisionEngine, 
+        gpParticleIntegrator);
+    gParticleSimulation.SetContinuousCollisions(USE_CONTINUOUS_COLLISIONS);
+    if (USE_POLYGON_WALLS)
+    {
+        gParticleSimulation.SetWalls(&gParticleWalls);
+    }
+    if (USE_FORCE_FIELDS)
+    {
+        gForceFieldGrid.SetRegion(particleRegionCenter, particleRegionRadius);
+        gForceFieldGrid.AddField(&gWindField);
+        gForceFieldGrid.AddField(&gVortexField);
+        gForceFieldGrid.AddField(&gGravityWellField);
+        gParticleSimulation.SetForceField(&gForceFieldGrid);
+    }
+    if (USE_COLLISION_EVENTS)
+    {
+        gCollisionEvents.SetMinImpulse(0.0001f);
+        gCollisionEvents.SetSampleInterval(4);
+        gParticleSimulation.SetCollisionEvents(&gCollisionEvents);
+    }
+    if (USE_PERIODIC_BOUNDARIES)
+    {
+        gParticleSimulation.SetPeriodicRegion(particleRegionCenter, PERIODIC_REGION_HALF_WIDTH);
+    }
+    if (USE_POSITION_BASED_CONTACTS)
+    {
+        gParticleSimulation.SetContactSolver(&gContactSolver);
+    }
+    if (USE_SPATIAL_REORDER)
+    {
+        gSpatialReorder.Init(MAX_PARTICLE_COUNT);
+        gParticleSimulation.SetParticleIds(gSpatialReorder.ParticleIds());
+    }
+    if (USE_TREE_AUTOTUNER)
+    {
+        gTreeAutotuner.Init(&gParticleQuadTree);
+    }
+    if (USE_BROADPHASE_SELECTION)
+    {
+        gpParticleCollisionEngine->SetBroadphase(&gBroadphase);
+        gParticleSimulation.SetBroadphase(&gBroadphase);
+    }
 
     // the timer will be used for framerate calculations
     gTimer.Init();
     gTimer.Start();
+    gSimulationClock.Start();
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Updates particle positions, generates the quad tree for the particles' new positions, and 
-    commands a new draw.
+    Starts a frame's worth of simulation steps: the clock takes the real time since the last 
+    frame, and the frame's counts start over.
 Parameters: None
 Returns:    None
 Exception:  Safe
-Creator:    John Cox (1-2-2017)
+Creator:    John Cox (10-19-2026)
 -----------------------------------------------------------------------------------------------*/
-void UpdateAllTheThings()
+void BeginSimulationFrame()
+{
+    gSimulateStart = std::chrono::steady_clock::now();
+    gNumStepsThisFrame = 0;
+    gCollisionSecThisFrame = 0.0;
+    if (USE_PARTICLE_STATS)
+    {
+        gParticleStats.BeginFrame();
+    }
+
+    gSimulationClock.AdvanceFrame();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Everything that happens before a step that isn't part of the simulation itself.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void BeginSimulationStep()
+{
+    // before the previous state is saved so that the blending lines up
+    if (USE_SPATIAL_REORDER && gSpatialReorder.IsReorderDue())
+    {
+        gSpatialReorder.Reorder(gParticleStorage._allParticles, 
+            gParticleStorage._allParticleProperties);
+        gContactSolver.RemapParticleIndices(gSpatialReorder.NewIndexOfOld());
+    }
+
+    // the frame is drawn between the state before the last step and the state after it
+    if (!USE_SIMULATION_THREAD)
+    {
+        gParticleStorage.SavePreviousState();
+    }
+
+    if (USE_BROADPHASE_SELECTION)
+    {
+        gBroadphase.SetType(gBroadphaseSelector.ChooseForStep(
+            gParticleUpdater.NumActiveParticles()));
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Everything that happens after a step that isn't part of the simulation itself: the 
+    checks and tuners that watch each step, and the next step's delta time.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void FinishSimulationStep()
+{
+    gNumStepsThisFrame++;
+    gCollisionSecThisFrame += gParticleSimulation.CollisionSecLastStep();
+
+    if (USE_CONSERVATION_MONITOR)
+    {
+        // the updater's totals are from the start of this step, so they tell what the 
+        // step before it did
+        int alarms = gConservationMonitor.RecordStep(gParticleUpdater.ConservationTotals(), 
+            gLastStepWasClosed);
+        if (alarms != CONSERVATION_ALARM_NONE)
+        {
+            const ParticleConservationRecord &record = gConservationMonitor.Record(0);
+            printf("conservation alarm (%d) at step %u: mass %.2e  momentum %.2e  "
+                "drift %.2e  energy %+.2e\n", alarms, record._stepNumber, 
+                record._massError, record._momentumError, 
+                gConservationMonitor.MomentumDrift(), record._energyGain);
+        }
+        gLastStepWasClosed = !USE_FORCE_FIELDS && !USE_CONTINUOUS_COLLISIONS && 
+            !USE_POSITION_BASED_CONTACTS && 
+            (gParticleWalls.NumParticlesBouncedLastCollide() == 0);
+    }
+
+    if (USE_SPATIAL_REORDER)
+    {
+        gSpatialReorder.RecordStep(gParticleSimulation.CollisionSecLastStep(), 
+            gParticleUpdater.NumActiveParticles());
+    }
+    if (USE_TREE_AUTOTUNER)
+    {
+        gTreeAutotuner.RecordStep(gParticleSimulation.CollisionSecLastStep(), 
+            gParticleUpdater.NumActiveParticles());
+    }
+    if (USE_BROADPHASE_SELECTION)
+    {
+        gBroadphaseSelector.RecordStep(gBroadphase.Type(), 
+            gParticleSimulation.CollisionSecLastStep(), gParticleUpdater.NumActiveParticles());
+    }
+
+    if (USE_COLLISION_VALIDATION && !USE_PERIODIC_BOUNDARIES && 
+        !USE_POSITION_BASED_CONTACTS && --gStepsUntilCollisionValidation == 0)
+    {
+        gStepsUntilCollisionValidation = COLLISION_VALIDATION_INTERVAL_STEPS;
+        if (!gCollisionValidator.Validate(gParticleStorage._allParticles, 
+            gParticleStorage._allParticleProperties, gParticleQuadTree, 
+            gSimulationClock.StepSec()))
+        {
+            const ParticleCollisionValidationReport &report = 
+                gCollisionValidator.LastReport();
+            printf("collision validation failed: missed %d  extra %d  duplicate %d  "
+                "counts %d  max dF %.3e (of %.3e)%s\n", report._numMissedPairs, 
+                report._numExtraPairs, report._numDuplicatePairs, 
+                report._numCountMismatches, report._maxForceDelta, 
+                report._maxReferenceForce, 
+                report._pairListsComplete ? "" : "  (pairs dropped)");
+        }
+    }
+
+    if (USE_ADAPTIVE_TIMESTEP)
+    {
+        // the updater found the fastest particles at the start of this step
+        gSimulationClock.SetStepSec(gTimestepController.NextStepSec(
+            gParticleUpdater.MaxSpeed(), gParticleUpdater.MaxAcceleration(), 
+            gParticleStorage._allParticleProperties.MinRadiusOfInfluence()));
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Finishes a frame's worth of simulation steps by recording the frame's stats and times, 
+    if it had any steps.
+Parameters: None
+Returns:
+    True if at least one step ran.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+bool FinishSimulationFrame()
+{
+    bool steppedAny = (gNumStepsThisFrame > 0);
+    if (USE_PARTICLE_STATS && steppedAny)
+    {
+        gParticleStats.EndFrame(gNumStatsFrames++, gNumStepsThisFrame, 
+            gParticleUpdater.NumActiveParticles(), gCollisionSecThisFrame, gParticleQuadTree, 
+            USE_BROADPHASE_SELECTION ? (int)gBroadphase.Type() : -1);
+    }
+
+    if (steppedAny)
+    {
+        gFrameTimes[FRAME_PHASE_SIMULATE].Record(std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - gSimulateStart).count());
+        gFrameTimes[FRAME_PHASE_COLLIDE].Record(gCollisionSecThisFrame);
+    }
+
+    return steppedAny;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs as many fixed-size simulation steps as the real time since the last call calls for, 
+    which may be none.
+Parameters: None
+Returns:
+    True if at least one step ran.
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+bool RunSimulationSteps()
+{
+    BeginSimulationFrame();
+    while (gSimulationClock.NextStep())
+    {
+        BeginSimulationStep();
+
+        // check bounds, emit, integrate, and collide
+        gParticleSimulation.Step(gParticleStorage._allParticles, 
+            gParticleStorage._allParticleProperties, gSimulationClock.StepSec());
+
+        FinishSimulationStep();
+    }
+
+    return FinishSimulationFrame();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Copies everything that Display() needs out of the simulation and hands it to the renderer.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void PublishSimulationFrame()
+{
+    ParticleRenderFrame &frame = gFrameExchange.BackFrame();
+    frame._particles = gParticleStorage._allParticles;
+    gParticleQuadTree.GenerateGeometry(&frame._treeGeometry);
+    frame._numActiveParticles = gParticleUpdater.NumActiveParticles();
+    frame._numSleepingParticles = gParticleUpdater.NumSleepingParticles();
+    frame._numTreeNodes = gParticleQuadTree.NumNodesInUse();
+    frame._stepsPerSecond = gSimulationClock.StepsPerSecond();
+    frame._stepSec = gSimulationClock.StepSec();
+    frame._numDroppedCollisionEvents = gCollisionEvents.NumDroppedEvents();
+    gFrameExchange.Publish();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The simulation thread.  Keeps simulated time up with real time and publishes a frame after 
+    every batch of steps until CleanupAll() says to stop.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationThreadLoop()
+{
+    while (!gStopSimulationThread.load())
+    {
+        if (RunSimulationSteps())
+        {
+            PublishSimulationFrame();
+        }
+        else
+        {
+            // less than a step's worth of time has gone by; don't spin
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The consumer side of the collision events.  The demo only counts them.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void DrainCollisionEvents()
 {
-    // just hard-code it for this demo
-    float deltaTimeSec = 0.01f;
+    if (!USE_COLLISION_EVENTS)
+    {
+        return;
+    }
 
-    // update particle positions and check bounds
-    gParticleUpdater.Update(gParticleStorage._allParticles, 0,
-        gParticleStorage._allParticles.size(), deltaTimeSec);
+    gNumCollisionEventsLastFrame = 0;
+    int numDrained = 0;
+    do
+    {
+        numDrained = gCollisionEvents.Drain(gDrainedCollisionEvents, 1024);
+        gNumCollisionEventsLastFrame += numDrained;
+    } while (numDrained == 1024);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets up the frame's phases as a task graph.  A step's phases each need the one before 
+    it, so they run one after the other, but the update and the integration are split into 
+    chunks on the same pool (and so are the collisions, with fork-join collisions).  
+    Everything after the step only reads what the step wrote, and each one writes to 
+    something different, so they can all run at the same time.  Uploading to the GPU stays 
+    in Display() because OpenGL calls must come from the thread that owns the context.
+
+    The graph only has room for one step, so a frame that owes several runs it once for each 
+    (see UpdateAllTheThings()).  The step's last task finds out whether another step is due, 
+    and if one is, the tasks after it leave the frame's work for the last run.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (10-19-2026)
+-----------------------------------------------------------------------------------------------*/
+void BuildFrameTaskGraph()
+{
+    gpFrameScheduler = new ParticleTaskScheduler();
 
-    // update quad tree
-    gParticleQuadTree.ResetTree();
-    gParticleQuadTree.AddParticlestoTree(gParticleStorage._allParticles);
+    // check bounds, emit, and sleep/wake
+    int updateTask = gpFrameScheduler->AddTask("update", []()
+    {
+        if (gStepIsDue)
+        {
+            BeginSimulationStep();
+            gParticleSimulation.BeginStep(gParticleStorage._allParticles, 
+                gParticleStorage._allParticleProperties);
+        }
+    });
+    int integrateTask = gpFrameScheduler->AddTask("integrate", []()
+    {
+        if (gStepIsDue)
+        {
+            gParticleSimulation.IntegrateStep(gParticleStorage._allParticles, 
+                gParticleStorage._allParticleProperties, gSimulationClock.StepSec());
+        }
+    });
+    int treeTask = gpFrameScheduler->AddTask("tree build", []()
+    {
+        if (gStepIsDue)
+        {
+            gParticleSimulation.BuildTreeForStep(gParticleStorage._allParticles, 
+                gParticleStorage._allParticleProperties);
+        }
+    });
+    int collideTask = gpFrameScheduler->AddTask("collide", []()
+    {
+        if (gStepIsDue)
+        {
+            gParticleSimulation.CollideStep(gParticleStorage._allParticles, 
+                gParticleStorage._allParticleProperties);
+        }
+    });
+
+    // contacts, continuous collisions, walls, and the per-step checks
+    int finishStepTask = gpFrameScheduler->AddTask("finish step", []()
+    {
+        gAnotherStepIsDue = false;
+        if (gStepIsDue)
+        {
+            gParticleSimulation.EndStep(gParticleStorage._allParticles, 
+                gParticleStorage._allParticleProperties, gSimulationClock.StepSec());
+            FinishSimulationStep();
+            gAnotherStepIsDue = gSimulationClock.NextStep();
+        }
+        if (!gAnotherStepIsDue)
+        {
+            FinishSimulationFrame();
+        }
+    });
+
+    int packTask = gpFrameScheduler->AddParallelTask("pack particles", MAX_PARTICLE_COUNT, 
+        PARTICLE_PACK_CHUNK_SIZE, [](int begin, int end)
+    {
+        if (!gAnotherStepIsDue)
+        {
+            gParticleStorage.PackRenderParticles(gSimulationClock.InterpolationAlpha(), begin, 
+                end);
+        }
+    });
+    // Note: If nothing after the tree build can change the tree, then the overlay only needs 
+    // the tree and can run alongside the collisions, which only read it.  It then can't know 
+    // yet whether another step is due, so it runs every time and the last run's lines are the 
+    // ones that are drawn.
+    int overlayTask = gpFrameScheduler->AddTask("tree overlay", []()
+    {
+        if (!gAnotherStepIsDue || TREE_OVERLAY_AFTER_TREE_BUILD)
+        {
+            gParticleQuadTree.GenerateGeometry(&gQuadTreeGeometry);
+        }
+    });
+    int eventsTask = gpFrameScheduler->AddTask("collision events", []()
+    {
+        if (!gAnotherStepIsDue)
+        {
+            DrainCollisionEvents();
+        }
+    });
+
+    gpFrameScheduler->AddDependency(updateTask, integrateTask);
+    gpFrameScheduler->AddDependency(integrateTask, treeTask);
+    gpFrameScheduler->AddDependency(treeTask, collideTask);
+    gpFrameScheduler->AddDependency(collideTask, finishStepTask);
+    gpFrameScheduler->AddDependency(finishStepTask, packTask);
+    gpFrameScheduler->AddDependency(TREE_OVERLAY_AFTER_TREE_BUILD ? treeTask : finishStepTask, 
+        overlayTask);
+    gpFrameScheduler->AddDependency(finishStepTask, eventsTask);
+}
 
-    // check for collisions
-    gParticleQuadTree.DoTheParticleParticleCollisions(deltaTimeSec, gParticleStorage._allParticles);
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Updates particle positions, generates the quad tree for the particles' new positions, and 
+    commands a new draw.  If the simulation has its own thread, then this only commands the 
+    draw.
+Parameters: None
+Returns:    None
+Exception:  Safe
+Creator:    John Cox (1-2-2017)
+-----------------------------------------------------------------------------------------------*/
+void UpdateAllTheThings()
+{
+    std::chrono::steady_clock::time_point updateStart = std::chrono::steady_clock::now();
+    if (gpFrameScheduler != 0)
+    {
+        // the graph runs once for every step that is due, and once if none are
+        BeginSimulationFrame();
+        gStepIsDue = gSimulationClock.NextStep();
+        do
+        {
+            gpFrameScheduler->Run();
+            gStepIsDue = gAnotherStepIsDue;
+        } while (gStepIsDue);
+    }
+    else
+    {
+        if (!USE_SIMULATION_THREAD)
+        {
+            RunSimulationSteps();
+        }
+        DrainCollisionEvents();
+    }
+    gFrameTimes[FRAME_PHASE_UPDATE].Record(std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - updateStart).count());
 
     // tell glut to call this display() function again on the next iteration of the main loop
     // Note: https://www.opengl.org/discussion_boards/showthread.php/168717-I-dont-understand-what-glutPostRedisplay()-does
@@ -270,14 +946,72 @@ Creator:    John Cox (2-13-2016)
 -----------------------------------------------------------------------------------------------*/
 void Display()
 {
+    std::chrono::steady_clock::time_point uploadStart = std::chrono::steady_clock::now();
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClearDepth(1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    // get the latest particles and quad tree onto the GPU
+    // Note: With the simulation thread, the particles and the tree belong to it, so only the 
+    // published frame is read.  If nothing new has been published, the buffers still have the 
+    // last frame.
+    // Also Note: Without it, the frame usually falls between two simulation steps, so the 
+    // positions are blended between them.
+    int numActiveParticles = 0;
+    int numSleepingParticles = 0;
+    int numTreeNodes = 0;
+    double stepsPerSecond = 0.0;
+    float stepSec = 0.0f;
+    unsigned int numDroppedCollisionEvents = 0;
+    if (USE_SIMULATION_THREAD)
+    {
+        if (gFrameExchange.AcquireLatest())
+        {
+            ParticleRenderFrame &frame = gFrameExchange.FrontFrame();
+            gParticleStorage.UpdateBufferData(frame._particles);
+            gQuadTreeGeometry._verts.swap(frame._treeGeometry._verts);
+            gQuadTreeGeometry._indices.swap(frame._treeGeometry._indices);
+            gQuadTreeGeometry.UpdateBufferData();
+        }
+
+        const ParticleRenderFrame &frame = gFrameExchange.FrontFrame();
+        numActiveParticles = frame._numActiveParticles;
+        numSleepingParticles = frame._numSleepingParticles;
+        numTreeNodes = frame._numTreeNodes;
+        stepsPerSecond = frame._stepsPerSecond;
+        stepSec = frame._stepSec;
+        numDroppedCollisionEvents = frame._numDroppedCollisionEvents;
+    }
+    else
+    {
+        // the task graph already packed the particles and made the tree's lines
+        if (gpFrameScheduler != 0)
+        {
+            gParticleStorage.UploadRenderParticles(gSimulationClock.InterpolationAlpha());
+        }
+        else
+        {
+            gParticleStorage.UpdateBufferData(gSimulationClock.InterpolationAlpha());
+            gParticleQuadTree.GenerateGeometry(&gQuadTreeGeometry);
+        }
+        gQuadTreeGeometry.UpdateBufferData();
+        numActiveParticles = gParticleUpdater.NumActiveParticles();
+        numSleepingParticles = gParticleUpdater.NumSleepingParticles();
+        numTreeNodes = gParticleQuadTree.NumNodesInUse();
+        stepsPerSecond = gSimulationClock.StepsPerSecond();
+        stepSec = gSimulationClock.StepSec();
+        numDroppedCollisionEvents = gCollisionEvents.NumDroppedEvents();
+    }
+
+    std::chrono::steady_clock::time_point drawStart = std::chrono::steady_clock::now();
+    gFrameTimes[FRAME_PHASE_UPLOAD].Record(
+        std::chrono::duration<double>(drawStart - uploadStart).count());
+
     // draw all particles
     // Note: All particles are points and are already in their world locations, so the shader 
     // does not use a transform matrix.
-    gParticleStorage.UpdateBufferData();
+    // Also Note: The number of particles never changes after Init(), so reading it from the 
+    // storage is safe even while the simulation thread is running.
     glUseProgram(ShaderStorage::GetInstance().GetShaderProgram("particles"));
     glBindVertexArray(gParticleStorage._vaoId);
     glDrawArrays(gParticleStorage._drawStyle, 0, gParticleStorage._allParticles.size());
@@ -293,33 +1027,65 @@ void Display()
     // Note: The quad tree nodes' locations are based on an already-transformed center point and 
     // on particle locations, which don't have a transform.  But the geometry shader needs a 
     // transform, so give it the identity matrix to make it happy.
-    gParticleQuadTree.GenerateGeometry(&gQuadTreeGeometry);
-    gQuadTreeGeometry.UpdateBufferData();
     glUniformMatrix4fv(gUnifMatrixTransformLoc, 1, GL_FALSE, glm::value_ptr(glm::mat4()));
     glBindVertexArray(gQuadTreeGeometry._vaoId);
     glDrawElements(gQuadTreeGeometry._drawStyle, gQuadTreeGeometry._indices.size(), GL_UNSIGNED_SHORT, 0);
 
     // draw the particle region borders
+    // Note: Like the circle, the periodic square is centered on the origin.
     glUniformMatrix4fv(gUnifMatrixTransformLoc, 1, GL_FALSE, glm::value_ptr(gRegionTransformMatrix));
-    glBindVertexArray(gCircleGeometry._vaoId);
-    glDrawElements(gCircleGeometry._drawStyle, gCircleGeometry._indices.size(), GL_UNSIGNED_SHORT, 0);
+    if (USE_PERIODIC_BOUNDARIES)
+    {
+        glBindVertexArray(gPeriodicRegionGeometry._vaoId);
+        glDrawElements(gPeriodicRegionGeometry._drawStyle, gPeriodicRegionGeometry._indices.size(), GL_UNSIGNED_SHORT, 0);
+    }
+    else
+    {
+        glBindVertexArray(gCircleGeometry._vaoId);
+        glDrawElements(gCircleGeometry._drawStyle, gCircleGeometry._indices.size(), GL_UNSIGNED_SHORT, 0);
+    }
+
+    // draw the walls
+    // Note: Like the quad tree, they are in the particles' space.
+    if (USE_POLYGON_WALLS)
+    {
+        glUniformMatrix4fv(gUnifMatrixTransformLoc, 1, GL_FALSE, glm::value_ptr(glm::mat4()));
+        glBindVertexArray(gWallGeometry._vaoId);
+        glDrawElements(gWallGeometry._drawStyle, gWallGeometry._indices.size(), GL_UNSIGNED_SHORT, 0);
+    }
 
 
     // draw the frame rate once per second in the lower left corner
     // Note: The font textures' orgin is their lower left corner, so the "lower left" in screen 
     // space is just above [-1.0f, -1.0f].
     GLfloat color[4] = { 0.5f, 0.5f, 0.0f, 1.0f };
-    char str[32];
+    char str[64];
     static int elapsedFramesPerSecond = 0;
     static double elapsedTime = 0.0;
     static double frameRate = 0.0;
     elapsedFramesPerSecond++;
-    elapsedTime += gTimer.Lap();
+    double frameSec = gTimer.Lap();
+    elapsedTime += frameSec;
+    gFrameTimes[FRAME_PHASE_FRAME].Record(frameSec);
     if (elapsedTime > 1.0)
     {
         frameRate = (double)elapsedFramesPerSecond / elapsedTime;
         elapsedFramesPerSecond = 0;
         elapsedTime -= 1.0f;
+
+        // the full task report is too long for the screen
+        if (gpFrameScheduler != 0)
+        {
+            for (int taskId = 0; taskId < gpFrameScheduler->NumTasks(); taskId++)
+            {
+                printf("%-18s start %7.3fms  end %7.3fms  busy %7.3fms %s\n", 
+                    gpFrameScheduler->TaskName(taskId), 
+                    1000.0 * gpFrameScheduler->TaskStartSec(taskId), 
+                    1000.0 * gpFrameScheduler->TaskEndSec(taskId), 
+                    1000.0 * gpFrameScheduler->TaskBusySec(taskId), 
+                    gpFrameScheduler->IsOnCriticalPath(taskId) ? "(critical)" : "");
+            }
+        }
     }
     sprintf(str, "%.2lf", frameRate);
     float frameRateXY[2] = { -0.99f, -0.99f };
@@ -329,17 +1095,151 @@ void Display()
     glUseProgram(ShaderStorage::GetInstance().GetShaderProgram("freetype"));
     gTextAtlases.GetAtlas(48)->RenderText(str, frameRateXY, scaleXY, color);
 
+    // simulation steps per second are independent of the frame rate
+    sprintf(str, "steps/s: %.1lf  dt: %.4f", stepsPerSecond, stepSec);
+    float stepsPerSecondXY[2] = { -0.99f, -0.89f };
+    gTextAtlases.GetAtlas(48)->RenderText(str, stepsPerSecondXY, scaleXY, color);
+
     // now show number of active particles
     // Note: For some reason, lower case "i" seems to appear too close to the other letters.
-    sprintf(str, "active: %d", gParticleUpdater.NumActiveParticles());
+    sprintf(str, "active: %d", numActiveParticles);
     float numActiveParticlesXY[2] = { -0.99f, +0.7f };
     gTextAtlases.GetAtlas(48)->RenderText(str, numActiveParticlesXY, scaleXY, color);
 
+    // and how many of those are asleep
+    sprintf(str, "sleeping: %d", numSleepingParticles);
+    float numSleepingParticlesXY[2] = { -0.99f, +0.6f };
+    gTextAtlases.GetAtlas(48)->RenderText(str, numSleepingParticlesXY, scaleXY, color);
+
     // now draw the number of active quad tree nodes
-    sprintf(str, "nodes: %d", gParticleQuadTree.NumNodesInUse());
+    sprintf(str, "nodes: %d", numTreeNodes);
     float numActiveNodesXY[2] = { -0.99f, +0.5f };
     gTextAtlases.GetAtlas(48)->RenderText(str, numActiveNodesXY, scaleXY, color);
 
+    // how long the frame's task graph took compared to the longest chain of tasks in it
+    if (gpFrameScheduler != 0)
+    {
+        sprintf(str, "tasks: %.2lfms  critical: %.2lfms", 
+            1000.0 * gpFrameScheduler->LastRunSec(), 1000.0 * gpFrameScheduler->CriticalPathSec());
+        float taskGraphXY[2] = { -0.99f, -0.79f };
+        gTextAtlases.GetAtlas(48)->RenderText(str, taskGraphXY, scaleXY, color);
+    }
+
+    // how stale the drawn frame is and how many frames the renderer is falling behind by
+    if (USE_SIMULATION_THREAD)
+    {
+        sprintf(str, "latency: %.1lfms  depth: %u  skipped: %u", 
+            1000.0 * gFrameExchange.LatencySecAtLastAcquire(), 
+            gFrameExchange.QueueDepthAtLastAcquire(), gFrameExchange.NumSkippedFrames());
+        float frameLatencyXY[2] = { -0.99f, -0.79f };
+        gTextAtlases.GetAtlas(48)->RenderText(str, frameLatencyXY, scaleXY, color);
+    }
+
+    // the reorder's cost and the interval that it settled on
+    // Note: Only when the simulation is on this thread; otherwise it is in the middle of 
+    // changing.
+    if (USE_SPATIAL_REORDER && !USE_SIMULATION_THREAD)
+    {
+        sprintf(str, "reorder: %.2lfms every %d steps", 
+            1000.0 * gSpatialReorder.LastReorderSec(), gSpatialReorder.LastIntervalSteps());
+        float spatialReorderXY[2] = { -0.99f, +0.3f };
+        gTextAtlases.GetAtlas(48)->RenderText(str, spatialReorderXY, scaleXY, color);
+    }
+
+    // the tree settings that the autotuner has settled on so far
+    if (USE_TREE_AUTOTUNER && !USE_SIMULATION_THREAD)
+    {
+        sprintf(str, "leaf: %d  grid: %d  %.1lfns/particle%s", 
+            gTreeAutotuner.BestLeafCapacity(), gTreeAutotuner.BestNumCellsPerAxis(), 
+            1.0e9 * gTreeAutotuner.BestSecPerParticle(), 
+            gTreeAutotuner.IsRoundRunning() ? "  (trying)" : "");
+        float treeAutotunerXY[2] = { -0.99f, +0.2f };
+        gTextAtlases.GetAtlas(48)->RenderText(str, treeAutotunerXY, scaleXY, color);
+    }
+
+    // which broadphase is cheapest right now and what each one is predicted to cost
+    if (USE_BROADPHASE_SELECTION && !USE_SIMULATION_THREAD)
+    {
+        const char *broadphaseNames[NUM_BROADPHASE_TYPES] = { "brute", "grid", "tree" };
+        unsigned int numActive = (unsigned int)numActiveParticles;
+        sprintf(str, "%s  brute: %.2lfms  grid: %.2lfms  tree: %.2lfms", 
+            broadphaseNames[gBroadphaseSelector.CheapestType(numActive)], 
+            1000.0 * gBroadphaseSelector.PredictedSec(BROADPHASE_BRUTE_FORCE, numActive), 
+            1000.0 * gBroadphaseSelector.PredictedSec(BROADPHASE_UNIFORM_GRID, numActive), 
+            1000.0 * gBroadphaseSelector.PredictedSec(BROADPHASE_TREE, numActive));
+        float broadphaseXY[2] = { -0.99f, +0.1f };
+        gTextAtlases.GetAtlas(48)->RenderText(str, broadphaseXY, scaleXY, color);
+    }
+
+    // how much work the last frame's collisions did and how well the tree fit the particles
+    if (USE_PARTICLE_STATS && !USE_SIMULATION_THREAD)
+    {
+        const ParticleStatsFrame &stats = gParticleStats.LastFrame();
+        sprintf(str, "pairs: %llu  hit: %llu  leaves: %d  depth: %d  failed splits: %d", 
+            stats._numPairTests, stats._numPairsCollided, stats._treeShape._numLeaves, 
+            stats._treeShape._maxDepth, stats._numSubdivisionFailures);
+        float particleStatsXY[2] = { -0.99f, -0.1f };
+        gTextAtlases.GetAtlas(48)->RenderText(str, particleStatsXY, scaleXY, color);
+    }
+
+    // how far the last step moved the conserved totals
+    if (USE_CONSERVATION_MONITOR && !USE_SIMULATION_THREAD && 
+        gConservationMonitor.NumRecords() > 0)
+    {
+        const ParticleConservationRecord &record = gConservationMonitor.Record(0);
+        sprintf(str, "KE: %.3e  dP: %.1e  drift: %.1e  alarms: %d of %d", 
+            record._kineticEnergy, record._momentumError, gConservationMonitor.MomentumDrift(), 
+            gConservationMonitor.NumAlarmedSteps(), gConservationMonitor.NumStepsChecked());
+        float conservationXY[2] = { -0.99f, -0.2f };
+        gTextAtlases.GetAtlas(48)->RenderText(str, conservationXY, scaleXY, color);
+    }
+
+    // what the last collision validation found
+    if (USE_COLLISION_VALIDATION && !USE_SIMULATION_THREAD)
+    {
+        const ParticleCollisionValidationReport &report = gCollisionValidator.LastReport();
+        sprintf(str, "validate: missed %d  extra %d  dF %.2e  failed %d of %d", 
+            report._numMissedPairs, report._numExtraPairs, report._maxForceDelta, 
+            gCollisionValidator.NumFailedValidations(), gCollisionValidator.NumValidations());
+        float collisionValidationXY[2] = { -0.99f, +0.0f };
+        gTextAtlases.GetAtlas(48)->RenderText(str, collisionValidationXY, scaleXY, color);
+    }
+
+    if (USE_COLLISION_EVENTS)
+    {
+        sprintf(str, "events: %d  dropped: %u", gNumCollisionEventsLastFrame, 
+            numDroppedCollisionEvents);
+        float numCollisionEventsXY[2] = { -0.99f, +0.4f };
+        gTextAtlases.GetAtlas(48)->RenderText(str, numCollisionEventsXY, scaleXY, color);
+    }
+
+    // each phase's median, 99th percentile, and worst time so far, down the right side
+    // Note: The simulation's phases belong to the simulation thread if there is one.
+    if (gShowFrameTimes)
+    {
+        float frameTimesXY[2] = { +0.05f, +0.9f };
+        gTextAtlases.GetAtlas(48)->RenderText("ms         p50     p99     max", frameTimesXY, 
+            scaleXY, color);
+        for (int phase = 0; phase < NUM_FRAME_PHASES; phase++)
+        {
+            bool phaseIsOnSimulationThread = 
+                (phase == FRAME_PHASE_SIMULATE) || (phase == FRAME_PHASE_COLLIDE);
+            if (USE_SIMULATION_THREAD && phaseIsOnSimulationThread)
+            {
+                continue;
+            }
+
+            const FrameTimeHistogram &histogram = gFrameTimes[phase];
+            sprintf(str, "%-8s %7.2f %7.2f %7.2f", FRAME_PHASE_NAMES[phase], 
+                1000.0 * histogram.PercentileSec(50.0), 1000.0 * histogram.PercentileSec(99.0), 
+                1000.0 * histogram.MaxSec());
+            frameTimesXY[1] -= 0.08f;
+            gTextAtlases.GetAtlas(48)->RenderText(str, frameTimesXY, scaleXY, color);
+        }
+    }
+    gFrameTimes[FRAME_PHASE_DRAW].Record(std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - drawStart).count());
+
     // clean up bindings
     glUseProgram(0);
     glBindVertexArray(0);       // unbind this BEFORE the buffer
@@ -397,6 +1297,12 @@ void Keyboard(unsigned char key, int x, int y)
         glutLeaveMainLoop();
         return;
     }
+    case 't':
+    {
+        // the frame time breakdown
+        gShowFrameTimes = !gShowFrameTimes;
+        return;
+    }
     default:
         break;
     }
@@ -442,11 +1348,32 @@ Creator:    John Cox (2-13-2016)
 -----------------------------------------------------------------------------------------------*/
 void CleanupAll()
 {
+    // the simulation thread is still using everything below
+    if (gSimulationThread.joinable())
+    {
+        gStopSimulationThread.store(true);
+        gSimulationThread.join();
+    }
+
     // Note: If I attempt to delete an ID that has already been deleted, that is ok.  OpenGL
     // will silently swallow that.
     delete(gpParticleEmitterBar1);
     delete(gpParticleEmitterBar2);
     delete(gpParticleEmitterPoint);
+    delete(gpParticleCollisionEngine);
+    delete(gpParticleIntegrator);
+    if (gpCollisionScheduler != gpFrameScheduler)
+    {
+        delete(gpCollisionScheduler);
+    }
+    delete(gpFrameScheduler);
+    gParticleStats.CloseLog();
+
+    // the simulation thread has stopped, so its phases can be read too
+    for (int phase = 0; phase < NUM_FRAME_PHASES; phase++)
+    {
+        gFrameTimes[phase].Print(FRAME_PHASE_NAMES[phase], PRINT_FRAME_TIME_BUCKETS_ON_EXIT);
+    }
 }
 
 /*-----------------------------------------------------------------------------------------------
@@ -504,6 +1431,65 @@ int main(int argc, char *argv[])
 
     Init();
 
+    if (USE_TASK_GRAPH && !USE_SIMULATION_THREAD)
+    {
+        BuildFrameTaskGraph();
+    }
+
+    if (USE_FORK_JOIN_COLLISIONS)
+    {
+        gpCollisionScheduler = (gpFrameScheduler != 0) ? 
+            gpFrameScheduler : new ParticleTaskScheduler();
+        gpParticleCollisionEngine->SetForkJoinScheduler(gpCollisionScheduler, 
+            FORK_JOIN_SERIAL_CUTOFF);
+    }
+
+    // the collisions' pool also runs the contact solver's iterations and the updater's and the 
+    // integrator's chunks, and the stats and the event stream need one slot for each thread 
+    // that it has
+    ParticleTaskScheduler *pCollisionPool = (gpFrameScheduler != 0) ?
+        gpFrameScheduler : gpCollisionScheduler;
+    int numCollisionWorkers = (pCollisionPool != 0) ? pCollisionPool->NumWorkerThreads() : 0;
+    if (USE_COLLISION_EVENTS)
+    {
+        gCollisionEvents.SetNumWorkerThreads(numCollisionWorkers);
+    }
+    if (USE_POSITION_BASED_CONTACTS)
+    {
+        gContactSolver.SetScheduler(pCollisionPool);
+    }
+    gParticleUpdater.SetScheduler(pCollisionPool);
+    gpParticleIntegrator->SetScheduler(pCollisionPool);
+    if (USE_PARTICLE_STATS)
+    {
+        gParticleStats.Init(numCollisionWorkers);
+        if (PARTICLE_STATS_LOG_PATH != 0)
+        {
+            gParticleStats.OpenLog(PARTICLE_STATS_LOG_PATH, PARTICLE_STATS_LOG_BINARY);
+        }
+        gParticleQuadTree.SetStats(&gParticleStats);
+        gBroadphase.SetStats(&gParticleStats);
+    }
+
+    if (USE_CONSERVATION_MONITOR)
+    {
+        gParticleUpdater.SetConservationTotalsEnabled(true);
+    }
+
+    // the reference's brute force shares the collisions' pool
+    if (USE_COLLISION_VALIDATION)
+    {
+        gCollisionValidator.Init(gpParticleCollisionEngine, 
+            USE_BROADPHASE_SELECTION ? &gBroadphase : 0, MAX_PARTICLE_COUNT, 
+            gpCollisionScheduler);
+    }
+
+    // from now on, only the simulation thread touches the simulation
+    if (USE_SIMULATION_THREAD)
+    {
+        gSimulationThread = std::thread(SimulationThreadLoop);
+    }
+
     glutIdleFunc(UpdateAllTheThings);
     glutDisplayFunc(Display);
     glutReshapeFunc(Reshape);